@@ -6,8 +6,10 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "ash/components/arc/arc_features.h"
 #include "ash/components/arc/arc_prefs.h"
@@ -520,20 +522,16 @@ void ArcAppListPrefs::UprevCurrentIconsVersionForTesting() {
 
 std::string ArcAppListPrefs::GetAppIdByPackageName(
     const std::string& package_name) const {
-  const base::Value::Dict& apps = prefs_->GetDict(arc::prefs::kArcApps);
-
-  for (const auto it : apps) {
-    const base::Value& value = it.second;
-    const std::string* installed_package_name =
-        value.GetDict().FindString(kPackageName);
-    if (!installed_package_name || *installed_package_name != package_name)
-      continue;
+  const std::vector<std::string> app_ids =
+      GetAppIdsForPackageFromPrefs(package_name);
+  if (app_ids.empty())
+    return std::string();
 
-    const std::string* activity_name = value.GetDict().FindString(kActivity);
-    return activity_name ? GetAppId(package_name, *activity_name)
-                         : std::string();
-  }
-  return std::string();
+  const base::Value::Dict* app =
+      prefs_->GetDict(arc::prefs::kArcApps).FindDict(app_ids.front());
+  const std::string* activity_name = app ? app->FindString(kActivity) : nullptr;
+  return activity_name ? GetAppId(package_name, *activity_name)
+                       : std::string();
 }
 
 ArcAppListPrefs::ArcAppListPrefs(
@@ -1411,6 +1409,7 @@ void ArcAppListPrefs::SetAppLocale(const std::string& package_name,
                                      arc::prefs::kArcPackages);
   base::Value::Dict& package_dict = update.Get();
   package_dict.EnsureDict(kLocaleInfo)->Set(kSelectedLocale, selected_locale);
+  UpdatePackageIndex(package_name);
 
   const std::string& app_id = GetAppIdByPackageName(package_name);
   NotifyAppStatesChanged(app_id);
@@ -1561,6 +1560,7 @@ void ArcAppListPrefs::SetPackagePrefs(const std::string& package_name,
   arc::ArcAppScopedPrefUpdate update(prefs_, package_name,
                                      arc::prefs::kArcPackages);
   update->Set(key, std::move(value));
+  UpdatePackageIndex(package_name);
 }
 
 void ArcAppListPrefs::SetDefaultAppsReadyCallback(base::OnceClosure callback) {
@@ -1709,6 +1709,7 @@ void ArcAppListPrefs::AddAppAndShortcut(
   base::Value::Dict& app_dict = update.Get();
   app_dict.Set(kName, updated_name);
   app_dict.Set(kPackageName, package_name);
+  AddAppToPackageIndex(app_id, package_name);
   app_dict.Set(kActivity, activity);
   app_dict.Set(kIntentUri, intent_uri);
   app_dict.Set(kIconResourceId, icon_resource_id);
@@ -1830,10 +1831,18 @@ void ArcAppListPrefs::RemoveApp(const std::string& app_id) {
   // Remove asyncronously local data on file system.
   ScheduleAppFolderDeletion(app_id);
 
-  // Remove from prefs.
-  ScopedDictPrefUpdate apps_update(prefs_, arc::prefs::kArcApps);
-  const bool removed = apps_update->Remove(app_id);
-  DCHECK(removed);
+  // Remove from prefs. The update is committed before observers are notified
+  // so that they see the app removed.
+  {
+    ScopedDictPrefUpdate apps_update(prefs_, arc::prefs::kArcApps);
+    const base::Value::Dict* app = apps_update->FindDict(app_id);
+    const std::string* package_name =
+        app ? app->FindString(kPackageName) : nullptr;
+    if (package_name)
+      RemoveAppFromPackageIndex(app_id, *package_name);
+    const bool removed = apps_update->Remove(app_id);
+    DCHECK(removed);
+  }
 
   // |tracked_apps_| contains apps that are reported externally as available.
   // However, in case ARC++ appears as disbled on next start and had some apps
@@ -1885,6 +1894,7 @@ void ArcAppListPrefs::AddOrUpdatePackagePrefs(
   package_dict.Set(kLastBackupAndroidId, id_str);
   package_dict.Set(kLastBackupTime, time_str);
   package_dict.Set(kUninstalled, false);
+  UpdatePackageIndex(package_name);
   package_dict.Set(kVPNProvider, package.vpn_provider);
   package_dict.Set(kPreinstalled, package.preinstalled);
   package_dict.Set(kGameControlsOptOut, package.game_controls_opt_out);
@@ -1989,6 +1999,7 @@ void ArcAppListPrefs::AddOrUpdatePackagePrefs(
 
 void ArcAppListPrefs::RemovePackageFromPrefs(const std::string& package_name) {
   ScopedDictPrefUpdate(prefs_, arc::prefs::kArcPackages)->Remove(package_name);
+  UpdatePackageIndex(package_name);
   OnArcAppListRefreshed(profile_);
 }
 
@@ -2182,6 +2193,7 @@ void ArcAppListPrefs::OnPackageAppListRefreshed(
       int pin_index =
           shelf_controller->PinnedItemIndexByAppID(*apps_to_remove.begin());
       package_dict.Set(kPinIndex, pin_index);
+      UpdatePackageIndex(package_name);
     }
   }
 
@@ -2210,28 +2222,19 @@ void ArcAppListPrefs::OnUninstallShortcut(const std::string& package_name,
                                           const std::string& intent_uri) {
   std::vector<std::string> shortcuts_to_remove;
   const base::Value::Dict& apps = prefs_->GetDict(arc::prefs::kArcApps);
-  for (const auto app : apps) {
-    if (!app.second.is_dict()) {
-      VLOG(2) << "Failed to extract information for " << app.first << ".";
-      continue;
-    }
-
-    const std::string* installed_package_name =
-        app.second.GetDict().FindString(kPackageName);
+  for (const std::string& app_id : GetAppIdsForPackageFromPrefs(package_name)) {
+    const base::Value::Dict* app = apps.FindDict(app_id);
     const std::string* installed_intent_uri =
-        app.second.GetDict().FindString(kIntentUri);
-    if (!installed_package_name || !installed_intent_uri) {
-      VLOG(2) << "Failed to extract information for " << app.first << ".";
+        app ? app->FindString(kIntentUri) : nullptr;
+    if (!installed_intent_uri) {
+      VLOG(2) << "Failed to extract information for " << app_id << ".";
       continue;
     }
-    const bool shortcut =
-        app.second.GetDict().FindBool(kShortcut).value_or(false);
-    if (!shortcut || *installed_package_name != package_name ||
-        *installed_intent_uri != intent_uri) {
+    const bool shortcut = app->FindBool(kShortcut).value_or(false);
+    if (!shortcut || *installed_intent_uri != intent_uri)
       continue;
-    }
 
-    shortcuts_to_remove.push_back(app.first);
+    shortcuts_to_remove.push_back(app_id);
   }
 
   for (const auto& shortcut_id : shortcuts_to_remove)
@@ -2251,42 +2254,100 @@ std::unordered_set<std::string> ArcAppListPrefs::GetAppsAndShortcutsForPackage(
     bool include_shortcuts) const {
   std::unordered_set<std::string> app_set;
   const base::Value::Dict& apps = prefs_->GetDict(arc::prefs::kArcApps);
-  for (const auto app : apps) {
-    if (!crx_file::id_util::IdIsValid(app.first))
+  for (const std::string& app_id : GetAppIdsForPackageFromPrefs(package_name)) {
+    if (!crx_file::id_util::IdIsValid(app_id))
       continue;
 
-    if (!app.second.is_dict()) {
-      NOTREACHED_IN_MIGRATION();
-      continue;
-    }
-
-    const std::string* app_package =
-        app.second.GetDict().FindString(kPackageName);
-    if (!app_package) {
-      LOG(ERROR) << "App is malformed: " << app.first;
-      continue;
-    }
-
-    if (package_name != *app_package)
+    const base::Value::Dict* app = apps.FindDict(app_id);
+    if (!app)
       continue;
 
     if (!include_shortcuts) {
-      if (app.second.GetDict().FindBool(kShortcut).value_or(false))
+      if (app->FindBool(kShortcut).value_or(false))
         continue;
     }
 
     if (include_only_launchable_apps) {
       // Filter out non-lauchable apps.
-      if (!app.second.GetDict().FindBool(kLaunchable).value_or(false))
+      if (!app->FindBool(kLaunchable).value_or(false))
         continue;
     }
 
-    app_set.insert(app.first);
+    app_set.insert(app_id);
   }
 
   return app_set;
 }
 
+std::vector<std::string> ArcAppListPrefs::GetAppIdsForPackageFromPrefs(
+    const std::string& package_name) const {
+  if (!app_ids_by_package_) {
+    app_ids_by_package_.emplace();
+    const base::Value::Dict& apps = prefs_->GetDict(arc::prefs::kArcApps);
+    for (const auto app : apps) {
+      if (!app.second.is_dict()) {
+        VLOG(2) << "Failed to extract information for " << app.first << ".";
+        continue;
+      }
+
+      const std::string* app_package =
+          app.second.GetDict().FindString(kPackageName);
+      if (!app_package) {
+        LOG(ERROR) << "App is malformed: " << app.first;
+        continue;
+      }
+
+      (*app_ids_by_package_)[*app_package].push_back(app.first);
+    }
+  }
+
+  auto it = app_ids_by_package_->find(package_name);
+  if (it == app_ids_by_package_->end())
+    return {};
+  return it->second;
+}
+
+void ArcAppListPrefs::AddAppToPackageIndex(const std::string& app_id,
+                                           const std::string& package_name) {
+  if (!app_ids_by_package_)
+    return;
+
+  // Keep the ids sorted, matching the iteration order of the apps pref.
+  std::vector<std::string>& app_ids = (*app_ids_by_package_)[package_name];
+  auto it = std::lower_bound(app_ids.begin(), app_ids.end(), app_id);
+  if (it == app_ids.end() || *it != app_id)
+    app_ids.insert(it, app_id);
+}
+
+void ArcAppListPrefs::RemoveAppFromPackageIndex(
+    const std::string& app_id,
+    const std::string& package_name) {
+  if (!app_ids_by_package_)
+    return;
+
+  auto it = app_ids_by_package_->find(package_name);
+  if (it == app_ids_by_package_->end())
+    return;
+  std::erase(it->second, app_id);
+  if (it->second.empty())
+    app_ids_by_package_->erase(it);
+}
+
+void ArcAppListPrefs::UpdatePackageIndex(const std::string& package_name) {
+  if (!installed_packages_)
+    return;
+
+  installed_packages_->erase(package_name);
+  uninstalled_packages_->erase(package_name);
+  const base::Value::Dict* package =
+      prefs_->GetDict(arc::prefs::kArcPackages).FindDict(package_name);
+  if (!package)
+    return;
+  const bool uninstalled = package->FindBool(kUninstalled).value_or(false);
+  (uninstalled ? *uninstalled_packages_ : *installed_packages_)
+      .insert(package_name);
+}
+
 void ArcAppListPrefs::HandlePackageRemoved(const std::string& package_name) {
   DCHECK(IsArcAndroidEnabledForProfile(profile_));
   const std::unordered_set<std::string> apps_to_remove =
@@ -2381,22 +2442,8 @@ void ArcAppListPrefs::OnTaskSetActive(int32_t task_id) {
 void ArcAppListPrefs::OnNotificationsEnabledChanged(
     const std::string& package_name,
     bool enabled) {
-  const base::Value::Dict& apps = prefs_->GetDict(arc::prefs::kArcApps);
-  for (const auto app : apps) {
-    if (!app.second.is_dict()) {
-      NOTREACHED_IN_MIGRATION();
-      continue;
-    }
-    const std::string* app_package_name =
-        app.second.GetDict().FindString(kPackageName);
-    if (!app_package_name) {
-      LOG(ERROR) << "App is malformed: " << app.first;
-      continue;
-    }
-    if (*app_package_name != package_name) {
-      continue;
-    }
-    arc::ArcAppScopedPrefUpdate update(prefs_, app.first, arc::prefs::kArcApps);
+  for (const std::string& app_id : GetAppIdsForPackageFromPrefs(package_name)) {
+    arc::ArcAppScopedPrefUpdate update(prefs_, app_id, arc::prefs::kArcApps);
     base::Value::Dict& updating_app_dict = update.Get();
     updating_app_dict.Set(kNotificationsEnabled, enabled);
   }
@@ -2480,29 +2527,32 @@ std::vector<std::string> ArcAppListPrefs::GetPackagesFromPrefs() const {
 std::vector<std::string> ArcAppListPrefs::GetPackagesFromPrefs(
     bool check_arc_alive,
     bool installed) const {
-  std::vector<std::string> packages;
   if (check_arc_alive &&
       (!IsArcAlive() || !IsArcAndroidEnabledForProfile(profile_))) {
-    return packages;
+    return std::vector<std::string>();
   }
 
-  const base::Value::Dict& package_prefs =
-      prefs_->GetDict(arc::prefs::kArcPackages);
-  for (const auto package : package_prefs) {
-    if (!package.second.is_dict()) {
-      NOTREACHED_IN_MIGRATION();
-      continue;
-    }
-
-    const bool uninstalled =
-        package.second.GetDict().FindBool(kUninstalled).value_or(false);
-    if (installed != !uninstalled)
-      continue;
+  if (!installed_packages_) {
+    installed_packages_.emplace();
+    uninstalled_packages_.emplace();
+    const base::Value::Dict& package_prefs =
+        prefs_->GetDict(arc::prefs::kArcPackages);
+    for (const auto package : package_prefs) {
+      if (!package.second.is_dict()) {
+        NOTREACHED_IN_MIGRATION();
+        continue;
+      }
 
-    packages.push_back(package.first);
+      const bool uninstalled =
+          package.second.GetDict().FindBool(kUninstalled).value_or(false);
+      (uninstalled ? *uninstalled_packages_ : *installed_packages_)
+          .insert(package.first);
+    }
   }
 
-  return packages;
+  const std::set<std::string>& packages =
+      installed ? *installed_packages_ : *uninstalled_packages_;
+  return std::vector<std::string>(packages.begin(), packages.end());
 }
 
 base::Time ArcAppListPrefs::GetInstallTime(const std::string& app_id) const {
@@ -608,6 +608,19 @@ class ArcAppListPrefs : public KeyedService,
       const std::string& package_name,
       bool include_only_launchable_apps,
       bool include_shortcuts) const;
+  // Returns the ids of all apps and shortcuts in prefs that belong to
+  // |package_name|, in pref order.
+  std::vector<std::string> GetAppIdsForPackageFromPrefs(
+      const std::string& package_name) const;
+  // Keep |app_ids_by_package_| in sync when the apps pref entry of |app_id|,
+  // which belongs to |package_name|, is added or removed.
+  void AddAppToPackageIndex(const std::string& app_id,
+                            const std::string& package_name);
+  void RemoveAppFromPackageIndex(const std::string& app_id,
+                                 const std::string& package_name);
+  // Keeps |installed_packages_| and |uninstalled_packages_| in sync after the
+  // packages pref entry of |package_name| was written or removed.
+  void UpdatePackageIndex(const std::string& package_name);
 
   // Enumerates apps from preferences and notifies listeners about available
   // apps while ARC is not started yet. All apps in this case have disabled
@@ -706,6 +719,16 @@ class ArcAppListPrefs : public KeyedService,
   // Keeps root folder where ARC app icons for different scale factor are
   // stored.
   base::FilePath base_path_;
+  // Ids of the apps in the apps pref grouped by package name, in pref order.
+  // Built on first use so that per-package lookups do not scan every app. Only
+  // this class writes the apps and packages prefs, and it updates the entries
+  // below whenever it adds or removes an app or package.
+  mutable std::optional<std::map<std::string, std::vector<std::string>>>
+      app_ids_by_package_;
+  // Names of the installed and uninstalled packages in the packages pref.
+  // Built on first use.
+  mutable std::optional<std::set<std::string>> installed_packages_;
+  mutable std::optional<std::set<std::string>> uninstalled_packages_;
   // Contains set of ARC apps that are currently ready.
   std::unordered_set<std::string> ready_apps_;
   // Contains set of ARC apps that are currently tracked.
@@ -8,6 +8,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -33,6 +34,7 @@
 #include "base/path_service.h"
 #include "base/ranges/algorithm.h"
 #include "base/run_loop.h"
+#include "base/scoped_observation.h"
 #include "base/strings/stringprintf.h"
 #include "base/test/bind.h"
 #include "base/test/metrics/histogram_tester.h"
@@ -2323,6 +2325,76 @@ TEST_P(ArcAppModelBuilderTest, ArcPacakgesIsUpToDate) {
       arc::prefs::kArcPackagesIsUpToDate));
 }
 
+// Validate that package lookups stay in sync with the apps and packages prefs.
+// Records what the package lookups return while app removal is observed.
+class PackageLookupsOnAppRemovedObserver : public ArcAppListPrefs::Observer {
+ public:
+  PackageLookupsOnAppRemovedObserver(ArcAppListPrefs* prefs,
+                                     const std::string& package_name)
+      : prefs_(prefs), package_name_(package_name) {
+    observation_.Observe(prefs);
+  }
+
+  // ArcAppListPrefs::Observer:
+  void OnAppRemoved(const std::string& app_id) override {
+    ++removed_count_;
+    app_id_for_package_ = prefs_->GetAppIdByPackageName(package_name_);
+    apps_for_package_ = prefs_->GetAppsForPackage(package_name_);
+  }
+
+  int removed_count() const { return removed_count_; }
+  const std::string& app_id_for_package() const { return app_id_for_package_; }
+  const std::unordered_set<std::string>& apps_for_package() const {
+    return apps_for_package_;
+  }
+
+ private:
+  const raw_ptr<ArcAppListPrefs> prefs_;
+  const std::string package_name_;
+  int removed_count_ = 0;
+  std::string app_id_for_package_;
+  std::unordered_set<std::string> apps_for_package_;
+  base::ScopedObservation<ArcAppListPrefs, ArcAppListPrefs::Observer>
+      observation_{this};
+};
+
+TEST_P(ArcAppModelBuilderTest, PackageLookupsTrackPrefs) {
+  ArcAppListPrefs* prefs = ArcAppListPrefs::Get(profile_.get());
+  ASSERT_NE(nullptr, prefs);
+
+  const arc::mojom::AppInfoPtr& app = fake_apps()[0];
+  const std::string app_id = ArcAppTest::GetAppId(*app);
+  EXPECT_EQ(std::string(), prefs->GetAppIdByPackageName(app->package_name));
+  EXPECT_TRUE(prefs->GetAppsForPackage(app->package_name).empty());
+
+  AddPackage(CreatePackage(app->package_name));
+  std::vector<arc::mojom::AppInfoPtr> apps;
+  apps.push_back(app->Clone());
+  SendRefreshAppList(apps);
+  EXPECT_EQ(app_id, prefs->GetAppIdByPackageName(app->package_name));
+  EXPECT_THAT(prefs->GetAppsForPackage(app->package_name),
+              testing::UnorderedElementsAre(app_id));
+  EXPECT_TRUE(
+      base::Contains(prefs->GetPackagesFromPrefs(), app->package_name));
+
+  // Writes to other fields of the app entry leave the lookups intact.
+  prefs->SetLastLaunchTime(app_id);
+  EXPECT_EQ(app_id, prefs->GetAppIdByPackageName(app->package_name));
+  EXPECT_THAT(prefs->GetAppsForPackage(app->package_name),
+              testing::UnorderedElementsAre(app_id));
+
+  // Observers of the removal already see the app gone.
+  PackageLookupsOnAppRemovedObserver observer(prefs, app->package_name);
+  SendPackageUninstalled(app->package_name);
+  EXPECT_EQ(1, observer.removed_count());
+  EXPECT_EQ(std::string(), observer.app_id_for_package());
+  EXPECT_TRUE(observer.apps_for_package().empty());
+  EXPECT_EQ(std::string(), prefs->GetAppIdByPackageName(app->package_name));
+  EXPECT_TRUE(prefs->GetAppsForPackage(app->package_name).empty());
+  EXPECT_FALSE(
+      base::Contains(prefs->GetPackagesFromPrefs(), app->package_name));
+}
+
 // Validate that arc model contains expected elements on restart.
 // Flaky. https://crbug.com/1013813
 TEST_P(ArcAppModelBuilderRecreate, DISABLED_AppModelRestart) {
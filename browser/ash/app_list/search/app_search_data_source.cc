@@ -5,10 +5,13 @@
 #include "chrome/browser/ash/app_list/search/app_search_data_source.h"
 
 #include <algorithm>
+#include <map>
+#include <numeric>
 #include <set>
 #include <utility>
 
 #include "ash/public/cpp/app_list/internal_app_id_constants.h"
+#include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/time/clock.h"
@@ -221,6 +224,18 @@ class AppSearchDataSource::AppInfo {
     searchable_text_.push_back(searchable_text);
   }
 
+  // Takes over the tokenized name and searchable text of `previous`, an
+  // earlier snapshot of the same app, where they are still up to date.
+  void TakeTokenizedStringsFrom(AppInfo& previous) {
+    if (previous.name_ == name_) {
+      tokenized_indexed_name_ = std::move(previous.tokenized_indexed_name_);
+    }
+    if (previous.searchable_text_ == searchable_text_) {
+      tokenized_indexed_searchable_text_ =
+          std::move(previous.tokenized_indexed_searchable_text_);
+    }
+  }
+
  private:
   void EnsureTokenizedIndexedSearchableText() {
     if (!tokenized_indexed_searchable_text_.empty()) {
@@ -331,7 +346,20 @@ SearchProvider::Results AppSearchDataSource::GetExactMatches(
 
   const TokenizedString query_terms(query);
 
-  for (auto& app : apps_) {
+  // Exact matching is prefix based, so extending a query can only drop apps
+  // from its matches.
+  std::vector<size_t> candidates;
+  if (last_exact_matches_ && !last_exact_query_.empty() &&
+      base::StartsWith(query, last_exact_query_)) {
+    candidates = std::move(*last_exact_matches_);
+  } else {
+    candidates.resize(apps_size);
+    std::iota(candidates.begin(), candidates.end(), 0u);
+  }
+
+  std::vector<size_t> matched_apps;
+  for (size_t index : candidates) {
+    AppInfo* const app = apps_[index].get();
     if (!app->searchable()) {
       continue;
     }
@@ -345,6 +373,7 @@ SearchProvider::Results AppSearchDataSource::GetExactMatches(
     if (relevance <= 0 && !app->MatchSearchableTextExactly(query_terms)) {
       continue;
     }
+    matched_apps.push_back(index);
 
     std::unique_ptr<AppResult> result = CreateResult(app->id(), false);
 
@@ -355,6 +384,8 @@ SearchProvider::Results AppSearchDataSource::GetExactMatches(
     MaybeAddResult(&matches, std::move(result), &handled_results);
   }
 
+  last_exact_query_ = query;
+  last_exact_matches_ = std::move(matched_apps);
   return matches;
 }
 
@@ -402,12 +433,21 @@ std::unique_ptr<AppResult> AppSearchDataSource::CreateResult(
 void AppSearchDataSource::Refresh() {
   refresh_apps_factory_.InvalidateWeakPtrs();
 
+  // Keep the previous snapshots around, so that apps whose names did not
+  // change need not be tokenized again.
+  std::map<std::string, std::unique_ptr<AppInfo>> previous_apps;
+  for (auto& app : apps_) {
+    const std::string app_id = app->id();
+    previous_apps.emplace(app_id, std::move(app));
+  }
+
   apps_.clear();
   apps_.reserve(kMinimumReservedAppsContainerCapacity);
+  last_exact_matches_.reset();
 
   apps::AppServiceProxyFactory::GetForProfile(profile_)
       ->AppRegistryCache()
-      .ForEachApp([this](const apps::AppUpdate& update) {
+      .ForEachApp([this, &previous_apps](const apps::AppUpdate& update) {
         if (!apps_util::IsInstalled(update.Readiness()) ||
             (!update.ShowInSearch().value_or(false) &&
              !(update.Recommendable().value_or(false) &&
@@ -433,6 +473,11 @@ void AppSearchDataSource::Refresh() {
         for (const std::string& term : update.AdditionalSearchTerms()) {
           apps_.back()->AddSearchableText(base::UTF8ToUTF16(term));
         }
+
+        auto previous_it = previous_apps.find(update.AppId());
+        if (previous_it != previous_apps.end()) {
+          apps_.back()->TakeTokenizedStringsFrom(*previous_it->second);
+        }
       });
 
   // Presort app based on last activity time in order to be able to remove
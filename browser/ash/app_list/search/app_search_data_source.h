@@ -6,6 +6,7 @@
 #define CHROME_BROWSER_ASH_APP_LIST_SEARCH_APP_SEARCH_DATA_SOURCE_H_
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -62,6 +63,8 @@ class AppSearchDataSource : public apps::AppRegistryCache::Observer {
   SearchProvider::Results GetRecommendations();
 
   // Returns app results that match `query`. It uses exact matching algorithm.
+  // If `query` extends the previous query, only the apps which matched that
+  // query are considered.
   SearchProvider::Results GetExactMatches(const std::u16string& query);
 
   // Returns app results that match `query`. It uses fuzzy matching algorithm.
@@ -106,6 +109,11 @@ class AppSearchDataSource : public apps::AppRegistryCache::Observer {
 
   std::vector<std::unique_ptr<AppInfo>> apps_;
 
+  // The last query passed to `GetExactMatches()`, and the indices in `apps_`
+  // of the apps it matched. Reset whenever `apps_` is rebuilt.
+  std::u16string last_exact_query_;
+  std::optional<std::vector<size_t>> last_exact_matches_;
+
   base::RepeatingClosureList app_updates_callback_list_;
 
   base::ScopedObservation<apps::AppRegistryCache,
@@ -191,6 +191,51 @@ TEST_F(AppSearchProviderTest, NonLatinLocale) {
   base::i18n::SetICUDefaultLocale("en");
 }
 
+TEST_F(AppSearchProviderTest, NonLatinLocaleRefinedQuery) {
+  // Serbian, as non-latin locale, uses exact matching.
+  base::i18n::SetICUDefaultLocale("sr");
+
+  const std::string test_app_id_1 = "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa";
+  AddExtension(test_app_id_1, "Тестна апликација 1",
+               ManifestLocation::kExternalPrefDownload,
+               extensions::Extension::WAS_INSTALLED_BY_DEFAULT);
+  service_->EnableExtension(test_app_id_1);
+  const std::string test_app_id_2 = "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb";
+  AddExtension(test_app_id_2, "Тестна апликација 2",
+               ManifestLocation::kExternalPrefDownload,
+               extensions::Extension::WAS_INSTALLED_BY_DEFAULT);
+  service_->EnableExtension(test_app_id_2);
+  base::RunLoop().RunUntilIdle();
+
+  InitializeSearchProvider();
+
+  // Each query extends the previous one, so only the previous matches are
+  // searched.
+  std::string result = RunQuery("Т");
+  EXPECT_TRUE(result == "Тестна апликација 1,Тестна апликација 2" ||
+              result == "Тестна апликација 2,Тестна апликација 1");
+  result = RunQuery("Тестна");
+  EXPECT_TRUE(result == "Тестна апликација 1,Тестна апликација 2" ||
+              result == "Тестна апликација 2,Тестна апликација 1");
+  EXPECT_EQ("Тестна апликација 1", RunQuery("Тестна 1"));
+  EXPECT_EQ("", RunQuery("Тестна 12"));
+
+  // A query which does not extend the previous one searches all apps again.
+  EXPECT_EQ("Тестна апликација 2", RunQuery("Тестна 2"));
+
+  // Apps installed between queries are found, even if the query extends the
+  // previous one.
+  const std::string test_app_id_3 = "cccccccccccccccccccccccccccccccc";
+  AddExtension(test_app_id_3, "Тестна апликација 23",
+               ManifestLocation::kExternalPrefDownload,
+               extensions::Extension::WAS_INSTALLED_BY_DEFAULT);
+  service_->EnableExtension(test_app_id_3);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ("Тестна апликација 23", RunQuery("Тестна 23"));
+
+  base::i18n::SetICUDefaultLocale("en");
+}
+
 TEST_F(AppSearchProviderTest, DisableAndEnable) {
   InitializeSearchProvider();
 
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -45,6 +46,8 @@ constexpr double kResultRelevanceThreshold = 0.79;
 // The threshold is used to filter the results from the search handler of the
 // new shortcuts app.
 constexpr double kRelevanceScoreThreshold = 0.52;
+// Comfortably more than the number of shortcuts with a description.
+constexpr size_t kMaxTokenizedDescriptions = 256u;
 
 // Remove disabled shortcuts and leave enabled ones only.
 void RemoveDisabledShortcuts(
@@ -57,7 +60,9 @@ void RemoveDisabledShortcuts(
 }  // namespace
 
 KeyboardShortcutProvider::KeyboardShortcutProvider(Profile* profile)
-    : SearchProvider(SearchCategory::kHelp), profile_(profile) {
+    : SearchProvider(SearchCategory::kHelp),
+      profile_(profile),
+      tokenized_descriptions_(kMaxTokenizedDescriptions) {
   CHECK(profile_);
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
@@ -154,9 +159,8 @@ void KeyboardShortcutProvider::OnShortcutsSearchComplete(
       break;
     }
 
-    TokenizedString tokenized_target(
-        search_result->accelerator_layout_info->description,
-        TokenizedString::Mode::kWords);
+    const TokenizedString& tokenized_target = GetTokenizedDescription(
+        search_result->accelerator_layout_info->description);
 
     // Excludes the result if either the query or the description is empty.
     if (tokenized_query.text().empty() || tokenized_target.text().empty()) {
@@ -187,4 +191,15 @@ void KeyboardShortcutProvider::OnShortcutsSearchComplete(
   SwapResults(&results);
 }
 
+const TokenizedString& KeyboardShortcutProvider::GetTokenizedDescription(
+    const std::u16string& description) {
+  auto it = tokenized_descriptions_.Get(description);
+  if (it == tokenized_descriptions_.end()) {
+    it = tokenized_descriptions_.Put(
+        description, std::make_unique<TokenizedString>(
+                         description, TokenizedString::Mode::kWords));
+  }
+  return *it->second;
+}
+
 }  // namespace app_list
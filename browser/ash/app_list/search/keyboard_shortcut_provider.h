@@ -5,12 +5,17 @@
 #ifndef CHROME_BROWSER_ASH_APP_LIST_SEARCH_KEYBOARD_SHORTCUT_PROVIDER_H_
 #define CHROME_BROWSER_ASH_APP_LIST_SEARCH_KEYBOARD_SHORTCUT_PROVIDER_H_
 
+#include <memory>
+#include <string>
+
 #include "ash/webui/shortcut_customization_ui/backend/search/search_handler.h"
+#include "base/containers/lru_cache.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/scoped_observation.h"
 #include "base/sequence_checker.h"
 #include "chrome/browser/ash/app_list/search/search_provider.h"
+#include "chromeos/ash/components/string_matching/tokenized_string.h"
 #include "components/session_manager/core/session_manager.h"
 #include "components/session_manager/core/session_manager_observer.h"
 
@@ -50,6 +55,11 @@ class KeyboardShortcutProvider
       const std::u16string& query,
       std::vector<ash::shortcut_customization::mojom::SearchResultPtr>);
 
+  // Returns `description` tokenized in words mode. Shortcut descriptions are
+  // a small, fixed set, so they are tokenized once rather than per keystroke.
+  const ash::string_matching::TokenizedString& GetTokenizedDescription(
+      const std::u16string& description);
+
   const raw_ptr<Profile> profile_;
 
   // The |search_handler_| is managed by ShortcutsAppManager which is
@@ -60,6 +70,10 @@ class KeyboardShortcutProvider
                           session_manager::SessionManagerObserver>
       session_manager_observation_{this};
 
+  base::LRUCache<std::u16string,
+                 std::unique_ptr<ash::string_matching::TokenizedString>>
+      tokenized_descriptions_;
+
   SEQUENCE_CHECKER(sequence_checker_);
   base::WeakPtrFactory<KeyboardShortcutProvider> weak_factory_{this};
 };
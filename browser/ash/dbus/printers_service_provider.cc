@@ -27,6 +27,18 @@ void PrintersServiceProvider::Start(
 void PrintersServiceProvider::OnPrintersChanged(
     chromeos::PrinterClass printer_class,
     const std::vector<chromeos::Printer>& /*printers*/) {
+  MaybeEmitSignal(printer_class);
+}
+
+void PrintersServiceProvider::OnPrinterClassUpdated(
+    chromeos::PrinterClass printer_class,
+    const std::vector<chromeos::Printer>& /*added_or_updated*/,
+    const std::vector<std::string>& /*removed_printer_ids*/) {
+  MaybeEmitSignal(printer_class);
+}
+
+void PrintersServiceProvider::MaybeEmitSignal(
+    chromeos::PrinterClass printer_class) {
   // Signal is suppressed for discovered printers because they require setup
   // before being usable.
   if (printer_class == chromeos::PrinterClass::kDiscovered) {
@@ -5,6 +5,9 @@
 #ifndef CHROME_BROWSER_ASH_DBUS_PRINTERS_SERVICE_PROVIDER_H_
 #define CHROME_BROWSER_ASH_DBUS_PRINTERS_SERVICE_PROVIDER_H_
 
+#include <string>
+#include <vector>
+
 #include "base/memory/ref_counted.h"
 #include "base/scoped_observation.h"
 #include "chrome/browser/ash/printing/cups_printers_manager.h"
@@ -35,8 +38,15 @@ class PrintersServiceProvider
   void OnPrintersChanged(
       chromeos::PrinterClass printers_class,
       const std::vector<chromeos::Printer>& printers) override;
+  void OnPrinterClassUpdated(
+      chromeos::PrinterClass printer_class,
+      const std::vector<chromeos::Printer>& added_or_updated,
+      const std::vector<std::string>& removed_printer_ids) override;
 
  private:
+  // Emits the D-Bus signal unless only discovered printers changed.
+  void MaybeEmitSignal(chromeos::PrinterClass printer_class);
+
   // Emits the D-Bus signal for this event.
   void EmitSignal();
 
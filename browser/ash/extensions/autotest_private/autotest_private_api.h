@@ -657,6 +657,11 @@ class AutotestPrivateGetPrinterListFunction
   void RespondWithSuccess();
 
   // ash::CupsPrintersManager::Observer
+  // The printers are read once, when enterprise printers are initialized.
+  void OnPrinterClassUpdated(
+      chromeos::PrinterClass printer_class,
+      const std::vector<chromeos::Printer>& added_or_updated,
+      const std::vector<std::string>& removed_printer_ids) override {}
   void OnEnterprisePrintersInitialized() override;
 
   base::Value::List results_;
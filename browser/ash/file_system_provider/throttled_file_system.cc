@@ -12,13 +12,123 @@
 
 #include "base/files/file.h"
 #include "base/functional/bind.h"
+#include "base/task/sequenced_task_runner.h"
 #include "chrome/browser/ash/file_system_provider/queue.h"
 
 namespace ash::file_system_provider {
+namespace {
+
+// How long metadata returned by the providing extension is reused for.
+constexpr base::TimeDelta kMetadataCacheTimeToLive = base::Seconds(5);
+
+// Maximum number of entries with cached metadata.
+constexpr size_t kMetadataCacheMaxSize = 1000;
+
+// Thumbnails are too large to be worth keeping around.
+constexpr ProvidedFileSystemInterface::MetadataFieldMask kCacheableFields =
+    ~ProvidedFileSystemInterface::METADATA_FIELD_THUMBNAIL;
+
+// Returns a copy of the |fields| of |metadata| which are set.
+std::unique_ptr<EntryMetadata> CloneEntryMetadata(
+    const EntryMetadata& metadata,
+    ProvidedFileSystemInterface::MetadataFieldMask fields) {
+  auto clone = std::make_unique<EntryMetadata>();
+  if (fields & ProvidedFileSystemInterface::METADATA_FIELD_IS_DIRECTORY &&
+      metadata.is_directory) {
+    clone->is_directory = std::make_unique<bool>(*metadata.is_directory);
+  }
+  if (fields & ProvidedFileSystemInterface::METADATA_FIELD_NAME &&
+      metadata.name) {
+    clone->name = std::make_unique<std::string>(*metadata.name);
+  }
+  if (fields & ProvidedFileSystemInterface::METADATA_FIELD_SIZE &&
+      metadata.size) {
+    clone->size = std::make_unique<int64_t>(*metadata.size);
+  }
+  if (fields & ProvidedFileSystemInterface::METADATA_FIELD_MODIFICATION_TIME &&
+      metadata.modification_time) {
+    clone->modification_time =
+        std::make_unique<base::Time>(*metadata.modification_time);
+  }
+  if (fields & ProvidedFileSystemInterface::METADATA_FIELD_MIME_TYPE &&
+      metadata.mime_type) {
+    clone->mime_type = std::make_unique<std::string>(*metadata.mime_type);
+  }
+  if (fields & ProvidedFileSystemInterface::METADATA_FIELD_THUMBNAIL &&
+      metadata.thumbnail) {
+    clone->thumbnail = std::make_unique<std::string>(*metadata.thumbnail);
+  }
+  if (fields & ProvidedFileSystemInterface::METADATA_FIELD_CLOUD_IDENTIFIER &&
+      metadata.cloud_identifier) {
+    clone->cloud_identifier =
+        std::make_unique<CloudIdentifier>(*metadata.cloud_identifier);
+  }
+  if (fields & ProvidedFileSystemInterface::METADATA_FIELD_CLOUD_FILE_INFO &&
+      metadata.cloud_file_info) {
+    clone->cloud_file_info =
+        std::make_unique<CloudFileInfo>(metadata.cloud_file_info->version_tag);
+  }
+  return clone;
+}
+
+// Returns true if metadata or a listing of |path| may be stale after
+// |changed_path| changed, i.e. if it is the changed entry itself, its parent
+// or one of its descendants.
+bool IsAffectedByChange(const base::FilePath& path,
+                        const base::FilePath& changed_path) {
+  return path == changed_path || path == changed_path.DirName() ||
+         changed_path.IsParent(path);
+}
+
+}  // namespace
+
+ThrottledFileSystem::CachedMetadata::CachedMetadata(
+    MetadataFieldMask fields,
+    std::unique_ptr<EntryMetadata> metadata,
+    base::TimeTicks expiration_time)
+    : fields(fields),
+      metadata(std::move(metadata)),
+      expiration_time(expiration_time) {}
+
+ThrottledFileSystem::CachedMetadata::CachedMetadata(CachedMetadata&&) =
+    default;
+
+ThrottledFileSystem::CachedMetadata&
+ThrottledFileSystem::CachedMetadata::operator=(CachedMetadata&&) = default;
+
+ThrottledFileSystem::CachedMetadata::~CachedMetadata() = default;
+
+ThrottledFileSystem::PendingGetMetadata::PendingGetMetadata(
+    const base::FilePath& entry_path,
+    MetadataFieldMask fields)
+    : entry_path(entry_path), fields(fields) {}
+
+ThrottledFileSystem::PendingGetMetadata::PendingGetMetadata(
+    PendingGetMetadata&&) = default;
+
+ThrottledFileSystem::PendingGetMetadata&
+ThrottledFileSystem::PendingGetMetadata::operator=(PendingGetMetadata&&) =
+    default;
+
+ThrottledFileSystem::PendingGetMetadata::~PendingGetMetadata() = default;
+
+ThrottledFileSystem::PendingReadDirectory::PendingReadDirectory(
+    const base::FilePath& directory_path)
+    : directory_path(directory_path) {}
+
+ThrottledFileSystem::PendingReadDirectory::PendingReadDirectory(
+    PendingReadDirectory&&) = default;
+
+ThrottledFileSystem::PendingReadDirectory&
+ThrottledFileSystem::PendingReadDirectory::operator=(PendingReadDirectory&&) =
+    default;
+
+ThrottledFileSystem::PendingReadDirectory::~PendingReadDirectory() = default;
 
 ThrottledFileSystem::ThrottledFileSystem(
     std::unique_ptr<ProvidedFileSystemInterface> file_system)
-    : file_system_(std::move(file_system)) {
+    : file_system_(std::move(file_system)),
+      metadata_cache_(kMetadataCacheMaxSize) {
   const int opened_files_limit =
       file_system_->GetFileSystemInfo().opened_files_limit();
   open_queue_.reset(opened_files_limit
@@ -36,7 +146,42 @@ AbortCallback ThrottledFileSystem::RequestUnmount(
 AbortCallback ThrottledFileSystem::GetMetadata(const base::FilePath& entry_path,
                                                MetadataFieldMask fields,
                                                GetMetadataCallback callback) {
-  return file_system_->GetMetadata(entry_path, fields, std::move(callback));
+  const auto joinable_it = joinable_get_metadata_.find({entry_path, fields});
+  if (joinable_it != joinable_get_metadata_.end()) {
+    return AddGetMetadataCallback(joinable_it->second, std::move(callback));
+  }
+
+  const int operation_id = next_request_id_++;
+  pending_get_metadata_.try_emplace(operation_id, entry_path, fields);
+  AbortCallback abort_callback =
+      AddGetMetadataCallback(operation_id, std::move(callback));
+
+  // Answer asynchronously from the cache, as the extension would.
+  const EntryMetadata* const cached_metadata =
+      GetCachedMetadata(entry_path, fields);
+  if (cached_metadata) {
+    pending_get_metadata_.at(operation_id).cache_result = false;
+    base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+        FROM_HERE,
+        base::BindOnce(&ThrottledFileSystem::OnGetMetadataCompleted,
+                       weak_ptr_factory_.GetWeakPtr(), operation_id,
+                       CloneEntryMetadata(*cached_metadata, fields),
+                       base::File::FILE_OK));
+    return abort_callback;
+  }
+
+  joinable_get_metadata_[{entry_path, fields}] = operation_id;
+  AbortCallback operation_abort_callback = file_system_->GetMetadata(
+      entry_path, fields,
+      base::BindOnce(&ThrottledFileSystem::OnGetMetadataCompleted,
+                     weak_ptr_factory_.GetWeakPtr(), operation_id));
+
+  // The operation may have already failed synchronously.
+  const auto it = pending_get_metadata_.find(operation_id);
+  if (it != pending_get_metadata_.end()) {
+    it->second.abort_callback = std::move(operation_abort_callback);
+  }
+  return abort_callback;
 }
 
 AbortCallback ThrottledFileSystem::GetActions(
@@ -49,14 +194,36 @@ AbortCallback ThrottledFileSystem::ExecuteAction(
     const std::vector<base::FilePath>& entry_paths,
     const std::string& action_id,
     storage::AsyncFileUtil::StatusCallback callback) {
-  return file_system_->ExecuteAction(entry_paths, action_id,
-                                     std::move(callback));
+  return file_system_->ExecuteAction(
+      entry_paths, action_id,
+      InvalidateOnMutation(entry_paths, std::move(callback)));
 }
 
 AbortCallback ThrottledFileSystem::ReadDirectory(
     const base::FilePath& directory_path,
     storage::AsyncFileUtil::ReadDirectoryCallback callback) {
-  return file_system_->ReadDirectory(directory_path, callback);
+  const auto joinable_it = joinable_read_directory_.find(directory_path);
+  if (joinable_it != joinable_read_directory_.end()) {
+    return AddReadDirectoryCallback(joinable_it->second, std::move(callback));
+  }
+
+  const int operation_id = next_request_id_++;
+  pending_read_directory_.try_emplace(operation_id, directory_path);
+  joinable_read_directory_[directory_path] = operation_id;
+  AbortCallback abort_callback =
+      AddReadDirectoryCallback(operation_id, std::move(callback));
+
+  AbortCallback operation_abort_callback = file_system_->ReadDirectory(
+      directory_path,
+      base::BindRepeating(&ThrottledFileSystem::OnReadDirectoryChunkReceived,
+                          weak_ptr_factory_.GetWeakPtr(), operation_id));
+
+  // The operation may have already failed synchronously.
+  const auto it = pending_read_directory_.find(operation_id);
+  if (it != pending_read_directory_.end()) {
+    it->second.abort_callback = std::move(operation_abort_callback);
+  }
+  return abort_callback;
 }
 
 AbortCallback ThrottledFileSystem::ReadFile(
@@ -98,28 +265,34 @@ AbortCallback ThrottledFileSystem::CreateDirectory(
     const base::FilePath& directory_path,
     bool recursive,
     storage::AsyncFileUtil::StatusCallback callback) {
-  return file_system_->CreateDirectory(directory_path, recursive,
-                                       std::move(callback));
+  return file_system_->CreateDirectory(
+      directory_path, recursive,
+      InvalidateOnMutation({directory_path}, std::move(callback)));
 }
 
 AbortCallback ThrottledFileSystem::DeleteEntry(
     const base::FilePath& entry_path,
     bool recursive,
     storage::AsyncFileUtil::StatusCallback callback) {
-  return file_system_->DeleteEntry(entry_path, recursive, std::move(callback));
+  return file_system_->DeleteEntry(
+      entry_path, recursive,
+      InvalidateOnMutation({entry_path}, std::move(callback)));
 }
 
 AbortCallback ThrottledFileSystem::CreateFile(
     const base::FilePath& file_path,
     storage::AsyncFileUtil::StatusCallback callback) {
-  return file_system_->CreateFile(file_path, std::move(callback));
+  return file_system_->CreateFile(
+      file_path, InvalidateOnMutation({file_path}, std::move(callback)));
 }
 
 AbortCallback ThrottledFileSystem::CopyEntry(
     const base::FilePath& source_path,
     const base::FilePath& target_path,
     storage::AsyncFileUtil::StatusCallback callback) {
-  return file_system_->CopyEntry(source_path, target_path, std::move(callback));
+  return file_system_->CopyEntry(
+      source_path, target_path,
+      InvalidateOnMutation({target_path}, std::move(callback)));
 }
 
 AbortCallback ThrottledFileSystem::WriteFile(
@@ -128,28 +301,36 @@ AbortCallback ThrottledFileSystem::WriteFile(
     int64_t offset,
     int length,
     storage::AsyncFileUtil::StatusCallback callback) {
-  return file_system_->WriteFile(file_handle, buffer, offset, length,
-                                 std::move(callback));
+  return file_system_->WriteFile(
+      file_handle, buffer, offset, length,
+      InvalidateOnMutation(GetOpenedFilePaths(file_handle),
+                           std::move(callback)));
 }
 
 AbortCallback ThrottledFileSystem::FlushFile(
     int file_handle,
     storage::AsyncFileUtil::StatusCallback callback) {
-  return file_system_->FlushFile(file_handle, std::move(callback));
+  return file_system_->FlushFile(
+      file_handle, InvalidateOnMutation(GetOpenedFilePaths(file_handle),
+                                        std::move(callback)));
 }
 
 AbortCallback ThrottledFileSystem::MoveEntry(
     const base::FilePath& source_path,
     const base::FilePath& target_path,
     storage::AsyncFileUtil::StatusCallback callback) {
-  return file_system_->MoveEntry(source_path, target_path, std::move(callback));
+  return file_system_->MoveEntry(
+      source_path, target_path,
+      InvalidateOnMutation({source_path, target_path}, std::move(callback)));
 }
 
 AbortCallback ThrottledFileSystem::Truncate(
     const base::FilePath& file_path,
     int64_t length,
     storage::AsyncFileUtil::StatusCallback callback) {
-  return file_system_->Truncate(file_path, length, std::move(callback));
+  return file_system_->Truncate(
+      file_path, length,
+      InvalidateOnMutation({file_path}, std::move(callback)));
 }
 
 AbortCallback ThrottledFileSystem::AddWatcher(
@@ -204,6 +385,12 @@ void ThrottledFileSystem::Notify(
     std::unique_ptr<ProvidedFileSystemObserver::Changes> changes,
     const std::string& tag,
     storage::AsyncFileUtil::StatusCallback callback) {
+  InvalidateEntry(entry_path);
+  if (changes) {
+    for (const auto& change : *changes) {
+      InvalidateEntry(change.entry_path);
+    }
+  }
   return file_system_->Notify(entry_path, recursive, change_type,
                               std::move(changes), tag, std::move(callback));
 }
@@ -259,4 +446,285 @@ void ThrottledFileSystem::OnCloseFileCompleted(
   std::move(callback).Run(result);
 }
 
+AbortCallback ThrottledFileSystem::AddGetMetadataCallback(
+    int operation_id,
+    GetMetadataCallback callback) {
+  const int callback_id = next_request_id_++;
+  pending_get_metadata_.at(operation_id)
+      .callbacks.emplace(callback_id, std::move(callback));
+  return base::BindOnce(&ThrottledFileSystem::AbortGetMetadata,
+                        weak_ptr_factory_.GetWeakPtr(), operation_id,
+                        callback_id);
+}
+
+void ThrottledFileSystem::AbortGetMetadata(int operation_id, int callback_id) {
+  const auto it = pending_get_metadata_.find(operation_id);
+  if (it == pending_get_metadata_.end()) {
+    return;
+  }
+
+  const auto callback_it = it->second.callbacks.find(callback_id);
+  if (callback_it == it->second.callbacks.end()) {
+    return;
+  }
+
+  // Answer the aborted caller as the extension would, while the others keep
+  // waiting for the result.
+  base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+      FROM_HERE, base::BindOnce(std::move(callback_it->second), nullptr,
+                                base::File::FILE_ERROR_ABORT));
+  it->second.callbacks.erase(callback_it);
+  if (!it->second.callbacks.empty()) {
+    return;
+  }
+
+  // Nobody is waiting for the result anymore.
+  AbortCallback abort_callback = std::move(it->second.abort_callback);
+  const auto joinable_it =
+      joinable_get_metadata_.find({it->second.entry_path, it->second.fields});
+  if (joinable_it != joinable_get_metadata_.end() &&
+      joinable_it->second == operation_id) {
+    joinable_get_metadata_.erase(joinable_it);
+  }
+  pending_get_metadata_.erase(it);
+
+  if (abort_callback) {
+    std::move(abort_callback).Run();
+  }
+}
+
+void ThrottledFileSystem::OnGetMetadataCompleted(
+    int operation_id,
+    std::unique_ptr<EntryMetadata> metadata,
+    base::File::Error result) {
+  const auto it = pending_get_metadata_.find(operation_id);
+  if (it == pending_get_metadata_.end()) {
+    return;
+  }
+
+  PendingGetMetadata operation = std::move(it->second);
+  pending_get_metadata_.erase(it);
+  const auto joinable_it =
+      joinable_get_metadata_.find({operation.entry_path, operation.fields});
+  if (joinable_it != joinable_get_metadata_.end() &&
+      joinable_it->second == operation_id) {
+    joinable_get_metadata_.erase(joinable_it);
+  }
+
+  if (result == base::File::FILE_OK && metadata && operation.cache_result) {
+    const MetadataFieldMask fields = operation.fields & kCacheableFields;
+    metadata_cache_.Put(
+        operation.entry_path,
+        CachedMetadata(fields, CloneEntryMetadata(*metadata, fields),
+                       base::TimeTicks::Now() + kMetadataCacheTimeToLive));
+  }
+
+  for (auto& [callback_id, callback] : operation.callbacks) {
+    std::move(callback).Run(
+        metadata ? CloneEntryMetadata(*metadata, operation.fields) : nullptr,
+        result);
+  }
+}
+
+AbortCallback ThrottledFileSystem::AddReadDirectoryCallback(
+    int operation_id,
+    storage::AsyncFileUtil::ReadDirectoryCallback callback) {
+  const int callback_id = next_request_id_++;
+  pending_read_directory_.at(operation_id)
+      .callbacks.emplace(callback_id, std::move(callback));
+  return base::BindOnce(&ThrottledFileSystem::AbortReadDirectory,
+                        weak_ptr_factory_.GetWeakPtr(), operation_id,
+                        callback_id);
+}
+
+void ThrottledFileSystem::AbortReadDirectory(int operation_id,
+                                             int callback_id) {
+  const auto it = pending_read_directory_.find(operation_id);
+  if (it == pending_read_directory_.end()) {
+    return;
+  }
+
+  const auto callback_it = it->second.callbacks.find(callback_id);
+  if (callback_it == it->second.callbacks.end()) {
+    return;
+  }
+
+  // Answer the aborted caller as the extension would, while the others keep
+  // receiving entries.
+  base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+      FROM_HERE,
+      base::BindOnce(callback_it->second, base::File::FILE_ERROR_ABORT,
+                     storage::AsyncFileUtil::EntryList(), /*has_more=*/false));
+  it->second.callbacks.erase(callback_it);
+  if (!it->second.callbacks.empty()) {
+    return;
+  }
+
+  // Nobody is waiting for more entries anymore.
+  AbortCallback abort_callback = std::move(it->second.abort_callback);
+  const auto joinable_it =
+      joinable_read_directory_.find(it->second.directory_path);
+  if (joinable_it != joinable_read_directory_.end() &&
+      joinable_it->second == operation_id) {
+    joinable_read_directory_.erase(joinable_it);
+  }
+  pending_read_directory_.erase(it);
+
+  if (abort_callback) {
+    std::move(abort_callback).Run();
+  }
+}
+
+void ThrottledFileSystem::OnReadDirectoryChunkReceived(
+    int operation_id,
+    base::File::Error result,
+    storage::AsyncFileUtil::EntryList entries,
+    bool has_more) {
+  const auto it = pending_read_directory_.find(operation_id);
+  if (it == pending_read_directory_.end()) {
+    return;
+  }
+
+  // Callers joining from now on would miss the entries received so far.
+  const base::FilePath directory_path = it->second.directory_path;
+  const auto joinable_it = joinable_read_directory_.find(directory_path);
+  if (joinable_it != joinable_read_directory_.end() &&
+      joinable_it->second == operation_id) {
+    joinable_read_directory_.erase(joinable_it);
+  }
+
+  if (result == base::File::FILE_OK && it->second.cache_result) {
+    CacheDirectoryEntries(directory_path, entries);
+  }
+
+  std::vector<storage::AsyncFileUtil::ReadDirectoryCallback> callbacks;
+  for (const auto& [callback_id, callback] : it->second.callbacks) {
+    callbacks.push_back(callback);
+  }
+  if (result != base::File::FILE_OK || !has_more) {
+    pending_read_directory_.erase(it);
+  }
+
+  for (const auto& callback : callbacks) {
+    callback.Run(result, entries, has_more);
+  }
+}
+
+const EntryMetadata* ThrottledFileSystem::GetCachedMetadata(
+    const base::FilePath& entry_path,
+    MetadataFieldMask fields) {
+  const auto it = metadata_cache_.Get(entry_path);
+  if (it == metadata_cache_.end()) {
+    return nullptr;
+  }
+
+  if (it->second.expiration_time <= base::TimeTicks::Now()) {
+    metadata_cache_.Erase(it);
+    return nullptr;
+  }
+
+  if (fields & ~it->second.fields) {
+    return nullptr;
+  }
+
+  return it->second.metadata.get();
+}
+
+void ThrottledFileSystem::CacheDirectoryEntries(
+    const base::FilePath& directory_path,
+    const storage::AsyncFileUtil::EntryList& entries) {
+  const base::TimeTicks now = base::TimeTicks::Now();
+  for (const auto& entry : entries) {
+    // Skip malformed entries, which are left for the callers to reject.
+    if (entry.name.empty() || entry.name != entry.name.BaseName() ||
+        entry.name.ReferencesParent() ||
+        (entry.type != filesystem::mojom::FsFileType::DIRECTORY &&
+         entry.type != filesystem::mojom::FsFileType::REGULAR_FILE)) {
+      continue;
+    }
+
+    const base::FilePath entry_path = directory_path.Append(entry.name);
+
+    // Do not replace metadata fetched with GetMetadata(), which may hold more
+    // fields.
+    const auto it = metadata_cache_.Peek(entry_path);
+    if (it != metadata_cache_.end() && it->second.expiration_time > now) {
+      continue;
+    }
+
+    auto metadata = std::make_unique<EntryMetadata>();
+    metadata->is_directory = std::make_unique<bool>(
+        entry.type == filesystem::mojom::FsFileType::DIRECTORY);
+    metadata->name = std::make_unique<std::string>(entry.name.value());
+    metadata_cache_.Put(
+        entry_path,
+        CachedMetadata(METADATA_FIELD_IS_DIRECTORY | METADATA_FIELD_NAME,
+                       std::move(metadata), now + kMetadataCacheTimeToLive));
+  }
+}
+
+void ThrottledFileSystem::InvalidateEntry(const base::FilePath& entry_path) {
+  for (auto it = metadata_cache_.begin(); it != metadata_cache_.end();) {
+    if (IsAffectedByChange(it->first, entry_path)) {
+      it = metadata_cache_.Erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // Running operations may return data from before the change. Let them
+  // complete for their current callers, but neither cache their results nor
+  // let further calls join them.
+  for (auto& [operation_id, operation] : pending_get_metadata_) {
+    if (IsAffectedByChange(operation.entry_path, entry_path)) {
+      operation.cache_result = false;
+    }
+  }
+  std::erase_if(joinable_get_metadata_, [&entry_path](const auto& joinable) {
+    return IsAffectedByChange(joinable.first.first, entry_path);
+  });
+
+  for (auto& [operation_id, operation] : pending_read_directory_) {
+    if (IsAffectedByChange(operation.directory_path, entry_path)) {
+      operation.cache_result = false;
+    }
+  }
+  std::erase_if(joinable_read_directory_, [&entry_path](const auto& joinable) {
+    return IsAffectedByChange(joinable.first, entry_path);
+  });
+}
+
+storage::AsyncFileUtil::StatusCallback
+ThrottledFileSystem::InvalidateOnMutation(
+    std::vector<base::FilePath> entry_paths,
+    storage::AsyncFileUtil::StatusCallback callback) {
+  for (const auto& entry_path : entry_paths) {
+    InvalidateEntry(entry_path);
+  }
+  return base::BindOnce(&ThrottledFileSystem::OnMutationCompleted,
+                        weak_ptr_factory_.GetWeakPtr(), std::move(entry_paths),
+                        std::move(callback));
+}
+
+void ThrottledFileSystem::OnMutationCompleted(
+    std::vector<base::FilePath> entry_paths,
+    storage::AsyncFileUtil::StatusCallback callback,
+    base::File::Error result) {
+  // Metadata may have been fetched again while the mutation was running.
+  for (const auto& entry_path : entry_paths) {
+    InvalidateEntry(entry_path);
+  }
+  std::move(callback).Run(result);
+}
+
+std::vector<base::FilePath> ThrottledFileSystem::GetOpenedFilePaths(
+    int file_handle) const {
+  const OpenedFiles& opened_files = file_system_->GetOpenedFiles();
+  const auto it = opened_files.find(file_handle);
+  if (it == opened_files.end()) {
+    return {};
+  }
+  return {it->second.file_path};
+}
+
 }  // namespace ash::file_system_provider
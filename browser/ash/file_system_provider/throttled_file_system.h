@@ -7,11 +7,16 @@
 
 #include <stdint.h>
 
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "base/containers/lru_cache.h"
+#include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "chrome/browser/ash/file_system_provider/abort_callback.h"
 #include "chrome/browser/ash/file_system_provider/provided_file_system.h"
 #include "chrome/browser/ash/file_system_provider/provided_file_system_info.h"
@@ -25,16 +30,16 @@ namespace net {
 class IOBuffer;
 }  // namespace net
 
-namespace base {
-class FilePath;
-}  // namespace base
-
 namespace ash::file_system_provider {
 
 class Queue;
 class OperationRequestManager;
 
-// Decorates ProvidedFileSystemInterface with throttling capabilities.
+// Decorates ProvidedFileSystemInterface with throttling capabilities. Identical
+// concurrent GetMetadata() and ReadDirectory() calls share one request to the
+// providing extension, and metadata is cached for a short time. The cache is
+// primed by directory listings, and invalidated by change notifications and
+// by mutations issued through this file system.
 class ThrottledFileSystem : public ProvidedFileSystemInterface {
  public:
   explicit ThrottledFileSystem(
@@ -131,9 +136,102 @@ class ThrottledFileSystem : public ProvidedFileSystemInterface {
   std::unique_ptr<ScopedUserInteraction> StartUserInteraction() override;
 
  private:
+  // Metadata of an entry fetched recently, valid until |expiration_time|.
+  struct CachedMetadata {
+    CachedMetadata(MetadataFieldMask fields,
+                   std::unique_ptr<EntryMetadata> metadata,
+                   base::TimeTicks expiration_time);
+    CachedMetadata(CachedMetadata&&);
+    CachedMetadata& operator=(CachedMetadata&&);
+    ~CachedMetadata();
+
+    MetadataFieldMask fields;
+    std::unique_ptr<EntryMetadata> metadata;
+    base::TimeTicks expiration_time;
+  };
+
+  // A GetMetadata() call shared by all callers asking for the same fields of
+  // the same entry while it is running.
+  struct PendingGetMetadata {
+    PendingGetMetadata(const base::FilePath& entry_path,
+                       MetadataFieldMask fields);
+    PendingGetMetadata(PendingGetMetadata&&);
+    PendingGetMetadata& operator=(PendingGetMetadata&&);
+    ~PendingGetMetadata();
+
+    base::FilePath entry_path;
+    MetadataFieldMask fields;
+    // Whether the result may be cached. Cleared if the entry is invalidated
+    // while the call is running.
+    bool cache_result = true;
+    AbortCallback abort_callback;
+    std::map<int, GetMetadataCallback> callbacks;
+  };
+
+  // A ReadDirectory() call shared by all callers listing the same directory
+  // before its first chunk of entries is received.
+  struct PendingReadDirectory {
+    explicit PendingReadDirectory(const base::FilePath& directory_path);
+    PendingReadDirectory(PendingReadDirectory&&);
+    PendingReadDirectory& operator=(PendingReadDirectory&&);
+    ~PendingReadDirectory();
+
+    base::FilePath directory_path;
+    // Whether the entries may be cached. Cleared if the directory is
+    // invalidated while the call is running.
+    bool cache_result = true;
+    AbortCallback abort_callback;
+    std::map<int, storage::AsyncFileUtil::ReadDirectoryCallback> callbacks;
+  };
+
   // Called when an operation enqueued with |queue_token| is aborted.
   void Abort(int queue_token);
 
+  // Adds |callback| to the GetMetadata() operation with |operation_id|. The
+  // returned callback detaches it, runs it with FILE_ERROR_ABORT, and aborts
+  // the operation if it was the last one waiting.
+  AbortCallback AddGetMetadataCallback(int operation_id,
+                                       GetMetadataCallback callback);
+  void AbortGetMetadata(int operation_id, int callback_id);
+  void OnGetMetadataCompleted(int operation_id,
+                              std::unique_ptr<EntryMetadata> metadata,
+                              base::File::Error result);
+
+  // Same as above, but for ReadDirectory() operations.
+  AbortCallback AddReadDirectoryCallback(
+      int operation_id,
+      storage::AsyncFileUtil::ReadDirectoryCallback callback);
+  void AbortReadDirectory(int operation_id, int callback_id);
+  void OnReadDirectoryChunkReceived(int operation_id,
+                                    base::File::Error result,
+                                    storage::AsyncFileUtil::EntryList entries,
+                                    bool has_more);
+
+  // Returns unexpired cached metadata of |entry_path| holding all of |fields|,
+  // or nullptr.
+  const EntryMetadata* GetCachedMetadata(const base::FilePath& entry_path,
+                                         MetadataFieldMask fields);
+
+  // Caches the types and names of |entries| listed in |directory_path|.
+  void CacheDirectoryEntries(const base::FilePath& directory_path,
+                             const storage::AsyncFileUtil::EntryList& entries);
+
+  // Drops cached metadata and listings which may be stale after |entry_path|
+  // changed, and stops later calls from joining running operations for them.
+  void InvalidateEntry(const base::FilePath& entry_path);
+
+  // Invalidates |entry_paths| now, and again once the mutation signalled with
+  // the returned callback completes.
+  storage::AsyncFileUtil::StatusCallback InvalidateOnMutation(
+      std::vector<base::FilePath> entry_paths,
+      storage::AsyncFileUtil::StatusCallback callback);
+  void OnMutationCompleted(std::vector<base::FilePath> entry_paths,
+                           storage::AsyncFileUtil::StatusCallback callback,
+                           base::File::Error result);
+
+  // Returns the path of the file opened with |file_handle|, if any.
+  std::vector<base::FilePath> GetOpenedFilePaths(int file_handle) const;
+
   // Called when opening a file is completed with either a success or an error.
   void OnOpenFileCompleted(int queue_token,
                            OpenFileCallback callback,
@@ -152,6 +250,19 @@ class ThrottledFileSystem : public ProvidedFileSystemInterface {
   // Map from file handles to open queue tokens.
   std::map<int, int> opened_files_;
 
+  // Used for both operation and callback ids below.
+  int next_request_id_ = 1;
+
+  std::map<int, PendingGetMetadata> pending_get_metadata_;
+  std::map<int, PendingReadDirectory> pending_read_directory_;
+
+  // Running operations which further identical calls may join.
+  std::map<std::pair<base::FilePath, MetadataFieldMask>, int>
+      joinable_get_metadata_;
+  std::map<base::FilePath, int> joinable_read_directory_;
+
+  base::LRUCache<base::FilePath, CachedMetadata> metadata_cache_;
+
   base::WeakPtrFactory<ThrottledFileSystem> weak_ptr_factory_{this};
 };
 
@@ -7,10 +7,14 @@
 #include <stddef.h>
 
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "base/files/file.h"
 #include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
+#include "base/memory/raw_ptr.h"
 #include "base/run_loop.h"
 #include "chrome/browser/ash/file_system_provider/abort_callback.h"
 #include "chrome/browser/ash/file_system_provider/fake_provided_file_system.h"
@@ -29,6 +33,9 @@ const char kDisplayName[] = "Camera Pictures";
 
 typedef std::vector<base::File::Error> StatusLog;
 typedef std::vector<std::pair<int, base::File::Error>> OpenLog;
+typedef std::vector<
+    std::pair<std::unique_ptr<EntryMetadata>, base::File::Error>>
+    MetadataLog;
 
 // Writes a |result| to the |log| vector for a status callback.
 void LogStatus(StatusLog* log, base::File::Error result) {
@@ -43,6 +50,21 @@ void LogOpen(OpenLog* log,
   log->emplace_back(handle, result);
 }
 
+// Writes |metadata| and |result| to the |log| vector for fetching metadata.
+void LogMetadata(MetadataLog* log,
+                 std::unique_ptr<EntryMetadata> metadata,
+                 base::File::Error result) {
+  log->emplace_back(std::move(metadata), result);
+}
+
+// Writes a |result| to the |log| vector for reading a directory.
+void LogReadDirectory(StatusLog* log,
+                      base::File::Error result,
+                      storage::AsyncFileUtil::EntryList entry_list,
+                      bool has_more) {
+  log->push_back(result);
+}
+
 }  // namespace
 
 class FileSystemProviderThrottledFileSystemTest : public testing::Test {
@@ -63,12 +85,16 @@ class FileSystemProviderThrottledFileSystemTest : public testing::Test {
         /*configurable=*/false, /*watchable=*/true, extensions::SOURCE_FILE,
         IconSet());
 
-    file_system_ = std::make_unique<ThrottledFileSystem>(
-        std::make_unique<FakeProvidedFileSystem>(file_system_info));
+    auto fake_file_system =
+        std::make_unique<FakeProvidedFileSystem>(file_system_info);
+    fake_file_system_ = fake_file_system.get();
+    file_system_ =
+        std::make_unique<ThrottledFileSystem>(std::move(fake_file_system));
   }
 
   content::BrowserTaskEnvironment task_environment_;
   std::unique_ptr<ThrottledFileSystem> file_system_;
+  raw_ptr<FakeProvidedFileSystem> fake_file_system_ = nullptr;
 };
 
 TEST_F(FileSystemProviderThrottledFileSystemTest, OpenFile_LimitedToOneAtOnce) {
@@ -161,4 +187,165 @@ TEST_F(FileSystemProviderThrottledFileSystemTest, AbortAfterRun) {
   EXPECT_EQ(0u, second_open_log.size());
 }
 
+TEST_F(FileSystemProviderThrottledFileSystemTest,
+       GetMetadata_CoalescedAndCached) {
+  SetUpFileSystem(0);
+  const base::FilePath file_path(kFakeFilePath);
+  int64_t* const size =
+      fake_file_system_->GetEntry(file_path)->metadata->size.get();
+  const int64_t original_size = *size;
+
+  MetadataLog first_log;
+  file_system_->GetMetadata(file_path,
+                            ProvidedFileSystemInterface::METADATA_FIELD_SIZE,
+                            base::BindOnce(&LogMetadata, &first_log));
+
+  // The fake file system reads the entry when called, so the new size would
+  // be returned unless the second call joins the first one.
+  *size = original_size + 1;
+  MetadataLog second_log;
+  file_system_->GetMetadata(file_path,
+                            ProvidedFileSystemInterface::METADATA_FIELD_SIZE,
+                            base::BindOnce(&LogMetadata, &second_log));
+
+  base::RunLoop().RunUntilIdle();
+
+  for (const MetadataLog* log : {&first_log, &second_log}) {
+    ASSERT_EQ(1u, log->size());
+    EXPECT_EQ(base::File::FILE_OK, (*log)[0].second);
+    ASSERT_TRUE((*log)[0].first && (*log)[0].first->size);
+    EXPECT_EQ(original_size, *(*log)[0].first->size);
+  }
+
+  // The result is cached.
+  MetadataLog cached_log;
+  file_system_->GetMetadata(file_path,
+                            ProvidedFileSystemInterface::METADATA_FIELD_SIZE,
+                            base::BindOnce(&LogMetadata, &cached_log));
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(1u, cached_log.size());
+  ASSERT_TRUE(cached_log[0].first && cached_log[0].first->size);
+  EXPECT_EQ(original_size, *cached_log[0].first->size);
+
+  // Change notifications invalidate the cache.
+  file_system_->Notify(file_path, /*recursive=*/false,
+                       storage::WatcherManager::CHANGED,
+                       /*changes=*/nullptr, /*tag=*/std::string(),
+                       base::DoNothing());
+
+  MetadataLog refreshed_log;
+  file_system_->GetMetadata(file_path,
+                            ProvidedFileSystemInterface::METADATA_FIELD_SIZE,
+                            base::BindOnce(&LogMetadata, &refreshed_log));
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(1u, refreshed_log.size());
+  ASSERT_TRUE(refreshed_log[0].first && refreshed_log[0].first->size);
+  EXPECT_EQ(original_size + 1, *refreshed_log[0].first->size);
+}
+
+TEST_F(FileSystemProviderThrottledFileSystemTest,
+       GetMetadata_AbortAnswersOnlyTheAbortingCaller) {
+  SetUpFileSystem(0);
+  const base::FilePath file_path(kFakeFilePath);
+
+  MetadataLog first_log;
+  AbortCallback first_abort_callback = file_system_->GetMetadata(
+      file_path, ProvidedFileSystemInterface::METADATA_FIELD_SIZE,
+      base::BindOnce(&LogMetadata, &first_log));
+  MetadataLog second_log;
+  AbortCallback second_abort_callback = file_system_->GetMetadata(
+      file_path, ProvidedFileSystemInterface::METADATA_FIELD_SIZE,
+      base::BindOnce(&LogMetadata, &second_log));
+
+  // The other caller still gets the result.
+  std::move(first_abort_callback).Run();
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(1u, first_log.size());
+  EXPECT_EQ(base::File::FILE_ERROR_ABORT, first_log[0].second);
+  EXPECT_FALSE(first_log[0].first);
+  ASSERT_EQ(1u, second_log.size());
+  EXPECT_EQ(base::File::FILE_OK, second_log[0].second);
+
+  // Aborting the last caller also answers it.
+  MetadataLog third_log;
+  file_system_->Notify(file_path, /*recursive=*/false,
+                       storage::WatcherManager::CHANGED,
+                       /*changes=*/nullptr, /*tag=*/std::string(),
+                       base::DoNothing());
+  AbortCallback third_abort_callback = file_system_->GetMetadata(
+      file_path, ProvidedFileSystemInterface::METADATA_FIELD_SIZE,
+      base::BindOnce(&LogMetadata, &third_log));
+  std::move(third_abort_callback).Run();
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(1u, third_log.size());
+  EXPECT_EQ(base::File::FILE_ERROR_ABORT, third_log[0].second);
+
+  StatusLog read_log;
+  AbortCallback read_abort_callback = file_system_->ReadDirectory(
+      file_path.DirName(), base::BindRepeating(&LogReadDirectory, &read_log));
+  std::move(read_abort_callback).Run();
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(1u, read_log.size());
+  EXPECT_EQ(base::File::FILE_ERROR_ABORT, read_log[0]);
+}
+
+TEST_F(FileSystemProviderThrottledFileSystemTest,
+       ReadDirectory_PrimesMetadataCache) {
+  SetUpFileSystem(0);
+  const base::FilePath file_path(kFakeFilePath);
+  std::string* const name =
+      fake_file_system_->GetEntry(file_path)->metadata->name.get();
+  const std::string original_name = *name;
+
+  StatusLog read_log;
+  file_system_->ReadDirectory(
+      file_path.DirName(), base::BindRepeating(&LogReadDirectory, &read_log));
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(1u, read_log.size());
+  EXPECT_EQ(base::File::FILE_OK, read_log[0]);
+
+  // Types and names of listed entries are served from the cache.
+  *name = "renamed.txt";
+  MetadataLog cached_log;
+  file_system_->GetMetadata(
+      file_path,
+      ProvidedFileSystemInterface::METADATA_FIELD_IS_DIRECTORY |
+          ProvidedFileSystemInterface::METADATA_FIELD_NAME,
+      base::BindOnce(&LogMetadata, &cached_log));
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(1u, cached_log.size());
+  EXPECT_EQ(base::File::FILE_OK, cached_log[0].second);
+  ASSERT_TRUE(cached_log[0].first && cached_log[0].first->is_directory &&
+              cached_log[0].first->name);
+  EXPECT_FALSE(*cached_log[0].first->is_directory);
+  EXPECT_EQ(original_name, *cached_log[0].first->name);
+
+  // Mutations through the file system invalidate the cache.
+  StatusLog delete_log;
+  file_system_->DeleteEntry(file_path, /*recursive=*/false,
+                            base::BindOnce(&LogStatus, &delete_log));
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(1u, delete_log.size());
+  EXPECT_EQ(base::File::FILE_OK, delete_log[0]);
+
+  MetadataLog deleted_log;
+  file_system_->GetMetadata(
+      file_path,
+      ProvidedFileSystemInterface::METADATA_FIELD_IS_DIRECTORY |
+          ProvidedFileSystemInterface::METADATA_FIELD_NAME,
+      base::BindOnce(&LogMetadata, &deleted_log));
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(1u, deleted_log.size());
+  EXPECT_EQ(base::File::FILE_ERROR_NOT_FOUND, deleted_log[0].second);
+}
+
 }  // namespace ash::file_system_provider
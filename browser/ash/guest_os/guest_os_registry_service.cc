@@ -9,11 +9,14 @@
 
 #include "ash/constants/ash_features.h"
 #include "ash/public/cpp/app_list/app_list_config.h"
+#include "base/auto_reset.h"
 #include "base/containers/contains.h"
+#include "base/containers/to_vector.h"
 #include "base/feature_list.h"
 #include "base/files/file_util.h"
 #include "base/functional/bind.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/ranges/algorithm.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
@@ -93,20 +96,14 @@ void Launch(vm_tools::apps::VmType vm_type,
   }
 }
 
-bool AppHandlesProtocol(const GuestOsRegistryService::Registration& app,
-                        const GURL& url) {
-  if (app.VmType() == VmType::BOREALIS &&
-      !borealis::IsExternalURLAllowed(url)) {
-    return false;
-  }
-  return base::Contains(app.MimeTypes(), "x-scheme-handler/" + url.scheme());
-}
-
 // This prefix is used when generating the crostini app list id.
 constexpr char kCrostiniAppIdPrefix[] = "crostini:";
 
 constexpr char kCrostiniIconFolder[] = "crostini.icons";
 
+// Apps declare the URL schemes they handle as MIME types with this prefix.
+constexpr char kSchemeHandlerMimeTypePrefix[] = "x-scheme-handler/";
+
 base::Value::Dict ProtoToDictionary(const App::LocaleString& locale_string) {
   base::Value::Dict result;
   for (const App::LocaleString::Entry& entry : locale_string.values()) {
@@ -338,7 +335,9 @@ std::string GetStringKey(const base::Value& dict, std::string_view key) {
 
 GuestOsRegistryService::Registration::Registration(std::string app_id,
                                                    base::Value pref)
-    : app_id_(std::move(app_id)), pref_(std::move(pref)) {}
+    : app_id_(std::move(app_id)),
+      pref_(base::MakeRefCounted<base::RefCountedData<base::Value>>(
+          std::move(pref))) {}
 
 GuestOsRegistryService::Registration::~Registration() = default;
 
@@ -347,7 +346,7 @@ std::string GuestOsRegistryService::Registration::DesktopFileId() const {
 }
 
 VmType GuestOsRegistryService::Registration::VmType() const {
-  return VmTypeFromPref(pref_);
+  return VmTypeFromPref(pref());
 }
 
 std::string GuestOsRegistryService::Registration::VmName() const {
@@ -376,22 +375,22 @@ std::string GuestOsRegistryService::Registration::ExecutableFileName() const {
 }
 
 std::set<std::string> GuestOsRegistryService::Registration::Extensions() const {
-  if (!pref_.is_dict()) {
+  if (!pref().is_dict()) {
     return {};
   }
   // Convert to lowercase ASCII to allow case-insensitive match.
   return ListToStringSet(
-      pref_.GetDict().FindList(guest_os::prefs::kAppExtensionsKey),
+      pref().GetDict().FindList(guest_os::prefs::kAppExtensionsKey),
       /*to_lower_ascii=*/true);
 }
 
 std::set<std::string> GuestOsRegistryService::Registration::MimeTypes() const {
-  if (!pref_.is_dict()) {
+  if (!pref().is_dict()) {
     return {};
   }
   // Convert to lowercase ASCII to allow case-insensitive match.
   return ListToStringSet(
-      pref_.GetDict().FindList(guest_os::prefs::kAppMimeTypesKey),
+      pref().GetDict().FindList(guest_os::prefs::kAppMimeTypesKey),
       /*to_lower_ascii=*/true);
 }
 
@@ -411,7 +410,7 @@ std::string GuestOsRegistryService::Registration::PackageId() const {
 }
 
 bool GuestOsRegistryService::Registration::CanUninstall() const {
-  if (!pref_.is_dict()) {
+  if (!pref().is_dict()) {
     return false;
   }
   // We can uninstall if and only if there is a package that owns the
@@ -425,7 +424,7 @@ bool GuestOsRegistryService::Registration::CanUninstall() const {
   // then Google to learn more) than to just not have an uninstall option at
   // all.
   const std::string* package_id =
-      pref_.GetDict().FindString(guest_os::prefs::kAppPackageIdKey);
+      pref().GetDict().FindString(guest_os::prefs::kAppPackageIdKey);
   if (package_id) {
     return !package_id->empty();
   }
@@ -458,24 +457,24 @@ bool GuestOsRegistryService::Registration::StartupNotify() const {
 
 std::string GuestOsRegistryService::Registration::GetString(
     std::string_view key) const {
-  return GetStringKey(pref_, key);
+  return GetStringKey(pref(), key);
 }
 
 bool GuestOsRegistryService::Registration::GetBool(std::string_view key) const {
-  if (!pref_.is_dict()) {
+  if (!pref().is_dict()) {
     return false;
   }
-  const std::optional<bool> value = pref_.GetDict().FindBool(key);
+  const std::optional<bool> value = pref().GetDict().FindBool(key);
   return value.value_or(false);
 }
 
 // This is the companion to GuestOsRegistryService::SetCurrentTime().
 base::Time GuestOsRegistryService::Registration::GetTime(
     std::string_view key) const {
-  if (!pref_.is_dict()) {
+  if (!pref().is_dict()) {
     return base::Time();
   }
-  const std::string* value = pref_.GetDict().FindString(key);
+  const std::string* value = pref().GetDict().FindString(key);
   int64_t time;
   if (!value || !base::StringToInt64(*value, &time)) {
     return base::Time();
@@ -488,10 +487,10 @@ base::Time GuestOsRegistryService::Registration::GetTime(
 // deal with this.
 std::string GuestOsRegistryService::Registration::GetLocalizedString(
     std::string_view key) const {
-  if (!pref_.is_dict()) {
+  if (!pref().is_dict()) {
     return std::string();
   }
-  const base::Value::Dict* dict = pref_.GetDict().FindDict(key);
+  const base::Value::Dict* dict = pref().GetDict().FindDict(key);
   if (!dict) {
     return std::string();
   }
@@ -514,10 +513,10 @@ std::string GuestOsRegistryService::Registration::GetLocalizedString(
 
 std::set<std::string> GuestOsRegistryService::Registration::GetLocalizedList(
     std::string_view key) const {
-  if (!pref_.is_dict()) {
+  if (!pref().is_dict()) {
     return {};
   }
-  const base::Value::Dict* dict = pref_.GetDict().FindDict(key);
+  const base::Value::Dict* dict = pref().GetDict().FindDict(key);
   if (!dict) {
     return {};
   }
@@ -538,12 +537,94 @@ std::set<std::string> GuestOsRegistryService::Registration::GetLocalizedList(
   return {};
 }
 
+struct GuestOsRegistryService::AppIndex {
+  using RegistrationList = std::vector<const Registration*>;
+
+  // Adds the app |app_id| with registry pref entry |pref| to the indexes,
+  // replacing any previous entry for it.
+  void Add(const std::string& app_id, base::Value pref) {
+    Remove(app_id);
+    const Registration& registration =
+        apps.emplace(app_id, Registration(app_id, std::move(pref)))
+            .first->second;
+    UpdateSecondaryIndexes(registration, /*add=*/true);
+  }
+
+  // Removes the app |app_id| from the indexes, if present.
+  void Remove(const std::string& app_id) {
+    auto it = apps.find(app_id);
+    if (it == apps.end()) {
+      return;
+    }
+    UpdateSecondaryIndexes(it->second, /*add=*/false);
+    apps.erase(it);
+  }
+
+  // Every app in the registry pref, keyed by app id.
+  std::map<std::string, Registration> apps;
+
+  // The entries below point into |apps|, in app id order.
+  std::map<VmType, RegistrationList> by_vm_type;
+  // Keyed by VM name and container name.
+  std::map<std::pair<std::string, std::string>, RegistrationList> by_container;
+  // Keyed by the URL schemes apps declare they handle.
+  std::map<std::string, RegistrationList> by_url_scheme;
+  // Keyed by the lowercased StartupWMClass of the apps that set one.
+  std::map<std::string, RegistrationList> by_wm_class;
+  // Keyed by the lowercased MIME types apps declare they open, excluding URL
+  // schemes.
+  std::map<std::string, RegistrationList> by_mime_type;
+
+ private:
+  void UpdateSecondaryIndexes(const Registration& registration, bool add) {
+    auto update = [&](auto& index, const auto& key) {
+      if (add) {
+        RegistrationList& list = index[key];
+        list.insert(base::ranges::upper_bound(list, registration.app_id(), {},
+                                              &Registration::app_id),
+                    &registration);
+        return;
+      }
+      auto it = index.find(key);
+      if (it == index.end()) {
+        return;
+      }
+      std::erase(it->second, &registration);
+      if (it->second.empty()) {
+        index.erase(it);
+      }
+    };
+
+    update(by_vm_type, registration.VmType());
+    update(by_container,
+           std::make_pair(registration.VmName(), registration.ContainerName()));
+    const std::string wm_class = registration.StartupWmClass();
+    if (!wm_class.empty()) {
+      update(by_wm_class, base::ToLowerASCII(wm_class));
+    }
+    for (const std::string& mime_type : registration.MimeTypes()) {
+      std::string_view scheme(mime_type);
+      if (base::StartsWith(scheme, kSchemeHandlerMimeTypePrefix)) {
+        scheme.remove_prefix(std::size(kSchemeHandlerMimeTypePrefix) - 1);
+        update(by_url_scheme, std::string(scheme));
+      } else {
+        update(by_mime_type, mime_type);
+      }
+    }
+  }
+};
+
 GuestOsRegistryService::GuestOsRegistryService(Profile* profile)
     : profile_(profile),
       prefs_(profile->GetPrefs()),
       base_icon_path_(profile->GetPath().AppendASCII(kCrostiniIconFolder)),
       clock_(base::DefaultClock::GetInstance()),
       svg_icon_transcoder_(std::make_unique<apps::SvgIconTranscoder>(profile)) {
+  pref_change_registrar_.Init(prefs_);
+  pref_change_registrar_.Add(
+      guest_os::prefs::kGuestOsRegistry,
+      base::BindRepeating(&GuestOsRegistryService::OnRegistryPrefChanged,
+                          base::Unretained(this)));
 }
 
 GuestOsRegistryService::~GuestOsRegistryService() = default;
@@ -554,65 +635,52 @@ base::WeakPtr<GuestOsRegistryService> GuestOsRegistryService::GetWeakPtr() {
 
 std::map<std::string, GuestOsRegistryService::Registration>
 GuestOsRegistryService::GetAllRegisteredApps() const {
-  const base::Value::Dict& apps =
-      prefs_->GetDict(guest_os::prefs::kGuestOsRegistry);
+  return GetAppIndex().apps;
+}
+
+std::map<std::string, GuestOsRegistryService::Registration>
+GuestOsRegistryService::GetEnabledApps() const {
   std::map<std::string, GuestOsRegistryService::Registration> result;
-  for (const auto item : apps) {
-    result.emplace(item.first, Registration(item.first, item.second.Clone()));
+  for (VmType vm_type : GetEnabledVmTypes()) {
+    result.merge(GetRegisteredApps(vm_type));
   }
   return result;
 }
 
 std::map<std::string, GuestOsRegistryService::Registration>
-GuestOsRegistryService::GetEnabledApps() const {
-  bool crostini_enabled =
-      crostini::CrostiniFeatures::Get()->IsEnabled(profile_);
-  bool plugin_vm_enabled =
-      plugin_vm::PluginVmFeatures::Get()->IsEnabled(profile_);
-  bool borealis_enabled = borealis::BorealisService::GetForProfile(profile_)
-                              ->Features()
-                              .IsEnabled();
-  if (!crostini_enabled && !plugin_vm_enabled && !borealis_enabled) {
+GuestOsRegistryService::GetRegisteredApps(VmType vm_type) const {
+  const AppIndex& index = GetAppIndex();
+  auto it = index.by_vm_type.find(vm_type);
+  if (it == index.by_vm_type.end()) {
     return {};
   }
 
-  auto apps = GetAllRegisteredApps();
-  for (auto it = apps.cbegin(); it != apps.cend();) {
-    bool enabled = false;
-    switch (it->second.VmType()) {
-      case VmType::TERMINA:
-        enabled = crostini_enabled;
-        break;
-      case VmType::PLUGIN_VM:
-        enabled = plugin_vm_enabled;
-        break;
-      case VmType::BOREALIS:
-        enabled = borealis_enabled;
-        break;
-      default:
-        LOG(ERROR) << "Unsupported VmType: "
-                   << static_cast<int>(it->second.VmType());
-    }
-    if (enabled) {
-      ++it;
-    } else {
-      it = apps.erase(it);
-    }
+  // The copies share their pref values with the index.
+  std::map<std::string, GuestOsRegistryService::Registration> result;
+  for (const Registration* registration : it->second) {
+    result.emplace_hint(result.end(), registration->app_id(), *registration);
   }
-  return apps;
+  return result;
 }
 
-std::map<std::string, GuestOsRegistryService::Registration>
-GuestOsRegistryService::GetRegisteredApps(VmType vm_type) const {
-  auto apps = GetAllRegisteredApps();
-  for (auto it = apps.cbegin(); it != apps.cend();) {
-    if (it->second.VmType() == vm_type) {
-      ++it;
-    } else {
-      it = apps.erase(it);
-    }
+std::vector<std::string> GuestOsRegistryService::GetAppIdsForWmClass(
+    const std::string& wm_class) const {
+  const AppIndex& index = GetAppIndex();
+  auto it = index.by_wm_class.find(base::ToLowerASCII(wm_class));
+  if (it == index.by_wm_class.end()) {
+    return {};
   }
-  return apps;
+  return base::ToVector(it->second, &Registration::app_id);
+}
+
+std::vector<std::string> GuestOsRegistryService::GetAppIdsForMimeType(
+    const std::string& mime_type) const {
+  const AppIndex& index = GetAppIndex();
+  auto it = index.by_mime_type.find(base::ToLowerASCII(mime_type));
+  if (it == index.by_mime_type.end()) {
+    return {};
+  }
+  return base::ToVector(it->second, &Registration::app_id);
 }
 
 std::optional<GuestOsRegistryService::Registration>
@@ -643,12 +711,24 @@ std::optional<GuestOsUrlHandler> GuestOsRegistryService::GetHandler(
     }
   }
 
-  std::map<std::string, Registration> apps = GetEnabledApps();
+  const AppIndex& index = GetAppIndex();
+  auto it = index.by_url_scheme.find(url.scheme());
+  if (it == index.by_url_scheme.end()) {
+    return std::nullopt;
+  }
+
+  std::set<VmType> enabled_vm_types = GetEnabledVmTypes();
   const Registration* result = nullptr;
-  for (auto& [unused, registration] : apps) {
-    if (AppHandlesProtocol(registration, url) &&
-        (!result || registration.LastLaunchTime() > result->LastLaunchTime())) {
-      result = &registration;
+  for (const Registration* registration : it->second) {
+    if (!base::Contains(enabled_vm_types, registration->VmType())) {
+      continue;
+    }
+    if (registration->VmType() == VmType::BOREALIS &&
+        !borealis::IsExternalURLAllowed(url)) {
+      continue;
+    }
+    if (!result || registration->LastLaunchTime() > result->LastLaunchTime()) {
+      result = registration;
     }
   }
   if (!result) {
@@ -659,6 +739,58 @@ std::optional<GuestOsUrlHandler> GuestOsRegistryService::GetHandler(
       base::BindRepeating(Launch, result->VmType(), result->app_id()));
 }
 
+const GuestOsRegistryService::AppIndex& GuestOsRegistryService::GetAppIndex()
+    const {
+  if (app_index_) {
+    return *app_index_;
+  }
+
+  auto index = std::make_unique<AppIndex>();
+  for (const auto item : prefs_->GetDict(guest_os::prefs::kGuestOsRegistry)) {
+    index->Add(item.first, item.second.Clone());
+  }
+  app_index_ = std::move(index);
+  return *app_index_;
+}
+
+void GuestOsRegistryService::OnRegistryPrefChanged() {
+  if (!keep_app_index_on_pref_change_) {
+    app_index_.reset();
+  }
+}
+
+void GuestOsRegistryService::UpdateIndexedApps(
+    const std::vector<std::string>& app_ids) {
+  if (!app_index_) {
+    return;
+  }
+  const base::Value::Dict& apps =
+      prefs_->GetDict(guest_os::prefs::kGuestOsRegistry);
+  for (const std::string& app_id : app_ids) {
+    if (const base::Value* pref = apps.Find(app_id)) {
+      app_index_->Add(app_id, pref->Clone());
+    } else {
+      app_index_->Remove(app_id);
+    }
+  }
+}
+
+std::set<VmType> GuestOsRegistryService::GetEnabledVmTypes() const {
+  std::set<VmType> result;
+  if (crostini::CrostiniFeatures::Get()->IsEnabled(profile_)) {
+    result.insert(VmType::TERMINA);
+  }
+  if (plugin_vm::PluginVmFeatures::Get()->IsEnabled(profile_)) {
+    result.insert(VmType::PLUGIN_VM);
+  }
+  if (borealis::BorealisService::GetForProfile(profile_)
+          ->Features()
+          .IsEnabled()) {
+    result.insert(VmType::BOREALIS);
+  }
+  return result;
+}
+
 base::FilePath GuestOsRegistryService::GetAppPath(
     const std::string& app_id) const {
   return base_icon_path_.AppendASCII(app_id);
@@ -892,30 +1024,32 @@ void GuestOsRegistryService::ClearApplicationList(
     const std::string& vm_name,
     const std::string& container_name) {
   std::vector<std::string> removed_apps;
+  // An empty |container_name| sorts first, so this visits either the named
+  // container or all containers of |vm_name|.
+  const AppIndex& index = GetAppIndex();
+  for (auto it = index.by_container.lower_bound({vm_name, container_name});
+       it != index.by_container.end() && it->first.first == vm_name &&
+       (container_name.empty() || it->first.second == container_name);
+       ++it) {
+    for (const Registration* registration : it->second) {
+      if (registration->VmType() == vm_type) {
+        removed_apps.push_back(registration->app_id());
+      }
+    }
+  }
+
   // The ScopedDictPrefUpdate should be destructed before calling the observer.
   {
+    base::AutoReset<bool> keep_app_index(&keep_app_index_on_pref_change_,
+                                         true);
     ScopedDictPrefUpdate update(prefs_, guest_os::prefs::kGuestOsRegistry);
     base::Value::Dict& apps = update.Get();
-
-    for (const auto item : apps) {
-      Registration registration(item.first, item.second.Clone());
-      if (vm_type != registration.VmType()) {
-        continue;
-      }
-      if (vm_name != registration.VmName()) {
-        continue;
-      }
-      if (!container_name.empty() &&
-          container_name != registration.ContainerName()) {
-        continue;
-      }
-      removed_apps.push_back(item.first);
-    }
     for (const std::string& removed_app : removed_apps) {
       RemoveAppData(removed_app);
       apps.Remove(removed_app);
     }
   }
+  UpdateIndexedApps(removed_apps);
 
   if (removed_apps.empty()) {
     return;
@@ -958,6 +1092,8 @@ void GuestOsRegistryService::UpdateApplicationList(
 
   // The ScopedDictPrefUpdate should be destructed before calling the observer.
   {
+    base::AutoReset<bool> keep_app_index(&keep_app_index_on_pref_change_,
+                                         true);
     ScopedDictPrefUpdate update(prefs_, guest_os::prefs::kGuestOsRegistry);
     base::Value::Dict& apps = update.Get();
     for (const App& app : app_list.apps()) {
@@ -1033,6 +1169,9 @@ void GuestOsRegistryService::UpdateApplicationList(
       apps.Remove(removed_app);
     }
   }
+  UpdateIndexedApps(updated_apps);
+  UpdateIndexedApps(removed_apps);
+  UpdateIndexedApps(inserted_apps);
 
   // When we receive notification of the application list then the container
   // *should* be online and we can retry all of our icon requests that failed
@@ -1061,10 +1200,12 @@ void GuestOsRegistryService::ContainerBadgeColorChanged(
     const guest_os::GuestId& container_id) {
   std::vector<std::string> updated_apps;
 
-  for (const auto& it : GetAllRegisteredApps()) {
-    if (it.second.VmName() == container_id.vm_name &&
-        it.second.ContainerName() == container_id.container_name) {
-      updated_apps.push_back(it.first);
+  const AppIndex& index = GetAppIndex();
+  auto it = index.by_container.find(
+      {container_id.vm_name, container_id.container_name});
+  if (it != index.by_container.end()) {
+    for (const Registration* registration : it->second) {
+      updated_apps.push_back(registration->app_id());
     }
   }
 
@@ -1095,11 +1236,22 @@ void GuestOsRegistryService::RemoveObserver(Observer* observer) {
 }
 
 void GuestOsRegistryService::AppLaunched(const std::string& app_id) {
-  ScopedDictPrefUpdate update(prefs_, guest_os::prefs::kGuestOsRegistry);
-  base::Value::Dict& app = update->Find(app_id)->GetDict();
-  SetCurrentTime(app, guest_os::prefs::kAppLastLaunchTimeKey);
+  std::optional<int> vm_type;
+  {
+    base::AutoReset<bool> keep_app_index(&keep_app_index_on_pref_change_,
+                                         true);
+    ScopedDictPrefUpdate update(prefs_, guest_os::prefs::kGuestOsRegistry);
+    base::Value::Dict* app = update->FindDict(app_id);
+    if (!app) {
+      LOG(ERROR) << "Tried to record a launch of the app with this app_id "
+                 << app_id << " that doesn't exist in the registry.";
+      return;
+    }
+    SetCurrentTime(*app, guest_os::prefs::kAppLastLaunchTimeKey);
+    vm_type = app->FindInt(guest_os::prefs::kVmTypeKey);
+  }
+  UpdateIndexedApps({app_id});
 
-  auto vm_type = app.FindInt(guest_os::prefs::kVmTypeKey);
   if (!vm_type.has_value()) {
     LOG(ERROR) << "Failed to find " << guest_os::prefs::kVmTypeKey
                << " for app " << app_id;
@@ -1120,17 +1272,22 @@ void GuestOsRegistryService::SetCurrentTime(base::Value::Dict& dictionary,
 
 void GuestOsRegistryService::SetAppScaled(const std::string& app_id,
                                           bool scaled) {
-  ScopedDictPrefUpdate update(prefs_, guest_os::prefs::kGuestOsRegistry);
-  base::Value::Dict& apps = update.Get();
-
-  base::Value::Dict* app = apps.FindDict(app_id);
-  if (!app) {
-    LOG(ERROR)
-        << "Tried to set display scaled property on the app with this app_id "
-        << app_id << " that doesn't exist in the registry.";
-    return;
+  {
+    base::AutoReset<bool> keep_app_index(&keep_app_index_on_pref_change_,
+                                         true);
+    ScopedDictPrefUpdate update(prefs_, guest_os::prefs::kGuestOsRegistry);
+    base::Value::Dict& apps = update.Get();
+
+    base::Value::Dict* app = apps.FindDict(app_id);
+    if (!app) {
+      LOG(ERROR)
+          << "Tried to set display scaled property on the app with this app_id "
+          << app_id << " that doesn't exist in the registry.";
+      return;
+    }
+    app->Set(guest_os::prefs::kAppScaledKey, scaled);
   }
-  app->Set(guest_os::prefs::kAppScaledKey, scaled);
+  UpdateIndexedApps({app_id});
 }
 
 // static
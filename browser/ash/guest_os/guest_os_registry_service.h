@@ -6,6 +6,7 @@
 #define CHROME_BROWSER_ASH_GUEST_OS_GUEST_OS_REGISTRY_SERVICE_H_
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <string_view>
@@ -14,6 +15,7 @@
 #include "base/files/file_path.h"
 #include "base/functional/callback.h"
 #include "base/memory/raw_ptr.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
 #include "base/values.h"
@@ -24,6 +26,7 @@
 #include "chrome/browser/ash/guest_os/public/types.h"
 #include "chromeos/ash/components/dbus/vm_applications/apps.pb.h"
 #include "components/keyed_service/core/keyed_service.h"
+#include "components/prefs/pref_change_registrar.h"
 #include "components/services/app_service/public/cpp/icon_types.h"
 #include "third_party/skia/include/core/SkColor.h"
 #include "ui/base/resource/resource_scale_factor.h"
@@ -87,8 +90,9 @@ class GuestOsRegistryService : public KeyedService {
     Registration(Registration&& registration) = default;
     Registration& operator=(Registration&& registration) = default;
 
-    Registration(const Registration&) = delete;
-    Registration& operator=(const Registration&) = delete;
+    // Copies share the immutable pref value.
+    Registration(const Registration&) = default;
+    Registration& operator=(const Registration&) = default;
 
     ~Registration();
 
@@ -128,8 +132,10 @@ class GuestOsRegistryService : public KeyedService {
     std::string GetLocalizedString(std::string_view key) const;
     std::set<std::string> GetLocalizedList(std::string_view key) const;
 
+    const base::Value& pref() const { return pref_->data; }
+
     std::string app_id_;
-    base::Value pref_;
+    scoped_refptr<const base::RefCountedData<base::Value>> pref_;
   };
 
   class Observer {
@@ -180,6 +186,17 @@ class GuestOsRegistryService : public KeyedService {
   std::optional<GuestOsRegistryService::Registration> GetRegistration(
       const std::string& app_id) const;
 
+  // Return the ids of the apps whose desktop file sets StartupWMClass to
+  // |wm_class|, compared case-insensitively, in app id order.
+  std::vector<std::string> GetAppIdsForWmClass(
+      const std::string& wm_class) const;
+
+  // Return the ids of the apps that declare they open |mime_type|, compared
+  // case-insensitively, in app id order. URL scheme handlers are looked up with
+  // GetHandler() instead.
+  std::vector<std::string> GetAppIdsForMimeType(
+      const std::string& mime_type) const;
+
   // Return the preferred handler for the given URL, if any.
   std::optional<GuestOsUrlHandler> GetHandler(const GURL& url) const;
 
@@ -277,6 +294,24 @@ class GuestOsRegistryService : public KeyedService {
                                    const std::string& container_name);
 
  private:
+  // Indexes over the apps in the registry pref. See GetAppIndex().
+  struct AppIndex;
+
+  // Returns the index of the apps in the registry pref, building it first if
+  // the pref changed since it was last built.
+  const AppIndex& GetAppIndex() const;
+
+  // Drops |app_index_| whenever the registry pref changes, unless the change
+  // is applied to the index in place.
+  void OnRegistryPrefChanged();
+
+  // Re-reads the registry pref entries of |app_ids| into |app_index_|, removing
+  // the apps that are no longer in the pref.
+  void UpdateIndexedApps(const std::vector<std::string>& app_ids);
+
+  // Returns the VM types whose apps are currently enabled.
+  std::set<VmType> GetEnabledVmTypes() const;
+
   // Construct path to app local data.
   base::FilePath GetAppPath(const std::string& app_id) const;
   // Called to request an icon from the container.
@@ -335,6 +370,15 @@ class GuestOsRegistryService : public KeyedService {
 
   raw_ptr<const base::Clock> clock_;
 
+  // Typed view of the registry pref, with apps indexed by VM type, container
+  // and handled URL scheme, so that launcher, shelf and URL routing lookups do
+  // not parse every app on every call. Built lazily and dropped whenever the
+  // pref changes.
+  mutable std::unique_ptr<AppIndex> app_index_;
+  // Set while writing a pref change that UpdateIndexedApps() then applies.
+  bool keep_app_index_on_pref_change_ = false;
+  PrefChangeRegistrar pref_change_registrar_;
+
   std::vector<std::pair<GuestOsUrlHandler, CanHandleUrlCallback>> url_handlers_;
 
   // Keeps record for icon request to avoid duplication. Each app may contain
@@ -558,6 +558,141 @@ TEST_F(GuestOsRegistryServiceTest, GetEnabledApps) {
   EXPECT_THAT(GetEnabledAppIds(), testing::IsEmpty());
 }
 
+TEST_F(GuestOsRegistryServiceTest, GetHandlerTracksRegistryChanges) {
+  crostini::FakeCrostiniFeatures fake_crostini_features;
+  fake_crostini_features.set_enabled(true);
+  const GURL url("mailto:someone@example.com");
+  EXPECT_FALSE(service()->GetHandler(url));
+
+  ApplicationList app_list =
+      crostini::CrostiniTestHelper::BasicAppList("mail", "vm", "container");
+  app_list.mutable_apps(0)->add_mime_types("x-scheme-handler/mailto");
+  *app_list.add_apps() = crostini::CrostiniTestHelper::BasicApp("editor");
+  service()->UpdateApplicationList(app_list);
+
+  std::optional<GuestOsUrlHandler> handler = service()->GetHandler(url);
+  ASSERT_TRUE(handler);
+  EXPECT_EQ("mail", handler->name());
+  EXPECT_FALSE(service()->GetHandler(GURL("https://example.com")));
+
+  // Apps of disabled VMs do not handle URLs.
+  fake_crostini_features.set_enabled(false);
+  EXPECT_FALSE(service()->GetHandler(url));
+  fake_crostini_features.set_enabled(true);
+
+  // The most recently launched app handles the URL. Launches update the
+  // indexed app in place.
+  std::string mail_app_id =
+      crostini::CrostiniTestHelper::GenerateAppId("mail", "vm", "container");
+  std::string editor_app_id =
+      crostini::CrostiniTestHelper::GenerateAppId("editor", "vm", "container");
+  app_list.mutable_apps(1)->add_mime_types("x-scheme-handler/mailto");
+  service()->UpdateApplicationList(app_list);
+  test_clock_.Advance(base::Hours(1));
+  service()->AppLaunched(editor_app_id);
+  handler = service()->GetHandler(url);
+  ASSERT_TRUE(handler);
+  EXPECT_EQ("editor", handler->name());
+  test_clock_.Advance(base::Hours(1));
+  service()->AppLaunched(mail_app_id);
+  handler = service()->GetHandler(url);
+  ASSERT_TRUE(handler);
+  EXPECT_EQ("mail", handler->name());
+
+  // Launching an app that is not registered does nothing.
+  service()->AppLaunched("unknown");
+  EXPECT_THAT(GetRegisteredAppIds(),
+              testing::UnorderedElementsAre(mail_app_id, editor_app_id));
+
+  // Removing the app from the registry also removes it as a handler.
+  app_list.mutable_apps(1)->clear_mime_types();
+  app_list.mutable_apps()->DeleteSubrange(0, 1);
+  service()->UpdateApplicationList(app_list);
+  EXPECT_FALSE(service()->GetHandler(url));
+  EXPECT_THAT(GetRegisteredAppIds(),
+              testing::ElementsAre(crostini::CrostiniTestHelper::GenerateAppId(
+                  "editor", "vm", "container")));
+}
+
+// The indexes are updated in place by every write, so lookups made before an
+// update see its result afterwards.
+TEST_F(GuestOsRegistryServiceTest, LookupsTrackApplicationListUpdates) {
+  std::string viewer_app_id =
+      crostini::CrostiniTestHelper::GenerateAppId("viewer", "vm", "container");
+  std::string editor_app_id =
+      crostini::CrostiniTestHelper::GenerateAppId("editor", "vm", "container");
+  std::string other_app_id = crostini::CrostiniTestHelper::GenerateAppId(
+      "editor", "vm", "other container");
+  EXPECT_THAT(service()->GetAppIdsForMimeType("text/plain"),
+              testing::IsEmpty());
+
+  ApplicationList app_list =
+      crostini::CrostiniTestHelper::BasicAppList("viewer", "vm", "container");
+  app_list.mutable_apps(0)->add_mime_types("text/plain");
+  app_list.mutable_apps(0)->set_startup_wm_class("viewer_wm");
+  *app_list.add_apps() = crostini::CrostiniTestHelper::BasicApp("editor");
+  app_list.mutable_apps(1)->add_mime_types("text/plain");
+  app_list.mutable_apps(1)->add_mime_types("text/x-python");
+  service()->UpdateApplicationList(app_list);
+
+  ApplicationList other_list = crostini::CrostiniTestHelper::BasicAppList(
+      "editor", "vm", "other container");
+  other_list.mutable_apps(0)->add_mime_types("text/x-python");
+  other_list.mutable_apps(0)->set_startup_wm_class("viewer_wm");
+  service()->UpdateApplicationList(other_list);
+
+  EXPECT_THAT(service()->GetAppIdsForMimeType("text/plain"),
+              testing::UnorderedElementsAre(viewer_app_id, editor_app_id));
+  EXPECT_THAT(service()->GetAppIdsForMimeType("text/x-python"),
+              testing::UnorderedElementsAre(editor_app_id, other_app_id));
+  EXPECT_THAT(service()->GetAppIdsForWmClass("viewer_wm"),
+              testing::UnorderedElementsAre(viewer_app_id, other_app_id));
+  EXPECT_THAT(service()->GetAppIdsForWmClass("editor_wm"), testing::IsEmpty());
+
+  // Lookups ignore case, like the MIME types and WM classes they are keyed by.
+  EXPECT_THAT(service()->GetAppIdsForMimeType("Text/X-Python"),
+              testing::UnorderedElementsAre(editor_app_id, other_app_id));
+  EXPECT_THAT(service()->GetAppIdsForWmClass("Viewer_WM"),
+              testing::UnorderedElementsAre(viewer_app_id, other_app_id));
+
+  // Changing the MIME types and WM class of an app moves it between keys.
+  app_list.mutable_apps(0)->clear_mime_types();
+  app_list.mutable_apps(0)->add_mime_types("image/png");
+  app_list.mutable_apps(1)->set_startup_wm_class("editor_wm");
+  service()->UpdateApplicationList(app_list);
+  EXPECT_THAT(service()->GetAppIdsForMimeType("text/plain"),
+              testing::ElementsAre(editor_app_id));
+  EXPECT_THAT(service()->GetAppIdsForMimeType("image/png"),
+              testing::ElementsAre(viewer_app_id));
+  EXPECT_THAT(service()->GetAppIdsForWmClass("editor_wm"),
+              testing::ElementsAre(editor_app_id));
+
+  // Launches and scaling keep the app in the indexes.
+  service()->AppLaunched(viewer_app_id);
+  service()->SetAppScaled(viewer_app_id, true);
+  EXPECT_THAT(service()->GetAppIdsForWmClass("viewer_wm"),
+              testing::UnorderedElementsAre(viewer_app_id, other_app_id));
+  EXPECT_TRUE(service()->GetRegisteredApps(VmType::TERMINA)
+                  .at(viewer_app_id)
+                  .IsScaled());
+
+  // Removed apps are dropped from every index.
+  app_list.mutable_apps()->DeleteSubrange(0, 1);
+  service()->UpdateApplicationList(app_list);
+  EXPECT_THAT(service()->GetAppIdsForMimeType("image/png"), testing::IsEmpty());
+  EXPECT_THAT(service()->GetAppIdsForWmClass("viewer_wm"),
+              testing::ElementsAre(other_app_id));
+  EXPECT_THAT(GetRegisteredAppIds(),
+              testing::UnorderedElementsAre(editor_app_id, other_app_id));
+
+  service()->ClearApplicationList(VmType::TERMINA, "vm", "other container");
+  EXPECT_THAT(service()->GetAppIdsForMimeType("text/x-python"),
+              testing::ElementsAre(editor_app_id));
+  EXPECT_THAT(service()->GetAppIdsForWmClass("viewer_wm"), testing::IsEmpty());
+  EXPECT_THAT(service()->GetRegisteredApps(VmType::TERMINA),
+              testing::ElementsAre(testing::Key(editor_app_id)));
+}
+
 TEST_F(GuestOsRegistryServiceTest, PluginVmNameSuffix) {
   ApplicationList crostini_list;
   crostini_list.set_vm_type(VmType::TERMINA);
@@ -12,6 +12,8 @@
 #include "chrome/browser/ash/borealis/borealis_window_manager.h"
 #include "chrome/browser/ash/guest_os/guest_id.h"
 #include "chrome/browser/ash/guest_os/guest_os_pref_names.h"
+#include "chrome/browser/ash/guest_os/guest_os_registry_service.h"
+#include "chrome/browser/ash/guest_os/guest_os_registry_service_factory.h"
 #include "chrome/browser/ash/guest_os/guest_os_session_tracker.h"
 #include "chrome/browser/ash/guest_os/public/types.h"
 #include "chrome/browser/profiles/profile.h"
@@ -129,6 +131,40 @@ FindAppIdResult FindAppId(const base::Value::Dict& prefs,
   return FindAppIdResult::NoMatch;
 }
 
+// Looks for a displayed app whose StartupWMClass matches |wm_class| using the
+// registry's WM class index, which avoids scanning every app in the pref.
+FindAppIdResult FindAppIdByWmClass(Profile* profile,
+                                   std::string_view wm_class,
+                                   const std::optional<GuestId>& guest_id,
+                                   std::string* result) {
+  result->clear();
+  GuestOsRegistryService* registry_service =
+      GuestOsRegistryServiceFactory::GetForProfile(profile);
+  if (!registry_service) {
+    return FindAppIdResult::NoMatch;
+  }
+  for (const std::string& app_id :
+       registry_service->GetAppIdsForWmClass(std::string(wm_class))) {
+    std::optional<GuestOsRegistryService::Registration> registration =
+        registry_service->GetRegistration(app_id);
+    if (!registration || registration->NoDisplay()) {
+      continue;
+    }
+    if (guest_id && !MatchContainerDict(registration->pref(), *guest_id)) {
+      continue;
+    }
+    if (!result->empty()) {
+      return FindAppIdResult::NonUniqueMatch;
+    }
+    *result = app_id;
+  }
+
+  if (!result->empty()) {
+    return FindAppIdResult::UniqueMatch;
+  }
+  return FindAppIdResult::NoMatch;
+}
+
 // For GuestOS |window_app_id|s which match the prefix of
 // org.chromium.guest_os.<token>.*, return the guest token.
 // The token should be one of the following:
@@ -252,9 +288,8 @@ std::string GetGuestOsShelfAppId(Profile* profile,
   // If an app had StartupWMClass set to the given WM class, use that,
   // otherwise look for a desktop file id matching the WM class.
   std::string_view key = suffix.substr(strlen(kWmClassPrefix));
-  FindAppIdResult result = FindAppId(
-      apps, guest_os::prefs::kAppStartupWMClassKey, key, guest_id, &app_id,
-      false /* require_startup_notification */, true /* need_display */);
+  FindAppIdResult result =
+      FindAppIdByWmClass(profile, key, guest_id, &app_id);
   if (result == FindAppIdResult::UniqueMatch)
     return app_id;
   if (result == FindAppIdResult::NonUniqueMatch)
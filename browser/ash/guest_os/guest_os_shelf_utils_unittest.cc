@@ -256,6 +256,20 @@ TEST_F(GuestOsShelfUtilsTest,
       GenAppId({.desktop_file_id = "app"}));
 }
 
+TEST_F(GuestOsShelfUtilsTest,
+       GetGuestOsShelfAppIdMatchesStartupWmClassIgnoringCase) {
+  SetGuestOsRegistry({
+      {.desktop_file_id = "app", .startup_wm_class = "App_Start"},
+      {.desktop_file_id = "hidden",
+       .startup_wm_class = "app_start",
+       .no_display = true},
+  });
+
+  // The no_display app sharing the WM class does not make the match ambiguous.
+  EXPECT_EQ(GetShelfAppId({.app_id = TestXWindowIdWithToken("APP_START")}),
+            GenAppId({.desktop_file_id = "app"}));
+}
+
 TEST_F(
     GuestOsShelfUtilsTest,
     GetGuestOsShelfAppIdCantFindAppIfMultipleAppsStartupWmClassesAreTheSame) {
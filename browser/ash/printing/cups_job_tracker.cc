@@ -0,0 +1,140 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/ash/printing/cups_job_tracker.h"
+
+#include <utility>
+
+#include "base/functional/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/ranges/algorithm.h"
+#include "base/task/sequenced_task_runner.h"
+#include "chrome/browser/chromeos/printing/cups_wrapper.h"
+
+namespace ash {
+
+CupsJobTracker::CupsJobTracker(chromeos::CupsWrapper* cups_wrapper,
+                               QueryCallback query_callback)
+    : cups_wrapper_(cups_wrapper), query_callback_(std::move(query_callback)) {
+  cups_wrapper_->SetJobEventsCallback(base::BindRepeating(
+      &CupsJobTracker::QueryTrackedPrinters, weak_ptr_factory_.GetWeakPtr()));
+}
+
+CupsJobTracker::~CupsJobTracker() {
+  RemoveAllPrinters();
+  cups_wrapper_->SetJobEventsCallback(
+      chromeos::CupsWrapper::JobEventsCallback());
+}
+
+void CupsJobTracker::AddPrinter(const std::string& printer_id) {
+  // Query on a fresh task, so that observers of the new job are notified of
+  // its creation first.
+  base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+      FROM_HERE, base::BindOnce(&CupsJobTracker::QueryTrackedPrinters,
+                                weak_ptr_factory_.GetWeakPtr(),
+                                std::vector<std::string>{printer_id}));
+
+  if (!printers_.emplace(printer_id, false).second) {
+    return;
+  }
+  cups_wrapper_->SubscribeToJobEvents(
+      printer_id, base::BindOnce(&CupsJobTracker::OnSubscribed,
+                                 weak_ptr_factory_.GetWeakPtr(), printer_id));
+  UpdatePollRate();
+}
+
+void CupsJobTracker::RemovePrinter(const std::string& printer_id) {
+  auto it = printers_.find(printer_id);
+  if (it == printers_.end()) {
+    return;
+  }
+  if (it->second) {
+    cups_wrapper_->UnsubscribeFromJobEvents(printer_id);
+  }
+  printers_.erase(it);
+  UpdatePollRate();
+}
+
+void CupsJobTracker::RemoveAllPrinters() {
+  for (const auto& [printer_id, subscribed] : printers_) {
+    if (subscribed) {
+      cups_wrapper_->UnsubscribeFromJobEvents(printer_id);
+    }
+  }
+  printers_.clear();
+  poll_timer_.Stop();
+}
+
+void CupsJobTracker::OnQueryFailed(int failure_count) {
+  if (!printers_.empty()) {
+    // Give CUPS a chance to recover.
+    StartPolling(kPollRate * failure_count);
+  }
+}
+
+void CupsJobTracker::OnQuerySucceeded() {
+  UpdatePollRate();
+}
+
+void CupsJobTracker::OnSubscribed(const std::string& printer_id,
+                                  bool success) {
+  auto it = printers_.find(printer_id);
+  if (it == printers_.end()) {
+    // The printer ran out of jobs while subscribing.
+    if (success) {
+      cups_wrapper_->UnsubscribeFromJobEvents(printer_id);
+    }
+    return;
+  }
+  if (!success) {
+    VLOG(1) << "Polling jobs of " << printer_id << " without job events";
+    return;
+  }
+  it->second = true;
+  UpdatePollRate();
+}
+
+void CupsJobTracker::QueryTrackedPrinters(
+    const std::vector<std::string>& printer_ids) {
+  std::vector<std::string> tracked_printer_ids;
+  for (const std::string& printer_id : printer_ids) {
+    if (printers_.contains(printer_id)) {
+      tracked_printer_ids.push_back(printer_id);
+    }
+  }
+  if (!tracked_printer_ids.empty()) {
+    query_callback_.Run(tracked_printer_ids);
+  }
+}
+
+void CupsJobTracker::UpdatePollRate() {
+  if (printers_.empty()) {
+    poll_timer_.Stop();
+    return;
+  }
+  const bool all_subscribed = base::ranges::all_of(
+      printers_, [](const auto& printer) { return printer.second; });
+  StartPolling(all_subscribed ? kFallbackPollRate : kPollRate);
+}
+
+void CupsJobTracker::StartPolling(base::TimeDelta poll_rate) {
+  if (poll_timer_.IsRunning() && poll_timer_.GetCurrentDelay() == poll_rate) {
+    return;
+  }
+  poll_timer_.Start(FROM_HERE, poll_rate,
+                    base::BindRepeating(&CupsJobTracker::Poll,
+                                        weak_ptr_factory_.GetWeakPtr()));
+}
+
+void CupsJobTracker::Poll() {
+  std::vector<std::string> printer_ids;
+  printer_ids.reserve(printers_.size());
+  for (const auto& [printer_id, subscribed] : printers_) {
+    printer_ids.push_back(printer_id);
+  }
+  query_callback_.Run(printer_ids);
+}
+
+}  // namespace ash
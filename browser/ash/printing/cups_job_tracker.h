@@ -0,0 +1,89 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_ASH_PRINTING_CUPS_JOB_TRACKER_H_
+#define CHROME_BROWSER_ASH_PRINTING_CUPS_JOB_TRACKER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/functional/callback.h"
+#include "base/memory/raw_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace chromeos {
+class CupsWrapper;
+}  // namespace chromeos
+
+namespace ash {
+
+// Decides when the job queues of printers with active print jobs are queried.
+// Printers are subscribed to CUPS job events, and their queues are queried as
+// soon as an event arrives. Printers which cannot be subscribed are polled
+// every |kPollRate|. Once all printers are subscribed, polling slows down to
+// |kFallbackPollRate|, which only catches lost events and expires stuck jobs.
+class CupsJobTracker {
+ public:
+  static constexpr base::TimeDelta kPollRate = base::Seconds(1);
+  static constexpr base::TimeDelta kFallbackPollRate = base::Seconds(10);
+
+  // Queries the job queues of |printer_ids|.
+  using QueryCallback = base::RepeatingCallback<void(
+      const std::vector<std::string>& printer_ids)>;
+
+  // |cups_wrapper| must outlive |this|.
+  CupsJobTracker(chromeos::CupsWrapper* cups_wrapper,
+                 QueryCallback query_callback);
+
+  CupsJobTracker(const CupsJobTracker&) = delete;
+  CupsJobTracker& operator=(const CupsJobTracker&) = delete;
+
+  ~CupsJobTracker();
+
+  // Starts tracking the job queue of |printer_id|, and queries it right away.
+  void AddPrinter(const std::string& printer_id);
+
+  // Stops tracking the job queue of |printer_id|.
+  void RemovePrinter(const std::string& printer_id);
+
+  // Stops tracking all printers.
+  void RemoveAllPrinters();
+
+  // Backs off polling after |failure_count| consecutive failed queries.
+  void OnQueryFailed(int failure_count);
+
+  // Restores the regular poll rate after OnQueryFailed().
+  void OnQuerySucceeded();
+
+  bool IsTracking(const std::string& printer_id) const {
+    return printers_.contains(printer_id);
+  }
+
+ private:
+  void OnSubscribed(const std::string& printer_id, bool success);
+
+  // Queries the job queues of the tracked printers among |printer_ids|.
+  void QueryTrackedPrinters(const std::vector<std::string>& printer_ids);
+
+  // Polls at the rate matching the current subscriptions.
+  void UpdatePollRate();
+  void StartPolling(base::TimeDelta poll_rate);
+  void Poll();
+
+  const raw_ptr<chromeos::CupsWrapper> cups_wrapper_;
+  const QueryCallback query_callback_;
+
+  // Tracked printers, mapped to whether they are subscribed to job events.
+  base::flat_map<std::string, bool> printers_;
+
+  base::RepeatingTimer poll_timer_;
+  base::WeakPtrFactory<CupsJobTracker> weak_ptr_factory_{this};
+};
+
+}  // namespace ash
+
+#endif  // CHROME_BROWSER_ASH_PRINTING_CUPS_JOB_TRACKER_H_
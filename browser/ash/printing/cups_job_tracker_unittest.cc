@@ -0,0 +1,173 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/ash/printing/cups_job_tracker.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/test/task_environment.h"
+#include "chrome/browser/chromeos/printing/test_cups_wrapper.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace ash {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+class CupsJobTrackerTest : public testing::Test {
+ public:
+  CupsJobTrackerTest() = default;
+  ~CupsJobTrackerTest() override = default;
+
+ protected:
+  void CreateTracker(bool supports_job_events) {
+    cups_wrapper_.set_supports_job_events(supports_job_events);
+    tracker_ = std::make_unique<CupsJobTracker>(
+        &cups_wrapper_, base::BindRepeating(&CupsJobTrackerTest::OnQuery,
+                                            base::Unretained(this)));
+  }
+
+  // Returns the queries made since the last call.
+  std::vector<std::vector<std::string>> TakeQueries() {
+    return std::move(queries_);
+  }
+
+  void OnQuery(const std::vector<std::string>& printer_ids) {
+    queries_.push_back(printer_ids);
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  chromeos::TestCupsWrapper cups_wrapper_;
+  std::vector<std::vector<std::string>> queries_;
+  std::unique_ptr<CupsJobTracker> tracker_;
+};
+
+TEST_F(CupsJobTrackerTest, PollsPrintersWithoutJobEvents) {
+  CreateTracker(/*supports_job_events=*/false);
+
+  tracker_->AddPrinter("printer");
+  task_environment_.RunUntilIdle();
+  EXPECT_THAT(TakeQueries(), ElementsAre(ElementsAre("printer")));
+  EXPECT_FALSE(cups_wrapper_.IsSubscribedToJobEvents("printer"));
+
+  task_environment_.FastForwardBy(CupsJobTracker::kPollRate);
+  EXPECT_THAT(TakeQueries(), ElementsAre(ElementsAre("printer")));
+}
+
+TEST_F(CupsJobTrackerTest, QueriesOnJobEvents) {
+  CreateTracker(/*supports_job_events=*/true);
+
+  tracker_->AddPrinter("printer1");
+  tracker_->AddPrinter("printer2");
+  task_environment_.RunUntilIdle();
+  EXPECT_THAT(TakeQueries(), ElementsAre(ElementsAre("printer1"),
+                                         ElementsAre("printer2")));
+  EXPECT_TRUE(cups_wrapper_.IsSubscribedToJobEvents("printer1"));
+  EXPECT_TRUE(cups_wrapper_.IsSubscribedToJobEvents("printer2"));
+
+  // Subscribed printers are not polled at the regular rate.
+  task_environment_.FastForwardBy(CupsJobTracker::kPollRate * 2);
+  EXPECT_THAT(TakeQueries(), IsEmpty());
+
+  // Only the printers with job events are queried.
+  cups_wrapper_.EmitJobEvents({"printer2"});
+  EXPECT_THAT(TakeQueries(), ElementsAre(ElementsAre("printer2")));
+
+  // All printers are polled at the fallback rate.
+  task_environment_.FastForwardBy(CupsJobTracker::kFallbackPollRate);
+  EXPECT_THAT(TakeQueries(), ElementsAre(ElementsAre("printer1", "printer2")));
+}
+
+TEST_F(CupsJobTrackerTest, PollsUntilJobEventsAreWatched) {
+  CreateTracker(/*supports_job_events=*/true);
+  cups_wrapper_.set_defer_job_event_subscriptions(true);
+
+  tracker_->AddPrinter("printer");
+  task_environment_.RunUntilIdle();
+  EXPECT_THAT(TakeQueries(), ElementsAre(ElementsAre("printer")));
+
+  // The printer is subscribed, but no request waits for its job events yet,
+  // so it is still polled at the regular rate.
+  task_environment_.FastForwardBy(CupsJobTracker::kPollRate);
+  EXPECT_THAT(TakeQueries(), ElementsAre(ElementsAre("printer")));
+
+  // Once its job events are waited for, it is only polled at the fallback
+  // rate.
+  cups_wrapper_.CompleteJobEventSubscriptions();
+  task_environment_.FastForwardBy(CupsJobTracker::kFallbackPollRate -
+                                  CupsJobTracker::kPollRate);
+  EXPECT_THAT(TakeQueries(), IsEmpty());
+  task_environment_.FastForwardBy(CupsJobTracker::kPollRate);
+  EXPECT_THAT(TakeQueries(), ElementsAre(ElementsAre("printer")));
+}
+
+TEST_F(CupsJobTrackerTest, BacksOffAfterFailedQueries) {
+  CreateTracker(/*supports_job_events=*/false);
+
+  tracker_->AddPrinter("printer");
+  task_environment_.RunUntilIdle();
+  TakeQueries();
+
+  tracker_->OnQueryFailed(/*failure_count=*/3);
+  task_environment_.FastForwardBy(CupsJobTracker::kPollRate * 2);
+  EXPECT_THAT(TakeQueries(), IsEmpty());
+  task_environment_.FastForwardBy(CupsJobTracker::kPollRate);
+  EXPECT_THAT(TakeQueries(), ElementsAre(ElementsAre("printer")));
+}
+
+TEST_F(CupsJobTrackerTest, RestoresPollRateAfterSuccessfulQuery) {
+  CreateTracker(/*supports_job_events=*/true);
+
+  tracker_->AddPrinter("printer");
+  task_environment_.RunUntilIdle();
+  TakeQueries();
+
+  tracker_->OnQueryFailed(/*failure_count=*/1);
+  task_environment_.FastForwardBy(CupsJobTracker::kPollRate);
+  EXPECT_THAT(TakeQueries(), ElementsAre(ElementsAre("printer")));
+
+  // Once a query succeeds, the subscribed printer is only polled at the
+  // fallback rate again.
+  tracker_->OnQuerySucceeded();
+  task_environment_.FastForwardBy(CupsJobTracker::kFallbackPollRate -
+                                  CupsJobTracker::kPollRate);
+  EXPECT_THAT(TakeQueries(), IsEmpty());
+  task_environment_.FastForwardBy(CupsJobTracker::kPollRate);
+  EXPECT_THAT(TakeQueries(), ElementsAre(ElementsAre("printer")));
+}
+
+TEST_F(CupsJobTrackerTest, RemovePrinter) {
+  CreateTracker(/*supports_job_events=*/true);
+
+  tracker_->AddPrinter("printer");
+  task_environment_.RunUntilIdle();
+  TakeQueries();
+
+  tracker_->RemovePrinter("printer");
+  EXPECT_FALSE(tracker_->IsTracking("printer"));
+  EXPECT_FALSE(cups_wrapper_.IsSubscribedToJobEvents("printer"));
+
+  cups_wrapper_.EmitJobEvents({"printer"});
+  task_environment_.FastForwardBy(CupsJobTracker::kFallbackPollRate);
+  EXPECT_THAT(TakeQueries(), IsEmpty());
+}
+
+TEST_F(CupsJobTrackerTest, UnsubscribesOnDestruction) {
+  CreateTracker(/*supports_job_events=*/true);
+
+  tracker_->AddPrinter("printer");
+  EXPECT_TRUE(cups_wrapper_.IsSubscribedToJobEvents("printer"));
+
+  tracker_.reset();
+  EXPECT_FALSE(cups_wrapper_.IsSubscribedToJobEvents("printer"));
+}
+
+}  // namespace
+}  // namespace ash
@@ -18,10 +18,10 @@
 #include "base/metrics/histogram_functions.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/notreached.h"
+#include "base/ranges/algorithm.h"
 #include "base/strings/strcat.h"
 #include "base/strings/utf_string_conversions.h"
-#include "base/time/time.h"
-#include "base/timer/timer.h"
+#include "chrome/browser/ash/printing/cups_job_tracker.h"
 #include "chrome/browser/ash/printing/cups_print_job.h"
 #include "chrome/browser/ash/printing/cups_print_job_manager.h"
 #include "chrome/browser/ash/printing/cups_print_job_manager_utils.h"
@@ -40,7 +40,6 @@
 #include "chromeos/ash/components/scalable_iph/scalable_iph.h"
 #include "chromeos/printing/printing_constants.h"
 #include "content/public/browser/browser_context.h"
-#include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "printing/printed_document.h"
 #include "printing/printing_utils.h"
@@ -53,9 +52,6 @@ namespace {
 using ::chromeos::CupsWrapper;
 using StatusReason = crosapi::mojom::StatusReason::Reason;
 
-// The rate at which we will poll CUPS for print job updates.
-constexpr base::TimeDelta kPollRate = base::Milliseconds(1000);
-
 // Threshold for giving up on communicating with CUPS.
 const int kRetryMax = 6;
 
@@ -109,6 +105,12 @@ class CupsPrintJobManagerImpl : public CupsPrintJobManager {
   explicit CupsPrintJobManagerImpl(Profile* profile)
       : CupsPrintJobManager(profile),
         cups_wrapper_(CupsWrapper::Create()),
+        // NOTE: base::Unretained(this) is safe here because this object owns
+        // |job_tracker_|.
+        job_tracker_(
+            cups_wrapper_.get(),
+            base::BindRepeating(&CupsPrintJobManagerImpl::QueryPrinters,
+                                base::Unretained(this))),
         weak_ptr_factory_(this) {
     // NOTE: base::Unretained(this) is safe here because this object owns
     // |subscription_| and the callback won't be invoked after |subscription_|
@@ -116,7 +118,6 @@ class CupsPrintJobManagerImpl : public CupsPrintJobManager {
     subscription_ = g_browser_process->print_job_manager()->AddDocDoneCallback(
         base::BindRepeating(&CupsPrintJobManagerImpl::OnDocDone,
                             base::Unretained(this)));
-    timer_.SetTaskRunner(content::GetUIThreadTaskRunner({}));
   }
 
   CupsPrintJobManagerImpl(const CupsPrintJobManagerImpl&) = delete;
@@ -228,12 +229,8 @@ class CupsPrintJobManagerImpl : public CupsPrintJobManager {
     job->set_state(CupsPrintJob::State::STATE_WAITING);
     NotifyJobUpdated(job->GetWeakPtr());
 
-    // Run a query now.
-    content::GetUIThreadTaskRunner({})->PostTask(
-        FROM_HERE, base::BindOnce(&CupsPrintJobManagerImpl::PostQuery,
-                                  weak_ptr_factory_.GetWeakPtr()));
-    // Start the timer for ongoing queries.
-    ScheduleQuery();
+    // Run a query now, and keep tracking the queue of the printer.
+    job_tracker_.AddPrinter(job->printer().id());
 
     return true;
   }
@@ -248,37 +245,36 @@ class CupsPrintJobManagerImpl : public CupsPrintJobManager {
     const std::string unique_id = job->GetUniqueId();
     jobs_.erase(unique_id);
     printer_metrics_cache_.erase(unique_id);
+    if (!HasJobsForPrinter(printer_id)) {
+      job_tracker_.RemovePrinter(printer_id);
+    }
 
     cups_wrapper_->CancelJob(printer_id, job_id);
   }
 
-  // Schedule a query of CUPS for print job status with a delay of |delay|.
-  void ScheduleQuery(int attempt_count = 1) {
-    timer_.Start(FROM_HERE, kPollRate * attempt_count,
-                 base::BindRepeating(&CupsPrintJobManagerImpl::PostQuery,
-                                     weak_ptr_factory_.GetWeakPtr()));
+  bool HasJobsForPrinter(const std::string& printer_id) const {
+    return base::ranges::any_of(jobs_, [&printer_id](const auto& entry) {
+      return entry.second->printer().id() == printer_id;
+    });
   }
 
-  void PostQuery() {
+  // Queries CUPS for the jobs of |printer_ids|, as decided by |job_tracker_|.
+  void QueryPrinters(const std::vector<std::string>& printer_ids) {
     DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
-    // The set of active printers is expected to be small.
-    std::set<std::string> printer_ids;
-    for (const auto& entry : jobs_) {
-      printer_ids.insert(entry.second->printer().id());
-    }
-    std::vector<std::string> ids{printer_ids.begin(), printer_ids.end()};
-
     cups_wrapper_->QueryCupsPrintJobs(
-        ids, base::BindOnce(&CupsPrintJobManagerImpl::UpdateJobs,
-                            weak_ptr_factory_.GetWeakPtr()));
+        printer_ids,
+        base::BindOnce(&CupsPrintJobManagerImpl::UpdateJobs,
+                       weak_ptr_factory_.GetWeakPtr(), printer_ids));
   }
 
   // Process jobs from CUPS and perform notifications.
   // Use job information to update local job states.  Previously completed jobs
   // could be in |jobs| but those are ignored as we will not emit updates for
-  // them after they are completed.
-  void UpdateJobs(std::unique_ptr<CupsWrapper::QueryResult> result) {
+  // them after they are completed. |printer_ids| are the printers which were
+  // queried.
+  void UpdateJobs(const std::vector<std::string>& printer_ids,
+                  std::unique_ptr<CupsWrapper::QueryResult> result) {
     DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
     // If the query failed, either retry or purge.
@@ -288,20 +284,21 @@ class CupsPrintJobManagerImpl : public CupsPrintJobManager {
                    << retry_count_ << ")";
       if (retry_count_ > kRetryMax) {
         LOG(ERROR) << "CUPS is unreachable.  Giving up on all jobs.";
-        timer_.Stop();
         PurgeJobs();
       } else {
         // Backoff the polling frequency. Give CUPS a chance to recover.
-        DCHECK_GE(1, retry_count_);
-        ScheduleQuery(retry_count_);
+        job_tracker_.OnQueryFailed(retry_count_);
       }
       return;
     }
 
-    // A query has completed.  Reset retry counter.
-    retry_count_ = 0;
+    // A query has completed.  Reset retry counter and the poll rate.
+    if (retry_count_ > 0) {
+      retry_count_ = 0;
+      job_tracker_.OnQuerySucceeded();
+    }
 
-    std::vector<std::string> active_jobs;
+    std::set<std::string> active_printers;
     for (const auto& queue : result->queues) {
       for (auto& job : queue.jobs) {
         std::string key = CupsPrintJob::CreateUniqueId(job.printer_id, job.id);
@@ -341,20 +338,20 @@ class CupsPrintJobManagerImpl : public CupsPrintJobManager {
           jobs_.erase(entry);
           printer_metrics_cache_.erase(key);
         } else {
-          active_jobs.push_back(key);
+          active_printers.insert(job.printer_id);
         }
       }
     }
 
-    if (active_jobs.empty()) {
-      // CUPS has stopped reporting jobs.  Stop polling.
-      timer_.Stop();
-      if (!jobs_.empty()) {
-        // We're tracking jobs that we didn't receive an update for.  Something
-        // bad has happened.
-        LOG(ERROR) << "Lost track of (" << jobs_.size() << ") jobs";
-        PurgeJobs();
+    for (const std::string& printer_id : printer_ids) {
+      if (active_printers.contains(printer_id)) {
+        continue;
       }
+      // CUPS has stopped reporting jobs for the printer.  Stop tracking it.
+      job_tracker_.RemovePrinter(printer_id);
+      // We're tracking jobs that we didn't receive an update for.  Something
+      // bad has happened.
+      PurgePrinterJobs(printer_id);
     }
   }
 
@@ -362,18 +359,42 @@ class CupsPrintJobManagerImpl : public CupsPrintJobManager {
   void PurgeJobs() {
     DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
+    job_tracker_.RemoveAllPrinters();
     for (const auto& entry : jobs_) {
       // Declare all lost jobs errors.
-      CupsPrintJob* job = entry.second.get();
-      RecordJobResult(LOST, job->printer().AffectedByIppUsbMigration());
-      job->set_state(CupsPrintJob::State::STATE_FAILED);
-      NotifyJobStateUpdate(job->GetWeakPtr());
+      MarkJobLost(entry.second.get());
     }
 
     jobs_.clear();
     printer_metrics_cache_.clear();
   }
 
+  // Mark the remaining jobs of |printer_id| as errors and remove them.
+  void PurgePrinterJobs(const std::string& printer_id) {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+    size_t lost_jobs = 0;
+    for (auto it = jobs_.begin(); it != jobs_.end();) {
+      if (it->second->printer().id() != printer_id) {
+        ++it;
+        continue;
+      }
+      MarkJobLost(it->second.get());
+      printer_metrics_cache_.erase(it->first);
+      it = jobs_.erase(it);
+      ++lost_jobs;
+    }
+    if (lost_jobs) {
+      LOG(ERROR) << "Lost track of (" << lost_jobs << ") jobs";
+    }
+  }
+
+  void MarkJobLost(CupsPrintJob* job) {
+    RecordJobResult(LOST, job->printer().AffectedByIppUsbMigration());
+    job->set_state(CupsPrintJob::State::STATE_FAILED);
+    NotifyJobStateUpdate(job->GetWeakPtr());
+  }
+
   // Notify observers that a state update has occurred for |job|.
   void NotifyJobStateUpdate(base::WeakPtr<CupsPrintJob> job) {
     DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
@@ -533,8 +554,9 @@ class CupsPrintJobManagerImpl : public CupsPrintJobManager {
   // record the metrics entry to histograms and remove it from the map.
   base::flat_map<std::string, PrinterMetrics> printer_metrics_cache_;
 
-  base::RepeatingTimer timer_;
   std::unique_ptr<CupsWrapper> cups_wrapper_;
+  // Decides when the queues of printers with active jobs are queried.
+  CupsJobTracker job_tracker_;
   ::printing::PrintJobManager::DocDoneCallbackList::Subscription subscription_;
   base::WeakPtrFactory<CupsPrintJobManagerImpl> weak_ptr_factory_;
 };
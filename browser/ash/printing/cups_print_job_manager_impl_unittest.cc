@@ -0,0 +1,173 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/memory/raw_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/test/bind.h"
+#include "chrome/browser/ash/login/users/fake_chrome_user_manager.h"
+#include "chrome/browser/ash/printing/cups_job_tracker.h"
+#include "chrome/browser/ash/printing/cups_print_job.h"
+#include "chrome/browser/ash/printing/cups_print_job_manager.h"
+#include "chrome/browser/ash/printing/cups_printers_manager_factory.h"
+#include "chrome/browser/ash/printing/fake_cups_printers_manager.h"
+#include "chrome/browser/ash/printing/history/print_job_info.pb.h"
+#include "chrome/browser/ash/profiles/profile_helper.h"
+#include "chrome/browser/chromeos/printing/test_cups_wrapper.h"
+#include "chrome/browser/notifications/notification_display_service_tester.h"
+#include "chrome/browser/printing/print_job.h"
+#include "chrome/test/base/testing_browser_process.h"
+#include "chrome/test/base/testing_profile.h"
+#include "chrome/test/base/testing_profile_manager.h"
+#include "chromeos/printing/printer_configuration.h"
+#include "components/account_id/account_id.h"
+#include "components/user_manager/scoped_user_manager.h"
+#include "content/public/test/browser_task_environment.h"
+#include "printing/backend/cups_jobs.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace ash {
+namespace {
+
+using ::printing::CupsJob;
+
+constexpr char kPrinterId[] = "printer";
+constexpr char kUserEmail[] = "user@example.com";
+constexpr int kJobId = 1;
+constexpr int kTotalPages = 2;
+
+CupsJob CreateCupsJob(CupsJob::JobState state, int current_pages) {
+  CupsJob job;
+  job.id = kJobId;
+  job.printer_id = kPrinterId;
+  job.state = state;
+  job.current_pages = current_pages;
+  return job;
+}
+
+// Records the jobs which reached a final state.
+class TestJobObserver : public CupsPrintJobManager::Observer {
+ public:
+  void OnPrintJobDone(base::WeakPtr<CupsPrintJob> job) override {
+    ++done_count_;
+  }
+
+  int done_count() const { return done_count_; }
+
+ private:
+  int done_count_ = 0;
+};
+
+class CupsPrintJobManagerImplTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    chromeos::CupsWrapper::SetCupsWrapperFactoryForTesting(
+        base::BindLambdaForTesting(
+            [this]() -> std::unique_ptr<chromeos::CupsWrapper> {
+              auto cups_wrapper = std::make_unique<chromeos::TestCupsWrapper>();
+              cups_wrapper->set_supports_job_events(true);
+              cups_wrapper_ = cups_wrapper.get();
+              return cups_wrapper;
+            }));
+
+    // Print jobs are tracked for the printers of the primary user.
+    ASSERT_TRUE(profile_manager_.SetUp());
+    const AccountId account_id = AccountId::FromUserEmail(kUserEmail);
+    fake_user_manager_->AddUser(account_id);
+    fake_user_manager_->LoginUser(account_id);
+    profile_ = profile_manager_.CreateTestingProfile(kUserEmail);
+    fake_user_manager_->OnUserProfileCreated(account_id, profile_->GetPrefs());
+    ProfileHelper::Get()->SetUserToProfileMappingForTesting(
+        fake_user_manager_->GetPrimaryUser(), profile_);
+    CupsPrintersManagerFactory::GetInstance()->SetTestingFactoryAndUse(
+        profile_,
+        base::BindLambdaForTesting([](content::BrowserContext* context)
+                                       -> std::unique_ptr<KeyedService> {
+          auto printers_manager = std::make_unique<FakeCupsPrintersManager>();
+          printers_manager->AddPrinter(chromeos::Printer(kPrinterId),
+                                       chromeos::PrinterClass::kSaved);
+          return printers_manager;
+        }));
+    display_service_ =
+        std::make_unique<NotificationDisplayServiceTester>(profile_);
+
+    manager_.reset(CupsPrintJobManager::CreateInstance(profile_));
+    manager_->AddObserver(&observer_);
+  }
+
+  void TearDown() override {
+    manager_->RemoveObserver(&observer_);
+    manager_->Shutdown();
+    cups_wrapper_ = nullptr;
+    manager_.reset();
+    chromeos::CupsWrapper::SetCupsWrapperFactoryForTesting(
+        base::NullCallback());
+  }
+
+  void CreatePrintJob() {
+    ASSERT_TRUE(manager_->CreatePrintJob(
+        kPrinterId, "title", kJobId, kTotalPages,
+        ::printing::PrintJob::Source::kUnknown, /*source_id=*/"",
+        printing::proto::PrintSettings()));
+  }
+
+  content::BrowserTaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  user_manager::TypedScopedUserManager<FakeChromeUserManager>
+      fake_user_manager_{std::make_unique<FakeChromeUserManager>()};
+  TestingProfileManager profile_manager_{TestingBrowserProcess::GetGlobal()};
+  raw_ptr<TestingProfile> profile_ = nullptr;
+  std::unique_ptr<NotificationDisplayServiceTester> display_service_;
+  raw_ptr<chromeos::TestCupsWrapper> cups_wrapper_ = nullptr;
+  TestJobObserver observer_;
+  std::unique_ptr<CupsPrintJobManager> manager_;
+};
+
+TEST_F(CupsPrintJobManagerImplTest, UpdatesJobsOnJobEvents) {
+  cups_wrapper_->set_query_succeeds(true);
+  cups_wrapper_->SetJobs(kPrinterId, {CreateCupsJob(CupsJob::PROCESSING, 0)});
+  CreatePrintJob();
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(1, cups_wrapper_->query_count());
+  EXPECT_TRUE(cups_wrapper_->IsSubscribedToJobEvents(kPrinterId));
+
+  // The job completes without polling, as soon as CUPS reports the event.
+  cups_wrapper_->SetJobs(kPrinterId,
+                         {CreateCupsJob(CupsJob::COMPLETED, kTotalPages)});
+  cups_wrapper_->EmitJobEvents({kPrinterId});
+  EXPECT_EQ(2, cups_wrapper_->query_count());
+  EXPECT_EQ(1, observer_.done_count());
+
+  // The printer has no more jobs, so it is no longer tracked.
+  EXPECT_FALSE(cups_wrapper_->IsSubscribedToJobEvents(kPrinterId));
+  cups_wrapper_->EmitJobEvents({kPrinterId});
+  task_environment_.FastForwardBy(CupsJobTracker::kFallbackPollRate);
+  EXPECT_EQ(2, cups_wrapper_->query_count());
+}
+
+TEST_F(CupsPrintJobManagerImplTest, RestoresFallbackPollRateAfterFailure) {
+  CreatePrintJob();
+  task_environment_.RunUntilIdle();
+  ASSERT_EQ(1, cups_wrapper_->query_count());
+
+  // The failed query is retried at the backed off rate.
+  cups_wrapper_->set_query_succeeds(true);
+  cups_wrapper_->SetJobs(kPrinterId, {CreateCupsJob(CupsJob::PROCESSING, 0)});
+  task_environment_.FastForwardBy(CupsJobTracker::kPollRate);
+  ASSERT_EQ(2, cups_wrapper_->query_count());
+
+  // After the successful retry, the subscribed printer is only polled at the
+  // fallback rate.
+  task_environment_.FastForwardBy(CupsJobTracker::kFallbackPollRate -
+                                  CupsJobTracker::kPollRate);
+  EXPECT_EQ(2, cups_wrapper_->query_count());
+  task_environment_.FastForwardBy(CupsJobTracker::kPollRate);
+  EXPECT_EQ(3, cups_wrapper_->query_count());
+}
+
+}  // namespace
+}  // namespace ash
@@ -138,6 +138,14 @@ class CupsPrintersManagerImpl
   // class observes.
   enum DetectorIds { kUsbDetector, kZeroconfDetector, kPrintServerDetector };
 
+  // The printers which changed in a class, see
+  // Observer::OnPrinterClassUpdated().
+  struct PrinterClassDelta {
+    std::vector<Printer> added_or_updated;
+    std::vector<std::string> removed_ids;
+  };
+  using PrinterClassDeltas = std::map<PrinterClass, PrinterClassDelta>;
+
   CupsPrintersManagerImpl(
       SyncedPrintersManager* synced_printers_manager,
       std::unique_ptr<PrinterDetector> usb_detector,
@@ -194,9 +202,16 @@ class CupsPrintersManagerImpl
                             weak_ptr_factory_.GetWeakPtr(), kUsbDetector));
     OnPrintersFound(kUsbDetector, usb_detector_->GetPrinters());
 
-    zeroconf_detector_->RegisterPrintersFoundCallback(
-        base::BindRepeating(&CupsPrintersManagerImpl::OnPrintersFound,
-                            weak_ptr_factory_.GetWeakPtr(), kZeroconfDetector));
+    // Zeroconf detections can number in the thousands on large networks, so
+    // take them as deltas when the detector supports it.
+    if (!zeroconf_detector_->RegisterPrintersChangedCallback(
+            base::BindRepeating(
+                &CupsPrintersManagerImpl::OnZeroconfPrintersChanged,
+                weak_ptr_factory_.GetWeakPtr()))) {
+      zeroconf_detector_->RegisterPrintersFoundCallback(base::BindRepeating(
+          &CupsPrintersManagerImpl::OnPrintersFound,
+          weak_ptr_factory_.GetWeakPtr(), kZeroconfDetector));
+    }
     OnPrintersFound(kZeroconfDetector, zeroconf_detector_->GetPrinters());
 
     // TODO(b/192467856) Remove this metric gathering by M99
@@ -379,7 +394,11 @@ class CupsPrintersManagerImpl
         usb_detections_ = printers;
         break;
       case kZeroconfDetector:
-        zeroconf_detections_ = printers;
+        zeroconf_detections_.clear();
+        for (const PrinterDetector::DetectedPrinter& detected : printers) {
+          zeroconf_detections_.insert_or_assign(detected.printer.id(),
+                                                detected);
+        }
         // Start timer for recording the # of nearby printers.
         nearby_printers_metric_delay_timer_.Reset();
         break;
@@ -390,6 +409,32 @@ class CupsPrintersManagerImpl
     RebuildDetectedLists();
   }
 
+  // Delta callback for the zeroconf detector.  Unlike OnPrintersFound(), only
+  // the changed printers are reclassified, and only the classes they moved in
+  // or out of are notified.
+  void OnZeroconfPrintersChanged(
+      const PrinterDetector::DetectedPrintersDelta& delta) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_);
+    base::flat_set<std::string> changed_ids;
+    for (const std::string& id : delta.removed_ids) {
+      zeroconf_detections_.erase(id);
+      changed_ids.insert(id);
+    }
+    for (const PrinterDetector::DetectedPrinter& detected :
+         delta.added_or_updated) {
+      zeroconf_detections_.insert_or_assign(detected.printer.id(), detected);
+      changed_ids.insert(detected.printer.id());
+    }
+    // Start timer for recording the # of nearby printers.
+    nearby_printers_metric_delay_timer_.Reset();
+
+    PrinterClassDeltas deltas;
+    for (const std::string& id : changed_ids) {
+      ReclassifyNetworkPrinter(id, deltas);
+    }
+    NotifyObserversOfDeltas(deltas);
+  }
+
   // Callback for PrintServersManager.
   void OnServerPrintersChanged(
       const std::vector<PrinterDetector::DetectedPrinter>& printers) override {
@@ -616,10 +661,8 @@ class CupsPrintersManagerImpl
     size_t total_network_printers_count = zeroconf_detections_.size();
     // Count detected network printers that have not been saved
     size_t nearby_zeroconf_printers_count = 0;
-    for (const PrinterDetector::DetectedPrinter& detected :
-         zeroconf_detections_) {
-      if (!printers_.IsPrinterInClass(PrinterClass::kSaved,
-                                      detected.printer.id())) {
+    for (const auto& [printer_id, detected] : zeroconf_detections_) {
+      if (!printers_.IsPrinterInClass(PrinterClass::kSaved, printer_id)) {
         ++nearby_zeroconf_printers_count;
       }
     }
@@ -781,6 +824,22 @@ class CupsPrintersManagerImpl
     }
   }
 
+  // Notify observers of the classes in |deltas| of the printers which changed
+  // in them.
+  void NotifyObserversOfDeltas(const PrinterClassDeltas& deltas) {
+    for (const auto& [printer_class, delta] : deltas) {
+      PRINTER_LOG(DEBUG) << "Sending notification for "
+                         << delta.added_or_updated.size() << " updated and "
+                         << delta.removed_ids.size()
+                         << " removed printers in class ("
+                         << ToString(printer_class) << ")";
+      for (auto& observer : observer_list_) {
+        observer.OnPrinterClassUpdated(printer_class, delta.added_or_updated,
+                                       delta.removed_ids);
+      }
+    }
+  }
+
   // Notify observers that a local printer has updated.
   void NotifyLocalPrinterObservers() {
     for (auto& observer : local_printers_observer_list_) {
@@ -793,11 +852,26 @@ class CupsPrintersManagerImpl
   const PrinterDetector::DetectedPrinter* FindDetectedPrinter(
       const std::string& id) const {
     DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_);
-    for (const auto* printer_list : {&usb_detections_, &zeroconf_detections_}) {
-      for (const auto& detected : *printer_list) {
-        if (detected.printer.id() == id) {
-          return &detected;
-        }
+    for (const auto& detected : usb_detections_) {
+      if (detected.printer.id() == id) {
+        return &detected;
+      }
+    }
+    auto it = zeroconf_detections_.find(id);
+    return it != zeroconf_detections_.end() ? &it->second : nullptr;
+  }
+
+  // Returns the network detected printer with the given id, or null.
+  const PrinterDetector::DetectedPrinter* FindDetectedNetworkPrinter(
+      const std::string& id) const {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_);
+    auto it = zeroconf_detections_.find(id);
+    if (it != zeroconf_detections_.end()) {
+      return &it->second;
+    }
+    for (const auto& detected : servers_detections_) {
+      if (detected.printer.id() == id) {
+        return &detected;
       }
     }
     return nullptr;
@@ -881,60 +955,100 @@ class CupsPrintersManagerImpl
     }
   }
 
-  void AddDetectedNetworkPrinters(
-      const std::vector<PrinterDetector::DetectedPrinter>& detected_list) {
+  void AddDetectedNetworkPrinter(
+      const PrinterDetector::DetectedPrinter& detected) {
     DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_);
-    for (const PrinterDetector::DetectedPrinter& detected : detected_list) {
-      const std::string& detected_printer_id = detected.printer.id();
-      if (printers_.IsPrinterInClass(PrinterClass::kSaved,
-                                     detected_printer_id)) {
-        // It's already in the saved class, don't need to do anything else here.
-        continue;
-      }
+    Printer printer;
+    if (std::optional<PrinterClass> printer_class =
+            ClassifyDetectedNetworkPrinter(detected, &printer)) {
+      AddPrinterToPrintersMap(*printer_class, printer);
+    }
+  }
 
-      // Sometimes the detector can flag a printer as IPP-everywhere compatible;
-      // those printers can go directly into the automatic class without further
-      // processing.
-      auto printer = detected.printer;
-      if (printer.IsIppEverywhere()) {
-        AddPrinterToPrintersMap(PrinterClass::kAutomatic, printer);
-        continue;
-      }
+  // Returns the class the network detected printer belongs in, and sets
+  // |printer| to the printer to add to it.  Returns nullopt if the printer is
+  // saved, or if its class is not known until its PPD reference is resolved.
+  std::optional<PrinterClass> ClassifyDetectedNetworkPrinter(
+      const PrinterDetector::DetectedPrinter& detected,
+      Printer* printer) {
+    const std::string& detected_printer_id = detected.printer.id();
+    if (printers_.IsPrinterInClass(PrinterClass::kSaved, detected_printer_id)) {
+      // It's already in the saved class, don't need to do anything else here.
+      return std::nullopt;
+    }
 
-      if (!ppd_resolution_tracker_.IsResolutionComplete(detected_printer_id)) {
-        // Didn't find an entry for this printer in the PpdReferences cache.  We
-        // need to ask PpdProvider whether or not it can determine a
-        // PpdReference.  If there's not already an outstanding request for one,
-        // start one.  When the request comes back, we'll rerun classification
-        // and then should be able to figure out where this printer belongs.
-        if (!ppd_resolution_tracker_.IsResolutionPending(detected_printer_id)) {
-          ppd_resolution_tracker_.MarkResolutionPending(detected_printer_id);
-          ppd_provider_->ResolvePpdReference(
-              detected.ppd_search_data,
-              base::BindOnce(&CupsPrintersManagerImpl::ResolvePpdReferenceDone,
-                             weak_ptr_factory_.GetWeakPtr(),
-                             detected_printer_id));
-        }
-        continue;
-      }
-      if (ppd_resolution_tracker_.WasResolutionSuccessful(
-              detected_printer_id)) {
-        // We have a ppd reference, so we think we can set this up
-        // automatically.
-        *printer.mutable_ppd_reference() =
-            ppd_resolution_tracker_.GetPpdReference(detected_printer_id);
-        AddPrinterToPrintersMap(PrinterClass::kAutomatic, printer);
-        continue;
+    // Sometimes the detector can flag a printer as IPP-everywhere compatible;
+    // those printers can go directly into the automatic class without further
+    // processing.
+    *printer = detected.printer;
+    if (printer->IsIppEverywhere()) {
+      return PrinterClass::kAutomatic;
+    }
+
+    if (!ppd_resolution_tracker_.IsResolutionComplete(detected_printer_id)) {
+      // Didn't find an entry for this printer in the PpdReferences cache.  We
+      // need to ask PpdProvider whether or not it can determine a
+      // PpdReference.  If there's not already an outstanding request for one,
+      // start one.  When the request comes back, we'll rerun classification
+      // and then should be able to figure out where this printer belongs.
+      if (!ppd_resolution_tracker_.IsResolutionPending(detected_printer_id)) {
+        ppd_resolution_tracker_.MarkResolutionPending(detected_printer_id);
+        ppd_provider_->ResolvePpdReference(
+            detected.ppd_search_data,
+            base::BindOnce(&CupsPrintersManagerImpl::ResolvePpdReferenceDone,
+                           weak_ptr_factory_.GetWeakPtr(),
+                           detected_printer_id));
       }
+      return std::nullopt;
+    }
+    if (ppd_resolution_tracker_.WasResolutionSuccessful(detected_printer_id)) {
+      // We have a ppd reference, so we think we can set this up
+      // automatically.
+      *printer->mutable_ppd_reference() =
+          ppd_resolution_tracker_.GetPpdReference(detected_printer_id);
+      return PrinterClass::kAutomatic;
+    }
+
+    // We are not able to set the printer up automatically.
+    return PrinterClass::kDiscovered;
+  }
+
+  // Moves the network printer with the given id into the class matching its
+  // current detection, or out of the detected classes if it is no longer
+  // detected, and records the change in |deltas|.  Printers in any other
+  // class are left alone.
+  void ReclassifyNetworkPrinter(const std::string& id,
+                                PrinterClassDeltas& deltas) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_);
+    const std::optional<PrinterClass> current_class =
+        printers_.GetPrinterClass(id);
+    if (current_class && *current_class != PrinterClass::kAutomatic &&
+        *current_class != PrinterClass::kDiscovered) {
+      return;
+    }
 
-      // We are not able to set the printer up automatically.
-      AddPrinterToPrintersMap(PrinterClass::kDiscovered, printer);
+    Printer printer;
+    const PrinterDetector::DetectedPrinter* detected =
+        FindDetectedNetworkPrinter(id);
+    const std::optional<PrinterClass> printer_class =
+        detected ? ClassifyDetectedNetworkPrinter(*detected, &printer)
+                 : std::nullopt;
+    if (current_class && current_class != printer_class) {
+      if (!printer_class) {
+        printers_.Remove(*current_class, id);
+      }
+      deltas[*current_class].removed_ids.push_back(id);
+    }
+    if (printer_class) {
+      AddPrinterToPrintersMap(*printer_class, printer);
+      deltas[*printer_class].added_or_updated.push_back(
+          *printers_.Get(*printer_class, id));
     }
   }
 
   void AddPrinterToPrintersMap(PrinterClass printer_class,
                                const Printer& printer) {
-    printers_.Insert(printer_class, printer);
+    printers_.InsertOrUpdate(printer_class, printer);
 
     if (base::FeatureList::IsEnabled(::features::kLocalPrinterObserving)) {
       // If we've seen this printer before, don't trigger a new detection event.
@@ -999,8 +1113,13 @@ class CupsPrintersManagerImpl
     DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_);
     ResetNearbyPrintersLists();
     AddDetectedUsbPrinters(usb_detections_);
-    AddDetectedNetworkPrinters(zeroconf_detections_);
-    AddDetectedNetworkPrinters(servers_detections_);
+    for (const auto& [printer_id, detected] : zeroconf_detections_) {
+      AddDetectedNetworkPrinter(detected);
+    }
+    for (const PrinterDetector::DetectedPrinter& detected :
+         servers_detections_) {
+      AddDetectedNetworkPrinter(detected);
+    }
     NotifyObservers({PrinterClass::kAutomatic, PrinterClass::kDiscovered});
   }
 
@@ -1034,7 +1153,9 @@ class CupsPrintersManagerImpl
         ppd_resolution_tracker_.SetManufacturer(printer_id, usb_manufacturer);
       }
     }
-    RebuildDetectedLists();
+    PrinterClassDeltas deltas;
+    ReclassifyNetworkPrinter(printer_id, deltas);
+    NotifyObserversOfDeltas(deltas);
   }
 
   // Callback for `SetUpPrinterInCups`.
@@ -1088,9 +1209,10 @@ class CupsPrintersManagerImpl
 
   SEQUENCE_CHECKER(sequence_);
 
-  // Source lists for detected printers.
+  // Source lists for detected printers.  Zeroconf detections are keyed by
+  // printer id, so that deltas apply without scanning the whole list.
   std::vector<PrinterDetector::DetectedPrinter> usb_detections_;
-  std::vector<PrinterDetector::DetectedPrinter> zeroconf_detections_;
+  std::map<std::string, PrinterDetector::DetectedPrinter> zeroconf_detections_;
   std::vector<PrinterDetector::DetectedPrinter> servers_detections_;
 
   // Not owned.
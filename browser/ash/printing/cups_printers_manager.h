@@ -54,6 +54,15 @@ class CupsPrintersManager : public PrinterInstallationManager,
     virtual void OnPrintersChanged(
         chromeos::PrinterClass printer_class,
         const std::vector<chromeos::Printer>& printers) {}
+    // Printers in this class were added, updated or removed.  Called instead
+    // of OnPrintersChanged() for changes which only affect a few printers, so
+    // that large classes are not copied to every observer on each change.
+    // Observers which keep a copy of a class must apply these changes to it,
+    // so there is no default.
+    virtual void OnPrinterClassUpdated(
+        chromeos::PrinterClass printer_class,
+        const std::vector<chromeos::Printer>& added_or_updated,
+        const std::vector<std::string>& removed_printer_ids) = 0;
     // It is called exactly once for each observer. It means that the
     // subsystem for enterprise printers is initialized. When an observer is
     // being registered after the subsystem's initialization, this call is
@@ -5,6 +5,8 @@
 #include "chrome/browser/ash/printing/cups_printers_manager_proxy.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/memory/raw_ptr.h"
@@ -75,6 +77,16 @@ class ProxyImpl : public CupsPrintersManagerProxy,
     }
   }
 
+  void OnPrinterClassUpdated(
+      chromeos::PrinterClass printer_class,
+      const std::vector<chromeos::Printer>& added_or_updated,
+      const std::vector<std::string>& removed_printer_ids) override {
+    for (auto& observer : observers_) {
+      observer.OnPrinterClassUpdated(printer_class, added_or_updated,
+                                     removed_printer_ids);
+    }
+  }
+
  private:
   // The manager for which we are forwarding events.
   raw_ptr<CupsPrintersManager> active_manager_ = nullptr;
@@ -5,6 +5,7 @@
 #include "chrome/browser/ash/printing/cups_printers_manager.h"
 
 #include <algorithm>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <string>
@@ -20,7 +21,9 @@
 #include "base/functional/bind.h"
 #include "base/functional/callback_helpers.h"
 #include "base/memory/raw_ptr.h"
+#include "base/ranges/algorithm.h"
 #include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
 #include "base/task/sequenced_task_runner.h"
 #include "base/test/bind.h"
 #include "base/test/metrics/histogram_tester.h"
@@ -230,12 +233,21 @@ class FakePrinterDetector : public PrinterDetector {
     on_printers_found_callback_ = std::move(cb);
   }
 
+  bool RegisterPrintersChangedCallback(OnPrintersChangedCallback cb) override {
+    on_printers_changed_callback_ = std::move(cb);
+    return true;
+  }
+
   std::vector<DetectedPrinter> GetPrinters() override { return detections_; }
 
   void AddDetections(
       const std::vector<PrinterDetector::DetectedPrinter>& new_detections) {
     detections_.insert(detections_.end(), new_detections.begin(),
                        new_detections.end());
+    if (on_printers_changed_callback_) {
+      on_printers_changed_callback_.Run({.added_or_updated = new_detections});
+      return;
+    }
     on_printers_found_callback_.Run(detections_);
   }
 
@@ -244,16 +256,26 @@ class FakePrinterDetector : public PrinterDetector {
     std::erase_if(detections_, [&ids](const DetectedPrinter& detection) {
       return base::Contains(ids, detection.printer.id());
     });
+    if (on_printers_changed_callback_) {
+      on_printers_changed_callback_.Run(
+          {.removed_ids = std::vector<std::string>(ids.begin(), ids.end())});
+      return;
+    }
     on_printers_found_callback_.Run(detections_);
   }
 
   void RunPrintersFoundCallback() {
+    if (on_printers_changed_callback_) {
+      on_printers_changed_callback_.Run({.added_or_updated = detections_});
+      return;
+    }
     on_printers_found_callback_.Run(detections_);
   }
 
  private:
   std::vector<DetectedPrinter> detections_;
   OnPrintersFoundCallback on_printers_found_callback_;
+  OnPrintersChangedCallback on_printers_changed_callback_;
 };
 
 // Fake PpdProvider backend.  This fake generates PpdReferences based on
@@ -461,6 +483,30 @@ class CupsPrintersManagerTest : public testing::Test,
   void OnPrintersChanged(PrinterClass printer_class,
                          const std::vector<Printer>& printers) override {
     observed_printers_[printer_class] = printers;
+    ++printers_changed_count_;
+  }
+
+  void OnPrinterClassUpdated(
+      PrinterClass printer_class,
+      const std::vector<Printer>& added_or_updated,
+      const std::vector<std::string>& removed_printer_ids) override {
+    std::vector<Printer>& observed = observed_printers_[printer_class];
+    for (const std::string& printer_id : removed_printer_ids) {
+      std::erase_if(observed, [&printer_id](const Printer& printer) {
+        return printer.id() == printer_id;
+      });
+    }
+    base::ranges::copy(removed_printer_ids,
+                       std::back_inserter(removed_printer_ids_[printer_class]));
+    for (const Printer& printer : added_or_updated) {
+      auto it = base::ranges::find(observed, printer.id(), &Printer::id);
+      if (it != observed.end()) {
+        *it = printer;
+      } else {
+        observed.push_back(printer);
+      }
+      updated_printer_ids_[printer_class].push_back(printer.id());
+    }
   }
 
   // Check that, for the given printer class, the printers we have from the
@@ -500,6 +546,11 @@ class CupsPrintersManagerTest : public testing::Test,
 
   // Captured printer lists from observer callbacks.
   base::flat_map<PrinterClass, std::vector<Printer>> observed_printers_;
+  int printers_changed_count_ = 0;
+
+  // Captured printer ids from OnPrinterClassUpdated() callbacks.
+  base::flat_map<PrinterClass, std::vector<std::string>> updated_printer_ids_;
+  base::flat_map<PrinterClass, std::vector<std::string>> removed_printer_ids_;
 
   // Backend fakes driving the CupsPrintersManager.
   FakeSyncedPrintersManager synced_printers_manager_;
@@ -629,6 +680,54 @@ TEST_F(CupsPrintersManagerTest, GetZeroconfPrinters) {
   ExpectPrintersInClassAre(PrinterClass::kAutomatic, {"AutomaticPrinter"});
 }
 
+// Test that on a network with many zeroconf printers, a change to a few of them
+// only reclassifies and reports those printers.
+TEST_F(CupsPrintersManagerTest, ZeroconfPrinterChurn) {
+  constexpr int kNumPrinters = 1000;
+  std::vector<PrinterDetector::DetectedPrinter> detections;
+  std::vector<std::string> automatic_ids;
+  std::vector<std::string> discovered_ids;
+  for (int i = 0; i < kNumPrinters; ++i) {
+    const std::string id = base::StringPrintf("Printer%d", i);
+    if (i % 2) {
+      detections.push_back(MakeAutomaticPrinter(id));
+      automatic_ids.push_back(id);
+    } else {
+      detections.push_back(MakeDiscoveredPrinter(id));
+      discovered_ids.push_back(id);
+    }
+  }
+  zeroconf_detector_->AddDetections(detections);
+  task_environment_.RunUntilIdle();
+  ExpectPrintersInClassAre(PrinterClass::kAutomatic, automatic_ids);
+  ExpectPrintersInClassAre(PrinterClass::kDiscovered, discovered_ids);
+
+  updated_printer_ids_.clear();
+  removed_printer_ids_.clear();
+  const int printers_changed_count = printers_changed_count_;
+  zeroconf_detector_->RemoveDetections({"Printer0", "Printer1"});
+  zeroconf_detector_->AddDetections({MakeAutomaticPrinter("NewPrinter")});
+  task_environment_.RunUntilIdle();
+
+  // The full lists are not sent again.
+  EXPECT_EQ(printers_changed_count, printers_changed_count_);
+
+  EXPECT_THAT(removed_printer_ids_[PrinterClass::kDiscovered],
+              testing::ElementsAre("Printer0"));
+  EXPECT_THAT(removed_printer_ids_[PrinterClass::kAutomatic],
+              testing::ElementsAre("Printer1"));
+  EXPECT_THAT(updated_printer_ids_[PrinterClass::kAutomatic],
+              testing::ElementsAre("NewPrinter"));
+  EXPECT_THAT(updated_printer_ids_[PrinterClass::kDiscovered],
+              testing::IsEmpty());
+
+  std::erase(discovered_ids, "Printer0");
+  std::erase(automatic_ids, "Printer1");
+  automatic_ids.push_back("NewPrinter");
+  ExpectPrintersInClassAre(PrinterClass::kAutomatic, automatic_ids);
+  ExpectPrintersInClassAre(PrinterClass::kDiscovered, discovered_ids);
+}
+
 // Test that USB printers that prefer IPP-USB end up in the automatic class
 // instead of the discovered class.
 TEST_F(CupsPrintersManagerTest, GetIppUsbPrinters) {
@@ -5,6 +5,7 @@
 #ifndef CHROME_BROWSER_ASH_PRINTING_PRINTER_DETECTOR_H_
 #define CHROME_BROWSER_ASH_PRINTING_PRINTER_DETECTOR_H_
 
+#include <string>
 #include <vector>
 
 #include "base/functional/callback.h"
@@ -28,6 +29,9 @@ namespace ash {
 // detector_->RegisterPrintersFoundCallback(cb);
 // printers_ = detector_->GetPrinters();
 //
+// Detectors which track many printers may also report changes as deltas, see
+// RegisterPrintersChangedCallback().
+//
 class CHROMEOS_EXPORT PrinterDetector {
  public:
   // The result of a detection.
@@ -39,13 +43,29 @@ class CHROMEOS_EXPORT PrinterDetector {
     chromeos::PrinterSearchData ppd_search_data;
   };
 
+  // The changes to the detected printers since the previous notification.
+  struct DetectedPrintersDelta {
+    std::vector<DetectedPrinter> added_or_updated;
+    // Ids of the printers which are no longer detected.
+    std::vector<std::string> removed_ids;
+  };
+
   using OnPrintersFoundCallback = base::RepeatingCallback<void(
       const std::vector<DetectedPrinter>& printers)>;
+  using OnPrintersChangedCallback =
+      base::RepeatingCallback<void(const DetectedPrintersDelta& delta)>;
 
   virtual ~PrinterDetector() = default;
 
   virtual void RegisterPrintersFoundCallback(OnPrintersFoundCallback cb) = 0;
 
+  // Registers |cb| to be called with the changes to the detected printers, in
+  // place of the callback registered with RegisterPrintersFoundCallback().
+  // Returns false if the detector only reports full lists of printers.
+  virtual bool RegisterPrintersChangedCallback(OnPrintersChangedCallback cb) {
+    return false;
+  }
+
   // Get the current list of known printers.
   virtual std::vector<DetectedPrinter> GetPrinters() = 0;
 };
@@ -35,10 +35,16 @@ PrintersMap::PrintersMap() = default;
 PrintersMap::~PrintersMap() = default;
 
 std::optional<Printer> PrintersMap::Get(const std::string& printer_id) const {
-  for (const auto& [printer_class, printers_map] : printers_) {
-    if (auto* printer = base::FindOrNull(printers_map, printer_id)) {
-      return *printer;
-    }
+  if (auto* printer_class = base::FindOrNull(printer_classes_, printer_id)) {
+    return Get(*printer_class, printer_id);
+  }
+  return std::nullopt;
+}
+
+std::optional<PrinterClass> PrintersMap::GetPrinterClass(
+    const std::string& printer_id) const {
+  if (auto* printer_class = base::FindOrNull(printer_classes_, printer_id)) {
+    return *printer_class;
   }
   return std::nullopt;
 }
@@ -73,6 +79,7 @@ void PrintersMap::Insert(PrinterClass printer_class, const Printer& printer) {
   DCHECK(!IsExistingPrinter(printer.id()));
 
   printers_[printer_class][printer.id()] = printer;
+  printer_classes_[printer.id()] = printer_class;
 }
 
 void PrintersMap::Insert(PrinterClass printer_class,
@@ -83,8 +90,29 @@ void PrintersMap::Insert(PrinterClass printer_class,
       cups_printer_status);
 }
 
+void PrintersMap::InsertOrUpdate(PrinterClass printer_class,
+                                 const Printer& printer) {
+  const std::optional<PrinterClass> current_class =
+      GetPrinterClass(printer.id());
+  if (current_class && *current_class != printer_class) {
+    printers_[*current_class].erase(printer.id());
+  }
+
+  Printer& entry = printers_[printer_class][printer.id()];
+  entry = printer;
+  if (auto* printer_status =
+          base::FindOrNull(printer_statuses_, printer.id())) {
+    entry.set_printer_status(*printer_status);
+  }
+  printer_classes_[printer.id()] = printer_class;
+}
+
 void PrintersMap::Clear(PrinterClass printer_class) {
-  printers_[printer_class].clear();
+  PrintersInClassMap& printers_map = printers_[printer_class];
+  for (const auto& [printer_id, printer] : printers_map) {
+    printer_classes_.erase(printer_id);
+  }
+  printers_map.clear();
 }
 
 void PrintersMap::ReplacePrintersInClass(PrinterClass printer_class,
@@ -136,6 +164,7 @@ void PrintersMap::Remove(PrinterClass printer_class,
     return;
   }
   printers_[printer_class].erase(printer_id);
+  printer_classes_.erase(printer_id);
   printer_statuses_.erase(printer_id);
 
   DCHECK(!IsExistingPrinter(printer_id));
@@ -148,7 +177,7 @@ bool PrintersMap::IsPrinterInClass(PrinterClass printer_class,
 }
 
 bool PrintersMap::IsExistingPrinter(const std::string& printer_id) const {
-  return Get(printer_id).has_value();
+  return base::Contains(printer_classes_, printer_id);
 }
 
 bool PrintersMap::SavePrinterStatus(
@@ -30,6 +30,10 @@ class PrintersMap {
   // Returns printer matching |printer_id| if found in any PrinterClass.
   std::optional<chromeos::Printer> Get(const std::string& printer_id) const;
 
+  // Returns the class of the printer matching |printer_id|, if any.
+  std::optional<chromeos::PrinterClass> GetPrinterClass(
+      const std::string& printer_id) const;
+
   // Returns printer matching |printer_id| in |printer_class|.
   std::optional<chromeos::Printer> Get(chromeos::PrinterClass printer_class,
                                        const std::string& printer_id) const;
@@ -58,6 +62,12 @@ class PrintersMap {
               const chromeos::Printer& printer,
               const chromeos::CupsPrinterStatus& cups_printer_status);
 
+  // Adds |printer| to |printer_class|, replacing the printer with the same id
+  // in any class. Adds a status to the printer if a status was previously
+  // saved in the printer status map.
+  void InsertOrUpdate(chromeos::PrinterClass printer_class,
+                      const chromeos::Printer& printer);
+
   // Removes all printers in |printer_class|.
   void Clear(chromeos::PrinterClass printer_class);
 
@@ -104,6 +114,9 @@ class PrintersMap {
   // PrinterId.
   PrinterClassesMap printers_;
 
+  // Index of the class of each printer in |printers_|, keyed by printer id.
+  std::unordered_map<std::string, chromeos::PrinterClass> printer_classes_;
+
   // Stores printer statuses returned from performing printer status queries.
   // This map is used to persist the printer statuses so when |printers_| map is
   // rebuilt, all the statuses aren't lost. Key for this map is a printer id.
@@ -329,6 +329,46 @@ TEST_F(PrintersMapTest, ReplacePrintersInClassOverwritesPrinters) {
   EXPECT_EQ(2u, restored_printers.size());
 }
 
+TEST_F(PrintersMapTest, GetPrinterClass) {
+  PrintersMap printers_map;
+
+  printers_map.Insert(PrinterClass::kEnterprise, Printer("id1"));
+  printers_map.Insert(PrinterClass::kDiscovered, Printer("id2"));
+
+  EXPECT_EQ(PrinterClass::kEnterprise, printers_map.GetPrinterClass("id1"));
+  EXPECT_EQ(PrinterClass::kDiscovered, printers_map.GetPrinterClass("id2"));
+  EXPECT_FALSE(printers_map.GetPrinterClass("id3"));
+
+  printers_map.Clear(PrinterClass::kDiscovered);
+  EXPECT_FALSE(printers_map.GetPrinterClass("id2"));
+  EXPECT_FALSE(printers_map.Get("id2"));
+
+  printers_map.Remove(PrinterClass::kEnterprise, "id1");
+  EXPECT_FALSE(printers_map.GetPrinterClass("id1"));
+}
+
+TEST_F(PrintersMapTest, InsertOrUpdateMovesPrinterBetweenClasses) {
+  PrintersMap printers_map;
+  const std::string printer_id = "id";
+
+  Printer printer(printer_id);
+  printer.set_display_name("before");
+  printers_map.Insert(PrinterClass::kDiscovered, printer);
+  CupsPrinterStatus saved_printer_status = CreatePrinterStatus(printer_id);
+  printers_map.SavePrinterStatus(printer_id, saved_printer_status);
+
+  printer.set_display_name("after");
+  printers_map.InsertOrUpdate(PrinterClass::kAutomatic, printer);
+
+  EXPECT_TRUE(printers_map.Get(PrinterClass::kDiscovered).empty());
+  std::optional<Printer> updated =
+      printers_map.Get(PrinterClass::kAutomatic, printer_id);
+  ASSERT_TRUE(updated);
+  EXPECT_EQ("after", updated->display_name());
+  ExpectPrinterStatusesEqual(saved_printer_status, updated->printer_status());
+  EXPECT_EQ(PrinterClass::kAutomatic, printers_map.GetPrinterClass(printer_id));
+}
+
 TEST_F(PrintersMapTest, RemoveSucceedsOnPrinterInClass) {
   PrintersMap printers_map;
 
@@ -4,6 +4,7 @@
 
 #include "chrome/browser/ash/printing/zeroconf_printer_detector.h"
 
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -303,6 +304,14 @@ class ZeroconfPrinterDetectorImpl : public ZeroconfPrinterDetector {
     on_printers_found_callback_ = std::move(cb);
   }
 
+  // PrinterDetector override.
+  bool RegisterPrintersChangedCallback(OnPrintersChangedCallback cb) override {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_);
+    DCHECK(!on_printers_changed_callback_);
+    on_printers_changed_callback_ = std::move(cb);
+    return true;
+  }
+
   // PrinterDetector override.
   std::vector<DetectedPrinter> GetPrinters() override {
     DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_);
@@ -331,10 +340,11 @@ class ZeroconfPrinterDetectorImpl : public ZeroconfPrinterDetector {
       }
     }
     base::AutoLock auto_lock(printers_lock_);
-    printers_[service_type][service_description.instance_name()] = printer;
-    if (on_printers_found_callback_) {
-      on_printers_found_callback_.Run(GetPrintersLocked());
-    }
+    const std::string& instance_name = service_description.instance_name();
+    const std::optional<std::string> previous_id =
+        GetUnifiedPrinterIdLocked(instance_name);
+    printers_[service_type][instance_name] = printer;
+    NotifyPrinterChangedLocked(instance_name, previous_id);
   }
 
   // ServiceDiscoveryDeviceLister::Delegate implementation.  Remove the
@@ -346,14 +356,15 @@ class ZeroconfPrinterDetectorImpl : public ZeroconfPrinterDetector {
     service_description.service_name = service_name;
     base::AutoLock auto_lock(printers_lock_);
     auto& service_type_map = printers_[service_type];
-    auto it = service_type_map.find(service_description.instance_name());
+    const std::string& instance_name = service_description.instance_name();
+    auto it = service_type_map.find(instance_name);
     if (it != service_type_map.end()) {
       PRINTER_LOG(EVENT) << "Removed zeroconf printer type " << service_type
                          << " named " << service_name;
+      const std::optional<std::string> previous_id =
+          GetUnifiedPrinterIdLocked(instance_name);
       service_type_map.erase(it);
-      if (on_printers_found_callback_) {
-        on_printers_found_callback_.Run(GetPrintersLocked());
-      }
+      NotifyPrinterChangedLocked(instance_name, previous_id);
     } else {
       LOG(WARNING) << "Device removal requested for unknown '" << service_name
                    << "'";
@@ -366,8 +377,16 @@ class ZeroconfPrinterDetectorImpl : public ZeroconfPrinterDetector {
   void OnDeviceCacheFlushed(const std::string& service_type) override {
     base::AutoLock auto_lock(printers_lock_);
     if (!IsPrintersEmpty()) {
+      DetectedPrintersDelta delta;
+      if (on_printers_changed_callback_) {
+        for (const DetectedPrinter& printer : GetPrintersLocked()) {
+          delta.removed_ids.push_back(printer.printer.id());
+        }
+      }
       ClearPrinters();
-      if (on_printers_found_callback_) {
+      if (on_printers_changed_callback_) {
+        on_printers_changed_callback_.Run(delta);
+      } else if (on_printers_found_callback_) {
         on_printers_found_callback_.Run(GetPrintersLocked());
       }
     }
@@ -411,6 +430,53 @@ class ZeroconfPrinterDetectorImpl : public ZeroconfPrinterDetector {
     return ret;
   }
 
+  // Returns the printer advertised as |instance_name| by the highest priority
+  // service type, or nullptr.  Requires that printers_lock_ be held.
+  const DetectedPrinter* GetUnifiedPrinterLocked(
+      const std::string& instance_name) {
+    printers_lock_.AssertAcquired();
+    for (const char* service_type : kServiceNames) {
+      const auto& service_type_map = printers_[service_type];
+      auto it = service_type_map.find(instance_name);
+      if (it != service_type_map.end()) {
+        return &it->second;
+      }
+    }
+    return nullptr;
+  }
+
+  std::optional<std::string> GetUnifiedPrinterIdLocked(
+      const std::string& instance_name) {
+    const DetectedPrinter* printer = GetUnifiedPrinterLocked(instance_name);
+    return printer ? std::make_optional(printer->printer.id()) : std::nullopt;
+  }
+
+  // Reports that the printer advertised as |instance_name|, which had the id
+  // |previous_id| if it was known, has changed.  Only that printer is reported
+  // to |on_printers_changed_callback_|, rather than the full list.  Requires
+  // that printers_lock_ be held.
+  void NotifyPrinterChangedLocked(
+      const std::string& instance_name,
+      const std::optional<std::string>& previous_id) {
+    printers_lock_.AssertAcquired();
+    if (!on_printers_changed_callback_) {
+      if (on_printers_found_callback_) {
+        on_printers_found_callback_.Run(GetPrintersLocked());
+      }
+      return;
+    }
+
+    DetectedPrintersDelta delta;
+    const DetectedPrinter* current = GetUnifiedPrinterLocked(instance_name);
+    if (previous_id && (!current || current->printer.id() != *previous_id)) {
+      delta.removed_ids.push_back(*previous_id);
+    }
+    if (current) {
+      delta.added_or_updated.push_back(*current);
+    }
+    on_printers_changed_callback_.Run(delta);
+  }
+
   // Clear all printers for every service type.
   void ClearPrinters() {
     printers_lock_.AssertAcquired();
@@ -446,6 +512,7 @@ class ZeroconfPrinterDetectorImpl : public ZeroconfPrinterDetector {
       device_listers_;
 
   OnPrintersFoundCallback on_printers_found_callback_;
+  OnPrintersChangedCallback on_printers_changed_callback_;
 
   // A set of printers known not to work with IPP/IPPS protocol.
   const base::flat_set<std::string> reject_ipp_printers_;
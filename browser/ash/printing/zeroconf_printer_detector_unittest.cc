@@ -276,6 +276,29 @@ class ZeroconfPrinterDetectorTest : public testing::Test {
     printers_found_callbacks_.push_back(printers);
   }
 
+  // PrinterDetector delta callback.  Applies |delta| to |changed_printers_|.
+  void OnPrintersChanged(const PrinterDetector::DetectedPrintersDelta& delta) {
+    for (const std::string& id : delta.removed_ids) {
+      changed_printers_.erase(id);
+    }
+    for (const PrinterDetector::DetectedPrinter& printer :
+         delta.added_or_updated) {
+      changed_printers_.insert_or_assign(printer.printer.id(), printer);
+    }
+    ++printers_changed_count_;
+  }
+
+  // Expect that the printers built from the deltas match |printers|.
+  void ExpectChangedPrintersAre(
+      const std::vector<PrinterDetector::DetectedPrinter>& printers) {
+    std::vector<PrinterDetector::DetectedPrinter> changed_printers;
+    for (const auto& [id, printer] : changed_printers_) {
+      changed_printers.push_back(printer);
+    }
+    ExpectPrintersEq(printers, changed_printers);
+    ExpectPrintersEq(printers, detector_->GetPrinters());
+  }
+
  protected:
   // Runs pending tasks regardless of delay.
   void CompleteTasks() { task_environment_.FastForwardUntilNoTasksRemain(); }
@@ -302,6 +325,10 @@ class ZeroconfPrinterDetectorTest : public testing::Test {
   std::vector<std::vector<PrinterDetector::DetectedPrinter>>
       printers_found_callbacks_;
 
+  // Printers built from the deltas given to OnPrintersChanged, by id.
+  std::map<std::string, PrinterDetector::DetectedPrinter> changed_printers_;
+  int printers_changed_count_ = 0;
+
  private:
   // Temporary storage for the device listers, between the time the test is
   // constructed and the detector is created.  Tests shouldn't access this
@@ -651,6 +678,51 @@ TEST_F(ZeroconfPrinterDetectorTest, GeneralMixedTraffic) {
   ExpectPrintersEmpty();
 }
 
+// Test that once a delta callback is registered, only the changed printers are
+// reported, and full lists are no longer sent.
+TEST_F(ZeroconfPrinterDetectorTest, ReportsDeltas) {
+  CreateDetector();
+  ASSERT_TRUE(detector_->RegisterPrintersChangedCallback(
+      base::BindRepeating(&ZeroconfPrinterDetectorTest::OnPrintersChanged,
+                          base::Unretained(this))));
+  ipp_lister_->Announce(MakeServiceDescription(
+      "Printer1", ZeroconfPrinterDetector::kIppServiceName));
+  ipp_lister_->Announce(MakeServiceDescription(
+      "Printer2", ZeroconfPrinterDetector::kIppServiceName));
+  CompleteTasks();
+  ExpectChangedPrintersAre(
+      {MakeExpectedPrinter("Printer1", ServiceType::kIpp),
+       MakeExpectedPrinter("Printer2", ServiceType::kIpp)});
+  const size_t printers_found_count = printers_found_callbacks_.size();
+
+  // A higher priority service replaces the printer in place.
+  ippse_lister_->Announce(MakeServiceDescription(
+      "Printer1", ZeroconfPrinterDetector::kIppsEverywhereServiceName));
+  CompleteTasks();
+  ExpectChangedPrintersAre(
+      {MakeExpectedPrinter("Printer1", ServiceType::kIppsE),
+       MakeExpectedPrinter("Printer2", ServiceType::kIpp)});
+
+  // Removing the higher priority service falls back to the lower one.
+  ippse_lister_->Remove("Printer1");
+  CompleteTasks();
+  ExpectChangedPrintersAre(
+      {MakeExpectedPrinter("Printer1", ServiceType::kIpp),
+       MakeExpectedPrinter("Printer2", ServiceType::kIpp)});
+
+  ipp_lister_->Remove("Printer2");
+  CompleteTasks();
+  ExpectChangedPrintersAre(
+      {MakeExpectedPrinter("Printer1", ServiceType::kIpp)});
+
+  ipp_lister_->Clear();
+  CompleteTasks();
+  ExpectChangedPrintersAre({});
+
+  EXPECT_GT(printers_changed_count_, 0);
+  EXPECT_EQ(printers_found_count, printers_found_callbacks_.size());
+}
+
 // Verify tasks are cleaned up properly when class is destroyed.
 TEST_F(ZeroconfPrinterDetectorTest, DestroyedWithTasksPending) {
   CreateDetector();
@@ -0,0 +1,393 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/ash/system_logs/log_file_tailer.h"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <map>
+#include <string_view>
+#include <utility>
+
+#include "base/check.h"
+#include "base/containers/circular_deque.h"
+#include "base/files/file.h"
+#include "base/files/file_path_watcher.h"
+#include "base/functional/bind.h"
+#include "base/logging.h"
+#include "base/no_destructor.h"
+#include "base/ranges/algorithm.h"
+#include "base/task/bind_post_task.h"
+#include "base/task/thread_pool.h"
+
+namespace system_logs {
+
+namespace {
+
+constexpr int kMaxNumAllowedLogRotationsDuringFileRead = 3;
+
+// Returns the inode value of file at |path|, or 0 if it doesn't exist or is
+// otherwise unable to be accessed for file system info.
+ino_t GetInodeValue(const base::FilePath& path) {
+  struct stat file_stats;
+  if (stat(path.value().c_str(), &file_stats) != 0)
+    return 0;
+  return file_stats.st_ino;
+}
+
+// The live tailers, keyed by the path of their log file.
+std::map<base::FilePath, LogFileTailer*>& GetTailers() {
+  static base::NoDestructor<std::map<base::FilePath, LogFileTailer*>> tailers;
+  return *tailers;
+}
+
+}  // namespace
+
+// Reads the log file on a blocking sequence.
+//
+// The log is kept as a list of segments, one for each version of the file
+// that was opened, which ends when the file is rotated or truncated. Offsets
+// are positions in the concatenation of all the segments, so that a reader
+// only needs to remember a single offset.
+class LogFileTailer::Core {
+ public:
+  explicit Core(const base::FilePath& path) : path_(path) {
+    // Rotations replace the file at |path_|, which is reported even when the
+    // file is not written to afterwards.
+    if (!watcher_.Watch(path_, base::FilePathWatcher::Type::kNonRecursive,
+                        base::BindRepeating(&Core::OnFileChanged,
+                                            base::Unretained(this)))) {
+      // Rotations are still noticed by the next read.
+      VLOG(1) << "Failed to watch " << path_;
+    }
+  }
+
+  Core(const Core&) = delete;
+  Core& operator=(const Core&) = delete;
+
+  ~Core() = default;
+
+  void AddReader(int reader_id) {
+    CatchUp();
+    readers_[reader_id] = !segments_.empty() && !segments_.back().closed
+                              ? segments_.back().start
+                              : GetEndOffset();
+  }
+
+  void RemoveReader(int reader_id) {
+    readers_.erase(reader_id);
+    DropConsumedSegments();
+  }
+
+  void SetLogFileOpenedCallbackForTesting(base::RepeatingClosure callback) {
+    log_file_opened_callback_for_testing_ = std::move(callback);
+  }
+
+  std::optional<ReadResult> Read(int reader_id, size_t max_read_size) {
+    CatchUp();
+    if (segments_.empty()) {
+      return std::nullopt;
+    }
+
+    auto reader = readers_.find(reader_id);
+    CHECK(reader != readers_.end());
+    int64_t& cursor = reader->second;
+
+    ReadResult result;
+    for (size_t i = 0; i < segments_.size(); ++i) {
+      const Segment& segment = segments_[i];
+      const bool is_last_segment = i + 1 == segments_.size();
+      if (segment.end < cursor || (segment.end == cursor && !is_last_segment)) {
+        continue;
+      }
+      cursor = std::max(cursor, segment.start);
+      if (segment.truncated) {
+        // The rest of a file which was truncated in place is lost.
+        cursor = segment.end;
+        continue;
+      }
+
+      // Skip forward to at most |max_read_size| bytes before the end.
+      size_t size_to_read = segment.end - cursor;
+      if (size_to_read > max_read_size) {
+        result.bytes_skipped = true;
+        cursor = segment.end - max_read_size;
+        size_to_read = max_read_size;
+      }
+
+      // Trim down the previously read data before adding to it.
+      const size_t available_previous_read_size = max_read_size - size_to_read;
+      if (available_previous_read_size < result.contents.size()) {
+        result.contents.erase(
+            0, result.contents.size() - available_previous_read_size);
+      }
+
+      const int64_t buffer_start = segment.GetBufferStart();
+      if (cursor < buffer_start) {
+        // Dropped from the buffer before this reader got to it.
+        result.bytes_skipped = true;
+        cursor = buffer_start;
+      }
+      std::string_view new_contents =
+          segment.GetBuffer().substr(cursor - buffer_start);
+
+      // The reader may only read complete lines. The exception is a rotated
+      // file, all of which is read before moving on to the new log file.
+      if (!segment.closed &&
+          (new_contents.empty() || new_contents.back() != '\n')) {
+        const size_t last_newline_pos = new_contents.find_last_of('\n');
+        new_contents = new_contents.substr(
+            0, last_newline_pos == std::string_view::npos
+                   ? 0
+                   : last_newline_pos + 1);
+      }
+      cursor += new_contents.size();
+      result.contents.append(new_contents);
+    }
+
+    DropConsumedSegments();
+    return result;
+  }
+
+ private:
+  struct Segment {
+    // Returns the buffered tail of the segment, and its offset.
+    std::string_view GetBuffer() const {
+      return std::string_view(buffer).substr(buffer_begin);
+    }
+    int64_t GetBufferStart() const { return end - GetBuffer().size(); }
+
+    // Drops the first |size| buffered bytes.
+    void DropFront(size_t size) {
+      buffer_begin += size;
+      // Only move the remaining bytes once half of the buffer is stale.
+      if (buffer_begin > buffer.size() / 2) {
+        buffer.erase(0, buffer_begin);
+        buffer_begin = 0;
+      }
+    }
+
+    // Offset of the beginning of the file.
+    int64_t start = 0;
+    // Offset past what has been read from the file.
+    int64_t end = 0;
+    std::string buffer;
+    // Number of bytes at the front of |buffer| which have been dropped.
+    size_t buffer_begin = 0;
+    // Whether the file has been rotated or truncated.
+    bool closed = false;
+    bool truncated = false;
+  };
+
+  int64_t GetEndOffset() const {
+    return segments_.empty() ? 0 : segments_.back().end;
+  }
+
+  void OnFileChanged(const base::FilePath& path, bool error) {
+    // Also open a log file which is created after the previous one was moved
+    // aside, so that everything written to it is followed as well.
+    if (error || (file_.IsValid() && file_inode_ == GetInodeValue(path_))) {
+      return;
+    }
+    CatchUp();
+    if (file_.IsValid() && log_file_opened_callback_for_testing_) {
+      log_file_opened_callback_for_testing_.Run();
+    }
+  }
+
+  // Reads everything which was appended to the log file, following
+  // rotations of the file.
+  //
+  // At most |kMaxNumAllowedLogRotationsDuringFileRead| rotations are followed
+  // per call. This avoids never returning due to indefinitely repeated log
+  // file rotation.
+  void CatchUp() {
+    for (int num_rotations = 0;; ++num_rotations) {
+      if (!file_.IsValid() && !OpenFile()) {
+        return;
+      }
+      ReadToEnd();
+      if (num_rotations == kMaxNumAllowedLogRotationsDuringFileRead ||
+          file_inode_ == GetInodeValue(path_)) {
+        return;
+      }
+      // The file was rotated, and everything written to it has been read.
+      segments_.back().closed = true;
+      file_.Close();
+    }
+  }
+
+  bool OpenFile() {
+    file_.Initialize(path_, base::File::FLAG_OPEN | base::File::FLAG_READ);
+    if (!file_.IsValid()) {
+      return false;
+    }
+    file_inode_ = GetInodeValue(path_);
+    StartSegment();
+    return true;
+  }
+
+  void StartSegment() {
+    const int64_t offset = GetEndOffset();
+    Segment& segment = segments_.emplace_back();
+    segment.start = offset;
+    segment.end = offset;
+    file_position_ = 0;
+  }
+
+  void ReadToEnd() {
+    const int64_t length = file_.GetLength();
+    if (length < 0) {
+      return;
+    }
+    if (length < file_position_) {
+      // The file was truncated in place, read it again from the beginning.
+      segments_.back().closed = true;
+      segments_.back().truncated = true;
+      StartSegment();
+    }
+
+    Segment& segment = segments_.back();
+    if (length - file_position_ > static_cast<int64_t>(kMaxBufferSize)) {
+      // Skip what would not fit into the buffer anyway.
+      segment.buffer.clear();
+      segment.buffer_begin = 0;
+      file_position_ = length - kMaxBufferSize;
+      segment.end = segment.start + file_position_;
+    }
+
+    const size_t size_to_read = length - file_position_;
+    if (size_to_read == 0) {
+      return;
+    }
+    const size_t buffer_size = segment.buffer.size();
+    segment.buffer.resize(buffer_size + size_to_read);
+    const int size_read =
+        file_.Read(file_position_, &segment.buffer[buffer_size],
+                   static_cast<int>(size_to_read));
+    segment.buffer.resize(buffer_size + std::max(size_read, 0));
+    if (size_read <= 0) {
+      return;
+    }
+    file_position_ += size_read;
+    segment.end = segment.start + file_position_;
+    DropOverflow();
+  }
+
+  // Drops the oldest buffered bytes beyond |kMaxBufferSize|.
+  void DropOverflow() {
+    size_t buffered_size = 0;
+    for (const Segment& segment : segments_) {
+      buffered_size += segment.GetBuffer().size();
+    }
+    for (Segment& segment : segments_) {
+      if (buffered_size <= kMaxBufferSize) {
+        break;
+      }
+      const size_t size =
+          std::min(buffered_size - kMaxBufferSize, segment.GetBuffer().size());
+      segment.DropFront(size);
+      buffered_size -= size;
+    }
+  }
+
+  // Drops the segments of rotated files which all readers have read, and the
+  // buffered bytes of the remaining ones which all readers have read.
+  void DropConsumedSegments() {
+    while (segments_.size() > 1 && segments_.front().closed &&
+           base::ranges::all_of(readers_, [this](const auto& reader) {
+             return reader.second >= segments_.front().end;
+           })) {
+      segments_.pop_front();
+    }
+
+    if (readers_.empty()) {
+      return;
+    }
+    const int64_t min_offset =
+        base::ranges::min(readers_, {}, [](const auto& reader) {
+          return reader.second;
+        }).second;
+    for (Segment& segment : segments_) {
+      const int64_t buffer_start = segment.GetBufferStart();
+      if (min_offset <= buffer_start) {
+        break;
+      }
+      const int64_t drop_end = std::min(min_offset, segment.end);
+      segment.DropFront(static_cast<size_t>(drop_end - buffer_start));
+    }
+  }
+
+  const base::FilePath path_;
+  base::FilePathWatcher watcher_;
+
+  // Handle of the current log file, its inode value when it was opened, and
+  // how much of it has been read.
+  base::File file_;
+  ino_t file_inode_ = 0;
+  int64_t file_position_ = 0;
+
+  base::circular_deque<Segment> segments_;
+
+  // The offset of each reader, up to which it has read the log.
+  std::map<int, int64_t> readers_;
+
+  base::RepeatingClosure log_file_opened_callback_for_testing_;
+};
+
+// static
+scoped_refptr<LogFileTailer> LogFileTailer::GetOrCreate(
+    const base::FilePath& path) {
+  auto& tailers = GetTailers();
+  auto it = tailers.find(path);
+  if (it != tailers.end()) {
+    return base::WrapRefCounted(it->second);
+  }
+  return base::WrapRefCounted(new LogFileTailer(path));
+}
+
+LogFileTailer::LogFileTailer(const base::FilePath& path)
+    : path_(path),
+      core_(base::ThreadPool::CreateSequencedTaskRunner(
+                {base::MayBlock(), base::TaskPriority::BEST_EFFORT}),
+            path) {
+  GetTailers()[path_] = this;
+}
+
+LogFileTailer::~LogFileTailer() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  GetTailers().erase(path_);
+}
+
+int LogFileTailer::AddReader() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const int reader_id = next_reader_id_++;
+  core_.AsyncCall(&Core::AddReader).WithArgs(reader_id);
+  return reader_id;
+}
+
+void LogFileTailer::RemoveReader(int reader_id) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  core_.AsyncCall(&Core::RemoveReader).WithArgs(reader_id);
+}
+
+void LogFileTailer::SetLogFileOpenedCallbackForTesting(
+    base::RepeatingClosure callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  core_.AsyncCall(&Core::SetLogFileOpenedCallbackForTesting)
+      .WithArgs(base::BindPostTaskToCurrentDefault(std::move(callback)));
+}
+
+void LogFileTailer::Read(int reader_id,
+                         size_t max_read_size,
+                         ReadCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  core_.AsyncCall(&Core::Read)
+      .WithArgs(reader_id, max_read_size)
+      .Then(std::move(callback));
+}
+
+}  // namespace system_logs
@@ -0,0 +1,86 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_ASH_SYSTEM_LOGS_LOG_FILE_TAILER_H_
+#define CHROME_BROWSER_ASH_SYSTEM_LOGS_LOG_FILE_TAILER_H_
+
+#include <stddef.h>
+
+#include <optional>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/functional/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/sequence_checker.h"
+#include "base/threading/sequence_bound.h"
+
+namespace system_logs {
+
+// Follows a single log file on behalf of any number of readers, each of which
+// reads the lines it has not read yet. The file is read once, on a blocking
+// sequence, into a buffer of at most |kMaxBufferSize| bytes which all readers
+// share, and which only holds what some reader has not read yet. Rotations of
+// the file are noticed through inotify as they happen, so that the rest of the
+// old file is read before it is gone.
+//
+// There is at most one tailer per log file, which lives as long as a reader
+// holds a reference to it. Must only be used on the UI thread.
+class LogFileTailer : public base::RefCounted<LogFileTailer> {
+ public:
+  static constexpr size_t kMaxBufferSize = 5 * 1024 * 1024;
+
+  struct ReadResult {
+    std::string contents;
+    // Whether some of the log was skipped, because it exceeded the maximum
+    // read size or was dropped from the buffer before it was read.
+    bool bytes_skipped = false;
+  };
+
+  // Called with the result of a read, or nullopt if the log file could not be
+  // opened.
+  using ReadCallback =
+      base::OnceCallback<void(std::optional<ReadResult> result)>;
+
+  // Returns the tailer of the log file at |path|, creating one if needed.
+  static scoped_refptr<LogFileTailer> GetOrCreate(const base::FilePath& path);
+
+  LogFileTailer(const LogFileTailer&) = delete;
+  LogFileTailer& operator=(const LogFileTailer&) = delete;
+
+  // Adds a reader, which starts reading at the beginning of the current log
+  // file, or at the oldest part of it that some other reader has not read yet
+  // if the rest was dropped from the buffer. Returns the id of the reader.
+  int AddReader();
+
+  void RemoveReader(int reader_id);
+
+  // Reads what the reader |reader_id| has not read yet, across rotations of
+  // the log file, and runs |callback| with at most the last |max_read_size|
+  // bytes of it. Trailing incomplete lines of the current log file are left
+  // for the next read.
+  void Read(int reader_id, size_t max_read_size, ReadCallback callback);
+
+  // Runs |callback| whenever a change notification for the log file makes
+  // the tailer open a new log file.
+  void SetLogFileOpenedCallbackForTesting(base::RepeatingClosure callback);
+
+ private:
+  friend class base::RefCounted<LogFileTailer>;
+
+  class Core;
+
+  explicit LogFileTailer(const base::FilePath& path);
+  ~LogFileTailer();
+
+  const base::FilePath path_;
+  base::SequenceBound<Core> core_;
+  int next_reader_id_ = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+}  // namespace system_logs
+
+#endif  // CHROME_BROWSER_ASH_SYSTEM_LOGS_LOG_FILE_TAILER_H_
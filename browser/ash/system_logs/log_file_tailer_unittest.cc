@@ -0,0 +1,190 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/ash/system_logs/log_file_tailer.h"
+
+#include <optional>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/task_environment.h"
+#include "base/test/test_future.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace system_logs {
+
+namespace {
+
+constexpr size_t kMaxReadSize = 1024;
+
+class LogFileTailerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(log_dir_.CreateUniqueTempDir());
+    log_file_path_ = log_dir_.GetPath().Append("messages");
+    ASSERT_TRUE(base::WriteFile(log_file_path_, ""));
+  }
+
+  bool AppendToLog(const std::string& input) {
+    return base::AppendToFile(log_file_path_, input);
+  }
+
+  // Moves the log file aside, then creates an empty log file in its place.
+  bool RotateLog() {
+    return base::Move(log_file_path_,
+                      log_file_path_.AddExtensionASCII("1")) &&
+           base::WriteFile(log_file_path_, "");
+  }
+
+  // Returns what |reader_id| reads from |tailer|.
+  std::string Read(LogFileTailer* tailer, int reader_id) {
+    base::test::TestFuture<std::optional<LogFileTailer::ReadResult>> future;
+    tailer->Read(reader_id, kMaxReadSize, future.GetCallback());
+    std::optional<LogFileTailer::ReadResult> result = future.Take();
+    EXPECT_TRUE(result);
+    return result ? result->contents : std::string();
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir log_dir_;
+  base::FilePath log_file_path_;
+};
+
+TEST_F(LogFileTailerTest, SharedPerLogFile) {
+  scoped_refptr<LogFileTailer> tailer =
+      LogFileTailer::GetOrCreate(log_file_path_);
+  EXPECT_EQ(tailer, LogFileTailer::GetOrCreate(log_file_path_));
+  EXPECT_NE(tailer, LogFileTailer::GetOrCreate(
+                        log_dir_.GetPath().Append("net.log")));
+}
+
+TEST_F(LogFileTailerTest, MissingLogFile) {
+  scoped_refptr<LogFileTailer> tailer =
+      LogFileTailer::GetOrCreate(log_dir_.GetPath().Append("net.log"));
+  const int reader = tailer->AddReader();
+
+  base::test::TestFuture<std::optional<LogFileTailer::ReadResult>> future;
+  tailer->Read(reader, kMaxReadSize, future.GetCallback());
+  EXPECT_FALSE(future.Get());
+}
+
+// Several readers tail the same log while it is rotated. Each reader gets
+// everything written since its previous read, and new readers start at the
+// beginning of the current log file.
+TEST_F(LogFileTailerTest, ConcurrentReadersAcrossRotations) {
+  scoped_refptr<LogFileTailer> tailer =
+      LogFileTailer::GetOrCreate(log_file_path_);
+  const int reader1 = tailer->AddReader();
+  const int reader2 = tailer->AddReader();
+
+  ASSERT_TRUE(AppendToLog("1st log file\n"));
+  EXPECT_EQ("1st log file\n", Read(tailer.get(), reader1));
+
+  ASSERT_TRUE(AppendToLog("More 1st log file\n"));
+  ASSERT_TRUE(RotateLog());
+  ASSERT_TRUE(AppendToLog("2nd log file\n"));
+  EXPECT_EQ("1st log file\nMore 1st log file\n2nd log file\n",
+            Read(tailer.get(), reader2));
+
+  const int reader3 = tailer->AddReader();
+  ASSERT_TRUE(AppendToLog("No newline here..."));
+  ASSERT_TRUE(RotateLog());
+  ASSERT_TRUE(AppendToLog("3rd log file\n"));
+  ASSERT_TRUE(AppendToLog("Partial"));
+
+  EXPECT_EQ("More 1st log file\n2nd log file\nNo newline here...3rd log file\n",
+            Read(tailer.get(), reader1));
+  EXPECT_EQ("No newline here...3rd log file\n", Read(tailer.get(), reader2));
+  EXPECT_EQ("2nd log file\nNo newline here...3rd log file\n",
+            Read(tailer.get(), reader3));
+
+  // Readers which are up to date have nothing more to read until the partial
+  // line is complete.
+  EXPECT_EQ("", Read(tailer.get(), reader1));
+  ASSERT_TRUE(AppendToLog(" line\n"));
+  EXPECT_EQ("Partial line\n", Read(tailer.get(), reader2));
+
+  // Removing a reader does not affect the others.
+  tailer->RemoveReader(reader2);
+  EXPECT_EQ("Partial line\n", Read(tailer.get(), reader1));
+  EXPECT_EQ("Partial line\n", Read(tailer.get(), reader3));
+}
+
+TEST_F(LogFileTailerTest, ReadsLimitedToMaxReadSize) {
+  scoped_refptr<LogFileTailer> tailer =
+      LogFileTailer::GetOrCreate(log_file_path_);
+  const int reader1 = tailer->AddReader();
+  const int reader2 = tailer->AddReader();
+
+  ASSERT_TRUE(AppendToLog("Line 1\nLine 2\nLine 3\nLine 4\n"));
+  base::test::TestFuture<std::optional<LogFileTailer::ReadResult>> future;
+  tailer->Read(reader1, /*max_read_size=*/20, future.GetCallback());
+  std::optional<LogFileTailer::ReadResult> result = future.Take();
+  ASSERT_TRUE(result);
+  EXPECT_TRUE(result->bytes_skipped);
+  EXPECT_EQ("ine 2\nLine 3\nLine 4\n", result->contents);
+
+  // The limit of one reader does not affect another.
+  EXPECT_EQ("Line 1\nLine 2\nLine 3\nLine 4\n", Read(tailer.get(), reader2));
+}
+
+// Rotations are followed as inotify reports them, so the log files in between
+// two reads are not lost even though they were moved aside and replaced.
+TEST_F(LogFileTailerTest, FollowsRotationsBetweenReads) {
+  scoped_refptr<LogFileTailer> tailer =
+      LogFileTailer::GetOrCreate(log_file_path_);
+  const int reader = tailer->AddReader();
+  ASSERT_TRUE(AppendToLog("1st log file\n"));
+  EXPECT_EQ("1st log file\n", Read(tailer.get(), reader));
+
+  base::test::TestFuture<void> log_file_opened;
+  tailer->SetLogFileOpenedCallbackForTesting(
+      log_file_opened.GetRepeatingCallback());
+
+  ASSERT_TRUE(AppendToLog("More 1st log file\n"));
+  ASSERT_TRUE(RotateLog());
+  ASSERT_TRUE(log_file_opened.Wait());
+  log_file_opened.Clear();
+
+  // Only the watcher reads this before the file is replaced again.
+  ASSERT_TRUE(AppendToLog("2nd log file\n"));
+  ASSERT_TRUE(RotateLog());
+  ASSERT_TRUE(log_file_opened.Wait());
+
+  ASSERT_TRUE(AppendToLog("3rd log file\n"));
+  EXPECT_EQ("More 1st log file\n2nd log file\n3rd log file\n",
+            Read(tailer.get(), reader));
+}
+
+// The buffer only keeps what some reader has not read yet, so a new reader
+// starts where the slowest reader is.
+TEST_F(LogFileTailerTest, DropsWhatAllReadersHaveRead) {
+  scoped_refptr<LogFileTailer> tailer =
+      LogFileTailer::GetOrCreate(log_file_path_);
+  const int reader1 = tailer->AddReader();
+  const int reader2 = tailer->AddReader();
+
+  ASSERT_TRUE(AppendToLog("Line 1\nLine 2\n"));
+  EXPECT_EQ("Line 1\nLine 2\n", Read(tailer.get(), reader1));
+  ASSERT_TRUE(AppendToLog("Line 3\n"));
+  EXPECT_EQ("Line 1\nLine 2\nLine 3\n", Read(tailer.get(), reader2));
+  EXPECT_EQ("Line 3\n", Read(tailer.get(), reader1));
+
+  const int reader3 = tailer->AddReader();
+  ASSERT_TRUE(AppendToLog("Line 4\n"));
+  base::test::TestFuture<std::optional<LogFileTailer::ReadResult>> future;
+  tailer->Read(reader3, kMaxReadSize, future.GetCallback());
+  std::optional<LogFileTailer::ReadResult> result = future.Take();
+  ASSERT_TRUE(result);
+  EXPECT_TRUE(result->bytes_skipped);
+  EXPECT_EQ("Line 4\n", result->contents);
+
+  EXPECT_EQ("Line 4\n", Read(tailer.get(), reader1));
+}
+
+}  // namespace
+
+}  // namespace system_logs
@@ -4,6 +4,8 @@
 
 #include "chrome/browser/chromeos/printing/cups_wrapper.h"
 
+#include <utility>
+
 namespace chromeos {
 
 CupsWrapper::QueryResult::QueryResult() = default;
@@ -12,4 +14,14 @@ CupsWrapper::QueryResult::~QueryResult() = default;
 
 CupsWrapper::~CupsWrapper() = default;
 
+void CupsWrapper::SetJobEventsCallback(JobEventsCallback callback) {}
+
+void CupsWrapper::SubscribeToJobEvents(
+    const std::string& printer_id,
+    base::OnceCallback<void(bool)> callback) {
+  std::move(callback).Run(false);
+}
+
+void CupsWrapper::UnsubscribeFromJobEvents(const std::string& printer_id) {}
+
 }  // namespace chromeos
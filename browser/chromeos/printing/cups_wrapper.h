@@ -28,6 +28,10 @@ class CupsWrapper {
     std::vector<::printing::QueueStatus> queues;
   };
 
+  // Receives the ids of subscribed printers whose job queues have changed.
+  using JobEventsCallback = base::RepeatingCallback<void(
+      const std::vector<std::string>& printer_ids)>;
+
   static std::unique_ptr<CupsWrapper> Create();
 
   using CupsWrapperFactory = base::RepeatingCallback<decltype(Create)>;
@@ -50,6 +54,21 @@ class CupsWrapper {
       const std::string& printer_id,
       base::OnceCallback<void(std::unique_ptr<::printing::PrinterStatus>)>
           callback) = 0;
+
+  // Sets the callback which receives the job events of all subscribed
+  // printers.
+  virtual void SetJobEventsCallback(JobEventsCallback callback);
+
+  // Subscribes to the job events of |printer_id|. Passes true to |callback|
+  // once CUPS has held a request for job events of the printer, or delivered
+  // some, and false if CUPS cannot deliver them. Until then, the job queue of
+  // the printer has to be polled with QueryCupsPrintJobs(). Subscribing to an
+  // already watched printer succeeds right away.
+  virtual void SubscribeToJobEvents(const std::string& printer_id,
+                                    base::OnceCallback<void(bool)> callback);
+
+  // Cancels the job events subscription of |printer_id|, if any.
+  virtual void UnsubscribeFromJobEvents(const std::string& printer_id);
 };
 
 }  // namespace chromeos
@@ -4,44 +4,290 @@
 
 #include <cups/cups.h>
 
+#include <algorithm>
+#include <optional>
+#include <string_view>
 #include <utility>
+#include <vector>
 
+#include "base/containers/flat_map.h"
 #include "base/functional/callback.h"
 #include "base/logging.h"
 #include "base/no_destructor.h"
+#include "base/memory/raw_ptr.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/ranges/algorithm.h"
 #include "base/sequence_checker.h"
+#include "base/strings/strcat.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
 #include "base/task/sequenced_task_runner.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool.h"
 #include "base/threading/scoped_blocking_call.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "chrome/browser/chromeos/printing/cups_wrapper.h"
+#include "printing/backend/cups_ipp_helper.h"
 #include "printing/backend/cups_printer.h"
 #include "url/gurl.h"
 
 namespace chromeos {
 
 namespace {
+
+// The job events which make the job queue of a printer worth querying.
+constexpr const char* kJobEvents[] = {"job-created", "job-progress",
+                                      "job-state-changed", "job-completed"};
+
+// Subscriptions are cancelled once their printer has no active jobs. The
+// lease only bounds how long they outlive a crashed browser.
+constexpr int kJobSubscriptionLeaseSeconds = 24 * 60 * 60;
+
+// Timeout for connecting to CUPS for a Get-Notifications request.
+constexpr int kJobEventsConnectTimeoutMs = 30000;
+
+// Delay before asking CUPS for job events again after it failed to answer.
+constexpr base::TimeDelta kJobEventsRetryDelay = base::Seconds(5);
+
+// The shortest delay between Get-Notifications requests which return without
+// events, and how long a request has to be held by CUPS before its printers
+// count as watched. Matches the rate at which CupsJobTracker polls printers
+// without job events, so relying on events is never slower than polling.
+constexpr base::TimeDelta kMinJobEventsInterval = base::Seconds(1);
+
 CupsWrapper::CupsWrapperFactory& GetCupsWrapperFactoryForTesting() {
   static base::NoDestructor<CupsWrapper::CupsWrapperFactory>
       factory_for_testing;
   return *factory_for_testing;
 }
+
+// Job events received from CUPS.
+struct JobNotifications {
+  bool success = false;
+  // Maps subscription ids to the sequence number of their latest event.
+  base::flat_map<int, int> sequence_numbers;
+  // The delay CUPS asks for before the next Get-Notifications request.
+  base::TimeDelta get_interval;
+};
+
+// The connection of a Get-Notifications request. CUPS holds that request until
+// an event arrives, so the connection can be shut down from another sequence to
+// abandon the request.
+class JobEventsConnection
+    : public base::RefCountedThreadSafe<JobEventsConnection> {
+ public:
+  JobEventsConnection() = default;
+
+  JobEventsConnection(const JobEventsConnection&) = delete;
+  JobEventsConnection& operator=(const JobEventsConnection&) = delete;
+
+  // Connects to CUPS, unless the connection was shut down already. Returns
+  // null on failure. Blocks.
+  http_t* Connect() {
+    http_t* http = httpConnect2(cupsServer(), ippPort(), nullptr, AF_UNSPEC,
+                                cupsEncryption(), /*blocking=*/1,
+                                kJobEventsConnectTimeoutMs, nullptr);
+    base::AutoLock lock(lock_);
+    if (is_shut_down_ && http) {
+      httpClose(http);
+      return nullptr;
+    }
+    http_ = http;
+    return http;
+  }
+
+  // Closes the connection opened by Connect().
+  void Close() {
+    base::AutoLock lock(lock_);
+    http_t* http = http_;
+    http_ = nullptr;
+    if (http) {
+      httpClose(http);
+    }
+  }
+
+  // Makes a request running on the connection fail right away, and keeps
+  // Connect() from connecting. May be called from any sequence.
+  void Shutdown() {
+    base::AutoLock lock(lock_);
+    is_shut_down_ = true;
+    if (http_) {
+      httpShutdown(http_);
+    }
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<JobEventsConnection>;
+  ~JobEventsConnection() = default;
+
+  base::Lock lock_;
+  raw_ptr<http_t> http_ GUARDED_BY(lock_) = nullptr;
+  bool is_shut_down_ GUARDED_BY(lock_) = false;
+};
+
+std::string GetPrinterUri(const std::string& printer_id) {
+  return base::StrCat({"ipp://localhost/printers/", printer_id});
+}
+
+// Returns a new IPP request for |operation| on |printer_uri|.
+ipp_t* NewIppRequest(ipp_op_t operation, const std::string& printer_uri) {
+  ipp_t* request = ippNewRequest(operation);
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_URI, "printer-uri",
+               nullptr, printer_uri.c_str());
+  ippAddString(request, IPP_TAG_OPERATION, IPP_TAG_NAME,
+               "requesting-user-name", nullptr, cupsUser());
+  return request;
+}
+
+// Creates a pull subscription to the job events of |printer_id|. Returns the
+// id of the subscription, or nullopt if CUPS refused it.
+std::optional<int> CreateJobSubscription(const std::string& printer_id) {
+  base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                                base::BlockingType::MAY_BLOCK);
+  ipp_t* request = NewIppRequest(IPP_OP_CREATE_PRINTER_SUBSCRIPTIONS,
+                                 GetPrinterUri(printer_id));
+  ippAddStrings(request, IPP_TAG_SUBSCRIPTION, IPP_TAG_KEYWORD,
+                "notify-events", std::size(kJobEvents), nullptr, kJobEvents);
+  ippAddString(request, IPP_TAG_SUBSCRIPTION, IPP_TAG_KEYWORD,
+               "notify-pull-method", nullptr, "ippget");
+  ippAddInteger(request, IPP_TAG_SUBSCRIPTION, IPP_TAG_INTEGER,
+                "notify-lease-duration", kJobSubscriptionLeaseSeconds);
+
+  ::printing::ScopedIppPtr response =
+      ::printing::WrapIpp(cupsDoRequest(CUPS_HTTP_DEFAULT, request, "/"));
+  if (!response ||
+      ippGetStatusCode(response.get()) > IPP_STATUS_OK_CONFLICTING) {
+    VLOG(1) << "Cannot subscribe to job events of " << printer_id << ": "
+            << cupsLastErrorString();
+    return std::nullopt;
+  }
+  ipp_attribute_t* subscription_id = ippFindAttribute(
+      response.get(), "notify-subscription-id", IPP_TAG_INTEGER);
+  if (!subscription_id) {
+    return std::nullopt;
+  }
+  return ippGetInteger(subscription_id, 0);
+}
+
+void CancelJobSubscription(const std::string& printer_id,
+                           int subscription_id) {
+  base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                                base::BlockingType::MAY_BLOCK);
+  ipp_t* request =
+      NewIppRequest(IPP_OP_CANCEL_SUBSCRIPTION, GetPrinterUri(printer_id));
+  ippAddInteger(request, IPP_TAG_OPERATION, IPP_TAG_INTEGER,
+                "notify-subscription-id", subscription_id);
+  ::printing::ScopedIppPtr response =
+      ::printing::WrapIpp(cupsDoRequest(CUPS_HTTP_DEFAULT, request, "/"));
+  if (!response ||
+      ippGetStatusCode(response.get()) > IPP_STATUS_OK_CONFLICTING) {
+    LOG(WARNING) << "Cancelling job events subscription failed.";
+  }
+}
+
+// Fetches the events of all |subscription_ids| in a single request on
+// |connection|, starting at the matching |sequence_numbers|. CUPS holds the
+// request until an event arrives, so this blocks until then, or until
+// |connection| is shut down.
+std::unique_ptr<JobNotifications> GetJobNotifications(
+    scoped_refptr<JobEventsConnection> connection,
+    const std::vector<int>& subscription_ids,
+    const std::vector<int>& sequence_numbers) {
+  DCHECK_EQ(subscription_ids.size(), sequence_numbers.size());
+  base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                                base::BlockingType::WILL_BLOCK);
+  auto result = std::make_unique<JobNotifications>();
+  http_t* http = connection->Connect();
+  if (!http) {
+    return result;
+  }
+  ipp_t* request = NewIppRequest(IPP_OP_GET_NOTIFICATIONS, "ipp://localhost/");
+  ippAddIntegers(request, IPP_TAG_OPERATION, IPP_TAG_INTEGER,
+                 "notify-subscription-ids", subscription_ids.size(),
+                 subscription_ids.data());
+  ippAddIntegers(request, IPP_TAG_OPERATION, IPP_TAG_INTEGER,
+                 "notify-sequence-numbers", sequence_numbers.size(),
+                 sequence_numbers.data());
+  ippAddBoolean(request, IPP_TAG_OPERATION, "notify-wait", 1);
+
+  ::printing::ScopedIppPtr response =
+      ::printing::WrapIpp(cupsDoRequest(http, request, "/"));
+  connection->Close();
+  if (!response ||
+      ippGetStatusCode(response.get()) > IPP_STATUS_OK_EVENTS_COMPLETE) {
+    return result;
+  }
+  result->success = true;
+
+  ipp_attribute_t* get_interval = ippFindAttribute(
+      response.get(), "notify-get-interval", IPP_TAG_INTEGER);
+  if (get_interval) {
+    result->get_interval = base::Seconds(ippGetInteger(get_interval, 0));
+  }
+
+  // Each event is a group of attributes, delimited by separators.
+  int subscription_id = 0;
+  int sequence_number = 0;
+  auto add_event = [&] {
+    if (subscription_id && sequence_number) {
+      int& latest = result->sequence_numbers[subscription_id];
+      latest = std::max(latest, sequence_number);
+    }
+    subscription_id = 0;
+    sequence_number = 0;
+  };
+  for (ipp_attribute_t* attr = ippFirstAttribute(response.get()); attr;
+       attr = ippNextAttribute(response.get())) {
+    const char* name = ippGetName(attr);
+    if (!name) {
+      add_event();
+      continue;
+    }
+    if (ippGetGroupTag(attr) != IPP_TAG_EVENT_NOTIFICATION) {
+      continue;
+    }
+    const std::string_view attr_name(name);
+    if (attr_name == "notify-subscription-id") {
+      subscription_id = ippGetInteger(attr, 0);
+    } else if (attr_name == "notify-sequence-number") {
+      sequence_number = ippGetInteger(attr, 0);
+    }
+  }
+  add_event();
+  return result;
+}
+
 }  // namespace
 
 // A wrapper around the CUPS connection to ensure that it's always accessed on
 // the same sequence and run in the appropriate sequence off of the calling
-// sequence.
+// sequence. Job events of all subscribed printers are fetched with a single
+// outstanding Get-Notifications request on a separate sequence, as CUPS holds
+// that request until an event arrives.
 class CupsWrapperImpl : public CupsWrapper {
  public:
   CupsWrapperImpl()
       : backend_(std::make_unique<Backend>()),
         backend_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
             {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
-             base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})) {}
+             base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+        // CUPS holds a Get-Notifications request until an event arrives, so
+        // a running request must not block shutdown.
+        job_events_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+            {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+             base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN})) {}
 
   ~CupsWrapperImpl() override {
     DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    AbandonJobEventsRequest();
     backend_task_runner_->DeleteSoon(FROM_HERE, backend_.release());
+    for (const auto& [printer_id, subscription] : job_subscriptions_) {
+      backend_task_runner_->PostTask(
+          FROM_HERE,
+          base::BindOnce(&CancelJobSubscription, printer_id, subscription.id));
+    }
   }
 
   CupsWrapperImpl(const CupsWrapperImpl&) = delete;
@@ -86,7 +332,224 @@ class CupsWrapperImpl : public CupsWrapper {
         std::move(callback));
   }
 
+  void SetJobEventsCallback(JobEventsCallback callback) override {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    job_events_callback_ = std::move(callback);
+  }
+
+  void SubscribeToJobEvents(const std::string& printer_id,
+                            base::OnceCallback<void(bool)> callback) override {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    auto it = job_subscriptions_.find(printer_id);
+    if (it != job_subscriptions_.end()) {
+      if (it->second.is_watched) {
+        std::move(callback).Run(true);
+      } else {
+        it->second.watched_callbacks.push_back(std::move(callback));
+      }
+      return;
+    }
+    backend_task_runner_->PostTaskAndReplyWithResult(
+        FROM_HERE, base::BindOnce(&CreateJobSubscription, printer_id),
+        base::BindOnce(&CupsWrapperImpl::OnJobSubscriptionCreated,
+                       weak_ptr_factory_.GetWeakPtr(), printer_id,
+                       std::move(callback)));
+  }
+
+  void UnsubscribeFromJobEvents(const std::string& printer_id) override {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    auto it = job_subscriptions_.find(printer_id);
+    if (it == job_subscriptions_.end()) {
+      return;
+    }
+    backend_task_runner_->PostTask(
+        FROM_HERE,
+        base::BindOnce(&CancelJobSubscription, printer_id, it->second.id));
+    std::vector<base::OnceCallback<void(bool)>> watched_callbacks =
+        std::move(it->second.watched_callbacks);
+    job_subscriptions_.erase(it);
+    if (job_subscriptions_.empty()) {
+      // Nothing is left to wait for.
+      AbandonJobEventsRequest();
+      job_events_timer_.Stop();
+    }
+    for (auto& callback : watched_callbacks) {
+      std::move(callback).Run(false);
+    }
+  }
+
  private:
+  struct JobSubscription {
+    explicit JobSubscription(int id) : id(id) {}
+    JobSubscription(JobSubscription&&) = default;
+    JobSubscription& operator=(JobSubscription&&) = default;
+    ~JobSubscription() = default;
+
+    int id;
+    // The sequence number of the latest event received.
+    int last_sequence_number = 0;
+    // Whether the outstanding or the next Get-Notifications request covers
+    // this subscription.
+    bool is_requested = false;
+    // Whether CUPS has held a Get-Notifications request covering this
+    // subscription, or delivered events through one.
+    bool is_watched = false;
+    // Run with true once this subscription is watched. Until then, the job
+    // queue of the printer has to be polled.
+    std::vector<base::OnceCallback<void(bool)>> watched_callbacks;
+  };
+
+  void OnJobSubscriptionCreated(const std::string& printer_id,
+                                base::OnceCallback<void(bool)> callback,
+                                std::optional<int> subscription_id) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    if (!subscription_id) {
+      std::move(callback).Run(false);
+      return;
+    }
+    auto [it, inserted] =
+        job_subscriptions_.emplace(printer_id, JobSubscription(*subscription_id));
+    if (!inserted) {
+      // The printer was subscribed concurrently, drop the duplicate.
+      backend_task_runner_->PostTask(
+          FROM_HERE,
+          base::BindOnce(&CancelJobSubscription, printer_id, *subscription_id));
+    }
+    if (it->second.is_watched) {
+      std::move(callback).Run(true);
+      return;
+    }
+    it->second.watched_callbacks.push_back(std::move(callback));
+    MaybeWaitForJobEvents();
+  }
+
+  // Makes sure that a Get-Notifications request covers all subscriptions. If
+  // the outstanding request, or the one waiting for the interval CUPS asked
+  // for, misses a new subscription, it is replaced by a request for all of
+  // them right away.
+  void MaybeWaitForJobEvents() {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    if (job_subscriptions_.empty()) {
+      return;
+    }
+    const bool all_requested = base::ranges::all_of(
+        job_subscriptions_, [](const auto& subscription) {
+          return subscription.second.is_requested;
+        });
+    if (all_requested &&
+        (job_events_connection_ || job_events_timer_.IsRunning())) {
+      return;
+    }
+    job_events_timer_.Stop();
+    AbandonJobEventsRequest();
+
+    std::vector<int> subscription_ids;
+    std::vector<int> sequence_numbers;
+    for (auto& [printer_id, subscription] : job_subscriptions_) {
+      subscription_ids.push_back(subscription.id);
+      sequence_numbers.push_back(subscription.last_sequence_number + 1);
+      subscription.is_requested = true;
+    }
+    job_events_connection_ = base::MakeRefCounted<JobEventsConnection>();
+    job_events_task_runner_->PostTaskAndReplyWithResult(
+        FROM_HERE,
+        base::BindOnce(&GetJobNotifications, job_events_connection_,
+                       std::move(subscription_ids),
+                       std::move(sequence_numbers)),
+        base::BindOnce(&CupsWrapperImpl::OnJobNotifications,
+                       weak_ptr_factory_.GetWeakPtr(),
+                       job_events_connection_));
+
+    // CUPS may answer right away rather than hold the request, e.g. if it does
+    // not honour notify-wait. Only a request which is still outstanding after
+    // a while shows that events will be delivered without polling. It is safe
+    // to pass an unretained pointer here because |this| owns the timer.
+    job_events_held_timer_.Start(
+        FROM_HERE, kMinJobEventsInterval,
+        base::BindOnce(&CupsWrapperImpl::MarkRequestedSubscriptionsWatched,
+                       base::Unretained(this)));
+  }
+
+  // Marks the subscriptions covered by the latest Get-Notifications request as
+  // watched, and tells the callers waiting for that.
+  void MarkRequestedSubscriptionsWatched() {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    std::vector<base::OnceCallback<void(bool)>> watched_callbacks;
+    for (auto& [printer_id, subscription] : job_subscriptions_) {
+      if (!subscription.is_requested || subscription.is_watched) {
+        continue;
+      }
+      subscription.is_watched = true;
+      for (auto& callback : subscription.watched_callbacks) {
+        watched_callbacks.push_back(std::move(callback));
+      }
+      subscription.watched_callbacks.clear();
+    }
+    for (auto& callback : watched_callbacks) {
+      std::move(callback).Run(true);
+    }
+  }
+
+  // Shuts down the connection of the outstanding Get-Notifications request, if
+  // any, so that it returns right away and its result is ignored.
+  void AbandonJobEventsRequest() {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    job_events_held_timer_.Stop();
+    if (job_events_connection_) {
+      job_events_connection_->Shutdown();
+      job_events_connection_.reset();
+    }
+  }
+
+  void OnJobNotifications(scoped_refptr<JobEventsConnection> connection,
+                          std::unique_ptr<JobNotifications> notifications) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    if (connection != job_events_connection_) {
+      // The request was abandoned.
+      return;
+    }
+    job_events_connection_.reset();
+    job_events_held_timer_.Stop();
+
+    // If CUPS failed to answer, events may have been missed, so report every
+    // subscribed printer.
+    std::vector<std::string> printer_ids;
+    for (auto& [printer_id, subscription] : job_subscriptions_) {
+      if (!notifications->success) {
+        printer_ids.push_back(printer_id);
+        continue;
+      }
+      auto it = notifications->sequence_numbers.find(subscription.id);
+      if (it == notifications->sequence_numbers.end()) {
+        continue;
+      }
+      subscription.last_sequence_number = it->second;
+      printer_ids.push_back(printer_id);
+    }
+    if (!printer_ids.empty() && job_events_callback_) {
+      job_events_callback_.Run(printer_ids);
+    }
+    if (notifications->success && !notifications->sequence_numbers.empty()) {
+      MarkRequestedSubscriptionsWatched();
+    }
+
+    // When CUPS answers without waiting for events, it tells how long to wait
+    // before asking again. An answer without events may also come right away,
+    // so requests are never repeated faster than printers would be polled.
+    base::TimeDelta delay;
+    if (!notifications->success) {
+      delay = kJobEventsRetryDelay;
+    } else if (notifications->sequence_numbers.empty()) {
+      delay = std::max(notifications->get_interval, kMinJobEventsInterval);
+    }
+    // It is safe to pass an unretained pointer here because |this| owns the
+    // timer.
+    job_events_timer_.Start(
+        FROM_HERE, delay,
+        base::BindOnce(&CupsWrapperImpl::MaybeWaitForJobEvents,
+                       base::Unretained(this)));
+  }
+
   class Backend {
    public:
     Backend() : cups_connection_(::printing::CupsConnection::Create()) {
@@ -150,7 +613,20 @@ class CupsWrapperImpl : public CupsWrapper {
 
   scoped_refptr<base::SequencedTaskRunner> backend_task_runner_;
 
+  // Runs the blocking Get-Notifications requests.
+  scoped_refptr<base::SequencedTaskRunner> job_events_task_runner_;
+
+  JobEventsCallback job_events_callback_;
+  base::flat_map<std::string, JobSubscription> job_subscriptions_;
+  // The connection of the outstanding Get-Notifications request, if any.
+  scoped_refptr<JobEventsConnection> job_events_connection_;
+  base::OneShotTimer job_events_timer_;
+  // Marks the subscriptions as watched once CUPS has held the outstanding
+  // Get-Notifications request for a while.
+  base::OneShotTimer job_events_held_timer_;
+
   SEQUENCE_CHECKER(sequence_checker_);
+  base::WeakPtrFactory<CupsWrapperImpl> weak_ptr_factory_{this};
 };
 
 // static
@@ -17,8 +17,17 @@ TestCupsWrapper::~TestCupsWrapper() = default;
 void TestCupsWrapper::QueryCupsPrintJobs(
     const std::vector<std::string>& printer_ids,
     base::OnceCallback<void(std::unique_ptr<QueryResult>)> callback) {
+  ++query_count_;
   auto result = std::make_unique<CupsWrapper::QueryResult>();
-  result->success = false;
+  result->success = query_succeeds_;
+  if (query_succeeds_) {
+    for (const std::string& printer_id : printer_ids) {
+      ::printing::QueueStatus& queue = result->queues.emplace_back();
+      auto it = jobs_.find(printer_id);
+      if (it != jobs_.end())
+        queue.jobs = it->second;
+    }
+  }
   std::move(callback).Run(std::move(result));
 }
 
@@ -35,6 +44,54 @@ void TestCupsWrapper::QueryCupsPrinterStatus(
   std::move(callback).Run(std::move(result));
 }
 
+void TestCupsWrapper::SetJobEventsCallback(JobEventsCallback callback) {
+  job_events_callback_ = std::move(callback);
+}
+
+void TestCupsWrapper::SubscribeToJobEvents(
+    const std::string& printer_id,
+    base::OnceCallback<void(bool)> callback) {
+  if (supports_job_events_)
+    subscribed_printers_.insert(printer_id);
+  if (defer_job_event_subscriptions_) {
+    deferred_subscription_callbacks_.push_back(std::move(callback));
+    return;
+  }
+  std::move(callback).Run(supports_job_events_);
+}
+
+void TestCupsWrapper::CompleteJobEventSubscriptions() {
+  std::vector<base::OnceCallback<void(bool)>> callbacks =
+      std::move(deferred_subscription_callbacks_);
+  for (auto& callback : callbacks)
+    std::move(callback).Run(supports_job_events_);
+}
+
+void TestCupsWrapper::UnsubscribeFromJobEvents(const std::string& printer_id) {
+  subscribed_printers_.erase(printer_id);
+}
+
+bool TestCupsWrapper::IsSubscribedToJobEvents(
+    const std::string& printer_id) const {
+  return subscribed_printers_.contains(printer_id);
+}
+
+void TestCupsWrapper::EmitJobEvents(
+    const std::vector<std::string>& printer_ids) {
+  std::vector<std::string> subscribed_printer_ids;
+  for (const std::string& printer_id : printer_ids) {
+    if (subscribed_printers_.contains(printer_id))
+      subscribed_printer_ids.push_back(printer_id);
+  }
+  if (!subscribed_printer_ids.empty() && job_events_callback_)
+    job_events_callback_.Run(subscribed_printer_ids);
+}
+
+void TestCupsWrapper::SetJobs(const std::string& printer_id,
+                              std::vector<::printing::CupsJob> jobs) {
+  jobs_[printer_id] = std::move(jobs);
+}
+
 void TestCupsWrapper::SetPrinterStatus(
     const std::string& printer_id,
     const ::printing::PrinterStatus::PrinterReason& printer_reason) {
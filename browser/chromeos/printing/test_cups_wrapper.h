@@ -5,7 +5,11 @@
 #ifndef CHROME_BROWSER_CHROMEOS_PRINTING_TEST_CUPS_WRAPPER_H_
 #define CHROME_BROWSER_CHROMEOS_PRINTING_TEST_CUPS_WRAPPER_H_
 
+#include <string>
+#include <vector>
+
 #include "base/containers/flat_map.h"
+#include "base/containers/flat_set.h"
 #include "chrome/browser/chromeos/printing/cups_wrapper.h"
 
 namespace chromeos {
@@ -25,14 +29,60 @@ class TestCupsWrapper : public CupsWrapper {
       const std::string& printer_id,
       base::OnceCallback<void(std::unique_ptr<::printing::PrinterStatus>)>
           callback) override;
+  void SetJobEventsCallback(JobEventsCallback callback) override;
+  void SubscribeToJobEvents(const std::string& printer_id,
+                            base::OnceCallback<void(bool)> callback) override;
+  void UnsubscribeFromJobEvents(const std::string& printer_id) override;
+
+  // Job event subscriptions fail unless this is set.
+  void set_supports_job_events(bool supports_job_events) {
+    supports_job_events_ = supports_job_events;
+  }
+
+  // Holds back the results of job event subscriptions until
+  // CompleteJobEventSubscriptions() is called, as when the subscriptions are
+  // not covered by a request for job events yet.
+  void set_defer_job_event_subscriptions(bool defer) {
+    defer_job_event_subscriptions_ = defer;
+  }
+
+  // Passes the results of the held back job event subscriptions.
+  void CompleteJobEventSubscriptions();
+
+  bool IsSubscribedToJobEvents(const std::string& printer_id) const;
+
+  // Reports job events of the subscribed printers among |printer_ids|.
+  void EmitJobEvents(const std::vector<std::string>& printer_ids);
 
   void SetPrinterStatus(
       const std::string& printer_id,
       const ::printing::PrinterStatus::PrinterReason& printer_reason);
 
+  // Job queries fail unless this is set.
+  void set_query_succeeds(bool query_succeeds) {
+    query_succeeds_ = query_succeeds;
+  }
+
+  // Sets the jobs reported for the queue of |printer_id|.
+  void SetJobs(const std::string& printer_id,
+               std::vector<::printing::CupsJob> jobs);
+
+  // The number of job queries made so far.
+  int query_count() const { return query_count_; }
+
  private:
   base::flat_map<std::string, ::printing::PrinterStatus::PrinterReason>
       printer_reasons_;
+
+  bool query_succeeds_ = false;
+  int query_count_ = 0;
+  base::flat_map<std::string, std::vector<::printing::CupsJob>> jobs_;
+
+  bool supports_job_events_ = false;
+  bool defer_job_event_subscriptions_ = false;
+  std::vector<base::OnceCallback<void(bool)>> deferred_subscription_callbacks_;
+  base::flat_set<std::string> subscribed_printers_;
+  JobEventsCallback job_events_callback_;
 };
 
 }  // namespace chromeos
@@ -19,6 +19,7 @@
 #include "base/task/thread_pool.h"
 #include "base/version.h"
 #include "chrome/browser/browser_process.h"
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
 #include "chrome/common/chrome_features.h"
 #include "components/component_updater/component_updater_paths.h"
 #include "components/fingerprinting_protection_filter/browser/fingerprinting_protection_filter_constants.h"
@@ -91,11 +92,18 @@ void AntiFingerprintingBlockedDomainListComponentInstallerPolicy::
       fingerprinting_protection_filter::kUnindexedRulesetDataFileName);
   ruleset_info.license_path =
       install_dir.Append(subresource_filter::kUnindexedRulesetLicenseFileName);
-  subresource_filter::RulesetService* ruleset_service =
-      g_browser_process->fingerprinting_protection_ruleset_service();
-  if (ruleset_service != nullptr) {
-    ruleset_service->IndexAndStoreAndPublishRulesetIfNeeded(ruleset_info);
-  }
+  ComponentActivationScheduler::GetInstance()->Schedule(
+      "AntiFingerprintingBlockedDomainList", ActivationPriority::kDeferred,
+      base::BindOnce(
+          [](const subresource_filter::UnindexedRulesetInfo& ruleset_info) {
+            subresource_filter::RulesetService* ruleset_service =
+                g_browser_process->fingerprinting_protection_ruleset_service();
+            if (ruleset_service != nullptr) {
+              ruleset_service->IndexAndStoreAndPublishRulesetIfNeeded(
+                  ruleset_info);
+            }
+          },
+          std::move(ruleset_info)));
 }
 
 // Called during startup and installation before ComponentReady().
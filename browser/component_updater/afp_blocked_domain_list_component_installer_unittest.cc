@@ -11,6 +11,8 @@
 #include "base/memory/raw_ptr.h"
 #include "base/test/scoped_feature_list.h"
 #include "base/version.h"
+#include "chrome/browser/after_startup_task_utils.h"
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
 #include "chrome/common/chrome_features.h"
 #include "chrome/test/base/testing_browser_process.h"
 #include "components/component_updater/mock_component_updater_service.h"
@@ -110,12 +112,18 @@ class AntiFingerprintingBlockedDomainListComponentInstallerTest
             std::move(test_ruleset_service));
     policy_ = std::make_unique<
         AntiFingerprintingBlockedDomainListComponentInstallerPolicy>();
+
+    // Rulesets are only activated once browser startup is complete.
+    ComponentActivationScheduler::GetInstance()->ResetForTesting();
+    AfterStartupTaskUtils::SetBrowserStartupIsCompleteForTesting();
   }
 
   void TearDown() override {
     TestingBrowserProcess::GetGlobal()
         ->SetFingerprintingProtectionRulesetService(nullptr);
     task_env_.RunUntilIdle();
+    ComponentActivationScheduler::GetInstance()->ResetForTesting();
+    AfterStartupTaskUtils::UnsafeResetForTesting();
     PlatformTest::TearDown();
   }
 
@@ -13,9 +13,10 @@
 #include "base/feature_list.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/functional/bind.h"
 #include "base/functional/callback.h"
 #include "base/logging.h"
-#include "base/task/thread_pool.h"
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
 #include "components/commerce/core/commerce_heuristics_data.h"
 #include "components/component_updater/component_updater_paths.h"
 #if !BUILDFLAG(IS_ANDROID)
@@ -152,8 +153,8 @@ void CommerceHeuristicsInstallerPolicy::ComponentReady(
   VLOG(1) << "Component ready, version " << version.GetString() << " in "
           << install_dir.value();
 
-  base::ThreadPool::PostTask(
-      FROM_HERE, {base::MayBlock(), base::TaskPriority::BEST_EFFORT},
+  ComponentActivationScheduler::GetInstance()->ScheduleBlocking(
+      "CommerceHeuristics", ActivationPriority::kDeferred,
       base::BindOnce(&LoadHeuristicFilesFromDisk, version, install_dir));
 }
 
@@ -0,0 +1,165 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
+
+#include <utility>
+
+#include "base/functional/bind.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/no_destructor.h"
+#include "base/ranges/algorithm.h"
+#include "base/strings/strcat.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
+#include "base/timer/elapsed_timer.h"
+#include "chrome/browser/after_startup_task_utils.h"
+#include "content/public/browser/browser_thread.h"
+
+namespace component_updater {
+
+namespace {
+
+base::TimeDelta RunAndMeasure(base::OnceClosure activation) {
+  base::ElapsedTimer timer;
+  std::move(activation).Run();
+  return timer.Elapsed();
+}
+
+}  // namespace
+
+ComponentActivationScheduler::PendingActivation::PendingActivation(
+    std::string_view name,
+    bool may_block,
+    base::OnceClosure activation)
+    : name(name), may_block(may_block), activation(std::move(activation)) {}
+
+ComponentActivationScheduler::PendingActivation::PendingActivation(
+    PendingActivation&&) = default;
+
+ComponentActivationScheduler::PendingActivation&
+ComponentActivationScheduler::PendingActivation::operator=(
+    PendingActivation&&) = default;
+
+ComponentActivationScheduler::PendingActivation::~PendingActivation() =
+    default;
+
+ComponentActivationScheduler::ComponentActivationScheduler() = default;
+
+ComponentActivationScheduler::~ComponentActivationScheduler() = default;
+
+// static
+ComponentActivationScheduler* ComponentActivationScheduler::GetInstance() {
+  static base::NoDestructor<ComponentActivationScheduler> instance;
+  return instance.get();
+}
+
+void ComponentActivationScheduler::Schedule(std::string_view name,
+                                            ActivationPriority priority,
+                                            base::OnceClosure activation) {
+  Enqueue(PendingActivation(name, /*may_block=*/false, std::move(activation)),
+          priority);
+}
+
+void ComponentActivationScheduler::ScheduleBlocking(
+    std::string_view name,
+    ActivationPriority priority,
+    base::OnceClosure activation) {
+  Enqueue(PendingActivation(name, /*may_block=*/true, std::move(activation)),
+          priority);
+}
+
+void ComponentActivationScheduler::ResetForTesting() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  weak_ptr_factory_.InvalidateWeakPtrs();
+  deferred_activations_.clear();
+  running_deferred_activations_ = 0;
+  is_waiting_for_browser_startup_ = false;
+}
+
+void ComponentActivationScheduler::Enqueue(PendingActivation activation,
+                                           ActivationPriority priority) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  if (priority == ActivationPriority::kCritical) {
+    Run(std::move(activation), priority);
+    return;
+  }
+
+  auto it = base::ranges::find(deferred_activations_, activation.name,
+                               &PendingActivation::name);
+  if (it != deferred_activations_.end()) {
+    *it = std::move(activation);
+  } else {
+    deferred_activations_.push_back(std::move(activation));
+  }
+  MaybeStartDeferredActivations();
+}
+
+void ComponentActivationScheduler::MaybeStartDeferredActivations() {
+  if (!AfterStartupTaskUtils::IsBrowserStartupComplete()) {
+    if (!is_waiting_for_browser_startup_) {
+      is_waiting_for_browser_startup_ = true;
+      AfterStartupTaskUtils::PostTask(
+          FROM_HERE, base::SequencedTaskRunner::GetCurrentDefault(),
+          base::BindOnce(
+              &ComponentActivationScheduler::OnBrowserStartupComplete,
+              weak_ptr_factory_.GetWeakPtr()));
+    }
+    return;
+  }
+
+  while (!deferred_activations_.empty() &&
+         running_deferred_activations_ < kMaxConcurrentActivations) {
+    ++running_deferred_activations_;
+    // Post each activation separately, so that the UI thread stays
+    // responsive in between.
+    base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+        FROM_HERE,
+        base::BindOnce(&ComponentActivationScheduler::Run,
+                       weak_ptr_factory_.GetWeakPtr(),
+                       std::move(deferred_activations_.front()),
+                       ActivationPriority::kDeferred));
+    deferred_activations_.pop_front();
+  }
+}
+
+void ComponentActivationScheduler::OnBrowserStartupComplete() {
+  is_waiting_for_browser_startup_ = false;
+  MaybeStartDeferredActivations();
+}
+
+void ComponentActivationScheduler::Run(PendingActivation activation,
+                                       ActivationPriority priority) {
+  if (activation.may_block) {
+    base::ThreadPool::PostTaskAndReplyWithResult(
+        FROM_HERE,
+        {base::MayBlock(), priority == ActivationPriority::kCritical
+                               ? base::TaskPriority::USER_VISIBLE
+                               : base::TaskPriority::BEST_EFFORT},
+        base::BindOnce(&RunAndMeasure, std::move(activation.activation)),
+        base::BindOnce(&ComponentActivationScheduler::OnActivationComplete,
+                       weak_ptr_factory_.GetWeakPtr(), activation.name,
+                       priority));
+    return;
+  }
+
+  OnActivationComplete(activation.name, priority,
+                       RunAndMeasure(std::move(activation.activation)));
+}
+
+void ComponentActivationScheduler::OnActivationComplete(
+    const std::string& name,
+    ActivationPriority priority,
+    base::TimeDelta cost) {
+  base::UmaHistogramTimes(
+      base::StrCat({"ComponentUpdater.ActivationTime.", name}), cost);
+
+  if (priority == ActivationPriority::kDeferred) {
+    --running_deferred_activations_;
+    MaybeStartDeferredActivations();
+  }
+}
+
+}  // namespace component_updater
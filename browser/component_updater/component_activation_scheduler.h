@@ -0,0 +1,103 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_COMPONENT_UPDATER_COMPONENT_ACTIVATION_SCHEDULER_H_
+#define CHROME_BROWSER_COMPONENT_UPDATER_COMPONENT_ACTIVATION_SCHEDULER_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <string_view>
+
+#include "base/containers/circular_deque.h"
+#include "base/functional/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+
+namespace component_updater {
+
+// How soon the payload of a component must be activated once its installer
+// reports it ready.
+enum class ActivationPriority {
+  // Activated right away, e.g. because network requests wait for it.
+  kCritical,
+  // Activated once browser startup is complete.
+  kDeferred,
+};
+
+// Runs the work which loads a ready component payload and hands it over to its
+// consumers, called activation below. Deferred activations are held back until
+// browser startup is complete, so that they do not compete with profile loading
+// and first paint, and then run at most |kMaxConcurrentActivations| at a time.
+// The time taken by each activation is recorded per component.
+//
+// Must only be used on the UI thread.
+class ComponentActivationScheduler {
+ public:
+  static constexpr size_t kMaxConcurrentActivations = 2;
+
+  ComponentActivationScheduler();
+
+  ComponentActivationScheduler(const ComponentActivationScheduler&) = delete;
+  ComponentActivationScheduler& operator=(const ComponentActivationScheduler&) =
+      delete;
+
+  ~ComponentActivationScheduler();
+
+  static ComponentActivationScheduler* GetInstance();
+
+  // Activates the payload of the component called |name| by running
+  // |activation| on the UI thread. |name| is used as a histogram suffix. If a
+  // deferred activation of the same component is still pending, it is replaced
+  // by |activation|, as only the newest payload needs to be activated.
+  void Schedule(std::string_view name,
+                ActivationPriority priority,
+                base::OnceClosure activation);
+
+  // Same as above, but |activation| may block and is run on the thread pool.
+  void ScheduleBlocking(std::string_view name,
+                        ActivationPriority priority,
+                        base::OnceClosure activation);
+
+  // Drops pending deferred activations and the replies of those in flight, and
+  // stops waiting for browser startup, so that tests using the global instance
+  // start from a clean state.
+  void ResetForTesting();
+
+ private:
+  struct PendingActivation {
+    PendingActivation(std::string_view name,
+                      bool may_block,
+                      base::OnceClosure activation);
+    PendingActivation(PendingActivation&&);
+    PendingActivation& operator=(PendingActivation&&);
+    ~PendingActivation();
+
+    std::string name;
+    bool may_block;
+    base::OnceClosure activation;
+  };
+
+  void Enqueue(PendingActivation activation, ActivationPriority priority);
+
+  // Starts deferred activations while there are free slots, or waits for
+  // browser startup to complete.
+  void MaybeStartDeferredActivations();
+  void OnBrowserStartupComplete();
+
+  void Run(PendingActivation activation, ActivationPriority priority);
+  void OnActivationComplete(const std::string& name,
+                            ActivationPriority priority,
+                            base::TimeDelta cost);
+
+  base::circular_deque<PendingActivation> deferred_activations_;
+  size_t running_deferred_activations_ = 0;
+  bool is_waiting_for_browser_startup_ = false;
+
+  base::WeakPtrFactory<ComponentActivationScheduler> weak_ptr_factory_{this};
+};
+
+}  // namespace component_updater
+
+#endif  // CHROME_BROWSER_COMPONENT_UPDATER_COMPONENT_ACTIVATION_SCHEDULER_H_
@@ -0,0 +1,169 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/functional/bind.h"
+#include "base/memory/raw_ptr.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/run_loop.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/threading/thread_restrictions.h"
+#include "chrome/browser/after_startup_task_utils.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace component_updater {
+
+namespace {
+
+// Stands in for a component installer, recording when its payload is
+// activated.
+class FakeInstaller {
+ public:
+  FakeInstaller(std::string name, std::vector<std::string>* activations)
+      : name_(std::move(name)), activations_(activations) {}
+
+  base::OnceClosure GetActivation(std::string payload) {
+    return base::BindOnce(
+        [](std::vector<std::string>* activations, std::string payload) {
+          activations->push_back(std::move(payload));
+        },
+        activations_, std::move(payload));
+  }
+
+  const std::string& name() const { return name_; }
+
+ private:
+  const std::string name_;
+  const raw_ptr<std::vector<std::string>> activations_;
+};
+
+}  // namespace
+
+class ComponentActivationSchedulerTest : public testing::Test {
+ protected:
+  void SetUp() override { AfterStartupTaskUtils::UnsafeResetForTesting(); }
+
+  void TearDown() override { AfterStartupTaskUtils::UnsafeResetForTesting(); }
+
+  content::BrowserTaskEnvironment task_environment_;
+  ComponentActivationScheduler scheduler_;
+};
+
+TEST_F(ComponentActivationSchedulerTest, DefersUntilBrowserStartupComplete) {
+  base::HistogramTester histogram_tester;
+  std::vector<std::string> activations;
+  FakeInstaller crl_set("CRLSet", &activations);
+  FakeInstaller crowd_deny("CrowdDeny", &activations);
+  FakeInstaller hyphenation("Hyphenation", &activations);
+
+  scheduler_.Schedule(crowd_deny.name(), ActivationPriority::kDeferred,
+                      crowd_deny.GetActivation("crowd deny 1"));
+  scheduler_.Schedule(crl_set.name(), ActivationPriority::kCritical,
+                      crl_set.GetActivation("crl set"));
+  scheduler_.Schedule(hyphenation.name(), ActivationPriority::kDeferred,
+                      hyphenation.GetActivation("hyphenation"));
+  // Supersedes the pending activation, keeping its place in the queue.
+  scheduler_.Schedule(crowd_deny.name(), ActivationPriority::kDeferred,
+                      crowd_deny.GetActivation("crowd deny 2"));
+  task_environment_.RunUntilIdle();
+
+  EXPECT_THAT(activations, testing::ElementsAre("crl set"));
+
+  AfterStartupTaskUtils::SetBrowserStartupIsCompleteForTesting();
+  task_environment_.RunUntilIdle();
+
+  EXPECT_THAT(activations,
+              testing::ElementsAre("crl set", "crowd deny 2", "hyphenation"));
+  histogram_tester.ExpectTotalCount("ComponentUpdater.ActivationTime.CRLSet",
+                                    1);
+  histogram_tester.ExpectTotalCount(
+      "ComponentUpdater.ActivationTime.CrowdDeny", 1);
+  histogram_tester.ExpectTotalCount(
+      "ComponentUpdater.ActivationTime.Hyphenation", 1);
+}
+
+TEST_F(ComponentActivationSchedulerTest, ResetForTestingDropsPending) {
+  std::vector<std::string> activations;
+  FakeInstaller crowd_deny("CrowdDeny", &activations);
+
+  scheduler_.Schedule(crowd_deny.name(), ActivationPriority::kDeferred,
+                      crowd_deny.GetActivation("crowd deny 1"));
+  scheduler_.ResetForTesting();
+  AfterStartupTaskUtils::SetBrowserStartupIsCompleteForTesting();
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(activations.empty());
+
+  // The scheduler is usable again afterwards.
+  scheduler_.Schedule(crowd_deny.name(), ActivationPriority::kDeferred,
+                      crowd_deny.GetActivation("crowd deny 2"));
+  task_environment_.RunUntilIdle();
+  EXPECT_THAT(activations, testing::ElementsAre("crowd deny 2"));
+}
+
+TEST_F(ComponentActivationSchedulerTest, BoundsConcurrentBlockingActivations) {
+  AfterStartupTaskUtils::SetBrowserStartupIsCompleteForTesting();
+
+  constexpr size_t kLimit =
+      ComponentActivationScheduler::kMaxConcurrentActivations;
+  constexpr int kInstallerCount = 6;
+  std::atomic<size_t> running{0};
+  std::atomic<size_t> max_running{0};
+  std::atomic<int> completed{0};
+  base::WaitableEvent limit_reached;
+  // Holds every activation until the test has checked how many run at once.
+  base::WaitableEvent release(base::WaitableEvent::ResetPolicy::MANUAL);
+  for (int i = 0; i < kInstallerCount; ++i) {
+    scheduler_.ScheduleBlocking(
+        "Installer" + base::NumberToString(i), ActivationPriority::kDeferred,
+        base::BindOnce(
+            [](std::atomic<size_t>* running, std::atomic<size_t>* max_running,
+               std::atomic<int>* completed, base::WaitableEvent* limit_reached,
+               base::WaitableEvent* release) {
+              const size_t now_running = ++*running;
+              size_t max = max_running->load();
+              while (now_running > max &&
+                     !max_running->compare_exchange_weak(max, now_running)) {
+              }
+              if (now_running == kLimit) {
+                limit_reached->Signal();
+              }
+              {
+                base::ScopedAllowBaseSyncPrimitivesForTesting allow_wait;
+                release->Wait();
+              }
+              --*running;
+              ++*completed;
+            },
+            &running, &max_running, &completed, &limit_reached, &release));
+  }
+
+  // Start the first activations, and wait until as many run as allowed.
+  base::RunLoop().RunUntilIdle();
+  {
+    base::ScopedAllowBaseSyncPrimitivesForTesting allow_wait;
+    limit_reached.Wait();
+  }
+  // No further activation is started while those are blocked.
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(kLimit, running.load());
+  EXPECT_EQ(0, completed.load());
+
+  release.Signal();
+  task_environment_.RunUntilIdle();
+
+  // No payload is lost, and the limit is honoured.
+  EXPECT_EQ(kInstallerCount, completed.load());
+  EXPECT_EQ(kLimit, max_running.load());
+}
+
+}  // namespace component_updater
@@ -18,6 +18,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/task/thread_pool.h"
 #include "base/threading/scoped_blocking_call.h"
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
 #include "components/component_updater/component_installer.h"
 #include "components/component_updater/component_updater_service.h"
 #include "content/public/browser/browser_thread.h"
@@ -127,8 +128,15 @@ void CRLSetPolicy::OnCustomUninstall() {}
 void CRLSetPolicy::ComponentReady(const base::Version& version,
                                   const base::FilePath& install_dir,
                                   base::Value::Dict manifest) {
-  g_crl_set_data.Get().set_crl_set_path(install_dir.Append(kCRLSetFile));
-  g_crl_set_data.Get().ConfigureCertVerifierServiceFactory();
+  // Certificate verification must not run without revocation data.
+  ComponentActivationScheduler::GetInstance()->Schedule(
+      "CRLSet", ActivationPriority::kCritical,
+      base::BindOnce(
+          [](const base::FilePath& crl_set_path) {
+            g_crl_set_data.Get().set_crl_set_path(crl_set_path);
+            g_crl_set_data.Get().ConfigureCertVerifierServiceFactory();
+          },
+          install_dir.Append(kCRLSetFile)));
 }
 
 base::FilePath CRLSetPolicy::GetRelativeInstallDir() const {
@@ -12,10 +12,12 @@
 
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/functional/bind.h"
 #include "base/functional/callback.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
 #include "base/values.h"
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
 #include "chrome/browser/permissions/crowd_deny_preload_data.h"
 #include "components/permissions/permission_uma_util.h"
 
@@ -87,8 +89,11 @@ void CrowdDenyComponentInstallerPolicy::ComponentReady(
     return;
   }
 
-  CrowdDenyPreloadData::GetInstance()->LoadFromDisk(
-      GetPreloadDataFilePath(install_dir), version);
+  ComponentActivationScheduler::GetInstance()->Schedule(
+      "CrowdDeny", ActivationPriority::kDeferred,
+      base::BindOnce(&CrowdDenyPreloadData::LoadFromDisk,
+                     base::Unretained(CrowdDenyPreloadData::GetInstance()),
+                     GetPreloadDataFilePath(install_dir), version));
 }
 
 base::FilePath CrowdDenyComponentInstallerPolicy::GetRelativeInstallDir()
@@ -16,8 +16,8 @@
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
 #include "base/path_service.h"
-#include "base/task/thread_pool.h"
 #include "base/version.h"
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
 #include "components/component_updater/component_updater_paths.h"
 #include "components/safe_browsing/content/common/file_type_policies.h"
 
@@ -90,8 +90,8 @@ void FileTypePoliciesComponentInstallerPolicy::ComponentReady(
   VLOG(1) << "Component ready, version " << version.GetString() << " in "
           << install_dir.value();
 
-  base::ThreadPool::PostTask(
-      FROM_HERE, {base::MayBlock(), base::TaskPriority::BEST_EFFORT},
+  ComponentActivationScheduler::GetInstance()->ScheduleBlocking(
+      "FileTypePolicies", ActivationPriority::kDeferred,
       base::BindOnce(&LoadFileTypesFromDisk, GetInstalledPath(install_dir)));
 }
 
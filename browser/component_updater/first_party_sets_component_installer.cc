@@ -7,8 +7,10 @@
 #include "components/component_updater/installer_policies/first_party_sets_component_installer_policy.h"
 
 #include "base/feature_list.h"
+#include "base/functional/bind.h"
 #include "base/logging.h"
 #include "base/task/thread_pool.h"
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
 #include "content/public/browser/first_party_sets_handler.h"
 #include "content/public/common/content_features.h"
 #include "net/base/features.h"
@@ -27,6 +29,12 @@ base::TaskPriority GetTaskPriority() {
              : base::TaskPriority::BEST_EFFORT;
 }
 
+component_updater::ActivationPriority GetActivationPriority() {
+  return GetTaskPriority() == base::TaskPriority::USER_BLOCKING
+             ? component_updater::ActivationPriority::kCritical
+             : component_updater::ActivationPriority::kDeferred;
+}
+
 }  // namespace
 
 namespace component_updater {
@@ -42,8 +50,13 @@ void RegisterFirstPartySetsComponent(ComponentUpdateService* cus) {
       /*on_sets_ready=*/base::BindOnce([](base::Version version,
                                           base::File sets_file) {
         VLOG(1) << "Received Related Website Sets";
-        content::FirstPartySetsHandler::GetInstance()->SetPublicFirstPartySets(
-            version, std::move(sets_file));
+        ComponentActivationScheduler::GetInstance()->Schedule(
+            "FirstPartySets", GetActivationPriority(),
+            base::BindOnce(
+                &content::FirstPartySetsHandler::SetPublicFirstPartySets,
+                base::Unretained(
+                    content::FirstPartySetsHandler::GetInstance()),
+                std::move(version), std::move(sets_file)));
       }),
       GetTaskPriority());
 
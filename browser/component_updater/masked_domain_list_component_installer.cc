@@ -6,9 +6,11 @@
 
 #include <utility>
 
+#include "base/functional/bind.h"
 #include "base/logging.h"
 #include "base/task/task_traits.h"
 #include "base/version.h"
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
 #include "components/component_updater/installer_policies/masked_domain_list_component_installer_policy.h"
 #include "content/public/browser/network_service_instance.h"
 #include "mojo/public/cpp/base/proto_wrapper.h"
@@ -29,9 +31,15 @@ void RegisterMaskedDomainListComponent(ComponentUpdateService* cus) {
              std::optional<mojo_base::ProtoWrapper> masked_domain_list) {
             if (masked_domain_list.has_value()) {
               VLOG(1) << "Received Masked Domain List";
-              content::GetNetworkService()->UpdateMaskedDomainList(
-                  std::move(masked_domain_list.value()),
-                  /*exclusion_list=*/std::vector<std::string>());
+              ComponentActivationScheduler::GetInstance()->Schedule(
+                  "MaskedDomainList", ActivationPriority::kDeferred,
+                  base::BindOnce(
+                      [](mojo_base::ProtoWrapper masked_domain_list) {
+                        content::GetNetworkService()->UpdateMaskedDomainList(
+                            std::move(masked_domain_list),
+                            /*exclusion_list=*/std::vector<std::string>());
+                      },
+                      std::move(masked_domain_list.value())));
             } else {
               LOG(ERROR) << "Could not read Masked Domain List file";
             }
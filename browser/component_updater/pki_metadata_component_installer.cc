@@ -28,6 +28,7 @@
 #include "base/time/time.h"
 #include "base/values.h"
 #include "chrome/browser/browser_features.h"
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
 #include "chrome/browser/net/key_pinning.pb.h"
 #include "content/public/browser/network_service_instance.h"
 #include "net/net_buildflags.h"
@@ -457,8 +458,13 @@ void PKIMetadataComponentInstallerPolicy::ComponentReady(
     const base::Version& version,
     const base::FilePath& install_dir,
     base::Value::Dict /* manifest */) {
-  PKIMetadataComponentInstallerService::GetInstance()->OnComponentReady(
-      install_dir);
+  // Like CRLSet, certificate verification depends on this data.
+  ComponentActivationScheduler::GetInstance()->Schedule(
+      "PKIMetadata", ActivationPriority::kCritical,
+      base::BindOnce(
+          &PKIMetadataComponentInstallerService::OnComponentReady,
+          base::Unretained(PKIMetadataComponentInstallerService::GetInstance()),
+          install_dir));
 }
 
 // Called during startup and installation before ComponentReady().
@@ -12,7 +12,7 @@
 #include "base/functional/callback.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
-#include "base/task/thread_pool.h"
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
 #include "components/security_interstitials/content/ssl_error_assistant.h"
 #include "components/security_interstitials/content/ssl_error_handler.h"
 #include "content/public/browser/browser_task_traits.h"
@@ -99,8 +99,8 @@ void SSLErrorAssistantComponentInstallerPolicy::ComponentReady(
   DVLOG(1) << "Component ready, version " << version.GetString() << " in "
            << install_dir.value();
 
-  base::ThreadPool::PostTask(
-      FROM_HERE, {base::MayBlock(), base::TaskPriority::BEST_EFFORT},
+  ComponentActivationScheduler::GetInstance()->ScheduleBlocking(
+      "SSLErrorAssistant", ActivationPriority::kDeferred,
       base::BindOnce(&LoadProtoFromDisk, GetInstalledPath(install_dir)));
 }
 
@@ -9,12 +9,14 @@
 
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/functional/bind.h"
 #include "base/functional/callback.h"
 #include "base/memory/ref_counted.h"
 #include "base/path_service.h"
 #include "base/values.h"
 #include "base/version.h"
 #include "chrome/browser/browser_process.h"
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
 #include "components/component_updater/component_updater_paths.h"
 #include "components/subresource_filter/content/shared/browser/ruleset_service.h"
 #include "components/subresource_filter/core/browser/subresource_filter_constants.h"
@@ -87,11 +89,18 @@ void SubresourceFilterComponentInstallerPolicy::ComponentReady(
       install_dir.Append(subresource_filter::kUnindexedRulesetDataFileName);
   ruleset_info.license_path =
       install_dir.Append(subresource_filter::kUnindexedRulesetLicenseFileName);
-  subresource_filter::RulesetService* ruleset_service =
-      g_browser_process->subresource_filter_ruleset_service();
-  if (ruleset_service) {
-    ruleset_service->IndexAndStoreAndPublishRulesetIfNeeded(ruleset_info);
-  }
+  ComponentActivationScheduler::GetInstance()->Schedule(
+      "SubresourceFilter", ActivationPriority::kDeferred,
+      base::BindOnce(
+          [](const subresource_filter::UnindexedRulesetInfo& ruleset_info) {
+            subresource_filter::RulesetService* ruleset_service =
+                g_browser_process->subresource_filter_ruleset_service();
+            if (ruleset_service) {
+              ruleset_service->IndexAndStoreAndPublishRulesetIfNeeded(
+                  ruleset_info);
+            }
+          },
+          std::move(ruleset_info)));
 }
 
 // Called during startup and installation before ComponentReady().
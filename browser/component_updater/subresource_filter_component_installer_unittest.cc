@@ -22,6 +22,8 @@
 #include "base/test/scoped_feature_list.h"
 #include "base/values.h"
 #include "base/version.h"
+#include "chrome/browser/after_startup_task_utils.h"
+#include "chrome/browser/component_updater/component_activation_scheduler.h"
 #include "chrome/test/base/testing_browser_process.h"
 #include "components/component_updater/mock_component_updater_service.h"
 #include "components/prefs/testing_pref_service.h"
@@ -129,11 +131,17 @@ class SubresourceFilterComponentInstallerTest : public PlatformTest {
     TestingBrowserProcess::GetGlobal()->SetRulesetService(
         std::move(test_ruleset_service));
     policy_ = std::make_unique<SubresourceFilterComponentInstallerPolicy>();
+
+    // Rulesets are only activated once browser startup is complete.
+    ComponentActivationScheduler::GetInstance()->ResetForTesting();
+    AfterStartupTaskUtils::SetBrowserStartupIsCompleteForTesting();
   }
 
   void TearDown() override {
     TestingBrowserProcess::GetGlobal()->SetRulesetService(nullptr);
     task_environment_.RunUntilIdle();
+    ComponentActivationScheduler::GetInstance()->ResetForTesting();
+    AfterStartupTaskUtils::UnsafeResetForTesting();
     PlatformTest::TearDown();
   }
 
@@ -8,6 +8,7 @@
 
 #include <vector>
 
+#include "base/containers/contains.h"
 #include "base/memory/ptr_util.h"
 #include "build/build_config.h"
 #include "build/chromeos_buildflags.h"
@@ -66,21 +67,15 @@ bool DownloadStatusUpdater::GetProgress(float* progress,
   int64_t received_bytes = 0;
   int64_t total_bytes = 0;
 
-  for (const auto& notifier : notifiers_) {
-    if (notifier->GetManager()) {
-      content::DownloadManager::DownloadVector items;
-      notifier->GetManager()->GetAllDownloads(&items);
-      for (download::DownloadItem* item : items) {
-        if (item->GetState() == download::DownloadItem::IN_PROGRESS) {
-          ++*download_count;
-          if (item->GetTotalBytes() <= 0) {
-            // There may or may not be more data coming down this pipe.
-            progress_certain = false;
-          } else {
-            received_bytes += item->GetReceivedBytes();
-            total_bytes += item->GetTotalBytes();
-          }
-        }
+  for (const auto& [manager, items] : in_progress_items_) {
+    for (download::DownloadItem* item : items) {
+      ++*download_count;
+      if (item->GetTotalBytes() <= 0) {
+        // There may or may not be more data coming down this pipe.
+        progress_certain = false;
+      } else {
+        received_bytes += item->GetReceivedBytes();
+        total_bytes += item->GetTotalBytes();
       }
     }
   }
@@ -102,6 +97,7 @@ void DownloadStatusUpdater::AddManager(content::DownloadManager* manager) {
 
 void DownloadStatusUpdater::OnDownloadCreated(content::DownloadManager* manager,
                                               download::DownloadItem* item) {
+  TrackItemState(manager, item);
   // Ignore downloads loaded from history, which are in a terminal state.
   // TODO(benjhayden): Use the Observer interface to distinguish between
   // historical and started downloads.
@@ -116,6 +112,7 @@ void DownloadStatusUpdater::OnDownloadCreated(content::DownloadManager* manager,
 
 void DownloadStatusUpdater::OnDownloadUpdated(content::DownloadManager* manager,
                                               download::DownloadItem* item) {
+  TrackItemState(manager, item);
   if (item->GetState() == download::DownloadItem::IN_PROGRESS &&
       !item->IsTransient()) {
     // If the item was interrupted/cancelled and then resumed/restarted, then
@@ -137,8 +134,15 @@ void DownloadStatusUpdater::OnDownloadUpdated(content::DownloadManager* manager,
   UpdateProfileKeepAlive(manager);
 }
 
+void DownloadStatusUpdater::OnDownloadDestroyed(
+    content::DownloadManager* manager,
+    download::DownloadItem* item) {
+  UntrackItem(manager, item);
+}
+
 void DownloadStatusUpdater::OnManagerGoingDown(
     content::DownloadManager* manager) {
+  in_progress_items_.erase(manager);
   Profile* profile = Profile::FromBrowserContext(manager->GetBrowserContext());
   profile_keep_alives_.erase(profile);
 }
@@ -160,11 +164,7 @@ void DownloadStatusUpdater::UpdateProfileKeepAlive(
       (profile_keep_alives_.find(profile) != profile_keep_alives_.end());
 
   // Do we still need to hold a keepalive?
-  content::DownloadManager::DownloadVector items;
-  manager->GetAllDownloads(&items);
-  auto items_it = base::ranges::find(items, download::DownloadItem::IN_PROGRESS,
-                                     &download::DownloadItem::GetState);
-  bool should_keep_alive = (items_it != items.end());
+  bool should_keep_alive = base::Contains(in_progress_items_, manager);
 
   if (should_keep_alive == already_has_keep_alive) {
     // The current state is already correct for this Profile. No changes needed.
@@ -180,6 +180,28 @@ void DownloadStatusUpdater::UpdateProfileKeepAlive(
   }
 }
 
+void DownloadStatusUpdater::TrackItemState(content::DownloadManager* manager,
+                                           download::DownloadItem* item) {
+  // Transient downloads don't update the app icon, but like any other
+  // in-progress download they count toward the progress and keep the profile
+  // alive.
+  if (item->GetState() == download::DownloadItem::IN_PROGRESS) {
+    in_progress_items_[manager].insert(item);
+  } else {
+    UntrackItem(manager, item);
+  }
+}
+
+void DownloadStatusUpdater::UntrackItem(content::DownloadManager* manager,
+                                        download::DownloadItem* item) {
+  auto it = in_progress_items_.find(manager);
+  if (it == in_progress_items_.end())
+    return;
+  it->second.erase(item);
+  if (it->second.empty())
+    in_progress_items_.erase(it);
+}
+
 #if BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_CHROMEOS_ASH)
 void DownloadStatusUpdater::UpdateAppIconDownloadProgress(
     download::DownloadItem* download) {
@@ -5,14 +5,21 @@
 #ifndef CHROME_BROWSER_DOWNLOAD_DOWNLOAD_STATUS_UPDATER_H_
 #define CHROME_BROWSER_DOWNLOAD_DOWNLOAD_STATUS_UPDATER_H_
 
+#include <map>
 #include <memory>
 #include <set>
 
+#include "base/containers/flat_set.h"
+#include "build/build_config.h"
 #include "build/chromeos_buildflags.h"
 #include "components/download/content/public/all_download_item_notifier.h"
 #include "components/download/public/common/download_item.h"
 #include "content/public/browser/download_manager.h"
 
+#if BUILDFLAG(IS_LINUX)
+#include "base/timer/timer.h"
+#endif
+
 class Profile;
 class ScopedProfileKeepAlive;
 
@@ -31,6 +38,8 @@ class DownloadStatusUpdater
   // If we know the final size of all downloads, this routine returns true
   // with |*progress| set to the percentage complete of all in-progress
   // downloads.  Otherwise, it returns false.
+  // Only the tracked in-progress downloads are visited, so this is cheap
+  // enough to call on every download update.
   bool GetProgress(float* progress, int* download_count) const;
 
   // Add the specified DownloadManager to the list of managers for which
@@ -46,6 +55,8 @@ class DownloadStatusUpdater
                          download::DownloadItem* item) override;
   void OnDownloadUpdated(content::DownloadManager* manager,
                          download::DownloadItem* item) override;
+  void OnDownloadDestroyed(content::DownloadManager* manager,
+                           download::DownloadItem* item) override;
 
  protected:
   // Platform-specific function to update the platform UI for download progress.
@@ -63,7 +74,31 @@ class DownloadStatusUpdater
   void UpdateProfileKeepAlive(content::DownloadManager* manager);
 
  private:
+  // Adds |item| to or removes it from |in_progress_items_| according to its
+  // current state.
+  void TrackItemState(content::DownloadManager* manager,
+                      download::DownloadItem* item);
+  void UntrackItem(content::DownloadManager* manager,
+                   download::DownloadItem* item);
+
+#if BUILDFLAG(IS_LINUX)
+  // Pushes the current download count and progress to the launcher entry and
+  // holds off further byte progress updates for a while.
+  void UpdateLauncherEntry();
+  void OnLauncherUpdateTimer();
+
+  base::OneShotTimer launcher_update_timer_;
+  // Whether an update arrived while |launcher_update_timer_| was running.
+  bool launcher_update_pending_ = false;
+#endif  // BUILDFLAG(IS_LINUX)
+
   std::vector<std::unique_ptr<download::AllDownloadItemNotifier>> notifiers_;
+  // The in-progress downloads of each manager, including transient ones. Kept
+  // up to date from item state transitions so that neither progress nor
+  // keepalive updates have to walk every download, including history, of every
+  // manager.
+  std::map<content::DownloadManager*, base::flat_set<download::DownloadItem*>>
+      in_progress_items_;
   std::map<Profile*, std::unique_ptr<ScopedProfileKeepAlive>>
       profile_keep_alives_;
 
@@ -11,7 +11,9 @@
 
 #include "base/compiler_specific.h"
 #include "base/environment.h"
+#include "base/functional/bind.h"
 #include "base/nix/xdg_util.h"
+#include "base/time/time.h"
 #include "chrome/common/channel_info.h"
 #include "ui/base/glib/glib_integers.h"
 
@@ -37,6 +39,10 @@ typedef void (*unity_launcher_entry_set_progress_visible_func)(
 
 namespace {
 
+// Byte progress of an active download is reported many times a second; the
+// launcher entry is refreshed at most this often.
+constexpr base::TimeDelta kLauncherUpdateInterval = base::Milliseconds(500);
+
 bool attempted_load = false;
 
 // Unity has a singleton object that we can ask whether the unity is running.
@@ -146,9 +152,31 @@ void DownloadStatusUpdater::UpdateAppIconDownloadProgress(
   EnsureLibUnityLoaded();
   if (!IsRunning())
     return;
+  // A download that leaves the in-progress state changes the count, so show
+  // that right away instead of waiting for the next tick.
+  if (download->GetState() != download::DownloadItem::IN_PROGRESS)
+    launcher_update_timer_.Stop();
+  if (launcher_update_timer_.IsRunning()) {
+    launcher_update_pending_ = true;
+    return;
+  }
+  UpdateLauncherEntry();
+}
+
+void DownloadStatusUpdater::UpdateLauncherEntry() {
+  launcher_update_pending_ = false;
   float progress = 0;
   int download_count = 0;
   GetProgress(&progress, &download_count);
   SetDownloadCount(download_count);
   SetProgressFraction(progress);
+  launcher_update_timer_.Start(
+      FROM_HERE, kLauncherUpdateInterval,
+      base::BindOnce(&DownloadStatusUpdater::OnLauncherUpdateTimer,
+                     base::Unretained(this)));
+}
+
+void DownloadStatusUpdater::OnLauncherUpdateTimer() {
+  if (launcher_update_pending_)
+    UpdateLauncherEntry();
 }
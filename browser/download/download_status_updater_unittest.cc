@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <memory>
 
@@ -34,6 +35,7 @@ using testing::AtLeast;
 using testing::Invoke;
 using testing::Mock;
 using testing::Return;
+using testing::ReturnPointee;
 using testing::SetArgPointee;
 using testing::StrictMock;
 using testing::WithArg;
@@ -375,6 +377,38 @@ TEST_F(DownloadStatusUpdaterTest, ManyManagersMixedItems) {
   EXPECT_EQ(3, download_count);
 }
 
+// Test that progress updates only visit in-progress downloads instead of
+// walking every download of every manager.
+TEST_F(DownloadStatusUpdaterTest, UpdatesDoNotScanAllDownloads) {
+  SetupManagers(1);
+  AddItems(0, 1000, 2);
+  LinkManager(0);
+  EXPECT_CALL(*Manager(0), GetAllDownloads(_)).Times(0);
+
+  int64_t received_bytes[2] = {0, 0};
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_CALL(*Item(0, i), GetReceivedBytes())
+        .WillRepeatedly(ReturnPointee(&received_bytes[i]));
+    EXPECT_CALL(*Item(0, i), GetTotalBytes()).WillRepeatedly(Return(10000));
+  }
+
+  float progress = -1;
+  int download_count = -1;
+  for (int step = 1; step <= 5000; ++step) {
+    int index = step % 2;
+    received_bytes[index] = step;
+    updater_->OnDownloadUpdated(Manager(0), Item(0, index));
+    ASSERT_TRUE(updater_->GetProgress(&progress, &download_count));
+    ASSERT_EQ(2, download_count);
+  }
+  EXPECT_FLOAT_EQ((5000 + 4999) / 20000.0f, progress);
+
+  CompleteItem(0, 0);
+  EXPECT_TRUE(updater_->GetProgress(&progress, &download_count));
+  EXPECT_FLOAT_EQ(4999 / 10000.0f, progress);
+  EXPECT_EQ(1, download_count);
+}
+
 // Test that it prevents Profile deletion.
 TEST_F(DownloadStatusUpdaterTest, HoldsKeepAlive) {
   base::test::ScopedFeatureList feature_list;
@@ -409,7 +443,8 @@ TEST_F(DownloadStatusUpdaterTest, HoldsKeepAlive) {
       profile1, ProfileKeepAliveOrigin::kDownloadInProgress));
 }
 
-// Tests that transient download will not trigger any updates.
+// Tests that transient download will not trigger any updates, but still counts
+// toward the progress of the in-progress downloads.
 TEST_F(DownloadStatusUpdaterTest, TransientDownload) {
   SetupManagers(/*manager_count=*/1);
   AddItems(/*manager_index=*/0, /*item_count=*/2, /*in_progress_count=*/0);
@@ -421,14 +456,17 @@ TEST_F(DownloadStatusUpdaterTest, TransientDownload) {
   EXPECT_CALL(*item, GetState())
       .WillRepeatedly(Return(download::DownloadItem::IN_PROGRESS));
   EXPECT_CALL(*item, IsTransient()).WillRepeatedly(Return(true));
+  EXPECT_CALL(*item, GetReceivedBytes()).WillRepeatedly(Return(10));
+  EXPECT_CALL(*item, GetTotalBytes()).WillRepeatedly(Return(20));
   manager_items_[0].push_back(item.get());
   all_owned_items_.push_back(std::move(item));
   manager_observers_[0]->OnDownloadCreated(
       managers_[0].get(), manager_items_[0][manager_items_[0].size() - 1]);
+  EXPECT_EQ(0u, updater_->NotificationCount());
 
   float progress = -1;
   int download_count = -1;
   EXPECT_TRUE(updater_->GetProgress(&progress, &download_count));
-  EXPECT_FLOAT_EQ(0.0f, progress);
-  EXPECT_EQ(0, download_count);
+  EXPECT_FLOAT_EQ(0.5f, progress);
+  EXPECT_EQ(1, download_count);
 }
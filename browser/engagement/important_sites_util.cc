@@ -4,6 +4,8 @@
 
 #include "chrome/browser/engagement/important_sites_util.h"
 
+#include <stdint.h>
+
 #include <algorithm>
 #include <map>
 #include <memory>
@@ -13,8 +15,13 @@
 #include <utility>
 
 #include "base/containers/contains.h"
+#include "base/memory/raw_ptr.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/ranges/algorithm.h"
+#include "base/scoped_observation.h"
+#include "base/supports_user_data.h"
+#include "base/time/time.h"
+#include "base/types/optional_util.h"
 #include "base/values.h"
 #include "build/build_config.h"
 #include "chrome/browser/bookmarks/bookmark_model_factory.h"
@@ -23,8 +30,10 @@
 #include "chrome/browser/web_applications/web_app_utils.h"
 #include "chrome/browser/webapps/installable/installable_utils.h"
 #include "chrome/common/pref_names.h"
+#include "components/bookmarks/browser/base_bookmark_model_observer.h"
 #include "components/bookmarks/browser/bookmark_model.h"
 #include "components/bookmarks/browser/url_and_title.h"
+#include "components/content_settings/core/browser/content_settings_observer.h"
 #include "components/content_settings/core/browser/host_content_settings_map.h"
 #include "components/content_settings/core/common/content_settings.h"
 #include "components/content_settings/core/common/content_settings_utils.h"
@@ -42,6 +51,10 @@
 #include "url/url_util.h"
 
 #if !BUILDFLAG(IS_ANDROID)
+#include "chrome/browser/web_applications/web_app_install_manager.h"
+#include "chrome/browser/web_applications/web_app_install_manager_observer.h"
+#include "chrome/browser/web_applications/web_app_provider.h"
+#include "components/webapps/browser/installable/installable_metrics.h"
 #include "components/webapps/common/web_app_id.h"
 #endif
 
@@ -68,6 +81,8 @@ static const int kTimesIgnoredForSuppression = 3;
 // bookmarks on site engagement > 0, sort, and trim to kMaxBookmarks.
 static const int kMaxBookmarks = 5;
 
+const char kImportantSitesCacheKey[] = "ImportantSitesCache";
+
 // We need this to be a macro, as the histogram macros cache their pointers
 // after the first call, so when we change the uma name we check fail if we're
 // just a method.
@@ -243,6 +258,7 @@ void PopulateInfoMapWithEngagement(
     Profile* profile,
     blink::mojom::EngagementLevel minimum_engagement,
     std::map<GURL, double>* engagement_map,
+    std::set<GURL>* home_screen_origins,
     std::map<std::string, ImportantDomainInfo>* output) {
   SiteEngagementService* service = SiteEngagementService::Get(profile);
   std::vector<mojom::SiteEngagementDetails> engagement_details =
@@ -253,6 +269,7 @@ void PopulateInfoMapWithEngagement(
   // with the highest engagement score.
   for (const auto& detail : engagement_details) {
     if (detail.installed_bonus > 0) {
+      home_screen_origins->insert(detail.origin);
       MaybePopulateImportantInfoForReason(detail.origin, &content_origins,
                                           ImportantReason::HOME_SCREEN,
                                           std::nullopt, output);
@@ -302,9 +319,13 @@ void PopulateInfoMapWithContentTypeAllowed(
   }
 }
 
+// If there are more than |kMaxBookmarks| bookmarks, only the most engaged ones
+// are kept; their origins are then added to |ranked_origins|, as a change to
+// any of their scores can change the selection.
 void PopulateInfoMapWithBookmarks(
     Profile* profile,
     const std::map<GURL, double>& engagement_map,
+    std::set<GURL>* ranked_origins,
     std::map<std::string, ImportantDomainInfo>* output) {
   BookmarkModel* model =
       BookmarkModelFactory::GetForBrowserContextIfExists(profile);
@@ -315,6 +336,8 @@ void PopulateInfoMapWithBookmarks(
   // Process the bookmarks and optionally trim them if we have too many.
   std::vector<UrlAndTitle> result_bookmarks;
   if (untrimmed_bookmarks.size() > kMaxBookmarks) {
+    for (const UrlAndTitle& bookmark : untrimmed_bookmarks)
+      ranked_origins->insert(bookmark.url.DeprecatedGetOriginAsURL());
     base::ranges::copy_if(
         untrimmed_bookmarks, std::back_inserter(result_bookmarks),
         [&engagement_map](const UrlAndTitle& entry) {
@@ -349,6 +372,259 @@ void PopulateInfoMapWithBookmarks(
   }
 }
 
+// All important domain candidates of a profile, sorted by descending
+// importance. Domains the user has suppressed are not filtered out here, as
+// suppressions expire over time; they are skipped when a result is requested.
+struct ImportantSitesCandidates {
+  // Returns whether the candidates may differ once the engagement of |origin|
+  // is described by |details|.
+  bool IsAffectedByEngagementChange(
+      const GURL& origin,
+      const mojom::SiteEngagementDetails& details) const {
+    auto it = engagement_map.find(origin);
+    double old_score = it == engagement_map.end() ? 0 : it->second;
+    if ((details.installed_bonus > 0) != home_screen_origins.contains(origin))
+      return true;
+    if (details.total_score == old_score)
+      return false;
+    for (auto level : {blink::mojom::EngagementLevel::LOW,
+                       blink::mojom::EngagementLevel::MEDIUM}) {
+      if (SiteEngagementService::IsEngagementAtLeast(old_score, level) !=
+          SiteEngagementService::IsEngagementAtLeast(details.total_score,
+                                                     level)) {
+        return true;
+      }
+    }
+    // Engaged domains and trimmed bookmarks are ordered by score, so any change
+    // to the score of an origin that takes part in the ranking counts.
+    return SiteEngagementService::IsEngagementAtLeast(
+               old_score, blink::mojom::EngagementLevel::MEDIUM) ||
+           ranked_bookmark_origins.contains(origin);
+  }
+
+  std::vector<std::pair<std::string, ImportantDomainInfo>> sorted_domains;
+
+  // The engagement inputs the candidates were computed from.
+  std::map<GURL, double> engagement_map;
+  std::set<GURL> home_screen_origins;
+  std::set<GURL> ranked_bookmark_origins;
+
+  // When the first engagement score in |engagement_map| decays. Decay is not
+  // announced by a notification, so the candidates are stale from then on.
+  base::Time next_decay_time = base::Time::Max();
+};
+
+// Returns when the first of the scores in |engagement_map| decays. A score
+// decays once for every whole decay period since the last engagement with its
+// origin.
+base::Time GetNextEngagementDecayTime(
+    SiteEngagementService* service,
+    const std::map<GURL, double>& engagement_map) {
+  const int decay_period_in_hours =
+      static_cast<int>(SiteEngagementScore::GetDecayPeriodInHours());
+  if (decay_period_in_hours <= 0)
+    return base::Time::Max();
+
+  const base::Time now = base::Time::Now();
+  base::Time next_decay_time = base::Time::Max();
+  for (const auto& [origin, score] : engagement_map) {
+    if (score <= 0)
+      continue;
+    base::Time last_engagement_time =
+        service->CreateEngagementScore(origin).last_engagement_time();
+    int64_t periods = std::max<int64_t>(
+        0, (now - last_engagement_time).InHours() / decay_period_in_hours);
+    next_decay_time =
+        std::min(next_decay_time,
+                 last_engagement_time +
+                     base::Hours((periods + 1) * decay_period_in_hours));
+  }
+  return next_decay_time;
+}
+
+ImportantSitesCandidates ComputeImportantSitesCandidates(Profile* profile) {
+  SCOPED_UMA_HISTOGRAM_TIMER("Storage.ImportantSites.GenerationTime");
+  ImportantSitesCandidates candidates;
+  std::map<std::string, ImportantDomainInfo> important_info;
+
+  PopulateInfoMapWithEngagement(profile, blink::mojom::EngagementLevel::MEDIUM,
+                                &candidates.engagement_map,
+                                &candidates.home_screen_origins,
+                                &important_info);
+
+  PopulateInfoMapWithContentTypeAllowed(
+      profile, ContentSettingsType::NOTIFICATIONS,
+      ImportantReason::NOTIFICATIONS, &important_info);
+
+  PopulateInfoMapWithContentTypeAllowed(
+      profile, ContentSettingsType::DURABLE_STORAGE, ImportantReason::DURABLE,
+      &important_info);
+
+  PopulateInfoMapWithBookmarks(profile, candidates.engagement_map,
+                               &candidates.ranked_bookmark_origins,
+                               &important_info);
+
+  candidates.next_decay_time = GetNextEngagementDecayTime(
+      SiteEngagementService::Get(profile), candidates.engagement_map);
+
+  for (auto& item : important_info)
+    candidates.sorted_domains.emplace_back(std::move(item));
+  std::sort(candidates.sorted_domains.begin(), candidates.sorted_domains.end(),
+            &CompareDescendingImportantInfo);
+  return candidates;
+}
+
+ImportantDomainInfo CopyImportantDomainInfo(const ImportantDomainInfo& info) {
+  ImportantDomainInfo copy;
+  copy.registerable_domain = info.registerable_domain;
+  copy.example_origin = info.example_origin;
+  copy.engagement_score = info.engagement_score;
+  copy.reason_bitfield = info.reason_bitfield;
+  copy.app_name = info.app_name;
+  return copy;
+}
+
+// Keeps the ImportantSitesCandidates of a profile between calls, so that
+// repeated queries from the clear browsing data and storage pressure flows do
+// not walk every engagement entry and bookmark each time. The candidates are
+// dropped whenever one of their inputs changes: the bookmark model, installed
+// web apps, or the content settings they are derived from. Site engagement is
+// itself stored as a website setting; a score change only drops the candidates
+// if it can change them, see
+// ImportantSitesCandidates::IsAffectedByEngagementChange(). Scores also decay
+// as time passes, which drops the candidates at their |next_decay_time|.
+class ImportantSitesCache : public base::SupportsUserData::Data,
+#if !BUILDFLAG(IS_ANDROID)
+                            public web_app::WebAppInstallManagerObserver,
+#endif
+                            public content_settings::Observer,
+                            public bookmarks::BaseBookmarkModelObserver {
+ public:
+  explicit ImportantSitesCache(Profile* profile)
+      : profile_(profile),
+        settings_map_(HostContentSettingsMapFactory::GetForProfile(profile)) {
+    content_settings_observation_.Observe(settings_map_.get());
+#if !BUILDFLAG(IS_ANDROID)
+    auto* web_app_provider = web_app::WebAppProvider::GetForWebApps(profile);
+    if (web_app_provider) {
+      install_manager_observation_.Observe(
+          &web_app_provider->install_manager());
+    }
+#endif
+  }
+
+  ImportantSitesCache(const ImportantSitesCache&) = delete;
+  ImportantSitesCache& operator=(const ImportantSitesCache&) = delete;
+
+  ~ImportantSitesCache() override = default;
+
+  static ImportantSitesCache* GetOrCreate(Profile* profile) {
+    auto* cache = static_cast<ImportantSitesCache*>(
+        profile->GetUserData(kImportantSitesCacheKey));
+    if (!cache) {
+      auto new_cache = std::make_unique<ImportantSitesCache>(profile);
+      cache = new_cache.get();
+      profile->SetUserData(kImportantSitesCacheKey, std::move(new_cache));
+    }
+    return cache;
+  }
+
+  // Returns the cached candidates, or null if they must be recomputed.
+  const ImportantSitesCandidates* Get() {
+    // The bookmark model may have been created after the candidates were
+    // computed.
+    if (!bookmark_model_observation_.IsObserving()) {
+      BookmarkModel* model =
+          BookmarkModelFactory::GetForBrowserContextIfExists(profile_);
+      if (model) {
+        bookmark_model_observation_.Observe(model);
+        Invalidate();
+      }
+    }
+    if (candidates_ && base::Time::Now() >= candidates_->next_decay_time)
+      Invalidate();
+    return base::OptionalToPtr(candidates_);
+  }
+
+  const ImportantSitesCandidates* Set(ImportantSitesCandidates candidates) {
+    candidates_ = std::move(candidates);
+    return &candidates_.value();
+  }
+
+  void Invalidate() { candidates_.reset(); }
+
+  // content_settings::Observer:
+  void OnContentSettingChanged(
+      const ContentSettingsPattern& primary_pattern,
+      const ContentSettingsPattern& secondary_pattern,
+      ContentSettingsTypeSet content_type_set) override {
+    if (!candidates_)
+      return;
+    if (content_type_set.ContainsAllTypes() ||
+        content_type_set.Contains(ContentSettingsType::NOTIFICATIONS) ||
+        content_type_set.Contains(ContentSettingsType::DURABLE_STORAGE)) {
+      Invalidate();
+      return;
+    }
+    if (!content_type_set.Contains(ContentSettingsType::SITE_ENGAGEMENT))
+      return;
+
+    // Engagement scores are stored per origin; anything broader, such as a
+    // wildcard pattern from clearing browsing data, may affect any candidate.
+    GURL origin(primary_pattern.ToString());
+    if (!origin.is_valid()) {
+      Invalidate();
+      return;
+    }
+    SiteEngagementService* service = SiteEngagementService::Get(profile_);
+    origin = origin.DeprecatedGetOriginAsURL();
+    if (!service || candidates_->IsAffectedByEngagementChange(
+                        origin, service->GetDetails(origin))) {
+      Invalidate();
+    }
+  }
+
+#if !BUILDFLAG(IS_ANDROID)
+  // web_app::WebAppInstallManagerObserver:
+  void OnWebAppInstalled(const webapps::AppId& app_id) override {
+    Invalidate();
+  }
+  void OnWebAppUninstalled(
+      const webapps::AppId& app_id,
+      webapps::WebappUninstallSource uninstall_source) override {
+    Invalidate();
+  }
+  void OnWebAppInstallManagerDestroyed() override {
+    install_manager_observation_.Reset();
+  }
+#endif
+
+  // bookmarks::BaseBookmarkModelObserver:
+  void BookmarkModelLoaded(bool ids_reassigned) override { Invalidate(); }
+  void BookmarkModelChanged() override { Invalidate(); }
+  void BookmarkModelBeingDeleted() override {
+    bookmark_model_observation_.Reset();
+    Invalidate();
+  }
+
+ private:
+  const raw_ptr<Profile> profile_;
+  // Kept alive so that the observation can be removed safely when the profile
+  // is destroyed, after keyed services have been shut down.
+  const scoped_refptr<HostContentSettingsMap> settings_map_;
+  std::optional<ImportantSitesCandidates> candidates_;
+
+  base::ScopedObservation<HostContentSettingsMap, content_settings::Observer>
+      content_settings_observation_{this};
+  base::ScopedObservation<BookmarkModel, bookmarks::BookmarkModelObserver>
+      bookmark_model_observation_{this};
+#if !BUILDFLAG(IS_ANDROID)
+  base::ScopedObservation<web_app::WebAppInstallManager,
+                          web_app::WebAppInstallManagerObserver>
+      install_manager_observation_{this};
+#endif
+};
+
 }  // namespace
 
 ImportantDomainInfo::ImportantDomainInfo() = default;
@@ -399,48 +675,34 @@ std::set<std::string> ImportantSitesUtil::GetInstalledRegisterableDomains(
 std::vector<ImportantDomainInfo>
 ImportantSitesUtil::GetImportantRegisterableDomains(Profile* profile,
                                                     size_t max_results) {
-  SCOPED_UMA_HISTOGRAM_TIMER("Storage.ImportantSites.GenerationTime");
-  std::map<std::string, ImportantDomainInfo> important_info;
-  std::map<GURL, double> engagement_map;
-
-  PopulateInfoMapWithEngagement(profile, blink::mojom::EngagementLevel::MEDIUM,
-                                &engagement_map, &important_info);
-
-  PopulateInfoMapWithContentTypeAllowed(
-      profile, ContentSettingsType::NOTIFICATIONS,
-      ImportantReason::NOTIFICATIONS, &important_info);
-
-  PopulateInfoMapWithContentTypeAllowed(
-      profile, ContentSettingsType::DURABLE_STORAGE, ImportantReason::DURABLE,
-      &important_info);
-
-  PopulateInfoMapWithBookmarks(profile, engagement_map, &important_info);
+  ImportantSitesCache* cache = ImportantSitesCache::GetOrCreate(profile);
+  const ImportantSitesCandidates* candidates = cache->Get();
+  if (!candidates)
+    candidates = cache->Set(ComputeImportantSitesCandidates(profile));
 
   std::unordered_set<std::string> suppressed_domains =
       GetSuppressedImportantDomains(profile);
-
-  std::vector<std::pair<std::string, ImportantDomainInfo>> items;
-  for (auto& item : important_info)
-    items.emplace_back(std::move(item));
-  std::sort(items.begin(), items.end(), &CompareDescendingImportantInfo);
-
   std::vector<ImportantDomainInfo> final_list;
-  for (std::pair<std::string, ImportantDomainInfo>& domain_info : items) {
+  for (const auto& [domain, info] : candidates->sorted_domains) {
     if (final_list.size() >= max_results)
       return final_list;
-    if (suppressed_domains.find(domain_info.first) != suppressed_domains.end())
+    if (base::Contains(suppressed_domains, domain))
       continue;
 
-    final_list.push_back(std::move(domain_info.second));
+    final_list.push_back(CopyImportantDomainInfo(info));
     RECORD_UMA_FOR_IMPORTANT_REASON(
         "Storage.ImportantSites.GeneratedReason",
-        "Storage.ImportantSites.GeneratedReasonCount",
-        domain_info.second.reason_bitfield);
+        "Storage.ImportantSites.GeneratedReasonCount", info.reason_bitfield);
   }
 
   return final_list;
 }
 
+// static
+void ImportantSitesUtil::ClearCacheForTesting(Profile* profile) {
+  profile->RemoveUserData(kImportantSitesCacheKey);
+}
+
 void ImportantSitesUtil::RecordExcludedAndIgnoredImportantSites(
     Profile* profile,
     const std::vector<std::string>& excluded_sites,
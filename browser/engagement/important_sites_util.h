@@ -72,7 +72,10 @@ class ImportantSitesUtil {
 
   // This returns the top |<=max_results| important registrable domains. This
   // uses site engagement and notifications to generate the list. |max_results|
-  // is assumed to be small.
+  // is assumed to be small. The sorted candidates are cached per profile until
+  // an engagement threshold is crossed, a relevant content setting, the
+  // installed web apps or the bookmarks change, so repeated calls only walk
+  // the head of the cached list.
   // See net/base/registry_controlled_domains/registry_controlled_domain.h for
   // more details on registrable domains and the current list of effective
   // eTLDs.
@@ -100,6 +103,10 @@ class ImportantSitesUtil {
   // testing.
   static void MarkOriginAsImportantForTesting(Profile* profile,
                                               const GURL& origin);
+
+  // Drops the cached important sites of |profile|, so that the next call to
+  // GetImportantRegisterableDomains() computes them from scratch.
+  static void ClearCacheForTesting(Profile* profile);
 };
 
 }  // namespace site_engagement
@@ -11,8 +11,11 @@
 #include "base/memory/raw_ptr.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/metrics/sample_vector.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/test/metrics/histogram_tester.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 #include "chrome/browser/bookmarks/bookmark_model_factory.h"
 #include "chrome/browser/content_settings/host_content_settings_map_factory.h"
@@ -62,6 +65,11 @@ enum CrossedReasonForTesting {
 
 class ImportantSitesUtilTest : public ChromeRenderViewHostTestHarness {
  public:
+  ImportantSitesUtilTest() = default;
+  explicit ImportantSitesUtilTest(
+      base::test::TaskEnvironment::TimeSource time_source)
+      : ChromeRenderViewHostTestHarness(time_source) {}
+
   void SetUp() override {
     ChromeRenderViewHostTestHarness::SetUp();
     SiteEngagementScore::SetParamValuesForTesting();
@@ -497,6 +505,186 @@ TEST_F(ImportantSitesUtilTest, ExcludeNonRegisterableDomains) {
                            important_sites);
 }
 
+// Checks that engagement changes only cause the important sites to be computed
+// again when they cross an engagement threshold or reorder engaged sites.
+TEST_F(ImportantSitesUtilTest, RecomputesOnlyOnRelevantEngagementChanges) {
+  SiteEngagementService* service = SiteEngagementService::Get(profile());
+  ASSERT_TRUE(service);
+  base::HistogramTester histogram_tester;
+
+  GURL url1("http://www.google.com/");
+  GURL url2("https://www.yahoo.com/");
+  service->ResetBaseScoreForURL(url1, 8);
+  service->ResetBaseScoreForURL(url2, 2);
+
+  ExpectImportantResultsEq(
+      {"google.com"}, {url1},
+      ImportantSitesUtil::GetImportantRegisterableDomains(profile(),
+                                                          kNumImportantSites));
+  histogram_tester.ExpectTotalCount("Storage.ImportantSites.GenerationTime",
+                                    1);
+
+  // Repeated queries and changes below the medium engagement (5) are served
+  // from the cache.
+  service->ResetBaseScoreForURL(url2, 3);
+  ExpectImportantResultsEq(
+      {"google.com"}, {url1},
+      ImportantSitesUtil::GetImportantRegisterableDomains(profile(),
+                                                          kNumImportantSites));
+  histogram_tester.ExpectTotalCount("Storage.ImportantSites.GenerationTime",
+                                    1);
+
+  // Crossing the medium engagement adds the site.
+  service->ResetBaseScoreForURL(url2, 7);
+  ExpectImportantResultsEq(
+      {"google.com", "yahoo.com"}, {url1, url2},
+      ImportantSitesUtil::GetImportantRegisterableDomains(profile(),
+                                                          kNumImportantSites));
+  histogram_tester.ExpectTotalCount("Storage.ImportantSites.GenerationTime",
+                                    2);
+
+  // Engaged sites are ordered by their score.
+  service->ResetBaseScoreForURL(url2, 9);
+  ExpectImportantResultsEq(
+      {"yahoo.com", "google.com"}, {url2, url1},
+      ImportantSitesUtil::GetImportantRegisterableDomains(profile(),
+                                                          kNumImportantSites));
+  histogram_tester.ExpectTotalCount("Storage.ImportantSites.GenerationTime",
+                                    3);
+}
+
+// Checks that cached results stay identical to results computed from scratch
+// while engagement, content settings, bookmarks and suppressions change in a
+// fixed, interleaved order.
+TEST_F(ImportantSitesUtilTest, CachedResultsMatchRecomputedResults) {
+  SiteEngagementService* service = SiteEngagementService::Get(profile());
+  ASSERT_TRUE(service);
+
+  // Pairs of origins share a registerable domain.
+  std::vector<GURL> urls;
+  for (int i = 0; i < 20; ++i) {
+    urls.emplace_back(base::StringPrintf("https://%s.site%d.com/",
+                                         i % 2 ? "www" : "mail", i / 2));
+  }
+
+  for (int step = 0; step < 200; ++step) {
+    // |urls| has 20 entries and 7 is coprime with it, so every origin is
+    // visited once per 20 steps, with a different action in each round.
+    const GURL& url = urls[(step * 7) % urls.size()];
+    const int action = (step + step / 20) % 5;
+    const bool allow = (step / 3) % 2;
+    SCOPED_TRACE(base::StringPrintf("step %d: action %d on %s", step, action,
+                                    url.spec().c_str()));
+    switch (action) {
+      case 0:
+        service->ResetBaseScoreForURL(url, (step * 13) % 16);
+        break;
+      case 1:
+        AddContentSetting(
+            ContentSettingsType::NOTIFICATIONS,
+            allow ? CONTENT_SETTING_ALLOW : CONTENT_SETTING_BLOCK, url);
+        break;
+      case 2:
+        AddContentSetting(
+            ContentSettingsType::DURABLE_STORAGE,
+            allow ? CONTENT_SETTING_ALLOW : CONTENT_SETTING_BLOCK, url);
+        break;
+      case 3:
+        AddBookmark(url);
+        break;
+      case 4:
+        ImportantSitesUtil::RecordExcludedAndIgnoredImportantSites(
+            profile(), {"excluded.com"}, {1 << ENGAGEMENT},
+            {ImportantSitesUtil::GetRegisterableDomainOrIP(url)},
+            {1 << ENGAGEMENT});
+        break;
+    }
+
+    std::vector<ImportantDomainInfo> cached_sites =
+        ImportantSitesUtil::GetImportantRegisterableDomains(profile(),
+                                                            kNumImportantSites);
+    ImportantSitesUtil::ClearCacheForTesting(profile());
+    std::vector<ImportantDomainInfo> recomputed_sites =
+        ImportantSitesUtil::GetImportantRegisterableDomains(profile(),
+                                                            kNumImportantSites);
+
+    ASSERT_EQ(recomputed_sites.size(), cached_sites.size());
+    for (size_t i = 0; i < recomputed_sites.size(); ++i) {
+      EXPECT_EQ(recomputed_sites[i].registerable_domain,
+                cached_sites[i].registerable_domain);
+      EXPECT_EQ(recomputed_sites[i].example_origin,
+                cached_sites[i].example_origin);
+      EXPECT_EQ(recomputed_sites[i].reason_bitfield,
+                cached_sites[i].reason_bitfield);
+      EXPECT_DOUBLE_EQ(recomputed_sites[i].engagement_score,
+                       cached_sites[i].engagement_score);
+    }
+  }
+}
+
+class ImportantSitesUtilMockTimeTest : public ImportantSitesUtilTest {
+ public:
+  ImportantSitesUtilMockTimeTest()
+      : ImportantSitesUtilTest(
+            base::test::TaskEnvironment::TimeSource::MOCK_TIME) {}
+};
+
+// Checks that cached results do not outlive the decay of an engagement score,
+// which is not announced by a notification.
+TEST_F(ImportantSitesUtilMockTimeTest, RecomputesWhenEngagementDecays) {
+  SiteEngagementService* service = SiteEngagementService::Get(profile());
+  ASSERT_TRUE(service);
+  base::HistogramTester histogram_tester;
+
+  GURL url1("http://www.google.com/");
+  GURL url2("https://www.yahoo.com/");
+  service->ResetBaseScoreForURL(url1, 6);
+  service->ResetBaseScoreForURL(url2, 12);
+
+  ExpectImportantResultsEq(
+      {"yahoo.com", "google.com"}, {url2, url1},
+      ImportantSitesUtil::GetImportantRegisterableDomains(profile(),
+                                                          kNumImportantSites));
+  histogram_tester.ExpectTotalCount("Storage.ImportantSites.GenerationTime",
+                                    1);
+
+  // Nothing decays before a whole decay period has passed.
+  const base::TimeDelta decay_period =
+      base::Hours(SiteEngagementScore::GetDecayPeriodInHours());
+  task_environment()->AdvanceClock(decay_period - base::Hours(1));
+  ExpectImportantResultsEq(
+      {"yahoo.com", "google.com"}, {url2, url1},
+      ImportantSitesUtil::GetImportantRegisterableDomains(profile(),
+                                                          kNumImportantSites));
+  histogram_tester.ExpectTotalCount("Storage.ImportantSites.GenerationTime",
+                                    1);
+
+  // Once it has, the scores drop and the first site falls below the medium
+  // engagement. The result matches one computed from scratch.
+  task_environment()->AdvanceClock(base::Hours(1));
+  ASSERT_LT(service->GetScore(url1), 5);
+  ASSERT_GE(service->GetScore(url2), 5);
+  std::vector<ImportantDomainInfo> cached_sites =
+      ImportantSitesUtil::GetImportantRegisterableDomains(profile(),
+                                                          kNumImportantSites);
+  histogram_tester.ExpectTotalCount("Storage.ImportantSites.GenerationTime",
+                                    2);
+  ImportantSitesUtil::ClearCacheForTesting(profile());
+  std::vector<ImportantDomainInfo> recomputed_sites =
+      ImportantSitesUtil::GetImportantRegisterableDomains(profile(),
+                                                          kNumImportantSites);
+  ASSERT_EQ(recomputed_sites.size(), cached_sites.size());
+  for (size_t i = 0; i < recomputed_sites.size(); ++i) {
+    EXPECT_EQ(recomputed_sites[i].registerable_domain,
+              cached_sites[i].registerable_domain);
+    EXPECT_EQ(recomputed_sites[i].example_origin,
+              cached_sites[i].example_origin);
+    EXPECT_DOUBLE_EQ(recomputed_sites[i].engagement_score,
+                     cached_sites[i].engagement_score);
+  }
+  ExpectImportantResultsEq({"yahoo.com"}, {url2}, cached_sites);
+}
+
 }  // namespace site_engagement
 
 #endif  // !BUILDFLAG(IS_ANDROID)
@@ -5,6 +5,7 @@
 #include "chrome/browser/file_system_access/chrome_file_system_access_permission_context.h"
 
 #include <iterator>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -20,6 +21,8 @@
 #include "base/path_service.h"
 #include "base/ranges/algorithm.h"
 #include "base/strings/strcat.h"
+#include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
 #include "base/task/bind_post_task.h"
 #include "base/task/sequenced_task_runner.h"
 #include "base/task/task_traits.h"
@@ -341,44 +344,16 @@ const struct {
 // Describes a rule for blocking a directory, which can be constructed
 // dynamically (based on state) or statically (from kBlockedPaths).
 struct BlockPathRule {
+  friend bool operator==(const BlockPathRule&, const BlockPathRule&) = default;
+
   base::FilePath path;
   BlockType type;
 };
 
-bool ShouldBlockAccessToPath(const base::FilePath& path,
-                             HandleType handle_type,
-                             std::vector<BlockPathRule> rules) {
-  DCHECK(!path.empty());
-  DCHECK(path.IsAbsolute());
-
-  base::FilePath check_path;
-  if (base::FeatureList::IsEnabled(
-          features::kFileSystemAccessSymbolicLinkCheck)) {
-    // `NormalizeFilePath()` is called to perform normalization. It
-    // will resolve any file path elements like symbolic links or junctions by
-    // returning the target file path.
-    //
-    //  `path` is expected to be absolute. On Windows, this call will fail if
-    //  the target file path is greater than MAX_PATH.
-    if (!base::NormalizeFilePath(path, &check_path)) {
-      check_path = path;
-    }
-    DCHECK(!check_path.empty());
-  } else {
-    check_path = path;
-  }
-
-#if BUILDFLAG(IS_WIN)
-  // On Windows, local UNC paths are rejected, as UNC path can be written in a
-  // way that can bypass the blocklist.
-  if (base::FeatureList::IsEnabled(
-          features::kFileSystemAccessLocalUNCPathBlock) &&
-      MaybeIsLocalUNCPath(check_path)) {
-    return true;
-  }
-#endif
-
-  // Add the hard-coded rules to the dynamic rules.
+// Returns the hard-coded rules from kBlockedPaths, resolved to absolute paths.
+// May block.
+std::vector<BlockPathRule> ResolveBlockPathRules() {
+  std::vector<BlockPathRule> rules;
   for (const auto& block : kBlockedPaths) {
     base::FilePath blocked_path;
     if (block.base_path_key != kNoBasePathKey) {
@@ -394,41 +369,132 @@ bool ShouldBlockAccessToPath(const base::FilePath& path,
     }
     rules.emplace_back(blocked_path, block.type);
   }
+  return rules;
+}
 
-  base::FilePath nearest_ancestor;
-  BlockType nearest_ancestor_block_type = kDontBlockChildren;
-  for (const auto& block : rules) {
-    if (check_path == block.path || check_path.IsParent(block.path)) {
+// Returns the components of `path` in the form they are compared in by
+// FilePath::IsParent().
+std::vector<base::FilePath::StringType> GetComponentsForMatching(
+    const base::FilePath& path) {
+  std::vector<base::FilePath::StringType> components = path.GetComponents();
+#if BUILDFLAG(IS_WIN)
+  // Drive letters are case insensitive.
+  if (!components.empty() && components[0].size() == 2 &&
+      components[0][1] == L':') {
+    components[0] = base::ToLowerASCII(components[0]);
+  }
+#endif
+  return components;
+}
+
+// Component-wise prefix trie of blocklist rules, so that checking a path costs
+// O(number of path components) rather than comparing it with every rule.
+class BlockPathRuleTrie {
+ public:
+  explicit BlockPathRuleTrie(const std::vector<BlockPathRule>& rules) {
+    for (const auto& rule : rules) {
+      Node* node = &root_;
+      for (auto& component : GetComponentsForMatching(rule.path)) {
+        std::unique_ptr<Node>& child = node->children[std::move(component)];
+        if (!child) {
+          child = std::make_unique<Node>();
+          // The first rule below this node, as found by a linear scan.
+          child->first_blocked_path = rule.path;
+        }
+        node = child.get();
+      }
+      // As with a linear scan of the rules, the first rule for a path wins.
+      if (!node->type) {
+        node->path = rule.path;
+        node->type = rule.type;
+      }
+    }
+  }
+
+  BlockPathRuleTrie(const BlockPathRuleTrie&) = delete;
+  BlockPathRuleTrie& operator=(const BlockPathRuleTrie&) = delete;
+
+  bool ShouldBlock(const base::FilePath& check_path,
+                   HandleType handle_type) const {
+    const Node* node = &root_;
+    const Node* nearest_ancestor = nullptr;
+    for (const auto& component : GetComponentsForMatching(check_path)) {
+      // Every rule found before the last component of `check_path` is one of
+      // its ancestors.
+      if (node->type) {
+        nearest_ancestor = node;
+      }
+      auto it = node->children.find(component);
+      if (it == node->children.end()) {
+        node = nullptr;
+        break;
+      }
+      node = it->second.get();
+    }
+
+    // Every node in the trie lies on the path of at least one rule, so
+    // `check_path` is either a blocked path or one of its parents.
+    if (node) {
       VLOG(1) << "Blocking access to " << check_path
-              << " because it is a parent of " << block.path;
+              << " because it is a parent of " << node->first_blocked_path;
       return true;
     }
 
-    if (block.path.IsParent(check_path) &&
-        (nearest_ancestor.empty() || nearest_ancestor.IsParent(block.path))) {
-      nearest_ancestor = block.path;
-      nearest_ancestor_block_type = block.type;
+    // The path we're checking is not in a potentially blocked directory, or
+    // the nearest ancestor does not block access to its children. Grant
+    // access.
+    if (!nearest_ancestor || *nearest_ancestor->type == kDontBlockChildren) {
+      return false;
     }
-  }
 
-  // The path we're checking is not in a potentially blocked directory, or the
-  // nearest ancestor does not block access to its children. Grant access.
-  if (nearest_ancestor.empty() ||
-      nearest_ancestor_block_type == kDontBlockChildren) {
-    return false;
+    // The path we're checking is a file, and the nearest ancestor only blocks
+    // access to directories. Grant access.
+    if (handle_type == HandleType::kFile &&
+        *nearest_ancestor->type == kBlockNestedDirectories) {
+      return false;
+    }
+
+    // The nearest ancestor blocks access to its children, so block access.
+    VLOG(1) << "Blocking access to " << check_path << " because it is inside "
+            << nearest_ancestor->path;
+    return true;
   }
 
-  // The path we're checking is a file, and the nearest ancestor only blocks
-  // access to directories. Grant access.
-  if (handle_type == HandleType::kFile &&
-      nearest_ancestor_block_type == kBlockNestedDirectories) {
-    return false;
+ private:
+  struct Node {
+    std::map<base::FilePath::StringType, std::unique_ptr<Node>> children;
+    // The path of the first rule for this node or one of its descendants.
+    base::FilePath first_blocked_path;
+    // Set if a rule exists for the path of this node.
+    base::FilePath path;
+    std::optional<BlockType> type;
+  };
+
+  Node root_;
+};
+
+// Returns the path that should be compared against the blocklist for `path`.
+base::FilePath GetPathToCheck(const base::FilePath& path) {
+  DCHECK(!path.empty());
+  DCHECK(path.IsAbsolute());
+
+  if (!base::FeatureList::IsEnabled(
+          features::kFileSystemAccessSymbolicLinkCheck)) {
+    return path;
   }
 
-  // The nearest ancestor blocks access to its children, so block access.
-  VLOG(1) << "Blocking access to " << check_path << " because it is inside "
-          << nearest_ancestor;
-  return true;
+  // `NormalizeFilePath()` is called to perform normalization. It
+  // will resolve any file path elements like symbolic links or junctions by
+  // returning the target file path.
+  //
+  //  `path` is expected to be absolute. On Windows, this call will fail if
+  //  the target file path is greater than MAX_PATH.
+  base::FilePath check_path;
+  if (!base::NormalizeFilePath(path, &check_path)) {
+    check_path = path;
+  }
+  DCHECK(!check_path.empty());
+  return check_path;
 }
 
 void DoSafeBrowsingCheckOnUIThread(
@@ -544,6 +610,68 @@ bool FileHasDangerousExtension(const url::Origin& origin,
 
 }  // namespace
 
+// Compiles the blocklist rules into a BlockPathRuleTrie and checks paths
+// against it. The rules are resolved on every check, which PathService answers
+// from its own cache, so that PathService overrides apply right away. The trie
+// is only rebuilt when the resolved rules change. Used on blocking-capable
+// thread pool sequences.
+class ChromeFileSystemAccessPermissionContext::BlocklistRuleCache
+    : public base::RefCountedThreadSafe<BlocklistRuleCache> {
+ public:
+  BlocklistRuleCache() = default;
+
+  BlocklistRuleCache(const BlocklistRuleCache&) = delete;
+  BlocklistRuleCache& operator=(const BlocklistRuleCache&) = delete;
+
+  // Returns whether access to each of `paths` should be blocked.
+  std::vector<bool> ShouldBlockAccessToPaths(
+      const std::vector<base::FilePath>& paths,
+      HandleType handle_type,
+      std::vector<BlockPathRule> extra_rules) {
+    std::vector<base::FilePath> check_paths;
+    check_paths.reserve(paths.size());
+    for (const auto& path : paths) {
+      check_paths.push_back(GetPathToCheck(path));
+    }
+
+    // The extra rules come first, as they did in a linear scan.
+    std::vector<BlockPathRule> rules = std::move(extra_rules);
+    std::vector<BlockPathRule> hard_coded_rules = ResolveBlockPathRules();
+    rules.insert(rules.end(), hard_coded_rules.begin(), hard_coded_rules.end());
+
+    std::vector<bool> should_block(paths.size(), false);
+    base::AutoLock lock(lock_);
+    if (!trie_ || rules != rules_) {
+      trie_ = std::make_unique<BlockPathRuleTrie>(rules);
+      rules_ = std::move(rules);
+    }
+    for (size_t i = 0; i < check_paths.size(); ++i) {
+#if BUILDFLAG(IS_WIN)
+      // On Windows, local UNC paths are rejected, as UNC path can be written
+      // in a way that can bypass the blocklist.
+      if (base::FeatureList::IsEnabled(
+              features::kFileSystemAccessLocalUNCPathBlock) &&
+          MaybeIsLocalUNCPath(check_paths[i])) {
+        should_block[i] = true;
+        continue;
+      }
+#endif
+      should_block[i] = trie_->ShouldBlock(check_paths[i], handle_type);
+    }
+    return should_block;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<BlocklistRuleCache>;
+
+  ~BlocklistRuleCache() = default;
+
+  base::Lock lock_;
+  // The rules `trie_` was built from.
+  std::vector<BlockPathRule> rules_ GUARDED_BY(lock_);
+  std::unique_ptr<BlockPathRuleTrie> trie_ GUARDED_BY(lock_);
+};
+
 ChromeFileSystemAccessPermissionContext::Grants::Grants() = default;
 ChromeFileSystemAccessPermissionContext::Grants::~Grants() = default;
 ChromeFileSystemAccessPermissionContext::Grants::Grants(Grants&&) = default;
@@ -1104,7 +1232,8 @@ ChromeFileSystemAccessPermissionContext::
           ContentSettingsType::FILE_SYSTEM_ACCESS_CHOOSER_DATA,
           HostContentSettingsMapFactory::GetForProfile(context)),
       profile_(context),
-      clock_(clock) {
+      clock_(clock),
+      blocklist_rule_cache_(base::MakeRefCounted<BlocklistRuleCache>()) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
   content_settings_ = base::WrapRefCounted(
       HostContentSettingsMapFactory::GetForProfile(profile_));
@@ -1589,12 +1718,20 @@ void ChromeFileSystemAccessPermissionContext::ConfirmSensitiveEntryAccess(
     base::OnceCallback<void(SensitiveEntryResult)> callback) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
+  // The directory picker, like the file pickers, confirms access to the
+  // picked entry here.
   auto after_blocklist_check_callback = base::BindOnce(
       &ChromeFileSystemAccessPermissionContext::DidCheckPathAgainstBlocklist,
       GetWeakPtr(), origin, path, handle_type, user_action, frame_id,
       std::move(callback));
-  CheckPathAgainstBlocklist(path_type, path, handle_type,
-                            std::move(after_blocklist_check_callback));
+  CheckPathsAgainstBlocklist(
+      {PathInfo{.type = path_type, .path = path}}, handle_type,
+      base::BindOnce(
+          [](base::OnceCallback<void(bool)> callback,
+             std::vector<bool> should_block) {
+            std::move(callback).Run(should_block[0]);
+          },
+          std::move(after_blocklist_check_callback)));
 }
 
 void ChromeFileSystemAccessPermissionContext::CheckPathsAgainstEnterprisePolicy(
@@ -1674,19 +1811,26 @@ void ChromeFileSystemAccessPermissionContext::OnContentAnalysisComplete(
 
 #endif  // BUILDFLAG(ENTERPRISE_CLOUD_CONTENT_ANALYSIS)
 
-void ChromeFileSystemAccessPermissionContext::CheckPathAgainstBlocklist(
-    PathType path_type,
-    const base::FilePath& path,
+void ChromeFileSystemAccessPermissionContext::CheckPathsAgainstBlocklist(
+    std::vector<PathInfo> entries,
     HandleType handle_type,
-    base::OnceCallback<void(bool)> callback) {
+    base::OnceCallback<void(std::vector<bool>)> callback) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   // TODO(crbug.com/40101272): Figure out what external paths should be
   // blocked. We could resolve the external path to a local path, and check for
   // blocked directories based on that, but that doesn't work well. Instead we
   // should have a separate Chrome OS only code path to block for example the
   // root of certain external file systems.
-  if (path_type == PathType::kExternal) {
-    std::move(callback).Run(/*should_block=*/false);
+  std::vector<size_t> local_path_indices;
+  std::vector<base::FilePath> local_paths;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (entries[i].type == PathType::kLocal) {
+      local_path_indices.push_back(i);
+      local_paths.push_back(entries[i].path);
+    }
+  }
+  if (local_paths.empty()) {
+    std::move(callback).Run(std::vector<bool>(entries.size(), false));
     return;
   }
 
@@ -1705,8 +1849,20 @@ void ChromeFileSystemAccessPermissionContext::CheckPathAgainstBlocklist(
 
   base::ThreadPool::PostTaskAndReplyWithResult(
       FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_VISIBLE},
-      base::BindOnce(&ShouldBlockAccessToPath, path, handle_type, extra_rules),
-      std::move(callback));
+      base::BindOnce(&BlocklistRuleCache::ShouldBlockAccessToPaths,
+                     blocklist_rule_cache_, std::move(local_paths),
+                     handle_type, std::move(extra_rules)),
+      base::BindOnce(
+          [](size_t num_entries, std::vector<size_t> local_path_indices,
+             base::OnceCallback<void(std::vector<bool>)> callback,
+             std::vector<bool> local_path_should_block) {
+            std::vector<bool> should_block(num_entries, false);
+            for (size_t i = 0; i < local_path_indices.size(); ++i) {
+              should_block[local_path_indices[i]] = local_path_should_block[i];
+            }
+            std::move(callback).Run(std::move(should_block));
+          },
+          entries.size(), std::move(local_path_indices), std::move(callback)));
 }
 
 void ChromeFileSystemAccessPermissionContext::PerformAfterWriteChecks(
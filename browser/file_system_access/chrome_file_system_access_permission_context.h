@@ -11,6 +11,7 @@
 #include "base/callback_list.h"
 #include "base/files/file_path.h"
 #include "base/memory/raw_ptr.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/scoped_observation.h"
 #include "base/sequence_checker.h"
 #include "base/time/clock.h"
@@ -209,6 +210,16 @@ class ChromeFileSystemAccessPermissionContext
       content::GlobalRenderFrameHostId frame_id,
       EntriesAllowedByEnterprisePolicyCallback callback) override;
 
+  // Checks whether each of `entries` corresponds to a directory Chrome
+  // considers sensitive (i.e. system files), assuming they all are of
+  // `handle_type`. Calls `callback` with whether each entry is on the
+  // blocklist, in the same order as `entries`. All the entries are checked in
+  // a single thread pool task.
+  void CheckPathsAgainstBlocklist(
+      std::vector<PathInfo> entries,
+      HandleType handle_type,
+      base::OnceCallback<void(std::vector<bool>)> callback);
+
   // Registers a subscriber to be notified of file creation events originating
   // from `window.showSaveFilePicker()` until the returned subscription is
   // destroyed.
@@ -338,6 +349,7 @@ class ChromeFileSystemAccessPermissionContext
   SEQUENCE_CHECKER(sequence_checker_);
 
  private:
+  class BlocklistRuleCache;
   class PermissionGrantImpl;
 
   enum class PersistedPermissionOptions {
@@ -361,13 +373,6 @@ class ChromeFileSystemAccessPermissionContext
       std::vector<bool> allowed);
 #endif
 
-  // Checks whether the file or directory at `path` corresponds to a directory
-  // Chrome considers sensitive (i.e. system files). Calls `callback` with
-  // whether the path is on the blocklist.
-  void CheckPathAgainstBlocklist(PathType path_type,
-                                 const base::FilePath& path,
-                                 HandleType handle_type,
-                                 base::OnceCallback<void(bool)> callback);
   void DidCheckPathAgainstBlocklist(
       const url::Origin& origin,
       const base::FilePath& path,
@@ -534,6 +539,9 @@ class ChromeFileSystemAccessPermissionContext
 
   const raw_ptr<const base::Clock> clock_;
 
+  // Blocklist rules compiled for checking paths, shared with the thread pool.
+  const scoped_refptr<BlocklistRuleCache> blocklist_rule_cache_;
+
   // Subscribers to notify of file creation events originating from
   // `window.showSaveFilePicker()`.
   FileCreatedFromShowSaveFilePickerCallbackList
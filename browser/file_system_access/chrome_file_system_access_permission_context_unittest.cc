@@ -13,6 +13,7 @@
 #include "base/files/scoped_temp_dir.h"
 #include "base/json/values_util.h"
 #include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/test/bind.h"
 #include "base/test/metrics/histogram_tester.h"
 #include "base/test/scoped_path_override.h"
@@ -626,6 +627,79 @@ TEST_F(ChromeFileSystemAccessPermissionContextTest,
 #endif
 }
 
+TEST_F(ChromeFileSystemAccessPermissionContextTest,
+       ConfirmSensitiveEntryAccess_RulesFollowPathOverrides) {
+  base::FilePath home_dir = temp_dir_.GetPath().AppendASCII("home");
+  base::ScopedPathOverride home_override(base::DIR_HOME, home_dir, true, true);
+  base::FilePath app_dir = temp_dir_.GetPath().AppendASCII("app");
+  base::ScopedPathOverride app_override(base::DIR_EXE, app_dir, true, true);
+
+  // Check many paths, alternating between allowed paths inside the Home
+  // directory and blocked paths inside the App directory.
+  for (int i = 0; i < 100; ++i) {
+    const std::string name = base::NumberToString(i);
+    EXPECT_TRUE(IsOpenAllowed(home_dir.AppendASCII(name), HandleType::kFile));
+    EXPECT_FALSE(IsOpenAllowed(app_dir.AppendASCII(name), HandleType::kFile));
+  }
+
+  // A changed path override applies to the next check.
+  const base::FilePath exe_in_home_dir = home_dir.AppendASCII("exe");
+  EXPECT_TRUE(
+      IsOpenAllowed(exe_in_home_dir.AppendASCII("foo"), HandleType::kFile));
+  base::ScopedPathOverride exe_in_home_override(base::DIR_EXE,
+                                                exe_in_home_dir, true, true);
+  EXPECT_FALSE(
+      IsOpenAllowed(exe_in_home_dir.AppendASCII("foo"), HandleType::kFile));
+  EXPECT_TRUE(IsOpenAllowed(app_dir.AppendASCII("foo"), HandleType::kFile));
+}
+
+TEST_F(ChromeFileSystemAccessPermissionContextTest,
+       CheckPathsAgainstBlocklist_Batch) {
+  base::FilePath home_dir = temp_dir_.GetPath().AppendASCII("home");
+  base::ScopedPathOverride home_override(base::DIR_HOME, home_dir, true, true);
+  base::FilePath app_dir = temp_dir_.GetPath().AppendASCII("app");
+  base::ScopedPathOverride app_override(base::DIR_EXE, app_dir, true, true);
+
+  // Check 10k paths at once, alternating between allowed paths inside the
+  // Home directory, blocked paths inside the App directory and external paths.
+  constexpr size_t kNumPaths = 10000;
+  std::vector<PathInfo> entries;
+  for (size_t i = 0; i < kNumPaths; ++i) {
+    std::string name = base::NumberToString(i);
+    switch (i % 3) {
+      case 0:
+        entries.push_back(PathInfo{.type = PathType::kLocal,
+                                   .path = home_dir.AppendASCII(name)});
+        break;
+      case 1:
+        entries.push_back(PathInfo{.type = PathType::kLocal,
+                                   .path = app_dir.AppendASCII(name)});
+        break;
+      case 2:
+        entries.push_back(
+            PathInfo{.type = PathType::kExternal,
+                     .path = base::FilePath::FromASCII(name)});
+        break;
+    }
+  }
+
+  base::test::TestFuture<std::vector<bool>> future;
+  permission_context()->CheckPathsAgainstBlocklist(
+      entries, HandleType::kDirectory, future.GetCallback());
+  const std::vector<bool>& should_block = future.Get();
+  ASSERT_EQ(should_block.size(), kNumPaths);
+  for (size_t i = 0; i < kNumPaths; ++i) {
+    EXPECT_EQ(should_block[i], i % 3 == 1) << entries[i].path;
+  }
+
+  // A batch with no local path is answered without a thread pool task.
+  base::test::TestFuture<std::vector<bool>> external_future;
+  permission_context()->CheckPathsAgainstBlocklist(
+      {entries[2], entries[5]}, HandleType::kDirectory,
+      external_future.GetCallback());
+  EXPECT_EQ(external_future.Get(), std::vector<bool>({false, false}));
+}
+
 #if BUILDFLAG(IS_MAC)
 TEST_F(ChromeFileSystemAccessPermissionContextTest,
        ConfirmSensitiveEntryAccess_DontBlockAllChildren_Overlapping) {
@@ -4,6 +4,10 @@
 
 #include "chrome/browser/history/chrome_history_backend_client.h"
 
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/ranges/algorithm.h"
 #include "chrome/common/channel_info.h"
 #include "components/bookmarks/browser/history_bookmark_model.h"
 #include "components/bookmarks/browser/model_loader.h"
@@ -12,9 +16,98 @@
 #include "content/public/browser/child_process_security_policy.h"
 #include "url/gurl.h"
 
+PinnedURLSnapshot::PinnedURLSnapshot(std::vector<history::URLAndTitle> urls)
+    : urls_(std::move(urls)) {
+  DCHECK(base::ranges::is_sorted(urls_, {}, &history::URLAndTitle::url));
+}
+
+PinnedURLSnapshot::~PinnedURLSnapshot() = default;
+
+bool PinnedURLSnapshot::Contains(const GURL& url) const {
+  auto it =
+      base::ranges::lower_bound(urls_, url, {}, &history::URLAndTitle::url);
+  return it != urls_.end() && it->url == url;
+}
+
+PinnedURLSet::PinnedURLSet() {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+PinnedURLSet::~PinnedURLSet() = default;
+
+void PinnedURLSet::Reset(const std::vector<history::URLAndTitle>& nodes) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  titles_by_url_.clear();
+  for (const history::URLAndTitle& node : nodes)
+    titles_by_url_[node.url].push_back(node.title);
+  changed_ = true;
+}
+
+void PinnedURLSet::Add(const GURL& url, const std::u16string& title) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  titles_by_url_[url].push_back(title);
+  changed_ = true;
+}
+
+void PinnedURLSet::Remove(const GURL& url, const std::u16string& title) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = titles_by_url_.find(url);
+  if (it == titles_by_url_.end())
+    return;
+  std::vector<std::u16string>& titles = it->second;
+  auto title_it = base::ranges::find(titles, title);
+  titles.erase(title_it == titles.end() ? titles.begin() : title_it);
+  if (titles.empty())
+    titles_by_url_.erase(it);
+  changed_ = true;
+}
+
+void PinnedURLSet::Publish() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!changed_)
+    return;
+  changed_ = false;
+  std::vector<history::URLAndTitle> urls;
+  urls.reserve(titles_by_url_.size());
+  for (const auto& [url, titles] : titles_by_url_)
+    urls.push_back(history::URLAndTitle{url, titles.front()});
+  // Build the new snapshot, and release the old one, outside of the lock so
+  // that readers never wait on either.
+  scoped_refptr<const PinnedURLSnapshot> snapshot =
+      base::MakeRefCounted<PinnedURLSnapshot>(std::move(urls));
+  {
+    base::AutoLock lock(lock_);
+    snapshot_.swap(snapshot);
+  }
+}
+
+std::optional<bool> PinnedURLSet::Contains(const GURL& url) const {
+  scoped_refptr<const PinnedURLSnapshot> snapshot = GetSnapshot();
+  if (!snapshot)
+    return std::nullopt;
+  return snapshot->Contains(url);
+}
+
+std::optional<std::vector<history::URLAndTitle>> PinnedURLSet::GetURLs()
+    const {
+  scoped_refptr<const PinnedURLSnapshot> snapshot = GetSnapshot();
+  if (!snapshot)
+    return std::nullopt;
+  return snapshot->urls();
+}
+
+scoped_refptr<const PinnedURLSnapshot> PinnedURLSet::GetSnapshot() const {
+  base::AutoLock lock(lock_);
+  return snapshot_;
+}
+
 ChromeHistoryBackendClient::ChromeHistoryBackendClient(
-    scoped_refptr<bookmarks::ModelLoader> model_loader)
-    : model_loader_(std::move(model_loader)) {}
+    scoped_refptr<bookmarks::ModelLoader> model_loader,
+    scoped_refptr<PinnedURLSet> pinned_urls)
+    : model_loader_(std::move(model_loader)),
+      pinned_urls_(std::move(pinned_urls)) {
+  DCHECK_EQ(!!model_loader_, !!pinned_urls_);
+}
 
 ChromeHistoryBackendClient::~ChromeHistoryBackendClient() {
 }
@@ -23,9 +116,13 @@ bool ChromeHistoryBackendClient::IsPinnedURL(const GURL& url) {
   if (!model_loader_)
     return false;
 
-  // HistoryBackendClient is used to determine if an URL is bookmarked. The data
-  // is loaded on a separate thread and may not be done when this method is
-  // called, therefore blocks until the bookmarks have finished loading.
+  if (std::optional<bool> pinned = pinned_urls_->Contains(url))
+    return *pinned;
+
+  // The bookmarks have not finished loading yet. This is asked both before
+  // expiring a URL and before deleting it at the user's request, which must
+  // not keep a URL that is not bookmarked. So rather than guessing, wait until
+  // the bookmarks have loaded, as GetPinnedURLs() does.
   model_loader_->BlockTillLoaded();
   return model_loader_->history_bookmark_model()->IsBookmarked(url);
 }
@@ -35,9 +132,14 @@ std::vector<history::URLAndTitle> ChromeHistoryBackendClient::GetPinnedURLs() {
   if (!model_loader_)
     return result;
 
-  // HistoryBackendClient is used to determine the set of bookmarked URLs. The
-  // data is loaded on a separate thread and may not be done when this method is
-  // called, therefore blocks until the bookmarks have finished loading.
+  if (std::optional<std::vector<history::URLAndTitle>> urls =
+          pinned_urls_->GetURLs()) {
+    return std::move(*urls);
+  }
+
+  // The bookmarks have not finished loading yet. The callers need the complete
+  // set of bookmarked URLs to preserve them, so this rare case still has to
+  // wait until the bookmarks have finished loading.
   model_loader_->BlockTillLoaded();
   std::vector<bookmarks::UrlAndTitle> url_and_titles =
       model_loader_->history_bookmark_model()->GetUniqueUrls();
@@ -5,19 +5,103 @@
 #ifndef CHROME_BROWSER_HISTORY_CHROME_HISTORY_BACKEND_CLIENT_H_
 #define CHROME_BROWSER_HISTORY_CHROME_HISTORY_BACKEND_CLIENT_H_
 
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_refptr.h"
+#include "base/sequence_checker.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
 #include "components/history/core/browser/history_backend_client.h"
+#include "url/gurl.h"
 
 namespace bookmarks {
 class ModelLoader;
 }
 
+// An immutable snapshot of the bookmarked URLs, sorted by URL, with one entry
+// per URL.
+class PinnedURLSnapshot
+    : public base::RefCountedThreadSafe<PinnedURLSnapshot> {
+ public:
+  explicit PinnedURLSnapshot(std::vector<history::URLAndTitle> urls);
+
+  PinnedURLSnapshot(const PinnedURLSnapshot&) = delete;
+  PinnedURLSnapshot& operator=(const PinnedURLSnapshot&) = delete;
+
+  const std::vector<history::URLAndTitle>& urls() const { return urls_; }
+
+  bool Contains(const GURL& url) const;
+
+ private:
+  friend class base::RefCountedThreadSafe<PinnedURLSnapshot>;
+  ~PinnedURLSnapshot();
+
+  const std::vector<history::URLAndTitle> urls_;
+};
+
+// The URLs of all bookmarks. ChromeHistoryClient applies the changes to the
+// bookmark nodes on the UI thread, and publishes them as a new
+// PinnedURLSnapshot which ChromeHistoryBackendClient reads on the history
+// backend sequence. The lock is only held to swap the snapshot or take a
+// reference to it, so readers never wait on an update, nor copy the URLs while
+// holding it.
+class PinnedURLSet : public base::RefCountedThreadSafe<PinnedURLSet> {
+ public:
+  PinnedURLSet();
+
+  PinnedURLSet(const PinnedURLSet&) = delete;
+  PinnedURLSet& operator=(const PinnedURLSet&) = delete;
+
+  // Replaces the contents with |nodes|, which holds one entry per bookmark
+  // node.
+  void Reset(const std::vector<history::URLAndTitle>& nodes);
+
+  // Records that a bookmark node for |url| with |title| was added or removed.
+  void Add(const GURL& url, const std::u16string& title);
+  void Remove(const GURL& url, const std::u16string& title);
+
+  // Makes the changes since the last call visible to readers, and marks the
+  // set as loaded. The updates above and this must be called on the same
+  // sequence.
+  void Publish();
+
+  // Returns whether |url| is bookmarked, or std::nullopt if the bookmarks have
+  // not finished loading yet. May be called on any sequence.
+  std::optional<bool> Contains(const GURL& url) const;
+
+  // Returns each bookmarked URL once, or std::nullopt if the bookmarks have
+  // not finished loading yet. May be called on any sequence.
+  std::optional<std::vector<history::URLAndTitle>> GetURLs() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<PinnedURLSet>;
+  ~PinnedURLSet();
+
+  // Returns the last published snapshot, or null if there is none yet.
+  scoped_refptr<const PinnedURLSnapshot> GetSnapshot() const;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+  // The titles of the bookmark nodes of each bookmarked URL.
+  std::map<GURL, std::vector<std::u16string>> titles_by_url_
+      GUARDED_BY_CONTEXT(sequence_checker_);
+  // Whether |titles_by_url_| changed since the last snapshot.
+  bool changed_ GUARDED_BY_CONTEXT(sequence_checker_) = true;
+
+  mutable base::Lock lock_;
+  scoped_refptr<const PinnedURLSnapshot> snapshot_ GUARDED_BY(lock_);
+};
+
 // ChromeHistoryBackendClient implements history::HistoryBackendClient interface
 // to provides access to embedder-specific features.
 class ChromeHistoryBackendClient : public history::HistoryBackendClient {
  public:
-  explicit ChromeHistoryBackendClient(
-      scoped_refptr<bookmarks::ModelLoader> model_loader);
+  ChromeHistoryBackendClient(
+      scoped_refptr<bookmarks::ModelLoader> model_loader,
+      scoped_refptr<PinnedURLSet> pinned_urls);
 
   ChromeHistoryBackendClient(const ChromeHistoryBackendClient&) = delete;
   ChromeHistoryBackendClient& operator=(const ChromeHistoryBackendClient&) =
@@ -33,6 +117,9 @@ class ChromeHistoryBackendClient : public history::HistoryBackendClient {
  private:
   // ModelLoader is used to access bookmarks. May be null during testing.
   scoped_refptr<bookmarks::ModelLoader> model_loader_;
+
+  // The bookmarked URLs. Null if and only if |model_loader_| is.
+  scoped_refptr<PinnedURLSet> pinned_urls_;
 };
 
 #endif  // CHROME_BROWSER_HISTORY_CHROME_HISTORY_BACKEND_CLIENT_H_
@@ -4,9 +4,12 @@
 
 #include "chrome/browser/history/chrome_history_client.h"
 
+#include <vector>
+
 #include "base/check_op.h"
 #include "base/functional/bind.h"
 #include "base/functional/callback.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/time/time.h"
 #include "chrome/browser/history/chrome_history_backend_client.h"
 #include "chrome/browser/history/history_utils.h"
@@ -17,11 +20,31 @@
 #include "components/bookmarks/browser/model_loader.h"
 #include "components/history/core/browser/history_service.h"
 
+namespace {
+
+// Appends the URL and title of |node|, and of each of its descendants, that is
+// a URL to |nodes|.
+void AppendURLNodes(const bookmarks::BookmarkNode* node,
+                    std::vector<history::URLAndTitle>* nodes) {
+  if (node->is_url())
+    nodes->push_back(history::URLAndTitle{node->url(), node->GetTitle()});
+  for (const auto& child : node->children())
+    AppendURLNodes(child.get(), nodes);
+}
+
+}  // namespace
+
 ChromeHistoryClient::ChromeHistoryClient(
     bookmarks::BookmarkModel* bookmark_model)
     : bookmark_model_(bookmark_model) {
-  if (bookmark_model_)
-    bookmark_model_->AddObserver(this);
+  if (!bookmark_model_)
+    return;
+  pinned_urls_ = base::MakeRefCounted<PinnedURLSet>();
+  bookmark_model_->AddObserver(this);
+  if (bookmark_model_->loaded()) {
+    ResetPinnedURLs();
+    pinned_urls_->Publish();
+  }
 }
 
 ChromeHistoryClient::~ChromeHistoryClient() {
@@ -60,7 +83,8 @@ void ChromeHistoryClient::NotifyProfileError(sql::InitStatus init_status,
 std::unique_ptr<history::HistoryBackendClient>
 ChromeHistoryClient::CreateBackendClient() {
   return std::make_unique<ChromeHistoryBackendClient>(
-      bookmark_model_ ? bookmark_model_->model_loader() : nullptr);
+      bookmark_model_ ? bookmark_model_->model_loader() : nullptr,
+      bookmark_model_ ? pinned_urls_ : nullptr);
 }
 
 void ChromeHistoryClient::UpdateBookmarkLastUsedTime(int64_t bookmark_node_id,
@@ -82,13 +106,92 @@ void ChromeHistoryClient::StopObservingBookmarkModel() {
   bookmark_model_ = nullptr;
 }
 
+void ChromeHistoryClient::ResetPinnedURLs() {
+  std::vector<history::URLAndTitle> nodes;
+  AppendURLNodes(bookmark_model_->root_node(), &nodes);
+  pinned_urls_->Reset(nodes);
+}
+
+void ChromeHistoryClient::AddPinnedURLs(const bookmarks::BookmarkNode* node) {
+  std::vector<history::URLAndTitle> nodes;
+  AppendURLNodes(node, &nodes);
+  for (const history::URLAndTitle& entry : nodes)
+    pinned_urls_->Add(entry.url, entry.title);
+}
+
+void ChromeHistoryClient::RemovePinnedURLs(
+    const bookmarks::BookmarkNode* node) {
+  std::vector<history::URLAndTitle> nodes;
+  AppendURLNodes(node, &nodes);
+  for (const history::URLAndTitle& entry : nodes)
+    pinned_urls_->Remove(entry.url, entry.title);
+}
+
+void ChromeHistoryClient::PublishPinnedURLs() {
+  // Publishing copies every bookmarked URL, so do it once at the end of
+  // extensive changes such as an import or a sync merge.
+  if (!bookmark_model_->IsDoingExtensiveChanges())
+    pinned_urls_->Publish();
+}
+
+void ChromeHistoryClient::OnBookmarksRemoved(
+    const std::set<GURL>& removed_urls) {
+  if (bookmark_model_->IsDoingExtensiveChanges()) {
+    pending_removed_urls_.insert(removed_urls.begin(), removed_urls.end());
+    return;
+  }
+  // The published URLs no longer include |removed_urls|, which the history
+  // backend consults before deleting them.
+  if (on_bookmarks_removed_)
+    on_bookmarks_removed_.Run(removed_urls);
+}
+
 void ChromeHistoryClient::BookmarkModelChanged() {
+  // The pinned URLs are updated from the individual notifications below.
+}
+
+void ChromeHistoryClient::BookmarkModelLoaded(bool ids_reassigned) {
+  ResetPinnedURLs();
+  pinned_urls_->Publish();
 }
 
 void ChromeHistoryClient::BookmarkModelBeingDeleted() {
   StopObservingBookmarkModel();
 }
 
+void ChromeHistoryClient::ExtensiveBookmarkChangesEnded() {
+  PublishPinnedURLs();
+  std::set<GURL> removed_urls;
+  removed_urls.swap(pending_removed_urls_);
+  if (on_bookmarks_removed_ && !removed_urls.empty())
+    on_bookmarks_removed_.Run(removed_urls);
+}
+
+void ChromeHistoryClient::BookmarkNodeAdded(
+    const bookmarks::BookmarkNode* parent,
+    size_t index,
+    bool added_by_user) {
+  // A restored node may come with its descendants.
+  AddPinnedURLs(parent->children()[index].get());
+  PublishPinnedURLs();
+}
+
+void ChromeHistoryClient::OnWillChangeBookmarkNode(
+    const bookmarks::BookmarkNode* node) {
+  if (node->is_url())
+    changing_node_ = ChangingNode{node, node->url(), node->GetTitle()};
+}
+
+void ChromeHistoryClient::BookmarkNodeChanged(
+    const bookmarks::BookmarkNode* node) {
+  if (!changing_node_ || changing_node_->node != node)
+    return;
+  pinned_urls_->Remove(changing_node_->url, changing_node_->title);
+  pinned_urls_->Add(node->url(), node->GetTitle());
+  changing_node_.reset();
+  PublishPinnedURLs();
+}
+
 void ChromeHistoryClient::BookmarkNodeRemoved(
     const bookmarks::BookmarkNode* parent,
     size_t old_index,
@@ -97,8 +200,11 @@ void ChromeHistoryClient::BookmarkNodeRemoved(
     const base::Location& location) {
   BaseBookmarkModelObserver::BookmarkNodeRemoved(parent, old_index, node,
                                                  removed_urls, location);
-  if (on_bookmarks_removed_)
-    on_bookmarks_removed_.Run(removed_urls);
+  // Update the pinned URLs first, as the history backend consults them before
+  // deleting |removed_urls|.
+  RemovePinnedURLs(node);
+  PublishPinnedURLs();
+  OnBookmarksRemoved(removed_urls);
 }
 
 void ChromeHistoryClient::BookmarkAllUserNodesRemoved(
@@ -106,6 +212,8 @@ void ChromeHistoryClient::BookmarkAllUserNodesRemoved(
     const base::Location& location) {
   BaseBookmarkModelObserver::BookmarkAllUserNodesRemoved(removed_urls,
                                                          location);
-  if (on_bookmarks_removed_)
-    on_bookmarks_removed_.Run(removed_urls);
+  // Managed bookmarks, if any, are not removed.
+  ResetPinnedURLs();
+  PublishPinnedURLs();
+  OnBookmarksRemoved(removed_urls);
 }
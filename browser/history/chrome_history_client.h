@@ -6,21 +6,25 @@
 #define CHROME_BROWSER_HISTORY_CHROME_HISTORY_CLIENT_H_
 
 #include <memory>
+#include <optional>
 #include <set>
+#include <string>
 
 #include "base/callback_list.h"
 #include "base/functional/callback.h"
 #include "base/memory/raw_ptr.h"
+#include "base/memory/scoped_refptr.h"
 #include "components/bookmarks/browser/base_bookmark_model_observer.h"
 #include "components/history/core/browser/history_client.h"
-
-class GURL;
+#include "url/gurl.h"
 
 namespace bookmarks {
 class BookmarkModel;
 class BookmarkNode;
 }
 
+class PinnedURLSet;
+
 // This class implements history::HistoryClient to abstract operations that
 // depend on Chrome environment.
 class ChromeHistoryClient : public history::HistoryClient,
@@ -45,11 +49,42 @@ class ChromeHistoryClient : public history::HistoryClient,
                                   base::Time time) override;
 
  private:
+  // The URL and title of a URL node before it changes.
+  struct ChangingNode {
+    raw_ptr<const bookmarks::BookmarkNode> node;
+    GURL url;
+    std::u16string title;
+  };
+
   void StopObservingBookmarkModel();
 
+  // Rebuilds |pinned_urls_| from all nodes of the bookmark model.
+  void ResetPinnedURLs();
+
+  // Adds or removes the URLs of |node| and its descendants to or from
+  // |pinned_urls_|.
+  void AddPinnedURLs(const bookmarks::BookmarkNode* node);
+  void RemovePinnedURLs(const bookmarks::BookmarkNode* node);
+
+  // Publishes the changes to |pinned_urls_| to the history backend, unless the
+  // bookmark model is in the middle of extensive changes.
+  void PublishPinnedURLs();
+
+  // Forwards |removed_urls| to the history service, unless the bookmark model
+  // is in the middle of extensive changes, in which case they are held back
+  // until the bookmarked URLs without them have been published.
+  void OnBookmarksRemoved(const std::set<GURL>& removed_urls);
+
   // bookmarks::BaseBookmarkModelObserver implementation.
   void BookmarkModelChanged() override;
+  void BookmarkModelLoaded(bool ids_reassigned) override;
   void BookmarkModelBeingDeleted() override;
+  void ExtensiveBookmarkChangesEnded() override;
+  void BookmarkNodeAdded(const bookmarks::BookmarkNode* parent,
+                         size_t index,
+                         bool added_by_user) override;
+  void OnWillChangeBookmarkNode(const bookmarks::BookmarkNode* node) override;
+  void BookmarkNodeChanged(const bookmarks::BookmarkNode* node) override;
   void BookmarkNodeRemoved(const bookmarks::BookmarkNode* parent,
                            size_t old_index,
                            const bookmarks::BookmarkNode* node,
@@ -65,6 +100,18 @@ class ChromeHistoryClient : public history::HistoryClient,
   // Callback invoked when URLs are removed from BookmarkModel.
   base::RepeatingCallback<void(const std::set<GURL>&)> on_bookmarks_removed_;
 
+  // Shares the bookmarked URLs with the history backend, so that it never has
+  // to wait on the bookmark model. Null if |bookmark_model_| was null at
+  // construction.
+  scoped_refptr<PinnedURLSet> pinned_urls_;
+
+  // URLs removed during extensive changes, forwarded to the history service
+  // once they end.
+  std::set<GURL> pending_removed_urls_;
+
+  // The URL node between OnWillChangeBookmarkNode() and BookmarkNodeChanged().
+  std::optional<ChangingNode> changing_node_;
+
   // Subscription for notifications of changes to favicons.
   base::CallbackListSubscription favicons_changed_subscription_;
 };
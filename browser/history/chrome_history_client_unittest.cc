@@ -0,0 +1,131 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/history/chrome_history_client.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/location.h"
+#include "components/bookmarks/browser/bookmark_model.h"
+#include "components/bookmarks/browser/bookmark_node.h"
+#include "components/bookmarks/common/bookmark_metrics.h"
+#include "components/bookmarks/test/bookmark_test_helpers.h"
+#include "components/bookmarks/test/test_bookmark_client.h"
+#include "components/history/core/browser/history_backend_client.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+using bookmarks::BookmarkModel;
+using bookmarks::BookmarkNode;
+
+class ChromeHistoryClientTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    bookmark_model_ = std::make_unique<BookmarkModel>(
+        std::make_unique<bookmarks::TestBookmarkClient>());
+    bookmark_model_->Load(temp_dir_.GetPath());
+    history_client_ =
+        std::make_unique<ChromeHistoryClient>(bookmark_model_.get());
+    backend_client_ = history_client_->CreateBackendClient();
+  }
+
+  void TearDown() override { history_client_->Shutdown(); }
+
+  const BookmarkNode* AddBookmark(const GURL& url) {
+    return bookmark_model_->AddURL(bookmark_model_->bookmark_bar_node(), 0,
+                                   u"title", url);
+  }
+
+  void RemoveBookmark(const BookmarkNode* node) {
+    bookmark_model_->Remove(node, bookmarks::metrics::BookmarkEditSource::kUser,
+                            FROM_HERE);
+  }
+
+  std::vector<GURL> GetPinnedURLs() {
+    std::vector<GURL> urls;
+    for (const history::URLAndTitle& entry : backend_client_->GetPinnedURLs())
+      urls.push_back(entry.url);
+    return urls;
+  }
+
+  content::BrowserTaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<BookmarkModel> bookmark_model_;
+  std::unique_ptr<ChromeHistoryClient> history_client_;
+  std::unique_ptr<history::HistoryBackendClient> backend_client_;
+};
+
+// Deleting history at the user's request asks whether a URL is bookmarked
+// too, so a URL that is not bookmarked must not be reported as such while the
+// bookmarks load.
+TEST_F(ChromeHistoryClientTest, AnswersForUnbookmarkedURLWhileBookmarksLoad) {
+  const GURL url("https://example.com/");
+  ASSERT_FALSE(bookmark_model_->loaded());
+  EXPECT_FALSE(backend_client_->IsPinnedURL(url));
+
+  bookmarks::test::WaitForBookmarkModelToLoad(bookmark_model_.get());
+  EXPECT_FALSE(backend_client_->IsPinnedURL(url));
+
+  AddBookmark(url);
+  EXPECT_TRUE(backend_client_->IsPinnedURL(url));
+}
+
+TEST_F(ChromeHistoryClientTest, TracksBookmarkChanges) {
+  bookmarks::test::WaitForBookmarkModelToLoad(bookmark_model_.get());
+  const GURL url1("https://one.com/");
+  const GURL url2("https://two.com/");
+  const GURL url3("https://three.com/");
+
+  // A URL stays pinned until its last bookmark is removed.
+  const BookmarkNode* node1 = AddBookmark(url1);
+  const BookmarkNode* node2 = AddBookmark(url1);
+  EXPECT_EQ(std::vector<GURL>({url1}), GetPinnedURLs());
+  RemoveBookmark(node1);
+  EXPECT_TRUE(backend_client_->IsPinnedURL(url1));
+  RemoveBookmark(node2);
+  EXPECT_FALSE(backend_client_->IsPinnedURL(url1));
+
+  // Changing the URL of a bookmark unpins the old URL.
+  const BookmarkNode* node3 = AddBookmark(url2);
+  bookmark_model_->SetURL(node3, url3,
+                          bookmarks::metrics::BookmarkEditSource::kUser);
+  EXPECT_FALSE(backend_client_->IsPinnedURL(url2));
+  EXPECT_TRUE(backend_client_->IsPinnedURL(url3));
+
+  // Removing a folder unpins the URLs within it.
+  const BookmarkNode* folder = bookmark_model_->AddFolder(
+      bookmark_model_->other_node(), 0, u"folder");
+  bookmark_model_->AddURL(folder, 0, u"title", url1);
+  bookmark_model_->AddURL(folder, 1, u"title", url2);
+  EXPECT_EQ(std::vector<GURL>({url1, url3, url2}), GetPinnedURLs());
+  RemoveBookmark(folder);
+  EXPECT_EQ(std::vector<GURL>({url3}), GetPinnedURLs());
+
+  bookmark_model_->RemoveAllUserBookmarks(FROM_HERE);
+  EXPECT_TRUE(GetPinnedURLs().empty());
+}
+
+// Extensive changes, e.g. an import, publish the bookmarked URLs once at the
+// end rather than after every node.
+TEST_F(ChromeHistoryClientTest, PublishesOnceExtensiveChangesEnd) {
+  bookmarks::test::WaitForBookmarkModelToLoad(bookmark_model_.get());
+  const GURL url1("https://one.com/");
+  const GURL url2("https://two.com/");
+  const BookmarkNode* node1 = AddBookmark(url1);
+
+  bookmark_model_->BeginExtensiveChanges();
+  RemoveBookmark(node1);
+  AddBookmark(url2);
+  EXPECT_TRUE(backend_client_->IsPinnedURL(url1));
+  EXPECT_FALSE(backend_client_->IsPinnedURL(url2));
+
+  bookmark_model_->EndExtensiveChanges();
+  EXPECT_FALSE(backend_client_->IsPinnedURL(url1));
+  EXPECT_TRUE(backend_client_->IsPinnedURL(url2));
+  EXPECT_EQ(std::vector<GURL>({url2}), GetPinnedURLs());
+}
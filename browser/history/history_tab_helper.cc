@@ -6,7 +6,9 @@
 
 #include <optional>
 #include <string>
+#include <utility>
 
+#include "base/functional/bind.h"
 #include "build/build_config.h"
 #include "chrome/browser/complex_tasks/task_tab_helper.h"
 #include "chrome/browser/history/history_service_factory.h"
@@ -331,6 +333,8 @@ void HistoryTabHelper::DidFinishNavigation(
     return;
 
   if (navigation_handle->IsInPrimaryMainFrame()) {
+    // Any held back title belongs to the previous page.
+    FlushPendingTitle();
     is_loading_ = true;
     num_title_changes_ = 0;
   } else if (!navigation_handle->IsInMainFrame() &&
@@ -396,6 +400,7 @@ void HistoryTabHelper::DidFinishLoad(
   if (!render_frame_host->IsInPrimaryMainFrame())
     return;
 
+  FlushPendingTitle();
   is_loading_ = false;
   last_load_completion_ = base::TimeTicks::Now();
 }
@@ -445,14 +450,48 @@ void HistoryTabHelper::TitleWasSet(NavigationEntry* entry) {
   // loading or during a brief span after load is complete. This fixes the case
   // where a page uses a title change to alert a user of a situation but that
   // title change ends up saved in history.
-  if (is_loading_ || (base::TimeTicks::Now() - last_load_completion_ <
-                      history::GetTitleSettingWindow())) {
-    history::HistoryService* hs = GetHistoryService();
-    if (hs) {
-      hs->SetPageTitle(entry->GetVirtualURL(), entry->GetTitleForDisplay());
-      ++num_title_changes_;
-    }
+  const base::TimeDelta time_since_load =
+      base::TimeTicks::Now() - last_load_completion_;
+  if (!is_loading_ && time_since_load >= history::GetTitleSettingWindow())
+    return;
+
+  history::HistoryService* hs = GetHistoryService();
+  if (!hs)
+    return;
+
+  // The first title of a page is written right away. Later changes are
+  // coalesced, and only the latest one is written once the page finishes
+  // loading, the title-setting window ends, the limit of title changes is
+  // reached, or the page goes away. The title that ends up in history is the
+  // same as if every change had been written.
+  ++num_title_changes_;
+  if (num_title_changes_ == 1) {
+    hs->SetPageTitle(entry->GetVirtualURL(), entry->GetTitleForDisplay());
+    return;
   }
+  pending_title_ =
+      PendingTitle{entry->GetVirtualURL(), entry->GetTitleForDisplay()};
+  if (num_title_changes_ >= history::kMaxTitleChanges) {
+    FlushPendingTitle();
+    return;
+  }
+  if (!is_loading_ && !title_flush_timer_.IsRunning()) {
+    title_flush_timer_.Start(
+        FROM_HERE, history::GetTitleSettingWindow() - time_since_load,
+        base::BindOnce(&HistoryTabHelper::FlushPendingTitle,
+                       base::Unretained(this)));
+  }
+}
+
+void HistoryTabHelper::FlushPendingTitle() {
+  title_flush_timer_.Stop();
+  if (!pending_title_)
+    return;
+
+  PendingTitle pending_title = std::move(*pending_title_);
+  pending_title_.reset();
+  if (history::HistoryService* hs = GetHistoryService())
+    hs->SetPageTitle(pending_title.url, pending_title.title);
 }
 
 history::HistoryService* HistoryTabHelper::GetHistoryService() {
@@ -467,6 +506,7 @@ history::HistoryService* HistoryTabHelper::GetHistoryService() {
 
 void HistoryTabHelper::WebContentsDestroyed() {
   translate_observation_.Reset();
+  FlushPendingTitle();
 
   history::HistoryService* history_service = GetHistoryService();
   if (!history_service)
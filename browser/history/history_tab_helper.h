@@ -6,10 +6,12 @@
 #define CHROME_BROWSER_HISTORY_HISTORY_TAB_HELPER_H_
 
 #include <optional>
+#include <string>
 
 #include "base/gtest_prod_util.h"
 #include "base/scoped_observation.h"
 #include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "build/build_config.h"
 #include "components/sessions/core/serialized_navigation_entry.h"
 #include "components/translate/core/browser/translate_driver.h"
@@ -89,6 +91,9 @@ class HistoryTabHelper
   void OnLanguageDetermined(
       const translate::LanguageDetectionDetails& details) override;
 
+  // Writes the title held back in |pending_title_|, if any, to history.
+  void FlushPendingTitle();
+
   // Helper function to return the history service.  May return null.
   history::HistoryService* GetHistoryService();
 
@@ -108,6 +113,19 @@ class HistoryTabHelper
   // Number of title changes since the loading of the navigation started.
   int num_title_changes_ = 0;
 
+  // The latest accepted title change of the current page that has not been
+  // written to history yet. Pages that animate their title would otherwise
+  // cause a history write, and URL change notifications, for every frame.
+  struct PendingTitle {
+    GURL url;
+    std::u16string title;
+  };
+  std::optional<PendingTitle> pending_title_;
+
+  // Flushes |pending_title_| when the title-setting window after load
+  // completion ends.
+  base::OneShotTimer title_flush_timer_;
+
   // The time that the current page finished loading. Only title changes within
   // a certain time period after the page load is complete will be saved to the
   // history system. Only applies to the main frame of the page.
@@ -11,6 +11,7 @@
 
 #include "base/memory/raw_ptr.h"
 #include "base/run_loop.h"
+#include "base/scoped_observation.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/cancelable_task_tracker.h"
@@ -22,6 +23,7 @@
 #include "components/feed/buildflags.h"
 #include "components/history/core/browser/history_constants.h"
 #include "components/history/core/browser/history_service.h"
+#include "components/history/core/browser/history_service_observer.h"
 #include "components/history/core/browser/history_types.h"
 #include "components/history/core/browser/url_row.h"
 #include "content/public/browser/browser_context.h"
@@ -53,6 +55,35 @@ class TestFeedApi : public feed::StubFeedApi {
 };
 #endif  // BUILDFLAG(ENABLE_FEED_V2)
 
+// Counts the history notifications that modify a given URL, e.g. title writes.
+class URLModificationCounter : public history::HistoryServiceObserver {
+ public:
+  URLModificationCounter(history::HistoryService* history_service,
+                         const GURL& url)
+      : url_(url) {
+    observation_.Observe(history_service);
+  }
+
+  int count() const { return count_; }
+  void Reset() { count_ = 0; }
+
+  // history::HistoryServiceObserver:
+  void OnURLsModified(history::HistoryService* history_service,
+                      const history::URLRows& changed_urls) override {
+    for (const history::URLRow& row : changed_urls) {
+      if (row.url() == url_)
+        ++count_;
+    }
+  }
+
+ private:
+  const GURL url_;
+  int count_ = 0;
+  base::ScopedObservation<history::HistoryService,
+                          history::HistoryServiceObserver>
+      observation_{this};
+};
+
 }  // namespace
 
 class HistoryTabHelperTest : public ChromeRenderViewHostTestHarness {
@@ -203,6 +234,38 @@ TEST_F(HistoryTabHelperTest, ShouldLimitTitleUpdatesPerPage) {
   EXPECT_EQ("title10", QueryPageTitleFromHistory(page_url_));
 }
 
+TEST_F(HistoryTabHelperTest, ShouldCoalesceTitleUpdatesWhileLoading) {
+  URLModificationCounter counter(history_service_, page_url_);
+  std::unique_ptr<content::NavigationSimulator> navigation =
+      content::NavigationSimulator::CreateBrowserInitiated(page_url_,
+                                                           web_contents());
+  navigation->SetKeepLoading(true);
+  navigation->Commit();
+
+  content::NavigationEntry* entry =
+      web_contents()->GetController().GetLastCommittedEntry();
+  ASSERT_NE(nullptr, entry);
+
+  // Round-trip through the history backend so that notifications caused by
+  // the navigation itself are not counted.
+  QueryPageTitleFromHistory(page_url_);
+  counter.Reset();
+
+  // A page animating its title while loading only gets its first title
+  // written right away.
+  for (int i = 1; i < history::kMaxTitleChanges; ++i) {
+    const std::string title = base::StringPrintf("title%d", i);
+    web_contents()->UpdateTitleForEntry(entry, base::UTF8ToUTF16(title));
+  }
+  EXPECT_EQ("title1", QueryPageTitleFromHistory(page_url_));
+  EXPECT_EQ(1, counter.count());
+
+  // The latest title is written once the page finishes loading.
+  navigation->StopLoading();
+  EXPECT_EQ("title9", QueryPageTitleFromHistory(page_url_));
+  EXPECT_EQ(2, counter.count());
+}
+
 TEST_F(HistoryTabHelperTest, ShouldUpdateVisitDurationInHistory) {
   const GURL url1("https://url1.com");
   const GURL url2("https://url2.com");
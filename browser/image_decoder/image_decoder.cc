@@ -10,7 +10,10 @@
 #include "base/functional/callback.h"
 #include "base/task/sequenced_task_runner.h"
 #include "base/task/single_thread_task_runner.h"
+#include "base/task/thread_pool.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
+#include "crypto/sha2.h"
 #include "ipc/ipc_channel.h"
 #include "services/data_decoder/public/cpp/data_decoder.h"
 #include "services/data_decoder/public/cpp/decode_image.h"
@@ -21,6 +24,27 @@ namespace {
 const int64_t kMaxImageSizeInBytes =
     static_cast<int64_t>(IPC::Channel::kMaximumMessageSize);
 
+// How long the shared decoder process is kept alive without any request.
+constexpr base::TimeDelta kSharedDecoderIdleTimeout = base::Seconds(5);
+
+// Max number of decodes the shared decoder runs at a time.
+constexpr size_t kMaxConcurrentSharedDecodes = 4;
+
+// Max number of decoded images kept in memory.
+constexpr size_t kMaxCachedDecodedImages = 32;
+
+// Decoded images larger than this are not kept in memory.
+constexpr size_t kMaxCachedDecodedImageBytes = 256 * 1024;
+
+data_decoder::mojom::ImageCodec ToMojoImageCodec(
+    ImageDecoder::ImageCodec image_codec) {
+#if BUILDFLAG(IS_CHROMEOS)
+  if (image_codec == ImageDecoder::PNG_CODEC)
+    return data_decoder::mojom::ImageCodec::kPng;
+#endif  // BUILDFLAG(IS_CHROMEOS)
+  return data_decoder::mojom::ImageCodec::kDefault;
+}
+
 // Note that this is always called on the thread which initiated the
 // corresponding data_decoder::DecodeImage request.
 void OnDecodeImageDone(
@@ -34,6 +58,26 @@ void OnDecodeImageDone(
     std::move(fail_callback).Run(request_id);
 }
 
+std::vector<uint8_t> ToImageBytes(std::vector<uint8_t> image_data) {
+  return image_data;
+}
+
+std::vector<uint8_t> ToImageBytes(const std::string& image_data) {
+  return std::vector<uint8_t>(image_data.begin(), image_data.end());
+}
+
+// Returns a copy of |bitmap| with its own pixels, or a null bitmap if that
+// fails.
+SkBitmap CopyBitmap(const SkBitmap& bitmap) {
+  SkBitmap copy;
+  if (!copy.tryAllocPixels(bitmap.info()) ||
+      !bitmap.readPixels(copy.info(), copy.getPixels(), copy.rowBytes(), 0,
+                         0)) {
+    return SkBitmap();
+  }
+  return copy;
+}
+
 void RunDecodeCallbackOnTaskRunner(
     data_decoder::DecodeImageCallback callback,
     scoped_refptr<base::SequencedTaskRunner> task_runner,
@@ -52,19 +96,11 @@ void DecodeImage(ImageDataType image_data,
   base::span<const uint8_t> image_data_span(
       base::as_bytes(base::make_span(image_data)));
 
-  if (data_decoder) {
-    data_decoder::DecodeImage(
-        data_decoder, image_data_span, codec, shrink_to_fit,
-        kMaxImageSizeInBytes, desired_image_frame_size,
-        base::BindOnce(&RunDecodeCallbackOnTaskRunner, std::move(callback),
-                       std::move(callback_task_runner)));
-  } else {
-    data_decoder::DecodeImageIsolated(
-        image_data_span, codec, shrink_to_fit, kMaxImageSizeInBytes,
-        desired_image_frame_size,
-        base::BindOnce(&RunDecodeCallbackOnTaskRunner, std::move(callback),
-                       std::move(callback_task_runner)));
-  }
+  data_decoder::DecodeImage(
+      data_decoder, image_data_span, codec, shrink_to_fit,
+      kMaxImageSizeInBytes, desired_image_frame_size,
+      base::BindOnce(&RunDecodeCallbackOnTaskRunner, std::move(callback),
+                     std::move(callback_task_runner)));
 }
 
 }  // namespace
@@ -131,7 +167,12 @@ template void ImageDecoder::StartWithOptions(ImageRequest*,
                                              bool,
                                              const gfx::Size&);
 
-ImageDecoder::ImageDecoder() : image_request_id_counter_(0) {}
+ImageDecoder::ImageDecoder()
+    : image_request_id_counter_(0),
+      shared_decoder_task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      decoded_image_cache_(kMaxCachedDecodedImages) {}
 
 template <typename ImageDataType>
 void ImageDecoder::StartWithOptionsImpl(
@@ -150,12 +191,16 @@ void ImageDecoder::StartWithOptionsImpl(
     image_request_id_map_.insert(std::make_pair(request_id, image_request));
   }
 
-  data_decoder::mojom::ImageCodec codec =
-      data_decoder::mojom::ImageCodec::kDefault;
-#if BUILDFLAG(IS_CHROMEOS)
-  if (image_codec == PNG_CODEC)
-    codec = data_decoder::mojom::ImageCodec::kPng;
-#endif  // BUILDFLAG(IS_CHROMEOS)
+  if (!image_request->data_decoder()) {
+    shared_decoder_task_runner_->PostTask(
+        FROM_HERE,
+        base::BindOnce(&ImageDecoder::StartSharedDecode,
+                       base::Unretained(this),
+                       ToImageBytes(std::move(image_data)), image_codec,
+                       shrink_to_fit, desired_image_frame_size, request_id,
+                       base::WrapRefCounted(image_request->task_runner())));
+    return;
+  }
 
   auto callback =
       base::BindOnce(&OnDecodeImageDone,
@@ -165,7 +210,8 @@ void ImageDecoder::StartWithOptionsImpl(
                                     base::Unretained(this)),
                      request_id);
 
-  DecodeImage<ImageDataType>(std::move(image_data), codec, shrink_to_fit,
+  DecodeImage<ImageDataType>(std::move(image_data),
+                             ToMojoImageCodec(image_codec), shrink_to_fit,
                              desired_image_frame_size, std::move(callback),
                              image_request->task_runner(),
                              image_request->data_decoder());
@@ -200,6 +246,117 @@ void ImageDecoder::CancelImpl(ImageRequest* image_request) {
   }
 }
 
+size_t ImageDecoder::GetSharedDecodeCountForTesting() {
+  base::AutoLock lock(map_lock_);
+  return shared_decode_count_;
+}
+
+void ImageDecoder::StartSharedDecode(
+    std::vector<uint8_t> image_data,
+    ImageCodec image_codec,
+    bool shrink_to_fit,
+    const gfx::Size& desired_image_frame_size,
+    int request_id,
+    scoped_refptr<base::SequencedTaskRunner> task_runner) {
+  DCHECK(shared_decoder_task_runner_->RunsTasksInCurrentSequence());
+  DecodeKey key{crypto::SHA256Hash(image_data), image_codec, shrink_to_fit,
+                desired_image_frame_size.width(),
+                desired_image_frame_size.height()};
+  WaitingRequest request{request_id, std::move(task_runner)};
+
+  auto cache_it = decoded_image_cache_.Get(key);
+  if (cache_it != decoded_image_cache_.end()) {
+    PostSharedDecodeResult(request, CopyBitmap(cache_it->second));
+    return;
+  }
+
+  auto [it, inserted] = in_flight_decodes_.try_emplace(key);
+  it->second.push_back(std::move(request));
+  // An identical decode is already in flight; its result will be dispatched
+  // to this request as well.
+  if (!inserted)
+    return;
+
+  pending_decodes_.push_back({key, std::move(image_data)});
+  StartPendingSharedDecodes();
+}
+
+void ImageDecoder::StartPendingSharedDecodes() {
+  DCHECK(shared_decoder_task_runner_->RunsTasksInCurrentSequence());
+  while (num_shared_decodes_in_progress_ < kMaxConcurrentSharedDecodes &&
+         !pending_decodes_.empty()) {
+    PendingDecode decode = std::move(pending_decodes_.front());
+    pending_decodes_.pop_front();
+    ++num_shared_decodes_in_progress_;
+    {
+      base::AutoLock lock(map_lock_);
+      ++shared_decode_count_;
+    }
+
+    if (!shared_data_decoder_) {
+      shared_data_decoder_ = std::make_unique<data_decoder::DataDecoder>(
+          kSharedDecoderIdleTimeout);
+    }
+    data_decoder::DecodeImage(
+        shared_data_decoder_.get(), decode.image_data,
+        ToMojoImageCodec(decode.key.codec), decode.key.shrink_to_fit,
+        kMaxImageSizeInBytes, gfx::Size(decode.key.width, decode.key.height),
+        base::BindOnce(&ImageDecoder::OnSharedDecodeDone,
+                       base::Unretained(this), decode.key));
+  }
+}
+
+void ImageDecoder::OnSharedDecodeDone(const DecodeKey& key,
+                                      const SkBitmap& image) {
+  DCHECK(shared_decoder_task_runner_->RunsTasksInCurrentSequence());
+  --num_shared_decodes_in_progress_;
+
+  auto in_flight_it = in_flight_decodes_.find(key);
+  CHECK(in_flight_it != in_flight_decodes_.end());
+  const std::vector<WaitingRequest> waiting_requests =
+      std::move(in_flight_it->second);
+  in_flight_decodes_.erase(in_flight_it);
+
+  const bool success = !image.isNull() && !image.empty();
+  const bool cache_image =
+      success && image.computeByteSize() <= kMaxCachedDecodedImageBytes;
+
+  // Every request gets its own pixels, so that a request which modifies its
+  // bitmap doesn't change the bitmap of another request or the cached one.
+  // Only the last request may take |image| itself, if it isn't cached.
+  for (size_t i = 0; i < waiting_requests.size(); ++i) {
+    SkBitmap result;
+    if (success) {
+      const bool is_last_request = i + 1 == waiting_requests.size();
+      result = is_last_request && !cache_image ? image : CopyBitmap(image);
+    }
+    PostSharedDecodeResult(waiting_requests[i], std::move(result));
+  }
+
+  if (cache_image) {
+    SkBitmap cached_image = image;
+    cached_image.setImmutable();
+    decoded_image_cache_.Put(key, std::move(cached_image));
+  }
+
+  StartPendingSharedDecodes();
+}
+
+void ImageDecoder::PostSharedDecodeResult(const WaitingRequest& request,
+                                          SkBitmap image) {
+  if (!image.isNull() && !image.empty()) {
+    request.task_runner->PostTask(
+        FROM_HERE, base::BindOnce(&ImageDecoder::OnDecodeImageSucceeded,
+                                  base::Unretained(this), std::move(image),
+                                  request.request_id));
+  } else {
+    request.task_runner->PostTask(
+        FROM_HERE,
+        base::BindOnce(&ImageDecoder::OnDecodeImageFailed,
+                       base::Unretained(this), request.request_id));
+  }
+}
+
 void ImageDecoder::OnDecodeImageSucceeded(const SkBitmap& decoded_image,
                                           int request_id) {
   ImageRequest* image_request;
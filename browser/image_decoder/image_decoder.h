@@ -5,16 +5,22 @@
 #ifndef CHROME_BROWSER_IMAGE_DECODER_IMAGE_DECODER_H_
 #define CHROME_BROWSER_IMAGE_DECODER_IMAGE_DECODER_H_
 
+#include <array>
 #include <map>
+#include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
+#include "base/containers/circular_deque.h"
+#include "base/containers/lru_cache.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/ref_counted.h"
 #include "base/no_destructor.h"
 #include "base/sequence_checker.h"
 #include "base/synchronization/lock.h"
 #include "base/task/sequenced_task_runner.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/gfx/geometry/size.h"
 
 namespace data_decoder {
@@ -25,12 +31,16 @@ namespace gfx {
 class Size;
 }  // namespace gfx
 
-class SkBitmap;
-
 // This is a helper class for decoding images safely in a sandboxed service. To
 // use this, call ImageDecoder::Start(...) or
 // ImageDecoder::StartWithOptions(...) on any thread.
 //
+// Requests without a specific DataDecoder share a single decoder process,
+// which is shut down after being idle for a while and runs a bounded number of
+// decodes at a time. Concurrent requests for identical image data are decoded
+// only once, and recently decoded small images are served from memory. Each
+// request gets a bitmap with its own pixels.
+//
 // ImageRequest::OnImageDecoded or ImageRequest::OnDecodeImageFailed is posted
 // back to the |task_runner_| associated with the ImageRequest.
 //
@@ -65,7 +75,8 @@ class ImageDecoder {
     explicit ImageRequest(
         const scoped_refptr<base::SequencedTaskRunner>& task_runner);
     // Explicitly pass in |data_decoder| if there's a specific decoder that
-    // should be used; otherwise, an isolated decoder will created and used.
+    // should be used; otherwise, the decoder shared by all ImageDecoder
+    // requests is used.
     explicit ImageRequest(data_decoder::DataDecoder* data_decoder);
     virtual ~ImageRequest();
 
@@ -74,7 +85,7 @@ class ImageDecoder {
     // the image has been decoded.
     const scoped_refptr<base::SequencedTaskRunner> task_runner_;
 
-    // If null, will use a new decoder via DecodeImageIsolated() instead.
+    // If null, will use the shared ImageDecoder decoder instead.
     const raw_ptr<data_decoder::DataDecoder> data_decoder_ = nullptr;
 
     SEQUENCE_CHECKER(sequence_checker_);
@@ -116,10 +127,40 @@ class ImageDecoder {
   // ensuring callbacks are not made to the image_request after it is destroyed.
   static void Cancel(ImageRequest* image_request);
 
+  // Returns how many decodes the shared decoder has started.
+  size_t GetSharedDecodeCountForTesting();
+
  private:
   friend base::NoDestructor<ImageDecoder>;
   using RequestMap = std::map<int, ImageRequest*>;
 
+  // Identifies a decode by its input data and options.
+  struct DecodeKey {
+    bool operator<(const DecodeKey& other) const {
+      return std::tie(image_data_hash, codec, shrink_to_fit, width, height) <
+             std::tie(other.image_data_hash, other.codec, other.shrink_to_fit,
+                      other.width, other.height);
+    }
+
+    std::array<uint8_t, 32> image_data_hash;
+    ImageCodec codec;
+    bool shrink_to_fit;
+    int width;
+    int height;
+  };
+
+  // A request waiting for a shared decode.
+  struct WaitingRequest {
+    int request_id;
+    scoped_refptr<base::SequencedTaskRunner> task_runner;
+  };
+
+  // A shared decode which waits for one of the decodes in progress to finish.
+  struct PendingDecode {
+    DecodeKey key;
+    std::vector<uint8_t> image_data;
+  };
+
   ImageDecoder();
   ~ImageDecoder() = delete;
 
@@ -132,6 +173,28 @@ class ImageDecoder {
 
   void CancelImpl(ImageRequest* image_request);
 
+  // Serves the request |request_id| from the decoded image cache, from an
+  // identical decode in flight, or by queueing a decode of |image_data| with
+  // the shared decoder. Runs on |shared_decoder_task_runner_|, which also
+  // keeps hashing |image_data| off the thread of the request.
+  void StartSharedDecode(
+      std::vector<uint8_t> image_data,
+      ImageCodec image_codec,
+      bool shrink_to_fit,
+      const gfx::Size& desired_image_frame_size,
+      int request_id,
+      scoped_refptr<base::SequencedTaskRunner> task_runner);
+
+  // Starts queued shared decodes while fewer than the maximum are in progress.
+  void StartPendingSharedDecodes();
+
+  // Called on |shared_decoder_task_runner_| when a shared decode finishes.
+  // Dispatches the result to every request waiting for |key|.
+  void OnSharedDecodeDone(const DecodeKey& key, const SkBitmap& image);
+
+  // Posts |image|, or a failure if it is null, to |request|.
+  void PostSharedDecodeResult(const WaitingRequest& request, SkBitmap image);
+
   // IPC message handlers.
   void OnDecodeImageSucceeded(const SkBitmap& decoded_image, int request_id);
   void OnDecodeImageFailed(int request_id);
@@ -142,8 +205,30 @@ class ImageDecoder {
   // Map of request id's to ImageRequests.
   RequestMap image_request_id_map_;
 
-  // Protects |image_request_id_map_| and |image_request_id_counter_|.
+  // Number of decodes started by the shared decoder.
+  size_t shared_decode_count_ = 0;
+
+  // Protects |image_request_id_map_|, |image_request_id_counter_| and
+  // |shared_decode_count_|.
   base::Lock map_lock_;
+
+  // Sequence on which |shared_data_decoder_| lives. The members below are
+  // only accessed on it.
+  const scoped_refptr<base::SequencedTaskRunner> shared_decoder_task_runner_;
+
+  // Requests waiting for each shared decode, either in progress or pending.
+  std::map<DecodeKey, std::vector<WaitingRequest>> in_flight_decodes_;
+
+  // Shared decodes waiting to be started, in the order they were requested.
+  base::circular_deque<PendingDecode> pending_decodes_;
+  size_t num_shared_decodes_in_progress_ = 0;
+
+  // Recently decoded small images. Their pixels are never handed out, only
+  // copies of them.
+  base::LRUCache<DecodeKey, SkBitmap> decoded_image_cache_;
+
+  // Decoder shared by the requests without a specific DataDecoder.
+  std::unique_ptr<data_decoder::DataDecoder> shared_data_decoder_;
 };
 
 #endif  // CHROME_BROWSER_IMAGE_DECODER_IMAGE_DECODER_H_
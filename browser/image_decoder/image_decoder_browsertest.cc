@@ -4,6 +4,9 @@
 
 #include "chrome/browser/image_decoder/image_decoder.h"
 
+#include <memory>
+
+#include "base/barrier_closure.h"
 #include "base/run_loop.h"
 #include "build/build_config.h"
 #include "chrome/grit/generated_resources.h"
@@ -14,7 +17,9 @@
 #include "content/public/test/browser_test.h"
 #include "content/public/test/test_utils.h"
 #include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkColor.h"
 #include "ui/base/l10n/l10n_util.h"
+#include "ui/gfx/codec/png_codec.h"
 
 using content::BrowserThread;
 
@@ -57,6 +62,21 @@ std::vector<uint8_t> GetValidJpgData() {
   return std::vector<uint8_t>(kJpgData, kJpgData + sizeof(kJpgData) - 1);
 }
 
+// Returns a 1x1 PNG of |color|.
+std::vector<uint8_t> CreatePngData(SkColor color) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(1, 1);
+  bitmap.eraseColor(color);
+  std::vector<uint8_t> data;
+  CHECK(gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &data));
+  return data;
+}
+
+// Returns the color of the |index|th distinct payload of a burst.
+SkColor GetDistinctColor(size_t index) {
+  return SkColorSetRGB(static_cast<U8CPU>(index), 0, 0);
+}
+
 class TestImageRequest : public ImageDecoder::ImageRequest {
  public:
   explicit TestImageRequest(base::OnceClosure quit_closure)
@@ -99,6 +119,60 @@ class TestImageRequest : public ImageDecoder::ImageRequest {
   SkBitmap bitmap_;
 };
 
+// Counts the data decoder utility processes launched while it is alive.
+class DataDecoderLaunchCounter : public content::BrowserChildProcessObserver {
+ public:
+  DataDecoderLaunchCounter() { BrowserChildProcessObserver::Add(this); }
+
+  DataDecoderLaunchCounter(const DataDecoderLaunchCounter&) = delete;
+  DataDecoderLaunchCounter& operator=(const DataDecoderLaunchCounter&) =
+      delete;
+
+  ~DataDecoderLaunchCounter() override {
+    BrowserChildProcessObserver::Remove(this);
+  }
+
+  int launch_count() const { return launch_count_; }
+
+ private:
+  void BrowserChildProcessLaunchedAndConnected(
+      const content::ChildProcessData& data) override {
+    if (data.metrics_name == "data_decoder.mojom.DataDecoderService")
+      ++launch_count_;
+  }
+
+  int launch_count_ = 0;
+};
+
+// Decodes one image of a burst and keeps the decoded bitmap.
+class BurstImageRequest : public ImageDecoder::ImageRequest {
+ public:
+  explicit BurstImageRequest(base::RepeatingClosure done_closure)
+      : done_closure_(std::move(done_closure)) {}
+
+  BurstImageRequest(const BurstImageRequest&) = delete;
+  BurstImageRequest& operator=(const BurstImageRequest&) = delete;
+
+  ~BurstImageRequest() override = default;
+
+  bool decode_succeeded() const { return decode_succeeded_; }
+
+  SkBitmap& bitmap() { return bitmap_; }
+
+ private:
+  void OnImageDecoded(const SkBitmap& decoded_image) override {
+    decode_succeeded_ = decoded_image.width() == 1;
+    bitmap_ = decoded_image;
+    done_closure_.Run();
+  }
+
+  void OnDecodeImageFailed() override { done_closure_.Run(); }
+
+  base::RepeatingClosure done_closure_;
+  bool decode_succeeded_ = false;
+  SkBitmap bitmap_;
+};
+
 }  // namespace
 
 class ImageDecoderBrowserTest : public InProcessBrowserTest {};
@@ -198,3 +272,56 @@ IN_PROC_BROWSER_TEST_F(ImageDecoderBrowserTest, StartAndDestroy) {
   test_request.reset();
   run_loop.Run();
 }
+
+// Decodes a burst of small PNG and JPEG payloads without a specific
+// DataDecoder. Most requests are for one of two identical payloads, the others
+// are distinct. The requests share a single decoder process, and each distinct
+// payload is decoded once.
+IN_PROC_BROWSER_TEST_F(ImageDecoderBrowserTest, BurstSharesDecoderProcess) {
+  constexpr size_t kNumRequests = 500;
+  // Every 10th request is for a distinct payload.
+  constexpr size_t kDistinctPayloadInterval = 10;
+  constexpr size_t kNumDistinctPayloads =
+      kNumRequests / kDistinctPayloadInterval;
+
+  DataDecoderLaunchCounter launch_counter;
+  const size_t initial_decode_count =
+      ImageDecoder::GetInstance()->GetSharedDecodeCountForTesting();
+  base::RunLoop run_loop;
+  base::RepeatingClosure done_closure =
+      base::BarrierClosure(kNumRequests, run_loop.QuitClosure());
+
+  std::vector<std::unique_ptr<BurstImageRequest>> requests;
+  for (size_t i = 0; i < kNumRequests; ++i) {
+    requests.push_back(std::make_unique<BurstImageRequest>(done_closure));
+    if (i % kDistinctPayloadInterval == 0) {
+      ImageDecoder::Start(
+          requests.back().get(),
+          CreatePngData(GetDistinctColor(i / kDistinctPayloadInterval)));
+    } else {
+      ImageDecoder::Start(requests.back().get(),
+                          i % 2 ? GetValidJpgData() : GetValidPngData());
+    }
+  }
+  run_loop.Run();
+
+  for (size_t i = 0; i < kNumRequests; ++i) {
+    ASSERT_TRUE(requests[i]->decode_succeeded());
+    EXPECT_EQ(requests[i]->bitmap().getColor(0, 0),
+              i % kDistinctPayloadInterval == 0
+                  ? GetDistinctColor(i / kDistinctPayloadInterval)
+                  : SK_ColorWHITE);
+  }
+  // The identical payloads were decoded once each, along with every distinct
+  // payload.
+  EXPECT_EQ(ImageDecoder::GetInstance()->GetSharedDecodeCountForTesting() -
+                initial_decode_count,
+            kNumDistinctPayloads + 2);
+  EXPECT_LE(launch_counter.launch_count(), 1);
+
+  // Requests for identical payloads don't share pixels.
+  requests[1]->bitmap().eraseColor(SK_ColorBLACK);
+  EXPECT_EQ(requests[3]->bitmap().getColor(0, 0), SK_ColorWHITE);
+  EXPECT_NE(requests[1]->bitmap().getPixels(),
+            requests[3]->bitmap().getPixels());
+}
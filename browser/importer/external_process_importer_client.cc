@@ -18,6 +18,7 @@
 #include "components/strings/grit/components_strings.h"
 #include "content/public/browser/child_process_host.h"
 #include "content/public/browser/service_process_host.h"
+#include "mojo/public/cpp/bindings/message.h"
 #include "ui/base/l10n/l10n_util.h"
 
 ExternalProcessImporterClient::ExternalProcessImporterClient(
@@ -26,7 +27,6 @@ ExternalProcessImporterClient::ExternalProcessImporterClient(
     uint16_t items,
     InProcessImporterBridge* bridge)
     : total_bookmarks_count_(0),
-      total_history_rows_count_(0),
       total_favicons_count_(0),
       process_importer_host_(importer_host),
       source_profile_(source_profile),
@@ -142,8 +142,9 @@ void ExternalProcessImporterClient::OnHistoryImportStart(
   if (cancelled_)
     return;
 
-  total_history_rows_count_ = total_history_rows_count;
-  history_rows_.reserve(total_history_rows_count);
+  history_rows_ = std::make_unique<HistoryRowsBatcher>(
+      total_history_rows_count,
+      base::BindRepeating(&InProcessImporterBridge::SetHistoryItems, bridge_));
 }
 
 void ExternalProcessImporterClient::OnHistoryImportGroup(
@@ -152,11 +153,12 @@ void ExternalProcessImporterClient::OnHistoryImportGroup(
   if (cancelled_)
     return;
 
-  history_rows_.insert(history_rows_.end(), history_rows_group.begin(),
-                       history_rows_group.end());
-  if (history_rows_.size() >= total_history_rows_count_)
-    bridge_->SetHistoryItems(history_rows_,
-                             static_cast<importer::VisitSource>(visit_source));
+  if (!history_rows_) {
+    mojo::ReportBadMessage("History import group received before its start");
+    return;
+  }
+  history_rows_->Add(history_rows_group,
+                     static_cast<importer::VisitSource>(visit_source));
 }
 
 void ExternalProcessImporterClient::OnHomePageImportReady(
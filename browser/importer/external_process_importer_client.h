@@ -8,12 +8,14 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "build/build_config.h"
+#include "chrome/browser/importer/history_rows_batcher.h"
 #include "chrome/common/importer/importer_autofill_form_data_entry.h"
 #include "chrome/common/importer/importer_data_types.h"
 #include "chrome/common/importer/importer_url_row.h"
@@ -103,7 +105,8 @@ class ExternalProcessImporterClient
 
   // These variables store data being collected from the importer until the
   // entire group has been collected and is ready to be written to the profile.
-  std::vector<ImporterURLRow> history_rows_;
+  // History rows are written in batches instead.
+  std::unique_ptr<HistoryRowsBatcher> history_rows_;
   std::vector<ImportedBookmarkEntry> bookmarks_;
   favicon_base::FaviconUsageDataList favicons_;
   std::vector<ImporterAutofillFormDataEntry> autofill_form_data_;
@@ -115,9 +118,6 @@ class ExternalProcessImporterClient
   // Total number of bookmarks to import.
   size_t total_bookmarks_count_;
 
-  // Total number of history items to import.
-  size_t total_history_rows_count_;
-
   // Total number of favicons to import.
   size_t total_favicons_count_;
 
@@ -0,0 +1,46 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/importer/history_rows_batcher.h"
+
+#include <algorithm>
+#include <utility>
+
+HistoryRowsBatcher::HistoryRowsBatcher(size_t total_rows_count,
+                                       WriteCallback write)
+    : total_rows_count_(total_rows_count), write_(std::move(write)) {
+  pending_rows_.reserve(std::min(total_rows_count, kBatchSize));
+}
+
+HistoryRowsBatcher::~HistoryRowsBatcher() = default;
+
+void HistoryRowsBatcher::Add(const std::vector<ImporterURLRow>& rows,
+                             importer::VisitSource visit_source) {
+  // A batch is written with a single visit source.
+  if (visit_source != pending_visit_source_) {
+    Flush();
+    pending_visit_source_ = visit_source;
+  }
+
+  auto next = rows.begin();
+  while (next != rows.end()) {
+    const size_t count = std::min<size_t>(
+        kBatchSize - pending_rows_.size(), std::distance(next, rows.end()));
+    pending_rows_.insert(pending_rows_.end(), next, next + count);
+    next += count;
+    if (pending_rows_.size() == kBatchSize)
+      Flush();
+  }
+
+  added_rows_count_ += rows.size();
+  if (added_rows_count_ >= total_rows_count_)
+    Flush();
+}
+
+void HistoryRowsBatcher::Flush() {
+  if (pending_rows_.empty())
+    return;
+  write_.Run(pending_rows_, pending_visit_source_);
+  pending_rows_.clear();
+}
@@ -0,0 +1,56 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_IMPORTER_HISTORY_ROWS_BATCHER_H_
+#define CHROME_BROWSER_IMPORTER_HISTORY_ROWS_BATCHER_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "base/functional/callback.h"
+#include "chrome/common/importer/importer_data_types.h"
+#include "chrome/common/importer/importer_url_row.h"
+
+// Collects the history rows received from the importer process, and writes
+// them to the profile in batches of |kBatchSize| rows as they arrive, rather
+// than holding the entire imported history in memory. Each batch is a single
+// write to the history database.
+class HistoryRowsBatcher {
+ public:
+  using WriteCallback =
+      base::RepeatingCallback<void(const std::vector<ImporterURLRow>& rows,
+                                   importer::VisitSource visit_source)>;
+
+  static constexpr size_t kBatchSize = 10000;
+
+  // |write| is run for each batch. The last batch, written once
+  // |total_rows_count| rows have been added, may be smaller.
+  HistoryRowsBatcher(size_t total_rows_count, WriteCallback write);
+
+  HistoryRowsBatcher(const HistoryRowsBatcher&) = delete;
+  HistoryRowsBatcher& operator=(const HistoryRowsBatcher&) = delete;
+
+  ~HistoryRowsBatcher();
+
+  // Adds |rows|, imported with |visit_source|, and writes any full batch.
+  void Add(const std::vector<ImporterURLRow>& rows,
+           importer::VisitSource visit_source);
+
+ private:
+  // Writes the pending rows, if any.
+  void Flush();
+
+  const size_t total_rows_count_;
+  const WriteCallback write_;
+
+  // Number of rows added so far.
+  size_t added_rows_count_ = 0;
+
+  // The rows not written yet, fewer than |kBatchSize|, and their visit source.
+  std::vector<ImporterURLRow> pending_rows_;
+  importer::VisitSource pending_visit_source_ = importer::VISIT_SOURCE_BROWSED;
+};
+
+#endif  // CHROME_BROWSER_IMPORTER_HISTORY_ROWS_BATCHER_H_
@@ -0,0 +1,102 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/importer/history_rows_batcher.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/test/bind.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace {
+
+constexpr size_t kBatchSize = HistoryRowsBatcher::kBatchSize;
+
+// Returns |count| rows numbered from |first|.
+std::vector<ImporterURLRow> MakeRows(size_t first, size_t count) {
+  std::vector<ImporterURLRow> rows;
+  for (size_t i = first; i < first + count; ++i)
+    rows.emplace_back(GURL("https://example.com/" + base::NumberToString(i)));
+  return rows;
+}
+
+class HistoryRowsBatcherTest : public testing::Test {
+ protected:
+  // Adds |total_rows_count| rows to a batcher in groups of |group_size|.
+  void AddRows(size_t total_rows_count, size_t group_size) {
+    HistoryRowsBatcher batcher(
+        total_rows_count,
+        base::BindLambdaForTesting(
+            [&](const std::vector<ImporterURLRow>& rows,
+                importer::VisitSource visit_source) {
+              batch_sizes_.push_back(rows.size());
+              written_rows_.insert(written_rows_.end(), rows.begin(),
+                                   rows.end());
+            }));
+    for (size_t i = 0; i < total_rows_count; i += group_size) {
+      batcher.Add(MakeRows(i, std::min(group_size, total_rows_count - i)),
+                  importer::VISIT_SOURCE_FIREFOX_IMPORTED);
+    }
+  }
+
+  // Expects every row to have been written once, in order.
+  void ExpectRowsWritten(size_t total_rows_count) {
+    ASSERT_EQ(total_rows_count, written_rows_.size());
+    for (size_t i = 0; i < total_rows_count; ++i) {
+      EXPECT_EQ(GURL("https://example.com/" + base::NumberToString(i)),
+                written_rows_[i].url);
+    }
+  }
+
+  std::vector<size_t> batch_sizes_;
+  std::vector<ImporterURLRow> written_rows_;
+};
+
+TEST_F(HistoryRowsBatcherTest, WritesFewerRowsThanABatchAtOnce) {
+  AddRows(kBatchSize - 1, 1000);
+  EXPECT_EQ(std::vector<size_t>({kBatchSize - 1}), batch_sizes_);
+  ExpectRowsWritten(kBatchSize - 1);
+}
+
+TEST_F(HistoryRowsBatcherTest, WritesExactlyOneBatch) {
+  AddRows(kBatchSize, 1000);
+  EXPECT_EQ(std::vector<size_t>({kBatchSize}), batch_sizes_);
+  ExpectRowsWritten(kBatchSize);
+}
+
+// Groups which straddle a batch boundary are split across batches.
+TEST_F(HistoryRowsBatcherTest, SplitsGroupsAtBatchBoundaries) {
+  AddRows(2 * kBatchSize + 1, 3000);
+  EXPECT_EQ(std::vector<size_t>({kBatchSize, kBatchSize, 1}), batch_sizes_);
+  ExpectRowsWritten(2 * kBatchSize + 1);
+}
+
+TEST_F(HistoryRowsBatcherTest, SplitsGroupsLargerThanABatch) {
+  AddRows(3 * kBatchSize - 1, 3 * kBatchSize - 1);
+  EXPECT_EQ(std::vector<size_t>({kBatchSize, kBatchSize, kBatchSize - 1}),
+            batch_sizes_);
+  ExpectRowsWritten(3 * kBatchSize - 1);
+}
+
+TEST_F(HistoryRowsBatcherTest, DoesNotMixVisitSources) {
+  std::vector<importer::VisitSource> visit_sources;
+  HistoryRowsBatcher batcher(
+      4, base::BindLambdaForTesting([&](const std::vector<ImporterURLRow>& rows,
+                                        importer::VisitSource visit_source) {
+        visit_sources.push_back(visit_source);
+      }));
+  batcher.Add(MakeRows(0, 2), importer::VISIT_SOURCE_FIREFOX_IMPORTED);
+  batcher.Add(MakeRows(2, 2), importer::VISIT_SOURCE_SAFARI_IMPORTED);
+  EXPECT_EQ(std::vector<importer::VisitSource>(
+                {importer::VISIT_SOURCE_FIREFOX_IMPORTED,
+                 importer::VISIT_SOURCE_SAFARI_IMPORTED}),
+            visit_sources);
+}
+
+}  // namespace
@@ -9,8 +9,8 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
 
-#include "base/ranges/algorithm.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/thread.h"
@@ -69,6 +69,58 @@ std::u16string GenerateUniqueFolderName(BookmarkModel* model,
   return folder_name;
 }
 
+// Index of the folders created under each parent folder during an import, by
+// title. Importing a large bookmark tree looks up the enclosing folders of
+// every bookmark, so scanning the children of each parent would be quadratic.
+class ImportedFolderIndex {
+ public:
+  explicit ImportedFolderIndex(BookmarkModel* model) : model_(model) {}
+
+  // Returns the first folder under |parent| titled |title|, creating it if
+  // there is none.
+  const BookmarkNode* GetOrAddFolder(const BookmarkNode* parent,
+                                     const std::u16string& title) {
+    FolderMap& folders = GetFoldersFor(parent);
+    auto it = folders.find(title);
+    if (it != folders.end())
+      return it->second;
+    const BookmarkNode* folder =
+        model_->AddFolder(parent, parent->children().size(), title);
+    folders.emplace(title, folder);
+    return folder;
+  }
+
+  // Adds a new folder titled |title| at the end of |parent|, even if a folder
+  // with the same title already exists, and returns it.
+  const BookmarkNode* AddFolder(const BookmarkNode* parent,
+                                const std::u16string& title) {
+    const BookmarkNode* folder =
+        model_->AddFolder(parent, parent->children().size(), title);
+    // Lookups keep resolving to the first folder with a given title.
+    GetFoldersFor(parent).emplace(title, folder);
+    return folder;
+  }
+
+ private:
+  using FolderMap = std::map<std::u16string, const BookmarkNode*>;
+
+  // Returns the index for |parent|, populating it from the existing children
+  // the first time |parent| is seen.
+  FolderMap& GetFoldersFor(const BookmarkNode* parent) {
+    auto [it, inserted] = folders_.try_emplace(parent);
+    if (inserted) {
+      for (const auto& node : parent->children()) {
+        if (node->is_folder())
+          it->second.emplace(node->GetTitle(), node.get());
+      }
+    }
+    return it->second;
+  }
+
+  const raw_ptr<BookmarkModel> model_;
+  std::map<const BookmarkNode*, FolderMap> folders_;
+};
+
 // Shows the bookmarks toolbar.
 void ShowBookmarkBar(Profile* profile) {
   profile->GetPrefs()->SetBoolean(bookmarks::prefs::kShowBookmarkBar, true);
@@ -153,6 +205,7 @@ void ProfileWriter::AddBookmarks(
 
   model->BeginExtensiveChanges();
 
+  ImportedFolderIndex folder_index(model);
   std::set<const BookmarkNode*> folders_added_to;
   const BookmarkNode* top_level_folder = nullptr;
   for (std::vector<ImportedBookmarkEntry>::const_iterator bookmark =
@@ -172,8 +225,7 @@ void ProfileWriter::AddBookmarks(
       if (!top_level_folder) {
         std::u16string name =
             GenerateUniqueFolderName(model, top_level_folder_name);
-        top_level_folder = model->AddFolder(
-            bookmark_bar, bookmark_bar->children().size(), name);
+        top_level_folder = folder_index.AddFolder(bookmark_bar, name);
       }
       parent = top_level_folder;
     }
@@ -190,19 +242,12 @@ void ProfileWriter::AddBookmarks(
         continue;
       }
 
-      const auto it = base::ranges::find_if(
-          parent->children(), [folder_name](const auto& node) {
-            return node->is_folder() && node->GetTitle() == *folder_name;
-          });
-      parent = (it == parent->children().cend())
-                   ? model->AddFolder(parent, parent->children().size(),
-                                      *folder_name)
-                   : it->get();
+      parent = folder_index.GetOrAddFolder(parent, *folder_name);
     }
 
     folders_added_to.insert(parent);
     if (bookmark->is_folder) {
-      model->AddFolder(parent, parent->children().size(), bookmark->title);
+      folder_index.AddFolder(parent, bookmark->title);
     } else {
       model->AddURL(parent, parent->children().size(), bookmark->title,
                     bookmark->url, nullptr, bookmark->creation_time);
@@ -10,6 +10,7 @@
 
 #include "base/functional/bind.h"
 #include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/test/bind.h"
 #include "base/time/time.h"
@@ -226,6 +227,52 @@ TEST_F(ProfileWriterTest, CheckBookmarksAfterWritingDataTwice) {
   VerifyBookmarksCount(bookmarks_record, bookmark_model, 2);
 }
 
+// Verify that bookmarks sharing enclosing folders are grouped into the same
+// folders, including folders that were imported as folder entries.
+TEST_F(ProfileWriterTest, AddBookmarksReusesEnclosingFolders) {
+  BookmarkModel* bookmark_model =
+      BookmarkModelFactory::GetForBrowserContext(profile());
+  bookmarks::test::WaitForBookmarkModelToLoad(bookmark_model);
+
+  constexpr size_t kNumFolders = 50;
+  constexpr size_t kBookmarksPerFolder = 40;
+  std::vector<ImportedBookmarkEntry> bookmarks;
+  ImportedBookmarkEntry folder_entry;
+  folder_entry.is_folder = true;
+  folder_entry.title = u"Folder 0";
+  folder_entry.path = {u"Root"};
+  bookmarks.push_back(folder_entry);
+  for (size_t i = 0; i < kBookmarksPerFolder; ++i) {
+    for (size_t j = 0; j < kNumFolders; ++j) {
+      ImportedBookmarkEntry entry;
+      entry.url = GURL("https://example.com/" + base::NumberToString(i) + "/" +
+                       base::NumberToString(j));
+      entry.title = u"Bookmark";
+      entry.path = {u"Root", u"Folder " + base::NumberToString16(j)};
+      bookmarks.push_back(entry);
+    }
+  }
+
+  scoped_refptr<TestProfileWriter> profile_writer(
+      new TestProfileWriter(profile()));
+  profile_writer->AddBookmarks(bookmarks, u"Imported from Firefox");
+
+  // The bookmark bar was empty, so everything is imported directly to it.
+  const bookmarks::BookmarkNode* bookmark_bar =
+      bookmark_model->bookmark_bar_node();
+  ASSERT_EQ(1u, bookmark_bar->children().size());
+  const bookmarks::BookmarkNode* root = bookmark_bar->children()[0].get();
+  EXPECT_EQ(u"Root", root->GetTitle());
+  ASSERT_EQ(kNumFolders, root->children().size());
+  for (size_t j = 0; j < kNumFolders; ++j) {
+    const bookmarks::BookmarkNode* folder = root->children()[j].get();
+    EXPECT_EQ(u"Folder " + base::NumberToString16(j), folder->GetTitle());
+    ASSERT_EQ(kBookmarksPerFolder, folder->children().size());
+    EXPECT_EQ(GURL("https://example.com/0/" + base::NumberToString(j)),
+              folder->children()[0]->url());
+  }
+}
+
 std::unique_ptr<TemplateURL> ProfileWriterTest::CreateTemplateURL(
     const std::string& keyword,
     const std::string& url,
@@ -6,16 +6,22 @@
 
 #include <array>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/containers/flat_map.h"
+#include "base/containers/lru_cache.h"
 #include "base/feature_list.h"
 #include "base/functional/bind.h"
 #include "base/functional/callback.h"
+#include "base/location.h"
 #include "base/memory/ptr_util.h"
 #include "base/metrics/histogram_functions.h"
 #include "base/notreached.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/types/optional_util.h"
 #include "base/time/time.h"
 #include "chrome/browser/nearby_sharing/certificates/common.h"
 #include "chrome/browser/nearby_sharing/certificates/constants.h"
@@ -43,6 +49,10 @@ const char kDeviceIdPrefix[] = "users/me/devices/";
 
 constexpr base::TimeDelta kListPublicCertificatesTimeout = base::Seconds(30);
 
+// The number of recent decryption results to keep. Each entry is one device
+// advertising nearby, so this comfortably covers a busy room.
+constexpr size_t kDecryptedPublicCertificateCacheSize = 256;
+
 constexpr std::array<nearby_share::mojom::Visibility, 3> kVisibilities = {
     nearby_share::mojom::Visibility::kAllContacts,
     nearby_share::mojom::Visibility::kSelectedContacts,
@@ -192,43 +202,6 @@ void RecordDownloadPublicCertificatesResultMetrics(
   }
 }
 
-void TryDecryptPublicCertificates(
-    const NearbyShareEncryptedMetadataKey& encrypted_metadata_key,
-    NearbyShareCertificateManager::CertDecryptedCallback callback,
-    bool success,
-    std::unique_ptr<std::vector<nearby::sharing::proto::PublicCertificate>>
-        public_certificates) {
-  if (!success || !public_certificates) {
-    CD_LOG(ERROR, Feature::NS)
-        << __func__ << ": Failed to read public certificates from storage.";
-    RecordGetDecryptedPublicCertificateResultMetric(
-        GetDecryptedPublicCertificateResult::kStorageFailure);
-    std::move(callback).Run(std::nullopt);
-    return;
-  }
-
-  for (const auto& cert : *public_certificates) {
-    std::optional<NearbyShareDecryptedPublicCertificate> decrypted =
-        NearbyShareDecryptedPublicCertificate::DecryptPublicCertificate(
-            cert, encrypted_metadata_key);
-    if (decrypted) {
-      CD_LOG(VERBOSE, Feature::NS)
-          << __func__ << ": Successfully decrypted public certificate with ID "
-          << base::HexEncode(decrypted->id());
-      RecordGetDecryptedPublicCertificateResultMetric(
-          GetDecryptedPublicCertificateResult::kSuccess);
-      std::move(callback).Run(std::move(decrypted));
-      return;
-    }
-  }
-  CD_LOG(VERBOSE, Feature::NS)
-      << __func__
-      << ": Metadata key could not decrypt any public certificates.";
-  RecordGetDecryptedPublicCertificateResultMetric(
-      GetDecryptedPublicCertificateResult::kNoMatch);
-  std::move(callback).Run(std::nullopt);
-}
-
 // See documentation in declaration of `AttemptPrivateCertificateRefresh()`. The
 // `bluetooth_adapter` is considered ready if it can provide its address. On
 // BlueZ, it's when the `bluetooth_adapter` is non-null. On Floss, it's when
@@ -360,7 +333,9 @@ NearbyShareCertificateManagerImpl::NearbyShareCertificateManagerImpl(
                                   /*page_number=*/1,
                                   /*certificate_count=*/0),
               Feature::NS,
-              clock_)) {
+              clock_)),
+      decrypted_public_certificate_cache_(
+          kDecryptedPublicCertificateCacheSize) {
   local_device_data_manager_->AddObserver(this);
   contact_manager_->AddObserver(this);
 
@@ -384,9 +359,126 @@ NearbyShareCertificateManagerImpl::GetPrivateCertificatesAsPublicCertificates(
 void NearbyShareCertificateManagerImpl::GetDecryptedPublicCertificate(
     NearbyShareEncryptedMetadataKey encrypted_metadata_key,
     CertDecryptedCallback callback) {
-  certificate_storage_->GetPublicCertificates(
-      base::BindOnce(&TryDecryptPublicCertificates,
-                     std::move(encrypted_metadata_key), std::move(callback)));
+  // Answer from memory asynchronously, as when the certificates still have to
+  // be read from storage, so that callers never see their callback reentered.
+  if (public_certificates_) {
+    base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+        FROM_HERE,
+        base::BindOnce(std::move(callback),
+                       DecryptPublicCertificate(encrypted_metadata_key)));
+    return;
+  }
+
+  pending_decrypt_requests_.emplace_back(std::move(encrypted_metadata_key),
+                                         std::move(callback));
+  if (is_loading_public_certificates_) {
+    return;
+  }
+
+  is_loading_public_certificates_ = true;
+  are_loading_public_certificates_stale_ = false;
+  certificate_storage_->GetPublicCertificates(base::BindOnce(
+      &NearbyShareCertificateManagerImpl::OnPublicCertificatesLoaded,
+      base::Unretained(this)));
+}
+
+void NearbyShareCertificateManagerImpl::OnPublicCertificatesLoaded(
+    bool success,
+    std::unique_ptr<std::vector<nearby::sharing::proto::PublicCertificate>>
+        public_certificates) {
+  is_loading_public_certificates_ = false;
+  std::vector<std::pair<NearbyShareEncryptedMetadataKey, CertDecryptedCallback>>
+      requests;
+  requests.swap(pending_decrypt_requests_);
+
+  if (!success || !public_certificates) {
+    CD_LOG(ERROR, Feature::NS)
+        << __func__ << ": Failed to read public certificates from storage.";
+    for (auto& [encrypted_metadata_key, callback] : requests) {
+      RecordGetDecryptedPublicCertificateResultMetric(
+          GetDecryptedPublicCertificateResult::kStorageFailure);
+      std::move(callback).Run(std::nullopt);
+    }
+    return;
+  }
+
+  // Storage replaces certificates by secret ID, so there is at most one
+  // certificate per ID. Keep the first one regardless.
+  std::vector<std::pair<std::string, nearby::sharing::proto::PublicCertificate>>
+      entries;
+  entries.reserve(public_certificates->size());
+  for (auto& cert : *public_certificates) {
+    std::string secret_id = cert.secret_id();
+    entries.emplace_back(std::move(secret_id), std::move(cert));
+  }
+  public_certificates_.emplace(std::move(entries));
+  decrypted_public_certificate_cache_.Clear();
+
+  for (auto& [encrypted_metadata_key, callback] : requests) {
+    std::move(callback).Run(DecryptPublicCertificate(encrypted_metadata_key));
+  }
+
+  // Storage changed after the read was issued; read it again next time.
+  if (are_loading_public_certificates_stale_) {
+    InvalidatePublicCertificates();
+  }
+}
+
+std::optional<NearbyShareDecryptedPublicCertificate>
+NearbyShareCertificateManagerImpl::DecryptPublicCertificate(
+    const NearbyShareEncryptedMetadataKey& encrypted_metadata_key) {
+  DCHECK(public_certificates_);
+  std::pair<std::vector<uint8_t>, std::vector<uint8_t>> cache_key(
+      encrypted_metadata_key.salt(), encrypted_metadata_key.encrypted_key());
+  auto it = decrypted_public_certificate_cache_.Get(cache_key);
+  if (it != decrypted_public_certificate_cache_.end()) {
+    RecordGetDecryptedPublicCertificateResultMetric(
+        it->second ? GetDecryptedPublicCertificateResult::kSuccess
+                   : GetDecryptedPublicCertificateResult::kNoMatch);
+    return it->second;
+  }
+
+  std::optional<NearbyShareDecryptedPublicCertificate> decrypted;
+  for (const auto& [secret_id, cert] : *public_certificates_) {
+    decrypted = NearbyShareDecryptedPublicCertificate::DecryptPublicCertificate(
+        cert, encrypted_metadata_key);
+    if (decrypted) {
+      break;
+    }
+  }
+
+  if (decrypted) {
+    CD_LOG(VERBOSE, Feature::NS)
+        << __func__ << ": Successfully decrypted public certificate with ID "
+        << base::HexEncode(decrypted->id());
+    RecordGetDecryptedPublicCertificateResultMetric(
+        GetDecryptedPublicCertificateResult::kSuccess);
+  } else {
+    CD_LOG(VERBOSE, Feature::NS)
+        << __func__
+        << ": Metadata key could not decrypt any public certificates.";
+    RecordGetDecryptedPublicCertificateResultMetric(
+        GetDecryptedPublicCertificateResult::kNoMatch);
+  }
+  decrypted_public_certificate_cache_.Put(std::move(cache_key), decrypted);
+  return decrypted;
+}
+
+base::flat_map<std::string, nearby::sharing::proto::PublicCertificate>*
+NearbyShareCertificateManagerImpl::GetPublicCertificatesForUpdate() {
+  decrypted_public_certificate_cache_.Clear();
+  if (is_loading_public_certificates_) {
+    are_loading_public_certificates_stale_ = true;
+  }
+  return base::OptionalToPtr(public_certificates_);
+}
+
+void NearbyShareCertificateManagerImpl::InvalidatePublicCertificates() {
+  public_certificates_.reset();
+  decrypted_public_certificate_cache_.Clear();
+  if (is_loading_public_certificates_) {
+    are_loading_public_certificates_stale_ = true;
+  }
 }
 
 void NearbyShareCertificateManagerImpl::DownloadPublicCertificates() {
@@ -672,14 +764,29 @@ NearbyShareCertificateManagerImpl::NextPublicCertificateExpirationTime() {
          kNearbySharePublicCertificateValidityBoundOffsetTolerance;
 }
 void NearbyShareCertificateManagerImpl::OnPublicCertificateExpiration() {
+  base::Time now = clock_->Now();
   certificate_storage_->RemoveExpiredPublicCertificates(
-      clock_->Now(), base::BindOnce(&NearbyShareCertificateManagerImpl::
-                                        OnExpiredPublicCertificatesRemoved,
-                                    base::Unretained(this)));
+      now, base::BindOnce(&NearbyShareCertificateManagerImpl::
+                              OnExpiredPublicCertificatesRemoved,
+                          base::Unretained(this), now));
 }
 
 void NearbyShareCertificateManagerImpl::OnExpiredPublicCertificatesRemoved(
+    base::Time now,
     bool success) {
+  if (!success) {
+    InvalidatePublicCertificates();
+  } else if (auto* public_certificates = GetPublicCertificatesForUpdate()) {
+    // Mirror the expiration check done by storage.
+    base::EraseIf(*public_certificates, [now](const auto& entry) {
+      return IsNearbyShareCertificateExpired(
+          now,
+          /*not_after=*/
+          base::Time::FromSecondsSinceUnixEpoch(
+              entry.second.end_time().seconds()),
+          /*use_public_certificate_tolerance=*/true);
+    });
+  }
   public_certificate_expiration_scheduler_->HandleResult(success);
 }
 
@@ -743,7 +850,7 @@ void NearbyShareCertificateManagerImpl::OnListPublicCertificatesSuccess(
       certs, base::BindOnce(&NearbyShareCertificateManagerImpl::
                                 OnPublicCertificatesAddedToStorage,
                             base::Unretained(this), page_token, page_number,
-                            certificate_count + certs.size()));
+                            certificate_count + certs.size(), certs));
 }
 
 void NearbyShareCertificateManagerImpl::OnListPublicCertificatesFailure(
@@ -772,7 +879,19 @@ void NearbyShareCertificateManagerImpl::OnPublicCertificatesAddedToStorage(
     std::optional<std::string> page_token,
     size_t page_number,
     size_t certificate_count,
+    std::vector<nearby::sharing::proto::PublicCertificate> certificates,
     bool success) {
+  if (!success) {
+    InvalidatePublicCertificates();
+  } else if (auto* public_certificates = GetPublicCertificatesForUpdate()) {
+    // Like storage, replace existing certificates by secret ID.
+    for (auto& cert : certificates) {
+      std::string secret_id = cert.secret_id();
+      public_certificates->insert_or_assign(std::move(secret_id),
+                                            std::move(cert));
+    }
+  }
+
   if (success && page_token) {
     OnDownloadPublicCertificatesRequest(page_token, page_number + 1,
                                         certificate_count);
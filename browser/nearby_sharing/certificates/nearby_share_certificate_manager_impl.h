@@ -7,8 +7,12 @@
 
 #include <memory>
 #include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "base/containers/flat_map.h"
+#include "base/containers/lru_cache.h"
 #include "base/files/file_path.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/scoped_refptr.h"
@@ -182,7 +186,7 @@ class NearbyShareCertificateManagerImpl
   // public certificate needs to be removed from storage.
   void OnPublicCertificateExpiration();
 
-  void OnExpiredPublicCertificatesRemoved(bool success);
+  void OnExpiredPublicCertificatesRemoved(base::Time now, bool success);
 
   // Invoked by the certificate download scheduler when the public certificates
   // from trusted contacts need to be downloaded from Nearby Share server via
@@ -201,16 +205,45 @@ class NearbyShareCertificateManagerImpl
                                        ash::nearby::NearbyHttpError error);
   void OnListPublicCertificatesTimeout(size_t page_number,
                                        size_t certificate_count);
-  void OnPublicCertificatesAddedToStorage(std::optional<std::string> page_token,
-                                          size_t page_number,
-                                          size_t certificate_count,
-                                          bool success);
+  void OnPublicCertificatesAddedToStorage(
+      std::optional<std::string> page_token,
+      size_t page_number,
+      size_t certificate_count,
+      std::vector<nearby::sharing::proto::PublicCertificate> certificates,
+      bool success);
   void FinishDownloadPublicCertificates(
       bool success,
       ash::nearby::NearbyHttpResult http_result,
       size_t page_number,
       size_t certificate_count);
 
+  // Invoked when the public certificates read from storage on behalf of
+  // GetDecryptedPublicCertificate() are available. Builds
+  // `public_certificates_` and answers all pending requests.
+  void OnPublicCertificatesLoaded(
+      bool success,
+      std::unique_ptr<std::vector<nearby::sharing::proto::PublicCertificate>>
+          public_certificates);
+
+  // Returns the decryption of the first public certificate in
+  // `public_certificates_` that `encrypted_metadata_key` belongs to, if any.
+  // Results, including failures, are served from
+  // `decrypted_public_certificate_cache_` when possible.
+  std::optional<NearbyShareDecryptedPublicCertificate>
+  DecryptPublicCertificate(
+      const NearbyShareEncryptedMetadataKey& encrypted_metadata_key);
+
+  // Returns `public_certificates_` so that a change just applied to storage
+  // can be mirrored, or null if they are not loaded. Clears
+  // `decrypted_public_certificate_cache_`, and marks any read from storage that
+  // is in flight as stale.
+  base::flat_map<std::string, nearby::sharing::proto::PublicCertificate>*
+  GetPublicCertificatesForUpdate();
+
+  // Forgets `public_certificates_` so that they are read from storage again on
+  // the next request, e.g. after a storage write failed midway.
+  void InvalidatePublicCertificates();
+
   base::OneShotTimer timer_;
   raw_ptr<NearbyShareLocalDeviceDataManager> local_device_data_manager_ =
       nullptr;
@@ -230,6 +263,32 @@ class NearbyShareCertificateManagerImpl
       download_public_certificates_scheduler_;
   std::unique_ptr<NearbyShareClient> client_;
 
+  // In-memory copy of the public certificates in storage, keyed by secret ID.
+  // Read from storage on the first GetDecryptedPublicCertificate() call and
+  // then kept in sync with downloads and expiration, so that advertisements
+  // do not each cost a storage read. std::nullopt until loaded.
+  std::optional<
+      base::flat_map<std::string, nearby::sharing::proto::PublicCertificate>>
+      public_certificates_;
+
+  // Requests waiting for `public_certificates_` to be read from storage.
+  std::vector<std::pair<NearbyShareEncryptedMetadataKey, CertDecryptedCallback>>
+      pending_decrypt_requests_;
+  bool is_loading_public_certificates_ = false;
+
+  // Set if the public certificates in storage changed while a read was in
+  // flight, in which case the result of that read may already be stale.
+  bool are_loading_public_certificates_stale_ = false;
+
+  // Recent decryption results keyed by the advertised salt and encrypted
+  // metadata key. Failed attempts are cached too, since devices of
+  // non-contacts keep advertising and would otherwise cost a decryption
+  // attempt per public certificate each time. Cleared whenever
+  // `public_certificates_` changes.
+  base::LRUCache<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>,
+                 std::optional<NearbyShareDecryptedPublicCertificate>>
+      decrypted_public_certificate_cache_;
+
   // See documentation in declaration of `AttemptPrivateCertificateRefresh()`.
   // `adapter_` is set asynchronously in a call to `GetBluetoothAdapter()`
   // during the construction of `NearbyShareCertificateManagerImpl`. If
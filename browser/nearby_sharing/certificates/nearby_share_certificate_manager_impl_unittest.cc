@@ -9,6 +9,7 @@
 #include "base/test/metrics/histogram_tester.h"
 #include "base/test/scoped_feature_list.h"
 #include "base/test/task_environment.h"
+#include "base/test/test_future.h"
 #include "base/time/time.h"
 #include "chrome/browser/nearby_sharing/certificates/constants.h"
 #include "chrome/browser/nearby_sharing/certificates/fake_nearby_share_certificate_storage.h"
@@ -649,6 +650,64 @@ TEST_P(NearbyShareCertificateManagerImplTest,
   EXPECT_FALSE(decrypted_pub_cert);
 }
 
+TEST_P(NearbyShareCertificateManagerImplTest,
+       GetDecryptedPublicCertificateReadsStorageOnce) {
+  InitCertificateManager(/*use_floss=*/false);
+  std::optional<NearbyShareDecryptedPublicCertificate> decrypted_pub_cert;
+  cert_manager_->GetDecryptedPublicCertificate(
+      metadata_encryption_keys_[0],
+      base::BindOnce(&CaptureDecryptedPublicCertificateCallback,
+                     &decrypted_pub_cert));
+  GetPublicCertificatesCallback(true, public_certificates_);
+  ASSERT_TRUE(decrypted_pub_cert);
+
+  // Later requests, including repeated ones, are answered from memory, but
+  // never synchronously.
+  for (int i = 0; i < 2; ++i) {
+    decrypted_pub_cert.reset();
+    cert_manager_->GetDecryptedPublicCertificate(
+        metadata_encryption_keys_[1],
+        base::BindOnce(&CaptureDecryptedPublicCertificateCallback,
+                       &decrypted_pub_cert));
+    EXPECT_TRUE(cert_store_->get_public_certificates_callbacks().empty());
+    EXPECT_FALSE(decrypted_pub_cert);
+    task_environment_.RunUntilIdle();
+    ASSERT_TRUE(decrypted_pub_cert);
+    std::vector<uint8_t> id(public_certificates_[1].secret_id().begin(),
+                            public_certificates_[1].secret_id().end());
+    EXPECT_EQ(decrypted_pub_cert->id(), id);
+  }
+}
+
+TEST_P(NearbyShareCertificateManagerImplTest,
+       GetDecryptedPublicCertificateAfterExpiration) {
+  InitCertificateManager(/*use_floss=*/false);
+  std::optional<NearbyShareDecryptedPublicCertificate> decrypted_pub_cert;
+  cert_manager_->GetDecryptedPublicCertificate(
+      metadata_encryption_keys_[0],
+      base::BindOnce(&CaptureDecryptedPublicCertificateCallback,
+                     &decrypted_pub_cert));
+  GetPublicCertificatesCallback(true, public_certificates_);
+  ASSERT_TRUE(decrypted_pub_cert);
+
+  // Expire all public certificates.
+  cert_manager_->Start();
+  FastForward(kNearbyShareCertificateValidityPeriod +
+              kNearbySharePublicCertificateValidityBoundOffsetTolerance);
+  public_cert_exp_scheduler_->InvokeRequestCallback();
+  std::move(
+      cert_store_->remove_expired_public_certificates_calls().back().callback)
+      .Run(/*success=*/true);
+
+  // The expired certificate is no longer used, without reading storage again.
+  base::test::TestFuture<std::optional<NearbyShareDecryptedPublicCertificate>>
+      future;
+  cert_manager_->GetDecryptedPublicCertificate(metadata_encryption_keys_[0],
+                                               future.GetCallback());
+  EXPECT_TRUE(cert_store_->get_public_certificates_callbacks().empty());
+  EXPECT_FALSE(future.Take());
+}
+
 TEST_P(NearbyShareCertificateManagerImplTest,
        DownloadPublicCertificatesImmediateRequest) {
   InitCertificateManager(/*use_floss=*/false);
@@ -4,47 +4,168 @@
 
 #include "chrome/browser/permissions/crowd_deny_preload_data.h"
 
+#include <algorithm>
+#include <limits>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include "base/files/file_util.h"
 #include "base/functional/bind.h"
 #include "base/functional/callback_helpers.h"
 #include "base/location.h"
+#include "base/memory/ptr_util.h"
 #include "base/no_destructor.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/task/sequenced_task_runner.h"
 #include "base/task/thread_pool.h"
+#include "base/types/optional_util.h"
 #include "components/permissions/permission_uma_util.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #include "url/gurl.h"
 #include "url/origin.h"
 #include "url/url_constants.h"
 
-namespace {
+// CrowdDenyPreloadData::ReputationTable -----------------------------------
 
-using DomainToReputationMap = CrowdDenyPreloadData::DomainToReputationMap;
+// Stores all site reputations in one sorted array of fixed-size entries, plus
+// a single buffer holding the concatenated domain names. Compared to a map of
+// SiteReputation messages, this needs no per-site heap allocations, and is
+// queried in place by binary search. Instances are never modified after being
+// built, so an update simply replaces the whole table.
+class CrowdDenyPreloadData::ReputationTable {
+ public:
+  using DomainAndReputation =
+      std::pair<std::string_view, const SiteReputation*>;
 
-// Attempts to load the preload data from |proto_path|, parse it as a serialized
-// chrome_browser_crowd_deny::PreloadData message, and index it by domain.
-// Returns an empty map is anything goes wrong.
-DomainToReputationMap LoadAndParseAndIndexPreloadDataFromDisk(
-    const base::FilePath& proto_path) {
-  std::string binary_proto;
-  if (!base::ReadFileToString(proto_path, &binary_proto))
-    return {};
+  ReputationTable(const ReputationTable&) = delete;
+  ReputationTable& operator=(const ReputationTable&) = delete;
+  ~ReputationTable() = default;
 
-  CrowdDenyPreloadData::PreloadData preload_data;
-  if (!preload_data.ParseFromString(binary_proto))
-    return {};
+  // Builds a table from |site_reputations|. If a domain is listed more than
+  // once, the first entry wins.
+  static std::unique_ptr<const ReputationTable> Build(
+      std::vector<DomainAndReputation> site_reputations) {
+    std::erase_if(site_reputations, [](const DomainAndReputation& item) {
+      return item.first.size() > std::numeric_limits<uint16_t>::max();
+    });
+    std::stable_sort(site_reputations.begin(), site_reputations.end(),
+                     [](const DomainAndReputation& lhs,
+                        const DomainAndReputation& rhs) {
+                       return lhs.first < rhs.first;
+                     });
 
-  std::vector<DomainToReputationMap::value_type> domain_reputation_pairs;
-  domain_reputation_pairs.reserve(preload_data.site_reputations_size());
-  for (const auto& site_reputation : preload_data.site_reputations()) {
-    domain_reputation_pairs.emplace_back(site_reputation.domain(),
-                                         site_reputation);
+    std::string domains;
+    std::vector<Entry> entries;
+    entries.reserve(site_reputations.size());
+    for (const auto& [domain, reputation] : site_reputations) {
+      if (!entries.empty() && domain == DomainOf(domains, entries.back()))
+        continue;
+      uint8_t flags = 0;
+      if (reputation->include_subdomains())
+        flags |= kIncludeSubdomains;
+      if (reputation->warning_only())
+        flags |= kWarningOnly;
+      entries.push_back(
+          {base::checked_cast<uint32_t>(domains.size()),
+           static_cast<uint16_t>(domain.size()),
+           static_cast<uint8_t>(reputation->notification_ux_quality()), flags});
+      domains.append(domain);
+    }
+    domains.shrink_to_fit();
+    entries.shrink_to_fit();
+    return base::WrapUnique(
+        new ReputationTable(std::move(domains), std::move(entries)));
   }
-  return DomainToReputationMap(std::move(domain_reputation_pairs));
-}
+
+  // Attempts to load the preload data from |proto_path|, parse it as a
+  // serialized chrome_browser_crowd_deny::PreloadData message, and index it by
+  // domain. Returns an empty table if anything goes wrong.
+  static std::unique_ptr<const ReputationTable> LoadFromDisk(
+      const base::FilePath& proto_path) {
+    std::string binary_proto;
+    if (!base::ReadFileToString(proto_path, &binary_proto))
+      return Build({});
+
+    PreloadData preload_data;
+    if (!preload_data.ParseFromString(binary_proto))
+      return Build({});
+    // The serialized form is no longer needed; release it before building the
+    // table.
+    binary_proto = std::string();
+
+    std::vector<DomainAndReputation> domain_reputation_pairs;
+    domain_reputation_pairs.reserve(preload_data.site_reputations_size());
+    for (const auto& site_reputation : preload_data.site_reputations()) {
+      domain_reputation_pairs.emplace_back(site_reputation.domain(),
+                                           &site_reputation);
+    }
+    return Build(std::move(domain_reputation_pairs));
+  }
+
+  std::optional<SiteReputation> Find(std::string_view domain) const {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), domain,
+                               [this](const Entry& entry, std::string_view d) {
+                                 return DomainOf(domains_, entry) < d;
+                               });
+    if (it == entries_.end() || DomainOf(domains_, *it) != domain)
+      return std::nullopt;
+    return ToSiteReputation(*it);
+  }
+
+  DomainToReputationMap ToMap() const {
+    std::vector<DomainToReputationMap::value_type> items;
+    items.reserve(entries_.size());
+    for (const Entry& entry : entries_) {
+      items.emplace_back(std::string(DomainOf(domains_, entry)),
+                         ToSiteReputation(entry));
+    }
+    return DomainToReputationMap(base::sorted_unique, std::move(items));
+  }
+
+  size_t EstimateMemoryUsage() const {
+    return domains_.capacity() + entries_.capacity() * sizeof(Entry);
+  }
+
+ private:
+  enum Flags : uint8_t {
+    kIncludeSubdomains = 1 << 0,
+    kWarningOnly = 1 << 1,
+  };
+
+  struct Entry {
+    uint32_t domain_offset;
+    uint16_t domain_length;
+    uint8_t notification_ux_quality;
+    uint8_t flags;
+  };
+  static_assert(sizeof(Entry) == 8);
+
+  ReputationTable(std::string domains, std::vector<Entry> entries)
+      : domains_(std::move(domains)), entries_(std::move(entries)) {}
+
+  static std::string_view DomainOf(std::string_view domains,
+                                   const Entry& entry) {
+    return domains.substr(entry.domain_offset, entry.domain_length);
+  }
+
+  SiteReputation ToSiteReputation(const Entry& entry) const {
+    SiteReputation reputation;
+    reputation.set_domain(std::string(DomainOf(domains_, entry)));
+    reputation.set_notification_ux_quality(
+        static_cast<SiteReputation::NotificationUserExperienceQuality>(
+            entry.notification_ux_quality));
+    reputation.set_include_subdomains(entry.flags & kIncludeSubdomains);
+    reputation.set_warning_only(entry.flags & kWarningOnly);
+    return reputation;
+  }
+
+  const std::string domains_;
+  const std::vector<Entry> entries_;
+};
+
+namespace {
 
 PendingOrigin::PendingOrigin(
     url::Origin origin,
@@ -72,7 +193,9 @@ void CrowdDenyPreloadData::GetReputationDataForSiteAsync(
     const url::Origin& origin,
     SiteReputationCallback callback) {
   if (is_ready_to_use_) {
-    std::move(callback).Run(GetReputationDataForSite(origin));
+    std::optional<SiteReputation> reputation =
+        GetReputationDataForSite(origin);
+    std::move(callback).Run(base::OptionalToPtr(reputation));
   } else {
     origins_pending_verification_.emplace(origin, std::move(callback));
   }
@@ -82,46 +205,56 @@ void CrowdDenyPreloadData::LoadFromDisk(const base::FilePath& proto_path,
                                         const base::Version& version) {
   version_on_disk_ = version;
   is_ready_to_use_ = false;
-  // On failure, LoadAndParseAndIndexPreloadDataFromDisk will return an empty
-  // map. Replace the in-memory state with that regardless, so that the stale
-  // old data will no longer be used.
+  // On failure, ReputationTable::LoadFromDisk will return an empty table.
+  // Replace the in-memory state with that regardless, so that the stale old
+  // data will no longer be used.
   loading_task_runner_->PostTaskAndReplyWithResult(
       FROM_HERE,
-      base::BindOnce(&LoadAndParseAndIndexPreloadDataFromDisk, proto_path),
-      base::BindOnce(&CrowdDenyPreloadData::SetSiteReputations,
+      base::BindOnce(&ReputationTable::LoadFromDisk, proto_path),
+      base::BindOnce(&CrowdDenyPreloadData::SetReputationTable,
                      weak_factory_.GetWeakPtr()));
 }
 
-const CrowdDenyPreloadData::SiteReputation*
+std::optional<CrowdDenyPreloadData::SiteReputation>
 CrowdDenyPreloadData::GetReputationDataForSite(
     const url::Origin& origin) const {
-  if (origin.scheme() != url::kHttpsScheme)
-    return nullptr;
+  if (origin.scheme() != url::kHttpsScheme || !reputation_table_)
+    return std::nullopt;
 
-  const auto it_exact_match = domain_to_reputation_map_.find(origin.host());
-  if (it_exact_match != domain_to_reputation_map_.end())
-    return &it_exact_match->second;
+  std::optional<SiteReputation> exact_match =
+      reputation_table_->Find(origin.host());
+  if (exact_match)
+    return exact_match;
 
   const std::string registerable_domain =
       net::registry_controlled_domains::GetDomainAndRegistry(
           origin, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
-  const auto it_domain_suffix_match =
-      domain_to_reputation_map_.find(registerable_domain);
-  if (it_domain_suffix_match != domain_to_reputation_map_.end() &&
-      it_domain_suffix_match->second.include_subdomains()) {
-    return &it_domain_suffix_match->second;
-  }
+  std::optional<SiteReputation> domain_suffix_match =
+      reputation_table_->Find(registerable_domain);
+  if (domain_suffix_match && domain_suffix_match->include_subdomains())
+    return domain_suffix_match;
 
-  return nullptr;
+  return std::nullopt;
 }
 
-void CrowdDenyPreloadData::SetSiteReputations(DomainToReputationMap map) {
-  domain_to_reputation_map_ = std::move(map);
+void CrowdDenyPreloadData::SetReputationTable(
+    std::unique_ptr<const ReputationTable> table) {
+  reputation_table_ = std::move(table);
   is_ready_to_use_ = true;
 
   CheckOriginsPendingVerification();
 }
 
+void CrowdDenyPreloadData::SetSiteReputations(
+    const DomainToReputationMap& map) {
+  std::vector<ReputationTable::DomainAndReputation> domain_reputation_pairs;
+  domain_reputation_pairs.reserve(map.size());
+  for (const auto& [domain, site_reputation] : map)
+    domain_reputation_pairs.emplace_back(domain, &site_reputation);
+  SetReputationTable(
+      ReputationTable::Build(std::move(domain_reputation_pairs)));
+}
+
 void CrowdDenyPreloadData::CheckOriginsPendingVerification() {
   if (origins_pending_verification_.empty())
     return;
@@ -135,9 +268,17 @@ void CrowdDenyPreloadData::CheckOriginsPendingVerification() {
   CheckOriginsPendingVerification();
 }
 
+size_t CrowdDenyPreloadData::EstimateMemoryUsageForTesting() const {
+  return reputation_table_ ? reputation_table_->EstimateMemoryUsage() : 0;
+}
+
 CrowdDenyPreloadData::DomainToReputationMap
 CrowdDenyPreloadData::TakeSiteReputations() {
-  return std::move(domain_to_reputation_map_);
+  if (!reputation_table_)
+    return {};
+  DomainToReputationMap map = reputation_table_->ToMap();
+  reputation_table_.reset();
+  return map;
 }
 
 // ScopedCrowdDenyPreloadDataOverride -----------------------------------
@@ -149,7 +290,7 @@ ScopedCrowdDenyPreloadDataOverride::ScopedCrowdDenyPreloadDataOverride() {
 }
 
 ScopedCrowdDenyPreloadDataOverride::~ScopedCrowdDenyPreloadDataOverride() {
-  CrowdDenyPreloadData::GetInstance()->SetSiteReputations(std::move(old_map_));
+  CrowdDenyPreloadData::GetInstance()->SetSiteReputations(old_map_);
 }
 
 void ScopedCrowdDenyPreloadDataOverride::SetOriginReputation(
@@ -158,7 +299,7 @@ void ScopedCrowdDenyPreloadDataOverride::SetOriginReputation(
   auto* instance = CrowdDenyPreloadData::GetInstance();
   DomainToReputationMap testing_map = instance->TakeSiteReputations();
   testing_map[origin.host()] = std::move(site_reputation);
-  instance->SetSiteReputations(std::move(testing_map));
+  instance->SetSiteReputations(testing_map);
 }
 
 void ScopedCrowdDenyPreloadDataOverride::ClearAllReputations() {
@@ -95,15 +95,24 @@ class CrowdDenyPreloadData {
   friend class testing::ScopedCrowdDenyPreloadDataOverride;
   friend class CrowdDenyPreloadDataTest;
 
-  const SiteReputation* GetReputationDataForSite(
+  // Compact, immutable index of the preloaded site reputations. Defined in
+  // the .cc file.
+  class ReputationTable;
+
+  std::optional<SiteReputation> GetReputationDataForSite(
       const url::Origin& origin) const;
-  void SetSiteReputations(DomainToReputationMap map);
+  void SetReputationTable(std::unique_ptr<const ReputationTable> table);
+  void SetSiteReputations(const DomainToReputationMap& map);
   void CheckOriginsPendingVerification();
   DomainToReputationMap TakeSiteReputations();
+  // Returns the number of bytes held by |reputation_table_|.
+  size_t EstimateMemoryUsageForTesting() const;
   // The only moment when CrowdDenyPreloadData is not ready to use is during
   // loading from disk.
   bool is_ready_to_use_ = true;
-  DomainToReputationMap domain_to_reputation_map_;
+  // Built on |loading_task_runner_| and swapped in as a whole once loading
+  // completes; null while there is no data.
+  std::unique_ptr<const ReputationTable> reputation_table_;
   scoped_refptr<base::SequencedTaskRunner> loading_task_runner_;
   std::optional<base::Version> version_on_disk_;
   std::queue<PendingOrigin> origins_pending_verification_;
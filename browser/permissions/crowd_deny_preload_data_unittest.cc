@@ -4,12 +4,15 @@
 
 #include "chrome/browser/permissions/crowd_deny_preload_data.h"
 
+#include <optional>
 #include <string_view>
 
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/numerics/safe_conversions.h"
+#include "base/strings/stringprintf.h"
 #include "base/test/task_environment.h"
+#include "base/types/optional_util.h"
 #include "base/version.h"
 #include "chrome/browser/permissions/crowd_deny.pb.h"
 #include "testing/gmock/include/gmock/gmock.h"
@@ -134,14 +137,21 @@ class CrowdDenyPreloadDataTest : public testing::Test {
     }
   }
 
+  // The returned pointer is valid until the next call.
   const SiteReputation* GetReputationDataForSite(const url::Origin& origin) {
-    return preload_data()->GetReputationDataForSite(origin);
+    last_reputation_ = preload_data()->GetReputationDataForSite(origin);
+    return base::OptionalToPtr(last_reputation_);
+  }
+
+  size_t EstimatePreloadDataMemoryUsage() const {
+    return preload_data_.EstimateMemoryUsageForTesting();
   }
 
  private:
   base::test::TaskEnvironment task_environment_;
   base::ScopedTempDir scoped_temp_dir_;
   CrowdDenyPreloadData preload_data_;
+  std::optional<SiteReputation> last_reputation_;
 };
 
 TEST_F(CrowdDenyPreloadDataTest, NoData) {
@@ -375,6 +385,47 @@ TEST_F(CrowdDenyPreloadDataTest, UpdateToBadFileWipesInMemoryState) {
   ExpectEmptyPreloadData();
 }
 
+TEST_F(CrowdDenyPreloadDataTest, LargeList) {
+  constexpr int kNumDomains = 100000;
+
+  // Add the sites in descending order, as the list is not sorted.
+  chrome_browser_crowd_deny::PreloadData test_data;
+  for (int i = kNumDomains - 1; i >= 0; --i) {
+    auto* site_reputation = test_data.add_site_reputations();
+    site_reputation->set_domain(base::StringPrintf("site%d.com", i));
+    site_reputation->set_include_subdomains(i % 2 == 0);
+    site_reputation->set_notification_ux_quality(
+        i % 3 == 0 ? SiteReputation::ABUSIVE_PROMPTS
+                   : SiteReputation::ACCEPTABLE);
+  }
+  ASSERT_NO_FATAL_FAILURE(SerializeAndLoadTestData(std::move(test_data)));
+
+  for (int i = 0; i < kNumDomains; i += 997) {
+    SCOPED_TRACE(i);
+    const std::string domain = base::StringPrintf("site%d.com", i);
+    const auto* data = GetReputationDataForSite(
+        url::Origin::Create(GURL("https://" + domain)));
+    ASSERT_TRUE(data);
+    EXPECT_EQ(domain, data->domain());
+    EXPECT_EQ(i % 3 == 0 ? SiteReputation::ABUSIVE_PROMPTS
+                         : SiteReputation::ACCEPTABLE,
+              data->notification_ux_quality());
+    EXPECT_EQ(i % 2 == 0, data->include_subdomains());
+    EXPECT_FALSE(data->warning_only());
+
+    data = GetReputationDataForSite(
+        url::Origin::Create(GURL("https://www." + domain)));
+    EXPECT_EQ(i % 2 == 0, !!data);
+  }
+
+  EXPECT_FALSE(GetReputationDataForSite(url::Origin::Create(
+      GURL(base::StringPrintf("https://site%d.com", kNumDomains)))));
+
+  // Each site costs its domain name plus a small fixed-size entry, without any
+  // per-site heap allocations.
+  EXPECT_LT(EstimatePreloadDataMemoryUsage(), kNumDomains * 24u);
+}
+
 // During start-up congestion, it is possible that a new version of the
 // component becomes available while the old version is pending being loaded.
 // Ensure that when things settle down, the last version loaded will prevail,
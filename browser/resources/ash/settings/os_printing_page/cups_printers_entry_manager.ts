@@ -53,6 +53,7 @@ export class CupsPrintersEntryManager {
   private onEnterprisePrintersChangedListener_: WebUiListener|null;
   private onEnterprisePrintersChangedListeners_: PrintersListCallback[];
   private onNearbyPrintersChangedListener_: WebUiListener|null;
+  private onNearbyPrintersUpdatedListener_: WebUiListener|null;
   private onNearbyPrintersChangedListeners_: PrintersListCallback[];
   private onSavedPrintersChangedListeners_: PrintersListWithDeltasCallback[];
   private savedPrinters_: PrinterListEntry[];
@@ -67,6 +68,7 @@ export class CupsPrintersEntryManager {
     this.printServerPrinters = [];
     this.onNearbyPrintersChangedListeners_ = [];
     this.onNearbyPrintersChangedListener_ = null;
+    this.onNearbyPrintersUpdatedListener_ = null;
     this.onEnterprisePrintersChangedListeners_ = [];
     this.onEnterprisePrintersChangedListener_ = null;
     this.haveInitialSavedPrintersLoaded_ = false;
@@ -78,6 +80,9 @@ export class CupsPrintersEntryManager {
     this.onNearbyPrintersChangedListener_ = addWebUiListener(
         'on-nearby-printers-changed', this.setNearbyPrintersList.bind(this));
 
+    this.onNearbyPrintersUpdatedListener_ = addWebUiListener(
+        'on-nearby-printers-updated', this.updateNearbyPrintersList.bind(this));
+
     this.onEnterprisePrintersChangedListener_ = addWebUiListener(
         'on-enterprise-printers-changed',
         this.onEnterprisePrintersChanged.bind(this));
@@ -95,6 +100,10 @@ export class CupsPrintersEntryManager {
       removeWebUiListener(this.onNearbyPrintersChangedListener_);
       this.onNearbyPrintersChangedListener_ = null;
     }
+    if (this.onNearbyPrintersUpdatedListener_) {
+      removeWebUiListener(this.onNearbyPrintersUpdatedListener_);
+      this.onNearbyPrintersUpdatedListener_ = null;
+    }
     if (this.onEnterprisePrintersChangedListener_) {
       removeWebUiListener(this.onEnterprisePrintersChangedListener_);
       this.onEnterprisePrintersChangedListener_ = null;
@@ -191,6 +200,31 @@ export class CupsPrintersEntryManager {
     this.notifyOnNearbyPrintersChangedListeners_();
   }
 
+  /**
+   * Applies the printers added to, updated in or removed from either the
+   * automatic or the discovered printers to the nearby printers list and
+   * notifies observers.
+   */
+  updateNearbyPrintersList(
+      automatic: boolean, addedOrUpdatedPrinters: CupsPrinterInfo[],
+      removedPrinterIds: string[]): void {
+    const printerType =
+        automatic ? PrinterType.AUTOMATIC : PrinterType.DISCOVERED;
+    const changedIds = new Set(removedPrinterIds);
+    for (const printer of addedOrUpdatedPrinters) {
+      changedIds.add(printer.printerId);
+    }
+
+    this.nearbyPrinters_ = this.nearbyPrinters_.filter(
+        entry => entry.printerType !== printerType ||
+            !changedIds.has(entry.printerInfo.printerId));
+    for (const printer of addedOrUpdatedPrinters) {
+      this.nearbyPrinters_.push({printerInfo: printer, printerType});
+    }
+
+    this.notifyOnNearbyPrintersChangedListeners_();
+  }
+
   // Sets the enterprise printers list and notifies observers.
   setEnterprisePrintersList(enterprisePrinters: PrinterListEntry[]): void {
     this.enterprisePrinters_ = enterprisePrinters;
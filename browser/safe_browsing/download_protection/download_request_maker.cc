@@ -190,6 +190,8 @@ DownloadRequestMaker::DownloadRequestMaker(
   }
 
   request_->set_previous_token(previous_token);
+
+  file_analyzer_->SetContentDigest(sha256_hash, length);
 }
 
 DownloadRequestMaker::~DownloadRequestMaker() = default;
@@ -4,10 +4,15 @@
 
 #include "chrome/browser/safe_browsing/download_protection/file_analyzer.h"
 
+#include <tuple>
+
+#include "base/containers/lru_cache.h"
 #include "base/feature_list.h"
 #include "base/functional/bind.h"
 #include "base/metrics/histogram_functions.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/no_destructor.h"
+#include "base/task/sequenced_task_runner.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool.h"
 #include "build/build_config.h"
@@ -26,6 +31,69 @@ namespace {
 
 using content::BrowserThread;
 
+// Max number of archive analysis results kept in the cache.
+constexpr size_t kMaxCachedArchiveResults = 100;
+
+// Max age of a cached archive analysis result. Bounded so that changes to the
+// file type policies eventually apply to files that were analyzed before.
+constexpr base::TimeDelta kMaxCachedArchiveResultsAge = base::Hours(1);
+
+// Cache of archive analysis results, keyed by the contents of the analyzed
+// file. Identical archives are commonly downloaded several times in a row,
+// e.g. when a download is retried, and the results only depend on the
+// contents. Lives on the UI thread.
+class ArchiveResultsCache {
+ public:
+  struct Key {
+    bool operator<(const Key& other) const {
+      return std::tie(sha256_hash, size, inspection_type) <
+             std::tie(other.sha256_hash, other.size, other.inspection_type);
+    }
+
+    std::string sha256_hash;
+    int64_t size;
+    DownloadFileType::InspectionType inspection_type;
+  };
+
+  static ArchiveResultsCache* GetInstance() {
+    static base::NoDestructor<ArchiveResultsCache> instance;
+    return instance.get();
+  }
+
+  std::optional<ArchiveAnalyzerResults> Get(const Key& key) {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    auto it = cache_.Get(key);
+    if (it == cache_.end()) {
+      return std::nullopt;
+    }
+    if (base::TimeTicks::Now() - it->second.insertion_time >
+        kMaxCachedArchiveResultsAge) {
+      cache_.Erase(it);
+      return std::nullopt;
+    }
+    return it->second.results;
+  }
+
+  void Put(const Key& key, const ArchiveAnalyzerResults& results) {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    cache_.Put(key, Entry{results, base::TimeTicks::Now()});
+  }
+
+  void Clear() { cache_.Clear(); }
+
+ private:
+  friend class base::NoDestructor<ArchiveResultsCache>;
+
+  struct Entry {
+    ArchiveAnalyzerResults results;
+    base::TimeTicks insertion_time;
+  };
+
+  ArchiveResultsCache() : cache_(kMaxCachedArchiveResults) {}
+
+  base::LRUCache<Key, Entry> cache_;
+};
+
 FileAnalyzer::Results ExtractFileFeatures(
     scoped_refptr<BinaryFeatureExtractor> binary_feature_extractor,
     base::FilePath file_path) {
@@ -55,6 +123,17 @@ FileAnalyzer::FileAnalyzer(
 
 FileAnalyzer::~FileAnalyzer() {}
 
+void FileAnalyzer::SetContentDigest(const std::string& sha256_hash,
+                                    int64_t size) {
+  sha256_hash_ = sha256_hash;
+  size_ = size;
+}
+
+// static
+void FileAnalyzer::ClearArchiveResultsCacheForTesting() {
+  ArchiveResultsCache::GetInstance()->Clear();
+}
+
 void FileAnalyzer::Start(const base::FilePath& target_path,
                          const base::FilePath& tmp_path,
                          base::optional_ref<const std::string> password,
@@ -72,6 +151,10 @@ void FileAnalyzer::Start(const base::FilePath& target_path,
           ->PolicyForFile(target_path_, GURL{}, nullptr)
           .inspection_type();
 
+  if (MaybeUseCachedArchiveResults(inspection_type)) {
+    return;
+  }
+
   if (inspection_type == DownloadFileType::ZIP) {
     StartExtractZipFeatures();
   } else if (inspection_type == DownloadFileType::RAR) {
@@ -99,6 +182,69 @@ void FileAnalyzer::Start(const base::FilePath& target_path,
   }
 }
 
+bool FileAnalyzer::MaybeUseCachedArchiveResults(
+    DownloadFileType::InspectionType inspection_type) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+  // Results of password protected archives depend on the password, so they
+  // are neither cached nor served from the cache.
+  if (sha256_hash_.empty() || password_) {
+    return false;
+  }
+
+  base::OnceCallback<void(const ArchiveAnalyzerResults&)> on_finished;
+  if (inspection_type == DownloadFileType::ZIP) {
+    on_finished = base::BindOnce(&FileAnalyzer::OnZipAnalysisFinished,
+                                 weakptr_factory_.GetWeakPtr());
+  } else if (inspection_type == DownloadFileType::RAR) {
+    on_finished = base::BindOnce(&FileAnalyzer::OnRarAnalysisFinished,
+                                 weakptr_factory_.GetWeakPtr());
+#if BUILDFLAG(IS_MAC)
+  } else if (inspection_type == DownloadFileType::DMG) {
+    on_finished = base::BindOnce(&FileAnalyzer::OnDmgAnalysisFinished,
+                                 weakptr_factory_.GetWeakPtr());
+#endif
+  } else if (base::FeatureList::IsEnabled(kSevenZipEvaluationEnabled) &&
+             inspection_type == DownloadFileType::SEVEN_ZIP) {
+    on_finished = base::BindOnce(&FileAnalyzer::OnSevenZipAnalysisFinished,
+                                 weakptr_factory_.GetWeakPtr());
+  } else {
+    return false;
+  }
+
+  std::optional<ArchiveAnalyzerResults> cached_results =
+      ArchiveResultsCache::GetInstance()->Get(
+          {sha256_hash_, size_, inspection_type});
+  if (!cached_results) {
+    return false;
+  }
+
+  // Post the results so that |callback_| is never run synchronously from
+  // Start().
+  using_cached_results_ = true;
+  base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+      FROM_HERE,
+      base::BindOnce(std::move(on_finished), std::move(*cached_results)));
+  return true;
+}
+
+void FileAnalyzer::MaybeCacheArchiveResults(
+    DownloadFileType::InspectionType inspection_type,
+    const ArchiveAnalyzerResults& archive_results) {
+  if (sha256_hash_.empty() || password_ || using_cached_results_) {
+    return;
+  }
+
+  // Timeouts and disk errors may not happen on the next attempt.
+  if (archive_results.analysis_result == ArchiveAnalysisResult::kTimeout ||
+      archive_results.analysis_result == ArchiveAnalysisResult::kDiskError) {
+    return;
+  }
+
+  ArchiveResultsCache::GetInstance()->Put(
+      {sha256_hash_, size_, inspection_type}, archive_results);
+}
+
 void FileAnalyzer::StartExtractFileFeatures() {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
 
@@ -132,10 +278,14 @@ void FileAnalyzer::StartExtractZipFeatures() {
 
 void FileAnalyzer::OnZipAnalysisFinished(
     const ArchiveAnalyzerResults& archive_results) {
-  base::UmaHistogramEnumeration("SBClientDownload.ZipArchiveAnalysisResult",
-                                archive_results.analysis_result);
-  LogAnalysisDurationWithAndWithoutSuffix("Zip");
+  // Replayed results were already recorded when they were computed.
+  if (!using_cached_results_) {
+    base::UmaHistogramEnumeration("SBClientDownload.ZipArchiveAnalysisResult",
+                                  archive_results.analysis_result);
+    LogAnalysisDurationWithAndWithoutSuffix("Zip");
+  }
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  MaybeCacheArchiveResults(DownloadFileType::ZIP, archive_results);
 
   // Even if !results.success, some of the zip may have been parsed.
   // Some unzippers will successfully unpack archives that we cannot,
@@ -198,9 +348,12 @@ void FileAnalyzer::StartExtractRarFeatures() {
 void FileAnalyzer::OnRarAnalysisFinished(
     const ArchiveAnalyzerResults& archive_results) {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
-  base::UmaHistogramEnumeration("SBClientDownload.RarArchiveAnalysisResult",
-                                archive_results.analysis_result);
-  LogAnalysisDurationWithAndWithoutSuffix("Rar");
+  if (!using_cached_results_) {
+    base::UmaHistogramEnumeration("SBClientDownload.RarArchiveAnalysisResult",
+                                  archive_results.analysis_result);
+    LogAnalysisDurationWithAndWithoutSuffix("Rar");
+  }
+  MaybeCacheArchiveResults(DownloadFileType::RAR, archive_results);
 
   if (archive_results.success) {
     results_.archive_summary.set_parser_status(
@@ -271,9 +424,12 @@ void FileAnalyzer::ExtractFileOrDmgFeatures(
 void FileAnalyzer::OnDmgAnalysisFinished(
     const safe_browsing::ArchiveAnalyzerResults& archive_results) {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
-  base::UmaHistogramEnumeration("SBClientDownload.DmgArchiveAnalysisResult",
-                                archive_results.analysis_result);
-  LogAnalysisDurationWithAndWithoutSuffix("Dmg");
+  if (!using_cached_results_) {
+    base::UmaHistogramEnumeration("SBClientDownload.DmgArchiveAnalysisResult",
+                                  archive_results.analysis_result);
+    LogAnalysisDurationWithAndWithoutSuffix("Dmg");
+  }
+  MaybeCacheArchiveResults(DownloadFileType::DMG, archive_results);
 
   if (archive_results.signature_blob.size() > 0) {
     results_.disk_image_signature =
@@ -331,10 +487,13 @@ void FileAnalyzer::OnSevenZipAnalysisFinished(
     const ArchiveAnalyzerResults& archive_results) {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
 
-  base::UmaHistogramEnumeration(
-      "SBClientDownload.SevenZipArchiveAnalysisResult",
-      archive_results.analysis_result);
-  LogAnalysisDurationWithAndWithoutSuffix("SevenZip");
+  if (!using_cached_results_) {
+    base::UmaHistogramEnumeration(
+        "SBClientDownload.SevenZipArchiveAnalysisResult",
+        archive_results.analysis_result);
+    LogAnalysisDurationWithAndWithoutSuffix("SevenZip");
+  }
+  MaybeCacheArchiveResults(DownloadFileType::SEVEN_ZIP, archive_results);
 
   // Even if !results.success, some of the 7z may have been parsed.
   // Some unzippers will successfully unpack archives that we cannot,
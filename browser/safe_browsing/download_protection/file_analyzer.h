@@ -15,6 +15,7 @@
 #include "chrome/services/file_util/public/cpp/sandboxed_rar_analyzer.h"
 #include "chrome/services/file_util/public/cpp/sandboxed_seven_zip_analyzer.h"
 #include "chrome/services/file_util/public/cpp/sandboxed_zip_analyzer.h"
+#include "components/safe_browsing/content/common/proto/download_file_types.pb.h"
 #include "components/safe_browsing/core/common/proto/csd.pb.h"
 #include "third_party/protobuf/src/google/protobuf/repeated_field.h"
 
@@ -81,12 +82,33 @@ class FileAnalyzer {
   explicit FileAnalyzer(
       scoped_refptr<BinaryFeatureExtractor> binary_feature_extractor);
   ~FileAnalyzer();
+
+  // Sets the SHA-256 hash and size of the file that will be analyzed. When
+  // set, archive analysis results are cached under this digest, and a later
+  // analysis of identical contents reuses them instead of re-extracting the
+  // archive in a sandboxed utility process. Must be called before Start().
+  void SetContentDigest(const std::string& sha256_hash, int64_t size);
+
   void Start(const base::FilePath& target_path,
              const base::FilePath& tmp_path,
              base::optional_ref<const std::string> password,
              base::OnceCallback<void(Results)> callback);
 
+  // Clears archive analysis results cached by any FileAnalyzer.
+  static void ClearArchiveResultsCacheForTesting();
+
  private:
+  // Replays cached archive analysis results for the file if there are any.
+  // Returns true if the analysis was answered from the cache.
+  bool MaybeUseCachedArchiveResults(
+      DownloadFileType::InspectionType inspection_type);
+
+  // Caches |archive_results| for the file contents, unless the analysis
+  // failed for a transient reason.
+  void MaybeCacheArchiveResults(
+      DownloadFileType::InspectionType inspection_type,
+      const ArchiveAnalyzerResults& archive_results);
+
   void StartExtractFileFeatures();
   void OnFileAnalysisFinished(FileAnalyzer::Results results);
 
@@ -112,6 +134,11 @@ class FileAnalyzer {
   base::FilePath target_path_;
   base::FilePath tmp_path_;
   std::optional<std::string> password_;
+  std::string sha256_hash_;
+  int64_t size_ = 0;
+  // Whether the current analysis is answered from the archive results cache,
+  // in which case the analysis metrics are not recorded again.
+  bool using_cached_results_ = false;
   scoped_refptr<BinaryFeatureExtractor> binary_feature_extractor_;
   base::OnceCallback<void(Results)> callback_;
   base::Time start_time_;
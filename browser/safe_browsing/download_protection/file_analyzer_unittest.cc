@@ -52,7 +52,39 @@ class FileAnalyzerTest : public testing::Test {
     ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
   }
 
-  void TearDown() override {}
+  void TearDown() override {
+    FileAnalyzer::ClearArchiveResultsCacheForTesting();
+  }
+
+  // Writes a ZIP containing a single file named |file_name| to |zip_path|.
+  void WriteZipWithFile(const base::FilePath& zip_path,
+                        const base::FilePath::StringType& file_name) {
+    base::ScopedTempDir zip_source_dir;
+    ASSERT_TRUE(zip_source_dir.CreateUniqueTempDir());
+    ASSERT_TRUE(base::WriteFile(zip_source_dir.GetPath().Append(file_name),
+                                "dummy file"));
+    ASSERT_TRUE(zip::Zip(zip_source_dir.GetPath(), zip_path,
+                         /* include_hidden_files= */ false));
+  }
+
+  // Analyzes |tmp_path| as a download of |target_path| and waits for the
+  // results.
+  void RunAnalyzer(const base::FilePath& target_path,
+                   const base::FilePath& tmp_path,
+                   base::optional_ref<const std::string> password,
+                   const std::string& sha256_hash) {
+    scoped_refptr<MockBinaryFeatureExtractor> extractor =
+        new testing::StrictMock<MockBinaryFeatureExtractor>();
+    FileAnalyzer analyzer(extractor);
+    analyzer.SetContentDigest(sha256_hash, /*size=*/1024);
+    base::RunLoop run_loop;
+    has_result_ = false;
+    analyzer.Start(
+        target_path, tmp_path, password,
+        base::BindOnce(&FileAnalyzerTest::DoneCallback, base::Unretained(this),
+                       run_loop.QuitClosure()));
+    run_loop.Run();
+  }
 
  protected:
   bool has_result_;
@@ -1053,4 +1085,53 @@ TEST_F(FileAnalyzerTest, ZeroLengthSevenZipEntriesSupported) {
   EXPECT_EQ(result_.archived_binaries[1].length(), 0);
 }
 
+TEST_F(FileAnalyzerTest, ReusesCachedArchiveResultsForSameDigest) {
+  base::FilePath target_path(FILE_PATH_LITERAL("target.zip"));
+  base::FilePath tmp_path =
+      temp_dir_.GetPath().Append(FILE_PATH_LITERAL("tmp.crdownload"));
+  WriteZipWithFile(tmp_path, FILE_PATH_LITERAL("file.exe"));
+
+  RunAnalyzer(target_path, tmp_path, /*password=*/std::nullopt, "digest");
+  ASSERT_TRUE(has_result_);
+  EXPECT_EQ(result_.type, ClientDownloadRequest::ZIPPED_EXECUTABLE);
+
+  // Replace the file contents. Since the digest is the same, the results of
+  // the first analysis are reused instead of analyzing the new contents.
+  WriteZipWithFile(tmp_path, FILE_PATH_LITERAL("file.txt"));
+  base::HistogramTester histograms;
+  RunAnalyzer(target_path, tmp_path, /*password=*/std::nullopt, "digest");
+  ASSERT_TRUE(has_result_);
+  EXPECT_EQ(result_.type, ClientDownloadRequest::ZIPPED_EXECUTABLE);
+  EXPECT_TRUE(result_.archived_executable);
+  EXPECT_EQ(result_.archive_summary.file_count(), 1);
+  // The cached results were recorded by the first analysis.
+  histograms.ExpectTotalCount("SBClientDownload.ZipArchiveAnalysisResult", 0);
+  histograms.ExpectTotalCount("SBClientDownload.FileAnalysisDuration", 0);
+  histograms.ExpectTotalCount("SBClientDownload.FileAnalysisDuration.Zip", 0);
+
+  // A different digest is analyzed again.
+  RunAnalyzer(target_path, tmp_path, /*password=*/std::nullopt,
+              "other_digest");
+  ASSERT_TRUE(has_result_);
+  EXPECT_FALSE(result_.archived_executable);
+  histograms.ExpectUniqueSample("SBClientDownload.ZipArchiveAnalysisResult",
+                                ArchiveAnalysisResult::kValid, 1);
+}
+
+TEST_F(FileAnalyzerTest, DoesNotCacheArchiveResultsWithPassword) {
+  base::FilePath target_path(FILE_PATH_LITERAL("target.zip"));
+  base::FilePath tmp_path =
+      temp_dir_.GetPath().Append(FILE_PATH_LITERAL("tmp.crdownload"));
+  WriteZipWithFile(tmp_path, FILE_PATH_LITERAL("file.exe"));
+
+  RunAnalyzer(target_path, tmp_path, std::string("password"), "digest");
+  ASSERT_TRUE(has_result_);
+  EXPECT_EQ(result_.type, ClientDownloadRequest::ZIPPED_EXECUTABLE);
+
+  WriteZipWithFile(tmp_path, FILE_PATH_LITERAL("file.txt"));
+  RunAnalyzer(target_path, tmp_path, /*password=*/std::nullopt, "digest");
+  ASSERT_TRUE(has_result_);
+  EXPECT_FALSE(result_.archived_executable);
+}
+
 }  // namespace safe_browsing
@@ -6,6 +6,7 @@
 
 #include "base/check.h"
 #include "base/containers/fixed_flat_map.h"
+#include "base/files/file.h"
 #include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
 #include "base/metrics/histogram_functions.h"
@@ -27,6 +28,9 @@ constexpr int64_t kMaxFileSizeBytes = 100 * 1024;
 // Max number of files to read per extension.
 constexpr int64_t kMaxFilesToRead = 1000;
 
+// Max number of extensions whose file hashes are cached between passes.
+constexpr size_t kMaxCachedExtensions = 100;
+
 constexpr base::FilePath::CharType kManifestFilePath[] =
     FILE_PATH_LITERAL("manifest.json");
 constexpr base::FilePath::CharType kJSFileSuffix[] = FILE_PATH_LITERAL(".js");
@@ -87,7 +91,8 @@ ExtensionTelemetryFileProcessor::~ExtensionTelemetryFileProcessor() = default;
 ExtensionTelemetryFileProcessor::ExtensionTelemetryFileProcessor()
     : max_files_to_process_(kMaxFilesToProcess),
       max_file_size_(kMaxFileSizeBytes),
-      max_files_to_read_(kMaxFilesToRead) {}
+      max_files_to_read_(kMaxFilesToRead),
+      hash_cache_(kMaxCachedExtensions) {}
 
 base::Value::Dict ExtensionTelemetryFileProcessor::ProcessExtension(
     const base::FilePath& root_dir) {
@@ -168,28 +173,60 @@ base::Value::Dict ExtensionTelemetryFileProcessor::ComputeHashes(
     const SortedFilePaths& file_paths) {
   base::Value::Dict extension_data;
 
+  // Hashes from the previous pass over this extension. Entries for files that
+  // are no longer selected are dropped by replacing the cache entry below.
+  FileHashCache previous_hashes;
+  auto cache_it = hash_cache_.Get(root_dir);
+  if (cache_it != hash_cache_.end()) {
+    previous_hashes = std::move(cache_it->second);
+  }
+  FileHashCache current_hashes;
+
   for (const auto& full_path : file_paths) {
     if (extension_data.size() >= max_files_to_process_) {
       break;
     }
 
-    std::string file_contents;
-    base::ReadFileToString(full_path, &file_contents);
-
     // Use relative path as key since file names can repeat.
     base::FilePath relative_path;
     root_dir.AppendRelativePath(full_path, &relative_path);
 
-    std::string hash = crypto::SHA256HashString(file_contents);
-    std::string hex_encode = base::HexEncode(hash);
+    base::File::Info file_info;
+    if (!base::GetFileInfo(full_path, &file_info)) {
+      continue;
+    }
+
+    CachedFileHash cached_hash;
+    auto previous_it = previous_hashes.find(relative_path);
+    if (previous_it != previous_hashes.end() &&
+        previous_it->second.size == file_info.size &&
+        previous_it->second.last_modified == file_info.last_modified) {
+      cached_hash = std::move(previous_it->second);
+    } else {
+      // Skip files that cannot be read in full, rather than caching the hash
+      // of a partial read until the file changes.
+      std::string file_contents;
+      if (!base::ReadFileToString(full_path, &file_contents)) {
+        continue;
+      }
+      num_files_hashed_++;
+
+      cached_hash.size = file_info.size;
+      cached_hash.last_modified = file_info.last_modified;
+      cached_hash.hash =
+          base::HexEncode(crypto::SHA256HashString(file_contents));
+    }
 
     extension_data.Set(
         relative_path.NormalizePathSeparatorsTo('/').AsUTF8Unsafe(),
-        std::move(hex_encode));
+        cached_hash.hash);
 
-    RecordProcessedFileSize(file_contents.size());
+    RecordProcessedFileSize(cached_hash.size);
+    current_hashes.emplace(std::move(relative_path), std::move(cached_hash));
   }
 
+  hash_cache_.Put(root_dir, std::move(current_hashes));
+
   RecordNumFilesOverProcessingLimit(
       std::max(0, static_cast<int>(file_paths.size() - max_files_to_process_)));
   return extension_data;
@@ -206,6 +243,7 @@ void ExtensionTelemetryFileProcessor::SetMaxFilesToProcessForTest(
     int64_t max_files_to_process) {
   max_files_to_process_ = max_files_to_process;
 }
+
 void ExtensionTelemetryFileProcessor::SetMaxFileSizeBytesForTest(
     int64_t max_file_size) {
   max_file_size_ = max_file_size;
@@ -216,4 +254,8 @@ void ExtensionTelemetryFileProcessor::SetMaxFilesToReadForTest(
   max_files_to_read_ = max_files_to_read;
 }
 
+size_t ExtensionTelemetryFileProcessor::GetNumFilesHashedForTest() const {
+  return num_files_hashed_;
+}
+
 }  // namespace safe_browsing
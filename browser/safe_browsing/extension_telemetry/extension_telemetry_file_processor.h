@@ -5,10 +5,15 @@
 #ifndef CHROME_BROWSER_SAFE_BROWSING_EXTENSION_TELEMETRY_EXTENSION_TELEMETRY_FILE_PROCESSOR_H_
 #define CHROME_BROWSER_SAFE_BROWSING_EXTENSION_TELEMETRY_EXTENSION_TELEMETRY_FILE_PROCESSOR_H_
 
+#include <string>
+
+#include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
+#include "base/containers/lru_cache.h"
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
+#include "base/time/time.h"
 #include "base/values.h"
 
 namespace base {
@@ -43,15 +48,32 @@ class ExtensionTelemetryFileProcessor {
   // <manifest.json, file contents>
   // Each file path is relative starting from the extension root. Manifest.json
   // file is unhashed.
+  // File hashes are cached across calls, so only files that are new or whose
+  // size or last modified time changed since the previous pass are re-read.
   base::Value::Dict ProcessExtension(const base::FilePath& root_dir);
 
   void SetMaxFilesToProcessForTest(int64_t max_files_to_process);
   void SetMaxFileSizeBytesForTest(int64_t max_file_size);
   void SetMaxFilesToReadForTest(int64_t max_files_to_read);
 
+  // Returns the number of extension files fully read and hashed since this
+  // object was created.
+  size_t GetNumFilesHashedForTest() const;
+
  protected:
   struct FileExtensionsComparator;
 
+  // Hash of a file along with the file attributes it was computed from. A
+  // cached hash is only reused when both attributes are unchanged.
+  struct CachedFileHash {
+    int64_t size = 0;
+    base::Time last_modified;
+    std::string hash;
+  };
+
+  // <relative file path, cached hash> for a single extension root.
+  using FileHashCache = base::flat_map<base::FilePath, CachedFileHash>;
+
   using SortedFilePaths =
       base::flat_set<base::FilePath, FileExtensionsComparator>;
 
@@ -65,7 +87,9 @@ class ExtensionTelemetryFileProcessor {
   SortedFilePaths RetrieveFilePaths(const base::FilePath& root_dir);
 
   // Hashes the given list of extension files and returns a Dict of <relative
-  // file path, file hash> until |max_files_to_process_| is reached.
+  // file path, file hash> until |max_files_to_process_| is reached. Hashes in
+  // |hash_cache_| are reused for files whose size and last modified time have
+  // not changed.
   base::Value::Dict ComputeHashes(const base::FilePath& root_dir,
                                   const SortedFilePaths& file_paths);
 
@@ -82,6 +106,15 @@ class ExtensionTelemetryFileProcessor {
   // files.
   int64_t max_files_to_read_;
 
+  // File hashes from previous passes, keyed by extension root directory.
+  // Installed extensions live in a <extension id>/<version> directory, so the
+  // root directory identifies both the extension and its version; a version
+  // update starts with an empty cache.
+  base::LRUCache<base::FilePath, FileHashCache> hash_cache_;
+
+  // Number of files read and hashed, used to verify caching in tests.
+  size_t num_files_hashed_ = 0;
+
   SEQUENCE_CHECKER(sequence_checker_);
 
   base::WeakPtrFactory<ExtensionTelemetryFileProcessor> weak_factory_{this};
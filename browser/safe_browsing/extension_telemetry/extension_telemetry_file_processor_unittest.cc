@@ -12,6 +12,8 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/task/thread_pool.h"
 #include "base/threading/sequence_bound.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
 #include "content/public/test/browser_task_environment.h"
 #include "crypto/sha2.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -99,6 +101,28 @@ class ExtensionTelemetryFileProcessorTest : public ::testing::Test {
     extensions_data_ = std::move(data);
   }
 
+  void ProcessExtensionAndWait() {
+    processor_.AsyncCall(&ExtensionTelemetryFileProcessor::ProcessExtension)
+        .WithArgs(extension_root_dir_)
+        .Then(base::BindOnce(
+            &ExtensionTelemetryFileProcessorTest::CallbackHelper,
+            weak_factory_.GetWeakPtr()));
+    task_environment_.RunUntilIdle();
+  }
+
+  size_t GetNumFilesHashed() {
+    size_t num_files_hashed = 0;
+    processor_
+        .AsyncCall(&ExtensionTelemetryFileProcessor::GetNumFilesHashedForTest)
+        .Then(base::BindOnce(
+            [](size_t* out, size_t num_files_hashed) {
+              *out = num_files_hashed;
+            },
+            &num_files_hashed));
+    task_environment_.RunUntilIdle();
+    return num_files_hashed;
+  }
+
   void TearDown() override {
     processor_.SynchronouslyResetForTest();
     testing::Test::TearDown();
@@ -377,4 +401,82 @@ TEST_F(ExtensionTelemetryFileProcessorTest,
   EXPECT_EQ(extensions_data_, expected_dict);
 }
 
+TEST_F(ExtensionTelemetryFileProcessorTest, ReusesHashesForUnchangedFiles) {
+  SetUpExtensionFiles();
+
+  ProcessExtensionAndWait();
+  base::Value::Dict first_pass_data = extensions_data_.Clone();
+  // All 6 applicable files are read on the first pass.
+  EXPECT_EQ(GetNumFilesHashed(), 6u);
+
+  // The second pass over the unchanged extension reads no files.
+  ProcessExtensionAndWait();
+  EXPECT_EQ(GetNumFilesHashed(), 6u);
+  EXPECT_EQ(extensions_data_, first_pass_data);
+}
+
+TEST_F(ExtensionTelemetryFileProcessorTest, RehashesModifiedAndNewFiles) {
+  SetUpExtensionFiles();
+  ProcessExtensionAndWait();
+  EXPECT_EQ(GetNumFilesHashed(), 6u);
+
+  // Modify one file and add a new one.
+  constexpr char kModifiedContent[] = "modified content";
+  base::FilePath modified_file =
+      extension_root_dir_.AppendASCII(kJavaScriptFile1);
+  WriteExtensionFile(extension_root_dir_, kJavaScriptFile1, kModifiedContent);
+  base::Time new_time = base::Time::Now() + base::Hours(1);
+  ASSERT_TRUE(base::TouchFile(modified_file, new_time, new_time));
+  WriteExtensionFile(extension_root_dir_, "js_file_3.js", "js_file_3.js");
+
+  ProcessExtensionAndWait();
+  EXPECT_EQ(GetNumFilesHashed(), 8u);
+
+  base::Value::Dict expected_dict;
+  expected_dict.Set(kManifestFile, kManifestFile);
+  expected_dict.Set(kJavaScriptFile1, HashContent(kModifiedContent));
+  expected_dict.Set(kJavaScriptFile2, HashContent(kJavaScriptFile2));
+  expected_dict.Set("js_file_3.js", HashContent("js_file_3.js"));
+  expected_dict.Set(kExtensionSubDirHTMLFile1, HashContent(kHTMLFile1));
+  expected_dict.Set(kExtensionSubDirHTMLFile2, HashContent(kHTMLFile2));
+  expected_dict.Set(kExtensionSubDirCSSFile1, HashContent(kCSSFile1));
+  expected_dict.Set(kExtensionSubDirCSSFile2, HashContent(kCSSFile2));
+  EXPECT_EQ(extensions_data_, expected_dict);
+}
+
+#if BUILDFLAG(IS_POSIX)
+TEST_F(ExtensionTelemetryFileProcessorTest, SkipsUnreadableFiles) {
+  SetUpExtensionFiles();
+  base::FilePath unreadable_file =
+      extension_root_dir_.AppendASCII(kJavaScriptFile1);
+  ASSERT_TRUE(base::SetPosixFilePermissions(unreadable_file, 0));
+  if (base::PathIsReadable(unreadable_file)) {
+    GTEST_SKIP() << "File permissions are not enforced for this user.";
+  }
+
+  // The unreadable file is left out, and its hash is not cached.
+  ProcessExtensionAndWait();
+  EXPECT_EQ(GetNumFilesHashed(), 5u);
+  EXPECT_FALSE(extensions_data_.contains(kJavaScriptFile1));
+
+  // Once the file can be read again, it is hashed even though its size and
+  // modification time did not change.
+  ASSERT_TRUE(base::SetPosixFilePermissions(
+      unreadable_file, base::FILE_PERMISSION_READ_BY_USER |
+                           base::FILE_PERMISSION_WRITE_BY_USER));
+  ProcessExtensionAndWait();
+  EXPECT_EQ(GetNumFilesHashed(), 6u);
+
+  base::Value::Dict expected_dict;
+  expected_dict.Set(kManifestFile, kManifestFile);
+  expected_dict.Set(kJavaScriptFile1, HashContent(kJavaScriptFile1));
+  expected_dict.Set(kJavaScriptFile2, HashContent(kJavaScriptFile2));
+  expected_dict.Set(kExtensionSubDirHTMLFile1, HashContent(kHTMLFile1));
+  expected_dict.Set(kExtensionSubDirHTMLFile2, HashContent(kHTMLFile2));
+  expected_dict.Set(kExtensionSubDirCSSFile1, HashContent(kCSSFile1));
+  expected_dict.Set(kExtensionSubDirCSSFile2, HashContent(kCSSFile2));
+  EXPECT_EQ(extensions_data_, expected_dict);
+}
+#endif  // BUILDFLAG(IS_POSIX)
+
 }  // namespace safe_browsing
@@ -11,6 +11,7 @@
 #include <optional>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/barrier_closure.h"
@@ -25,6 +26,7 @@
 #include "base/logging.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/strings/string_util.h"
+#include "base/system/sys_info.h"
 #include "base/task/bind_post_task.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool.h"
@@ -59,6 +61,20 @@ base::FilePath CreateTempDirForOutput() {
   return temp_dir.Take();
 }
 
+SupportToolHandler::RedactionToolWorker::RedactionToolWorker(
+    scoped_refptr<base::SequencedTaskRunner> task_runner,
+    scoped_refptr<redaction::RedactionToolContainer> container)
+    : task_runner(std::move(task_runner)), container(std::move(container)) {}
+
+SupportToolHandler::RedactionToolWorker::RedactionToolWorker(
+    const RedactionToolWorker&) = default;
+
+SupportToolHandler::RedactionToolWorker&
+SupportToolHandler::RedactionToolWorker::operator=(const RedactionToolWorker&) =
+    default;
+
+SupportToolHandler::RedactionToolWorker::~RedactionToolWorker() = default;
+
 SupportToolHandler::SupportToolHandler()
     : SupportToolHandler(/*case_id=*/std::string(),
                          /*email_address=*/std::string(),
@@ -67,15 +83,7 @@ SupportToolHandler::SupportToolHandler()
 SupportToolHandler::SupportToolHandler(std::string case_id,
                                        std::string email_address,
                                        std::string issue_description)
-    : metadata_(case_id, email_address, issue_description),
-      task_runner_for_redaction_tool_(
-          base::ThreadPool::CreateSequencedTaskRunner(
-              {base::TaskPriority::USER_VISIBLE,
-               base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN})),
-      redaction_tool_container_(
-          base::MakeRefCounted<redaction::RedactionToolContainer>(
-              task_runner_for_redaction_tool_,
-              nullptr)) {}
+    : metadata_(case_id, email_address, issue_description) {}
 
 SupportToolHandler::~SupportToolHandler() {
   CleanUp();
@@ -116,6 +124,11 @@ SupportToolHandler::GetDataCollectorsForTesting() {
   return data_collectors_;
 }
 
+void SupportToolHandler::SetRedactionWorkerCountForTesting(size_t count) {
+  CHECK_IS_TEST();
+  redaction_worker_count_for_testing_ = count;
+}
+
 void SupportToolHandler::CollectSupportData(
     SupportToolDataCollectedCallback on_data_collection_done_callback) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
@@ -132,21 +145,49 @@ void SupportToolHandler::CollectSupportData(
 
   data_collection_timestamp_ = base::Time::NowFromSystemTime();
 
-  for (auto& data_collector : data_collectors_) {
-    // DataCollectors will use `redaction_tool_container_` on
-    // `task_runner_for_redaction_tool_` to redact PII from the collected logs.
-    // All DataCollectors will use the same RedactionTool instance on the same
-    // task runner as we need to replace the same PII data with the same
-    // place-holder strings (that are stored in RedactionTool instance's data
-    // member) in all collected logs to avoid confusing the reader.
-    data_collector->CollectDataAndDetectPII(
+  // DataCollectors only detect PII here, which doesn't depend on the
+  // placeholders a RedactionTool has handed out, so they can detect it in
+  // parallel.
+  CreateRedactionWorkers();
+  for (size_t i = 0; i < data_collectors_.size(); ++i) {
+    const RedactionToolWorker& worker = GetRedactionWorker(i);
+    data_collectors_[i]->CollectDataAndDetectPII(
         base::BindOnce(&SupportToolHandler::OnDataCollected,
                        weak_ptr_factory_.GetWeakPtr(),
                        collect_data_barrier_closure),
-        task_runner_for_redaction_tool_, redaction_tool_container_);
+        worker.task_runner, worker.container);
   }
 }
 
+// static
+SupportToolHandler::RedactionToolWorker
+SupportToolHandler::CreateRedactionWorker() {
+  scoped_refptr<base::SequencedTaskRunner> task_runner =
+      base::ThreadPool::CreateSequencedTaskRunner(
+          {base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN});
+  return RedactionToolWorker(
+      task_runner, base::MakeRefCounted<redaction::RedactionToolContainer>(
+                       task_runner, nullptr));
+}
+
+void SupportToolHandler::CreateRedactionWorkers() {
+  DCHECK(redaction_workers_.empty());
+  const size_t max_workers =
+      redaction_worker_count_for_testing_.value_or(std::min<size_t>(
+          base::SysInfo::NumberOfProcessors(), kMaxRedactionWorkers));
+  const size_t num_workers = std::clamp<size_t>(
+      std::min(data_collectors_.size(), max_workers), 1, kMaxRedactionWorkers);
+  for (size_t i = 0; i < num_workers; ++i) {
+    redaction_workers_.push_back(CreateRedactionWorker());
+  }
+}
+
+const SupportToolHandler::RedactionToolWorker&
+SupportToolHandler::GetRedactionWorker(size_t index) const {
+  return redaction_workers_[index % redaction_workers_.size()];
+}
+
 void SupportToolHandler::OnDataCollected(
     base::RepeatingClosure barrier_closure,
     std::optional<SupportToolError> error) {
@@ -163,6 +204,7 @@ void SupportToolHandler::AddDetectedPII(const PIIMap& pii_map) {
 
 void SupportToolHandler::OnAllDataCollected() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  redaction_workers_.clear();
   for (auto& data_collector : data_collectors_) {
     AddDetectedPII(data_collector->GetDetectedPII());
   }
@@ -222,10 +264,14 @@ void SupportToolHandler::ExportIntoTempDir(
                      weak_ptr_factory_.GetWeakPtr(), temp_dir_, target_path,
                      pii_types_to_keep));
 
+  // The same PII must be replaced with the same placeholder string in all
+  // collected logs to avoid confusing the reader. A RedactionTool hands out
+  // placeholders as it comes across the PII, and some PII is only recognized
+  // in context, so all DataCollectors redact with a single RedactionTool.
+  const RedactionToolWorker worker = CreateRedactionWorker();
   for (auto& data_collector : data_collectors_) {
     data_collector->ExportCollectedDataWithPII(
-        pii_types_to_keep, temp_dir_, task_runner_for_redaction_tool_,
-        redaction_tool_container_,
+        pii_types_to_keep, temp_dir_, worker.task_runner, worker.container,
         base::BindOnce(&SupportToolHandler::OnDataCollectorDoneExporting,
                        weak_ptr_factory_.GetWeakPtr(),
                        export_data_barrier_closure));
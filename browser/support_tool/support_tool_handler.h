@@ -5,6 +5,8 @@
 #ifndef CHROME_BROWSER_SUPPORT_TOOL_SUPPORT_TOOL_HANDLER_H_
 #define CHROME_BROWSER_SUPPORT_TOOL_SUPPORT_TOOL_HANDLER_H_
 
+#include <stddef.h>
+
 #include <memory>
 #include <optional>
 #include <set>
@@ -72,6 +74,10 @@ using SupportToolDataExportedCallback =
 
 class SupportToolHandler {
  public:
+  // The maximum number of RedactionTool instances that DataCollectors detect
+  // PII with in parallel.
+  static constexpr size_t kMaxRedactionWorkers = 4;
+
   // Intended to be used for unit tests. Initializes `case_id_`,
   // `email_address_` and `issue_description_` as empty string.
   SupportToolHandler();
@@ -110,7 +116,35 @@ class SupportToolHandler {
   const std::vector<std::unique_ptr<DataCollector>>&
   GetDataCollectorsForTesting();
 
+  // Makes data collection use `count` RedactionTools, or one per DataCollector
+  // if there are fewer DataCollectors, regardless of the number of processors.
+  void SetRedactionWorkerCountForTesting(size_t count);
+
  private:
+  // A RedactionTool and the sequence it is used on.
+  struct RedactionToolWorker {
+    RedactionToolWorker(
+        scoped_refptr<base::SequencedTaskRunner> task_runner,
+        scoped_refptr<redaction::RedactionToolContainer> container);
+    RedactionToolWorker(const RedactionToolWorker&);
+    RedactionToolWorker& operator=(const RedactionToolWorker&);
+    ~RedactionToolWorker();
+
+    scoped_refptr<base::SequencedTaskRunner> task_runner;
+    scoped_refptr<redaction::RedactionToolContainer> container;
+  };
+
+  // Returns a new RedactionTool on a sequence of its own.
+  static RedactionToolWorker CreateRedactionWorker();
+
+  // Fills `redaction_workers_` with one worker per processor, or as many as
+  // set by SetRedactionWorkerCountForTesting(), but no more than one per
+  // DataCollector or `kMaxRedactionWorkers`.
+  void CreateRedactionWorkers();
+
+  // Returns the worker that `data_collectors_[index]` uses.
+  const RedactionToolWorker& GetRedactionWorker(size_t index) const;
+
   // OnDataCollected is called when a single DataCollector finished collecting
   // data. Runs `barrier_closure` to make the handler wait until all
   // DataCollectors finish collecting.
@@ -180,11 +214,11 @@ class SupportToolHandler {
   // data export is done or on destruction of the SupportToolHandler instance if
   // it hasn't been removed before.
   base::FilePath temp_dir_;
-  // SequencedTaskRunner and RedactionToolContainer for the data collectors that
-  // will need to use redaction::RedactionTool for masking PII from the
-  // collected logs.
-  scoped_refptr<base::SequencedTaskRunner> task_runner_for_redaction_tool_;
-  scoped_refptr<redaction::RedactionToolContainer> redaction_tool_container_;
+  // The RedactionTools that DataCollectors detect PII with during data
+  // collection, spread over them round-robin. They are released once all
+  // DataCollectors are done collecting.
+  std::vector<RedactionToolWorker> redaction_workers_;
+  std::optional<size_t> redaction_worker_count_for_testing_;
   base::WeakPtrFactory<SupportToolHandler> weak_ptr_factory_{this};
 };
 
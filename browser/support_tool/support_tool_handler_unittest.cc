@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <map>
 #include <memory>
 #include <optional>
 #include <set>
@@ -18,6 +19,7 @@
 #include "base/functional/bind.h"
 #include "base/functional/callback.h"
 #include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
 #include "base/task/bind_post_task.h"
 #include "base/task/sequenced_task_runner.h"
 #include "base/task/single_thread_task_runner.h"
@@ -27,6 +29,7 @@
 #include "base/test/test_future.h"
 #include "chrome/browser/support_tool/data_collector.h"
 #include "components/feedback/redaction_tool/pii_types.h"
+#include "components/feedback/redaction_tool/redaction_tool.h"
 #include "testing/gmock/include/gmock/gmock-matchers.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/zlib/google/zip_reader.h"
@@ -36,8 +39,11 @@
 #include "chromeos/ash/components/system/statistics_provider.h"
 #endif  // BUILDFLAG(IS_CHROMEOS_ASH)
 
+using testing::HasSubstr;
 using testing::IsSupersetOf;
+using testing::Not;
 using testing::Pair;
+using testing::SizeIs;
 using testing::UnorderedElementsAre;
 
 const char kTestDataToWriteOnFile[] = "fake data to write to file for testing";
@@ -122,6 +128,107 @@ class TestDataCollector : public DataCollector {
   base::WeakPtrFactory<TestDataCollector> weak_ptr_factory_{this};
 };
 
+// Returns the log of the `index`th DataCollector. Some of its PII also appears
+// in the logs of the other DataCollectors and some is its own, including PII
+// that a RedactionTool only recognizes by the text around it.
+std::string CreateSyntheticLog(int index) {
+  std::string log;
+  for (int i = 0; i < 500; ++i) {
+    log += base::StringPrintf("Line %d: message sent to user%d@example.com\n",
+                              i, (i + 7 * index) % 60);
+    log += base::StringPrintf("Line %d: connected to 192.168.%d.%d\n", i,
+                              index, i % 20);
+    log += base::StringPrintf("Line %d: device aa:bb:cc:%02x:00:%02x\n", i,
+                              index, i % 16);
+    log += base::StringPrintf("Line %d: Cell ID: '%04X'\n", i,
+                              (index * 100 + i % 10) & 0xFFFF);
+    log += base::StringPrintf("Line %d: SSID: 'network-%d-%d'\n", i, index,
+                              i % 5);
+    log += base::StringPrintf("Line %d: serial_number: \"SN%02d%03d\"\n", i,
+                              index, i % 4);
+  }
+  return log;
+}
+
+// RedactingTestDataCollector detects and redacts PII in `log_` with the
+// RedactionTool it is given, the way the real DataCollectors do, and records
+// which RedactionTool that was.
+class RedactingTestDataCollector : public DataCollector {
+ public:
+  RedactingTestDataCollector(std::string name, std::string log)
+      : name_(std::move(name)), log_(std::move(log)) {}
+  ~RedactingTestDataCollector() override = default;
+
+  // Overrides from DataCollector.
+  std::string GetName() const override { return name_; }
+
+  std::string GetDescription() const override {
+    return "The data collector that will be used for testing redaction";
+  }
+
+  const PIIMap& GetDetectedPII() override { return pii_map_; }
+
+  void CollectDataAndDetectPII(
+      DataCollectorDoneCallback on_data_collected_callback,
+      scoped_refptr<base::SequencedTaskRunner> task_runner_for_redaction_tool,
+      scoped_refptr<redaction::RedactionToolContainer> redaction_tool_container)
+      override {
+    detection_tool_container_ = redaction_tool_container;
+    task_runner_for_redaction_tool->PostTaskAndReplyWithResult(
+        FROM_HERE,
+        base::BindOnce(
+            [](scoped_refptr<redaction::RedactionToolContainer> container,
+               std::string log) { return container->Get()->Detect(log); },
+            redaction_tool_container, log_),
+        base::BindOnce(&RedactingTestDataCollector::OnPIIDetected,
+                       weak_ptr_factory_.GetWeakPtr(),
+                       std::move(on_data_collected_callback)));
+  }
+
+  void ExportCollectedDataWithPII(
+      std::set<redaction::PIIType> pii_types_to_keep,
+      base::FilePath target_directory,
+      scoped_refptr<base::SequencedTaskRunner> task_runner_for_redaction_tool,
+      scoped_refptr<redaction::RedactionToolContainer> redaction_tool_container,
+      DataCollectorDoneCallback on_exported_callback) override {
+    export_tool_container_ = redaction_tool_container;
+    task_runner_for_redaction_tool->PostTaskAndReply(
+        FROM_HERE,
+        base::BindOnce(
+            [](scoped_refptr<redaction::RedactionToolContainer> container,
+               std::set<redaction::PIIType> pii_types_to_keep,
+               base::FilePath target_file, std::string log) {
+              base::WriteFile(target_file,
+                              container->Get()->RedactAndKeepSelected(
+                                  log, pii_types_to_keep));
+            },
+            redaction_tool_container, std::move(pii_types_to_keep),
+            target_directory.AppendASCII(name_), log_),
+        base::BindOnce(std::move(on_exported_callback), std::nullopt));
+  }
+
+  const redaction::RedactionToolContainer* detection_tool_container() const {
+    return detection_tool_container_.get();
+  }
+
+  const redaction::RedactionToolContainer* export_tool_container() const {
+    return export_tool_container_.get();
+  }
+
+ private:
+  void OnPIIDetected(DataCollectorDoneCallback callback, PIIMap pii_map) {
+    pii_map_ = std::move(pii_map);
+    std::move(callback).Run(std::nullopt);
+  }
+
+  std::string name_;
+  std::string log_;
+  PIIMap pii_map_;
+  scoped_refptr<redaction::RedactionToolContainer> detection_tool_container_;
+  scoped_refptr<redaction::RedactionToolContainer> export_tool_container_;
+  base::WeakPtrFactory<RedactingTestDataCollector> weak_ptr_factory_{this};
+};
+
 class SupportToolHandlerTest : public ::testing::Test {
  public:
   SupportToolHandlerTest() = default;
@@ -148,7 +255,7 @@ class SupportToolHandlerTest : public ::testing::Test {
   // Returns the contents of `zip_file` as a map [filename -> file contents].
   std::map<std::string, std::string> ReadZipFileContents(
       base::FilePath zip_file) {
-    const int64_t kMaxEntrySize = 10 * 1024;
+    const int64_t kMaxEntrySize = 1024 * 1024;
     std::map<std::string, std::string> result;
     zip::ZipReader reader;
     if (!reader.Open(zip_file)) {
@@ -177,6 +284,70 @@ class SupportToolHandlerTest : public ::testing::Test {
  protected:
   base::FilePath GetPathForOutput() { return temp_dir_.GetPath(); }
 
+  // Collects and exports `logs`, one per DataCollector, with `worker_count`
+  // RedactionTools. Returns the redacted logs in the support packet and adds the
+  // RedactionTools that were used to `detection_tools` and `export_tools`.
+  std::map<std::string, std::string> CollectAndExportRedactedLogs(
+      const std::vector<std::string>& logs,
+      size_t worker_count,
+      std::set<const redaction::RedactionToolContainer*>& detection_tools,
+      std::set<const redaction::RedactionToolContainer*>& export_tools) {
+    SupportToolHandler handler;
+    handler.SetRedactionWorkerCountForTesting(worker_count);
+    std::vector<RedactingTestDataCollector*> data_collectors;
+    for (size_t i = 0; i < logs.size(); ++i) {
+      auto data_collector = std::make_unique<RedactingTestDataCollector>(
+          base::StringPrintf("test_data_collector_%zu", i), logs[i]);
+      data_collectors.push_back(data_collector.get());
+      handler.AddDataCollector(std::move(data_collector));
+    }
+
+    base::test::TestFuture<PIIMap, std::set<SupportToolError>> collect_future;
+    handler.CollectSupportData(
+        collect_future
+            .GetCallback<const PIIMap&, std::set<SupportToolError>>());
+    EXPECT_TRUE(collect_future.Get<1>().empty());
+    const PIIMap& detected_pii = collect_future.Get<0>();
+    EXPECT_TRUE(detected_pii.contains(redaction::PIIType::kEmail));
+
+    base::FilePath target_path = GetPathForOutput().AppendASCII(
+        base::StringPrintf("support-tool-export-%zu", worker_count));
+    base::test::TestFuture<base::FilePath, std::set<SupportToolError>>
+        export_future;
+    handler.ExportCollectedData(/*pii_types_to_keep=*/{}, target_path,
+                                export_future.GetCallback());
+    EXPECT_TRUE(export_future.Get<1>().empty());
+
+    for (const RedactingTestDataCollector* data_collector : data_collectors) {
+      detection_tools.insert(data_collector->detection_tool_container());
+      export_tools.insert(data_collector->export_tool_container());
+    }
+
+    std::map<std::string, std::string> zip_contents = ReadZipFileContents(
+        target_path.AddExtension(FILE_PATH_LITERAL(".zip")));
+    // The metadata file contains timestamps of the data collection.
+    zip_contents.erase("metadata.txt");
+    return zip_contents;
+  }
+
+  // Returns `logs` redacted the way SupportToolHandler redacted them before it
+  // used several RedactionTools: a single RedactionTool detects the PII in all
+  // the logs in order and then redacts them in the same order.
+  std::map<std::string, std::string> RedactLogsSerially(
+      const std::vector<std::string>& logs) {
+    redaction::RedactionTool redaction_tool(nullptr);
+    for (const std::string& log : logs) {
+      redaction_tool.Detect(log);
+    }
+    std::map<std::string, std::string> redacted_logs;
+    for (size_t i = 0; i < logs.size(); ++i) {
+      redacted_logs[base::StringPrintf("test_data_collector_%zu", i)] =
+          redaction_tool.RedactAndKeepSelected(logs[i],
+                                               /*pii_types_to_keep=*/{});
+    }
+    return redacted_logs;
+  }
+
  private:
   // The temporary directory that we'll store the output files.
   base::ScopedTempDir temp_dir_;
@@ -337,3 +508,40 @@ TEST_F(SupportToolHandlerTest, ErrorMessageOnExportSupportData) {
   // Metadata file should not be empty.
   EXPECT_FALSE(metadata_file_contents->second.empty());
 }
+
+// DataCollectors detect PII with several RedactionTools in parallel, but the
+// collected data must still be redacted exactly as a single RedactionTool
+// redacted it before, so that the same PII gets the same placeholder in all the
+// files of the support packet.
+TEST_F(SupportToolHandlerTest, ParallelRedactionKeepsPlaceholdersConsistent) {
+  constexpr int kNumCollectors = 8;
+  std::vector<std::string> logs;
+  for (int i = 0; i < kNumCollectors; ++i) {
+    logs.push_back(CreateSyntheticLog(i));
+  }
+
+  std::set<const redaction::RedactionToolContainer*> detection_tools;
+  std::set<const redaction::RedactionToolContainer*> export_tools;
+  std::map<std::string, std::string> parallel_output =
+      CollectAndExportRedactedLogs(
+          logs, SupportToolHandler::kMaxRedactionWorkers, detection_tools,
+          export_tools);
+  // Detection was spread over several RedactionTools, while all the logs were
+  // redacted by one.
+  EXPECT_THAT(detection_tools,
+              SizeIs(SupportToolHandler::kMaxRedactionWorkers));
+  EXPECT_THAT(export_tools, SizeIs(1));
+
+  // The output is byte-identical to the output of the serial redaction.
+  std::map<std::string, std::string> serial_output = RedactLogsSerially(logs);
+  EXPECT_THAT(serial_output, SizeIs(kNumCollectors));
+  EXPECT_EQ(serial_output, parallel_output);
+
+  // Each DataCollector had PII of its own, so their redacted logs differ.
+  ASSERT_TRUE(parallel_output.contains("test_data_collector_0"));
+  ASSERT_TRUE(parallel_output.contains("test_data_collector_1"));
+  EXPECT_NE(parallel_output["test_data_collector_0"],
+            parallel_output["test_data_collector_1"]);
+  EXPECT_THAT(parallel_output["test_data_collector_0"],
+              Not(HasSubstr("user0@example.com")));
+}
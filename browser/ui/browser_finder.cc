@@ -7,13 +7,11 @@
 #include <stdint.h>
 
 #include "base/containers/contains.h"
-#include "base/ranges/algorithm.h"
 #include "build/build_config.h"
 #include "build/chromeos_buildflags.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/ui/browser_list.h"
 #include "chrome/browser/ui/browser_window.h"
-#include "chrome/browser/ui/tab_contents/tab_contents_iterator.h"
 #include "chrome/browser/ui/tabs/tab_group_model.h"
 #include "chrome/browser/ui/tabs/tab_strip_model.h"
 #include "components/tab_groups/tab_group_id.h"
@@ -296,10 +294,12 @@ Browser* FindBrowserWithActiveWindow() {
 
 Browser* FindBrowserWithTab(const WebContents* web_contents) {
   DCHECK(web_contents);
-  auto& all_tabs = AllTabContentses();
-  auto it = base::ranges::find(all_tabs, web_contents);
-
-  return (it == all_tabs.end()) ? nullptr : it.browser();
+  TabStripModel* tab_strip_model =
+      TabStripModel::GetModelWithWebContents(web_contents);
+  return tab_strip_model
+             ? BrowserList::GetInstance()->GetBrowserWithTabStrip(
+                   tab_strip_model)
+             : nullptr;
 }
 
 Browser* FindBrowserWithGroup(tab_groups::TabGroupId group, Profile* profile) {
@@ -4,11 +4,86 @@
 
 #include "chrome/browser/ui/browser_finder.h"
 
+#include <memory>
+#include <vector>
+
+#include "base/memory/raw_ptr.h"
 #include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/browser_list.h"
+#include "chrome/browser/ui/browser_list_observer.h"
+#include "chrome/browser/ui/browser_window.h"
+#include "chrome/browser/ui/tabs/tab_enums.h"
+#include "chrome/browser/ui/tabs/tab_model.h"
 #include "chrome/browser/ui/tabs/tab_strip_model.h"
+#include "chrome/browser/ui/tabs/tab_strip_model_observer.h"
 #include "chrome/test/base/browser_with_test_window_test.h"
+#include "components/tab_groups/tab_group_id.h"
+#include "testing/gmock/include/gmock/gmock.h"
 
 using BrowserFinderTest = BrowserWithTestWindowTest;
+using testing::ElementsAre;
+
+namespace {
+
+// Looks up the browser of a tab while BrowserList notifies observers of a new
+// browser.
+class BrowserAddedObserver : public BrowserListObserver {
+ public:
+  explicit BrowserAddedObserver(content::WebContents* contents)
+      : contents_(contents) {
+    BrowserList::AddObserver(this);
+  }
+  ~BrowserAddedObserver() override { BrowserList::RemoveObserver(this); }
+
+  // BrowserListObserver:
+  void OnBrowserAdded(Browser* browser) override {
+    browser_with_contents_ = chrome::FindBrowserWithTab(contents_);
+    browser_with_tab_strip_ =
+        BrowserList::GetInstance()->GetBrowserWithTabStrip(
+            browser->tab_strip_model());
+  }
+
+  Browser* browser_with_contents() const { return browser_with_contents_; }
+  Browser* browser_with_tab_strip() const { return browser_with_tab_strip_; }
+
+ private:
+  const raw_ptr<content::WebContents> contents_;
+  raw_ptr<Browser> browser_with_contents_ = nullptr;
+  raw_ptr<Browser> browser_with_tab_strip_ = nullptr;
+};
+
+// Looks up the browsers of the tabs which a tab strip inserts or removes, while
+// it notifies observers.
+class TabStripChangeObserver : public TabStripModelObserver {
+ public:
+  // TabStripModelObserver:
+  void OnTabStripModelChanged(
+      TabStripModel* tab_strip_model,
+      const TabStripModelChange& change,
+      const TabStripSelectionChange& selection) override {
+    if (change.type() == TabStripModelChange::kInserted) {
+      for (const auto& contents : change.GetInsert()->contents) {
+        found_browsers_.push_back(
+            chrome::FindBrowserWithTab(contents.contents));
+      }
+    } else if (change.type() == TabStripModelChange::kRemoved) {
+      for (const auto& contents : change.GetRemove()->contents) {
+        found_browsers_.push_back(
+            chrome::FindBrowserWithTab(contents.contents));
+      }
+    }
+  }
+
+  const std::vector<raw_ptr<Browser, VectorExperimental>>& found_browsers()
+      const {
+    return found_browsers_;
+  }
+
+ private:
+  std::vector<raw_ptr<Browser, VectorExperimental>> found_browsers_;
+};
+
+}  // namespace
 
 TEST_F(BrowserFinderTest, ScheduledForDeletion) {
   EXPECT_EQ(1u, chrome::GetTotalBrowserCount());
@@ -26,3 +101,98 @@ TEST_F(BrowserFinderTest, ScheduledForDeletion) {
   EXPECT_EQ(1u, chrome::GetTotalBrowserCount());
   EXPECT_EQ(nullptr, chrome::FindBrowserWithProfile(profile()));
 }
+
+// Finds the browsers of tabs and groups across many windows, as tabs move
+// between them and close.
+TEST_F(BrowserFinderTest, ManyWindows) {
+  constexpr int kNumBrowsers = 10;
+  constexpr int kNumTabsPerBrowser = 10;
+  std::vector<std::unique_ptr<BrowserWindow>> windows;
+  std::vector<std::unique_ptr<Browser>> browsers;
+  for (int i = 0; i < kNumBrowsers; ++i) {
+    windows.push_back(CreateBrowserWindow());
+    browsers.push_back(CreateBrowser(profile(), Browser::TYPE_NORMAL, false,
+                                     windows.back().get()));
+    for (int j = 0; j < kNumTabsPerBrowser; ++j)
+      AddTab(browsers.back().get(), GURL("http://foo"));
+  }
+
+  for (const auto& browser : browsers) {
+    TabStripModel* tab_strip_model = browser->tab_strip_model();
+    for (int i = 0; i < tab_strip_model->count(); ++i) {
+      EXPECT_EQ(browser.get(), chrome::FindBrowserWithTab(
+                                   tab_strip_model->GetWebContentsAt(i)));
+    }
+    EXPECT_EQ(browser.get(), chrome::FindBrowserWithID(browser->session_id()));
+  }
+
+  TabStripModel* first_tab_strip = browsers.front()->tab_strip_model();
+  TabStripModel* last_tab_strip = browsers.back()->tab_strip_model();
+  tab_groups::TabGroupId group = first_tab_strip->AddToNewGroup({0});
+  EXPECT_EQ(browsers.front().get(),
+            chrome::FindBrowserWithGroup(group, nullptr));
+  EXPECT_EQ(browsers.front().get(),
+            chrome::FindBrowserWithGroup(group, profile()));
+
+  // Move a tab to the last browser.
+  content::WebContents* moved_contents = first_tab_strip->GetWebContentsAt(1);
+  std::unique_ptr<tabs::TabModel> detached_tab =
+      first_tab_strip->DetachTabAtForInsertion(1);
+  EXPECT_EQ(nullptr, chrome::FindBrowserWithTab(moved_contents));
+  last_tab_strip->InsertDetachedTabAt(0, std::move(detached_tab),
+                                      AddTabTypes::ADD_NONE);
+  EXPECT_EQ(browsers.back().get(), chrome::FindBrowserWithTab(moved_contents));
+
+  // Closing the grouped tab closes the group.
+  first_tab_strip->DetachAndDeleteWebContentsAt(0);
+  EXPECT_EQ(nullptr, chrome::FindBrowserWithGroup(group, nullptr));
+
+  for (const auto& browser : browsers)
+    browser->tab_strip_model()->CloseAllTabs();
+}
+
+// Tabs are found while BrowserList notifies observers of a new browser, which
+// may be the first lookup.
+TEST_F(BrowserFinderTest, FindsTabsWhileBrowserIsAdded) {
+  AddTab(browser(), GURL("http://foo"));
+  content::WebContents* contents =
+      browser()->tab_strip_model()->GetWebContentsAt(0);
+
+  BrowserAddedObserver observer(contents);
+  std::unique_ptr<BrowserWindow> window = CreateBrowserWindow();
+  std::unique_ptr<Browser> other_browser =
+      CreateBrowser(profile(), Browser::TYPE_NORMAL, false, window.get());
+  EXPECT_EQ(browser(), observer.browser_with_contents());
+  EXPECT_EQ(other_browser.get(), observer.browser_with_tab_strip());
+
+  AddTab(other_browser.get(), GURL("http://foo"));
+  EXPECT_EQ(other_browser.get(),
+            chrome::FindBrowserWithTab(
+                other_browser->tab_strip_model()->GetWebContentsAt(0)));
+  EXPECT_EQ(browser(), chrome::FindBrowserWithTab(contents));
+
+  other_browser->tab_strip_model()->CloseAllTabs();
+}
+
+// Tab strip observers find the browser of a tab as soon as it moves.
+TEST_F(BrowserFinderTest, FindsTabsWhileTabStripIsChanged) {
+  std::unique_ptr<BrowserWindow> window = CreateBrowserWindow();
+  std::unique_ptr<Browser> other_browser =
+      CreateBrowser(profile(), Browser::TYPE_NORMAL, false, window.get());
+  AddTab(browser(), GURL("http://foo"));
+
+  TabStripChangeObserver observer;
+  browser()->tab_strip_model()->AddObserver(&observer);
+  other_browser->tab_strip_model()->AddObserver(&observer);
+
+  std::unique_ptr<tabs::TabModel> detached_tab =
+      browser()->tab_strip_model()->DetachTabAtForInsertion(0);
+  other_browser->tab_strip_model()->InsertDetachedTabAt(
+      0, std::move(detached_tab), AddTabTypes::ADD_NONE);
+  EXPECT_THAT(observer.found_browsers(),
+              ElementsAre(nullptr, other_browser.get()));
+
+  browser()->tab_strip_model()->RemoveObserver(&observer);
+  other_browser->tab_strip_model()->RemoveObserver(&observer);
+  other_browser->tab_strip_model()->CloseAllTabs();
+}
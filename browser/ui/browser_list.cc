@@ -68,6 +68,12 @@ Browser* BrowserList::GetLastActive() const {
   return nullptr;
 }
 
+Browser* BrowserList::GetBrowserWithTabStrip(
+    const TabStripModel* tab_strip_model) const {
+  auto it = browsers_by_tab_strip_.find(tab_strip_model);
+  return it == browsers_by_tab_strip_.end() ? nullptr : it->second;
+}
+
 // static
 BrowserList* BrowserList::GetInstance() {
   BrowserList** list = &instance_;
@@ -82,6 +88,13 @@ void BrowserList::AddBrowser(Browser* browser) {
   DCHECK(browser->window()) << "Browser should not be added to BrowserList "
                                "until it is fully constructed.";
   GetInstance()->browsers_.push_back(browser);
+  // Observers told about |browser| may look it up by its tab strip, so it is
+  // mapped exactly once, before they are notified.
+  const bool inserted = GetInstance()
+                            ->browsers_by_tab_strip_
+                            .emplace(browser->tab_strip_model(), browser)
+                            .second;
+  DCHECK(inserted) << "Browser was added to BrowserList twice.";
 
   browser->RegisterKeepAlive();
 
@@ -108,6 +121,7 @@ void BrowserList::RemoveBrowser(Browser* browser) {
   browser_list->currently_closing_browsers_.erase(browser);
 
   RemoveBrowserFrom(browser, &browser_list->browsers_);
+  browser_list->browsers_by_tab_strip_.erase(browser->tab_strip_model());
 
   for (BrowserListObserver& observer : observers_.Get())
     observer.OnBrowserRemoved(browser);
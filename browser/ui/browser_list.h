@@ -9,6 +9,7 @@
 
 #include <vector>
 
+#include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
 #include "base/functional/callback_forward.h"
 #include "base/lazy_instance.h"
@@ -25,6 +26,7 @@
 
 class Browser;
 class Profile;
+class TabStripModel;
 
 namespace base {
 class FilePath;
@@ -63,6 +65,11 @@ class BrowserList {
   // Returns the last active browser for this list.
   Browser* GetLastActive() const;
 
+  // Returns the browser in this list whose tab strip is |tab_strip_model|, or
+  // nullptr if there is none. Up to date before observers are notified of a
+  // browser being added or removed.
+  Browser* GetBrowserWithTabStrip(const TabStripModel* tab_strip_model) const;
+
   const_iterator begin() const { return browsers_.begin(); }
   const_iterator end() const { return browsers_.end(); }
 
@@ -224,6 +231,9 @@ class BrowserList {
   BrowserVector browsers_ordered_by_activation_;
   // A vector of the browsers that are currently in the closing state.
   BrowserSet currently_closing_browsers_;
+  // The browsers in this list, keyed by their tab strip.
+  base::flat_map<const TabStripModel*, raw_ptr<Browser, CtnExperimental>>
+      browsers_by_tab_strip_;
 
   // If an observer is added while iterating over them and notifying, it should
   // not be notified as it probably already saw the Browser* being added/removed
@@ -92,38 +92,24 @@ bool TabGroup::IsCustomized() const {
 }
 
 std::optional<int> TabGroup::GetFirstTab() const {
-  for (int i = 0; i < controller_->GetTabCount(); ++i) {
-    if (controller_->GetTabGroupForTab(i) == id_)
-      return i;
-  }
-
-  return std::nullopt;
+  if (tab_range_.is_empty())
+    return std::nullopt;
+  return tab_range_.start();
 }
 
 std::optional<int> TabGroup::GetLastTab() const {
-  for (int i = controller_->GetTabCount() - 1; i >= 0; --i) {
-    if (controller_->GetTabGroupForTab(i) == id_)
-      return i;
-  }
-
-  return std::nullopt;
+  if (tab_range_.is_empty())
+    return std::nullopt;
+  return tab_range_.end() - 1;
 }
 
 gfx::Range TabGroup::ListTabs() const {
-  std::optional<int> maybe_first_tab = GetFirstTab();
-  if (!maybe_first_tab)
-    return gfx::Range();
-
-  int first_tab = maybe_first_tab.value();
-  // Safe to assume GetLastTab() is not nullopt.
-  int last_tab = GetLastTab().value();
-
   // If DCHECKs are enabled, check for group contiguity. The result
   // doesn't really make sense if the group is discontiguous.
   if (DCHECK_IS_ON()) {
-    for (int i = first_tab; i <= last_tab; ++i)
+    for (uint32_t i = tab_range_.start(); i < tab_range_.end(); ++i)
       DCHECK(controller_->GetTabGroupForTab(i) == id_);
   }
 
-  return gfx::Range(first_tab, last_tab + 1);
+  return tab_range_;
 }
@@ -70,18 +70,16 @@ class TabGroup {
   bool IsCustomized() const;
 
   // Gets the model index of this group's first tab, or nullopt if it is
-  // empty. Similar to ListTabs() it traverses through TabStripModel's
-  // tabs. Unlike ListTabs() this is always safe to call.
+  // empty. Unlike ListTabs() this is always safe to call.
   std::optional<int> GetFirstTab() const;
 
   // Gets the model index of this group's last tab, or nullopt if it is
-  // empty. Similar to ListTabs() it traverses through TabStripModel's
-  // tabs. Unlike ListTabs() this is always safe to call.
+  // empty. Unlike ListTabs() this is always safe to call.
   std::optional<int> GetLastTab() const;
 
   // Returns the range of tab model indices this group contains. Notably
-  // does not rely on the TabGroup's internal metadata, but rather
-  // traverses directly through the tabs in TabStripModel.
+  // does not rely on tab_count(), but on the range TabGroupModel keeps up to
+  // date as TabStripModel's tabs change.
   //
   // The returned range will never be a reverse range. It will always be
   // a forward range, or the empty range {0,0}.
@@ -99,6 +97,8 @@ class TabGroup {
   gfx::Range ListTabs() const;
 
  private:
+  friend class TabGroupModel;
+
   raw_ptr<TabGroupController> controller_;
 
   tab_groups::TabGroupId id_;
@@ -106,6 +106,10 @@ class TabGroup {
 
   int tab_count_ = 0;
 
+  // The model indices from this group's first tab to its last tab, maintained
+  // by TabGroupModel. Empty if the group has no tabs.
+  gfx::Range tab_range_;
+
   bool is_customized_ = false;
 };
 
@@ -4,6 +4,7 @@
 
 #include "chrome/browser/ui/tabs/tab_group_model.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <optional>
@@ -16,6 +17,7 @@
 #include "components/tab_groups/tab_group_color.h"
 #include "components/tab_groups/tab_group_id.h"
 #include "components/tab_groups/tab_group_visual_data.h"
+#include "ui/gfx/range/range.h"
 
 TabGroupModel::TabGroupModel(TabGroupController* controller)
     : controller_(controller) {}
@@ -60,6 +62,128 @@ std::vector<tab_groups::TabGroupId> TabGroupModel::ListTabGroups() const {
   return group_ids_;
 }
 
+void TabGroupModel::OnTabInserted(
+    int index,
+    const std::optional<tab_groups::TabGroupId>& group) {
+  const uint32_t position = index;
+  for (const auto& id_group_pair : groups_) {
+    gfx::Range& range = id_group_pair.second->tab_range_;
+    if (range.is_empty())
+      continue;
+    if (range.start() >= position)
+      range.set_start(range.start() + 1);
+    if (range.end() > position)
+      range.set_end(range.end() + 1);
+  }
+
+  if (group)
+    AddToTabRange(group.value(), index);
+}
+
+void TabGroupModel::OnTabRemoved(
+    int index,
+    const std::optional<tab_groups::TabGroupId>& group) {
+  RemoveFromTabRanges(index, group, std::nullopt);
+}
+
+void TabGroupModel::OnTabMoved(
+    int from_index,
+    int to_index,
+    const std::optional<tab_groups::TabGroupId>& old_group,
+    const std::optional<tab_groups::TabGroupId>& new_group) {
+  if (from_index == to_index && old_group == new_group)
+    return;
+
+  RemoveFromTabRanges(from_index, old_group, to_index);
+  OnTabInserted(to_index, new_group);
+}
+
+void TabGroupModel::ResetTabRanges() {
+  for (const auto& id_group_pair : groups_)
+    id_group_pair.second->tab_range_ = gfx::Range();
+
+  for (int i = 0; i < controller_->GetTabCount(); ++i) {
+    std::optional<tab_groups::TabGroupId> group =
+        controller_->GetTabGroupForTab(i);
+    if (group)
+      AddToTabRange(group.value(), i);
+  }
+}
+
+void TabGroupModel::RemoveFromTabRanges(
+    int index,
+    const std::optional<tab_groups::TabGroupId>& group,
+    std::optional<int> moved_to_index) {
+  const uint32_t position = index;
+
+  // Whether the removed tab was the first or last tab of its group, which then
+  // need to be found among the remaining tabs.
+  TabGroup* tab_group = nullptr;
+  bool removed_first_tab = false;
+  bool removed_last_tab = false;
+  if (group && ContainsTabGroup(group.value())) {
+    tab_group = GetTabGroup(group.value());
+    removed_first_tab = tab_group->tab_range_.start() == position;
+    removed_last_tab = tab_group->tab_range_.end() == position + 1;
+    if (removed_first_tab && removed_last_tab) {
+      tab_group->tab_range_ = gfx::Range();
+      tab_group = nullptr;
+    }
+  }
+
+  for (const auto& id_group_pair : groups_) {
+    gfx::Range& range = id_group_pair.second->tab_range_;
+    if (range.is_empty())
+      continue;
+    if (range.start() > position)
+      range.set_start(range.start() - 1);
+    if (range.end() > position + 1)
+      range.set_end(range.end() - 1);
+  }
+
+  if (!tab_group)
+    return;
+
+  // Looks up the group of a remaining tab by its index as if the removed tab
+  // had not been inserted anywhere yet.
+  const auto get_group_for_remaining_tab = [&](int i) {
+    if (moved_to_index && i >= moved_to_index.value())
+      ++i;
+    return controller_->GetTabGroupForTab(i);
+  };
+
+  // In a contiguous group, these find the neighbor of the removed tab right
+  // away.
+  gfx::Range& range = tab_group->tab_range_;
+  if (removed_first_tab) {
+    int first_tab = index;
+    while (get_group_for_remaining_tab(first_tab) != group)
+      ++first_tab;
+    range.set_start(first_tab);
+  } else if (removed_last_tab) {
+    int last_tab = index - 1;
+    while (get_group_for_remaining_tab(last_tab) != group)
+      --last_tab;
+    range.set_end(last_tab + 1);
+  }
+}
+
+void TabGroupModel::AddToTabRange(const tab_groups::TabGroupId& group,
+                                  int index) {
+  // Tabs are only added to groups which exist.
+  if (!ContainsTabGroup(group))
+    return;
+
+  gfx::Range& range = GetTabGroup(group)->tab_range_;
+  const uint32_t position = index;
+  if (range.is_empty()) {
+    range = gfx::Range(position, position + 1);
+  } else {
+    range = gfx::Range(std::min(range.start(), position),
+                       std::max(range.end(), position + 1));
+  }
+}
+
 tab_groups::TabGroupColorId TabGroupModel::GetNextColor() const {
   std::vector<tab_groups::TabGroupColorId> used_colors;
   for (const auto& id_group_pair : groups_) {
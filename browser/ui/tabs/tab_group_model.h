@@ -54,7 +54,33 @@ class TabGroupModel {
 
   std::vector<tab_groups::TabGroupId> ListTabGroups() const;
 
+  // Keep the tab range of each group, see TabGroup::ListTabs(), up to date.
+  // Called by TabStripModel right after it changes its tabs, so that the
+  // ranges are right by the time observers are notified. |group| is the group
+  // of the inserted or removed tab, if any.
+  void OnTabInserted(int index,
+                     const std::optional<tab_groups::TabGroupId>& group);
+  void OnTabRemoved(int index,
+                    const std::optional<tab_groups::TabGroupId>& group);
+  void OnTabMoved(int from_index,
+                  int to_index,
+                  const std::optional<tab_groups::TabGroupId>& old_group,
+                  const std::optional<tab_groups::TabGroupId>& new_group);
+
+  // Recomputes the tab ranges of all groups from the tabs, after many tabs
+  // were moved at once.
+  void ResetTabRanges();
+
  private:
+  // Removes the tab at |index| from the tab ranges. If the tab was moved,
+  // |moved_to_index| is where it is now.
+  void RemoveFromTabRanges(int index,
+                           const std::optional<tab_groups::TabGroupId>& group,
+                           std::optional<int> moved_to_index);
+
+  // Extends the tab range of |group| to include the tab at |index|.
+  void AddToTabRange(const tab_groups::TabGroupId& group, int index);
+
   std::map<tab_groups::TabGroupId, std::unique_ptr<TabGroup>> groups_;
 
   // Used to maintain insertion order of TabGroupsIds added to the
@@ -18,6 +18,7 @@
 #include "base/memory/raw_ptr.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/metrics/user_metrics.h"
+#include "base/no_destructor.h"
 #include "base/not_fatal_until.h"
 #include "base/observer_list.h"
 #include "base/ranges/algorithm.h"
@@ -134,6 +135,15 @@ tabs::TabInterface::DetachReason RemoveReasonToDetachReason(
   }
 }
 
+// The TabStripModel of each tab, see TabStripModel::GetModelWithWebContents().
+std::unordered_map<const WebContents*, raw_ptr<TabStripModel>>&
+GetModelsByWebContents() {
+  static base::NoDestructor<
+      std::unordered_map<const WebContents*, raw_ptr<TabStripModel>>>
+      models_by_web_contents;
+  return *models_by_web_contents;
+}
+
 }  // namespace
 
 TabGroupModelFactory::TabGroupModelFactory() {
@@ -217,6 +227,9 @@ TabStripModel::TabStripModel(TabStripModelDelegate* delegate,
 }
 
 TabStripModel::~TabStripModel() {
+  for (int i = 0; i < count(); ++i) {
+    GetModelsByWebContents().erase(GetWebContentsAt(i));
+  }
   for (auto& observer : observers_) {
     observer.ModelDestroyed(TabStripModelObserver::ModelPasskey(), this);
   }
@@ -327,6 +340,8 @@ std::unique_ptr<content::WebContents> TabStripModel::DiscardWebContentsAt(
   WebContents* raw_new_contents = new_contents.get();
   std::unique_ptr<WebContents> old_contents =
       GetTabAtIndex(index)->DiscardContents(std::move(new_contents));
+  GetModelsByWebContents().erase(old_contents.get());
+  GetModelsByWebContents()[raw_new_contents] = this;
 
   // When the active WebContents is replaced send out a selection notification
   // too. We do this as nearly all observers need to treat a replacement of the
@@ -591,6 +606,7 @@ void TabStripModel::MoveGroupToImpl(const tab_groups::TabGroupId& group,
 
   // Remove all the tabs from the model.
   contents_data_->MoveGroupTo(group_model(), group, to_index);
+  group_model_->ResetTabRanges();
 
   ValidateTabStripModel();
 
@@ -639,6 +655,13 @@ int TabStripModel::GetIndexOfWebContents(const WebContents* contents) const {
   return kNoTab;
 }
 
+// static
+TabStripModel* TabStripModel::GetModelWithWebContents(
+    const WebContents* contents) {
+  auto it = GetModelsByWebContents().find(contents);
+  return it == GetModelsByWebContents().end() ? nullptr : it->second;
+}
+
 void TabStripModel::UpdateWebContentsStateAt(int index,
                                              TabChangeType change_type) {
   WebContents* const web_contents = GetWebContentsAtImpl(index);
@@ -2523,6 +2546,10 @@ void TabStripModel::InsertTabAtIndexImpl(
   WebContents* web_contents = tab_model->contents();
 
   contents_data_->AddTabRecursive(std::move(tab_model), index, group, pin);
+  GetModelsByWebContents()[web_contents] = this;
+  if (group_model_) {
+    group_model_->OnTabInserted(index, group);
+  }
 
   // Update selection model and send the notification.
   TabStripSelectionChange selection(GetActiveWebContents(), selection_model_);
@@ -2557,6 +2584,10 @@ std::unique_ptr<tabs::TabModel> TabStripModel::RemoveTabFromIndexImpl(
   // Remove the tab.
   std::unique_ptr<tabs::TabModel> old_data =
       contents_data_->RemoveTabAtIndexRecursive(index);
+  GetModelsByWebContents().erase(old_data->contents());
+  if (group_model_) {
+    group_model_->OnTabRemoved(index, old_group);
+  }
 
   if (empty()) {
     selection_model_.Clear();
@@ -2609,6 +2640,9 @@ void TabStripModel::MoveTabToIndexImpl(
   }
 
   contents_data_->MoveTabRecursive(initial_index, final_index, group, pin);
+  if (group_model_) {
+    group_model_->OnTabMoved(initial_index, final_index, initial_group, group);
+  }
 
   TabStripSelectionChange selection =
       MaybeUpdateSelectionModel(initial_index, final_index, select_after_move);
@@ -2658,6 +2692,9 @@ void TabStripModel::MoveTabsToIndexImpl(
 
   // Update `contents_data`.
   contents_data_->MoveTabsRecursive(tab_indices, destination_index, group, pin);
+  if (group_model_) {
+    group_model_->ResetTabRanges();
+  }
 
   ValidateTabStripModel();
 
@@ -2747,6 +2784,11 @@ void TabStripModel::ValidateTabStripModel() {
   for (auto selection : selected_indices) {
     DCHECK(GetTabAtIndex(selection));
   }
+
+  // Check that every tab maps back to this model.
+  for (int i = 0; i < count(); ++i) {
+    DCHECK_EQ(GetModelWithWebContents(GetWebContentsAtImpl(i)), this);
+  }
 #endif
 
   contents_data_->ValidateData(group_model());
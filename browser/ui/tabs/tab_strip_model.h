@@ -324,6 +324,11 @@ class TabStripModel : public TabGroupController {
   // if the WebContents is not in this TabStripModel.
   int GetIndexOfWebContents(const content::WebContents* contents) const;
 
+  // Returns the TabStripModel which has |contents| as a tab, or nullptr if
+  // there is none. Up to date before observers are notified of a change.
+  static TabStripModel* GetModelWithWebContents(
+      const content::WebContents* contents);
+
   // Notify any observers that the WebContents at the specified index has
   // changed in some way. See TabChangeType for details of |change_type|.
   void UpdateWebContentsStateAt(int index, TabChangeType change_type);
@@ -10,6 +10,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <random>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -56,6 +57,7 @@
 #include "content/public/test/web_contents_tester.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/skia/include/core/SkColor.h"
+#include "ui/gfx/range/range.h"
 
 using content::WebContents;
 
@@ -3821,6 +3823,162 @@ TEST_P(TabStripModelTest, MoveGroupToTest) {
   strip.CloseAllTabs();
 }
 
+// The tab range of each group is kept up to date as tabs are inserted,
+// removed, moved and regrouped, rather than computed by scanning the tabs.
+TEST_P(TabStripModelTest, GroupTabRangesFollowTabs) {
+  TestTabStripModelDelegate delegate;
+  TabStripModel strip(&delegate, profile());
+  PrepareTabs(&strip, 12);
+
+  const auto expect_ranges_match_tabs = [&strip]() {
+    for (const tab_groups::TabGroupId& group :
+         strip.group_model()->ListTabGroups()) {
+      std::optional<int> first_tab;
+      std::optional<int> last_tab;
+      for (int i = 0; i < strip.count(); ++i) {
+        if (strip.GetTabGroupForTab(i) != group) {
+          continue;
+        }
+        if (!first_tab) {
+          first_tab = i;
+        }
+        last_tab = i;
+      }
+      const TabGroup* tab_group = strip.group_model()->GetTabGroup(group);
+      EXPECT_EQ(first_tab, tab_group->GetFirstTab());
+      EXPECT_EQ(last_tab, tab_group->GetLastTab());
+      ASSERT_TRUE(first_tab);
+      EXPECT_EQ(gfx::Range(first_tab.value(), last_tab.value() + 1),
+                tab_group->ListTabs());
+    }
+  };
+
+  const tab_groups::TabGroupId group1 = strip.AddToNewGroup({2, 3, 4});
+  const tab_groups::TabGroupId group2 = strip.AddToNewGroup({8, 9});
+  const TabGroup* const tab_group1 = strip.group_model()->GetTabGroup(group1);
+  const TabGroup* const tab_group2 = strip.group_model()->GetTabGroup(group2);
+  expect_ranges_match_tabs();
+
+  // Insert tabs before, at the edges of and within the groups.
+  strip.InsertWebContentsAt(0, CreateWebContents(), AddTabTypes::ADD_NONE);
+  expect_ranges_match_tabs();
+  strip.InsertWebContentsAt(6, CreateWebContents(), AddTabTypes::ADD_NONE,
+                            group1);
+  expect_ranges_match_tabs();
+  strip.InsertWebContentsAt(3, CreateWebContents(), AddTabTypes::ADD_NONE,
+                            group1);
+  expect_ranges_match_tabs();
+  strip.AppendWebContents(CreateWebContents(), false);
+  expect_ranges_match_tabs();
+
+  // Grow and shrink the groups from either end.
+  strip.AddToExistingGroup({1, 14}, group1);
+  expect_ranges_match_tabs();
+  strip.RemoveFromGroup({tab_group1->GetFirstTab().value()});
+  expect_ranges_match_tabs();
+  strip.RemoveFromGroup({tab_group2->GetLastTab().value()});
+  expect_ranges_match_tabs();
+
+  // Move tabs within and across the groups, and move whole groups.
+  strip.MoveWebContentsAt(tab_group1->GetFirstTab().value(), 0, false);
+  expect_ranges_match_tabs();
+  strip.MoveGroupTo(group2, 0);
+  expect_ranges_match_tabs();
+  strip.MoveGroupTo(group1, strip.count() - static_cast<int>(
+                                tab_group1->ListTabs().length()));
+  expect_ranges_match_tabs();
+
+  // Repeatedly regroup and close tabs, until the groups are gone.
+  for (int i = 0; !strip.group_model()->ListTabGroups().empty(); ++i) {
+    const std::vector<tab_groups::TabGroupId> groups =
+        strip.group_model()->ListTabGroups();
+    const int index = (i * 7) % strip.count();
+    if (i % 3 == 2) {
+      strip.CloseWebContentsAt(index, TabCloseTypes::CLOSE_NONE);
+    } else {
+      strip.AddToExistingGroup({index}, groups[i % groups.size()]);
+    }
+    expect_ranges_match_tabs();
+  }
+
+  // Apply a seeded random sequence of inserts, moves, regroups and closes over
+  // many groups. minstd_rand is fully specified, so every platform runs the
+  // same sequence.
+  std::minstd_rand random(0x7ab5);
+  const auto random_index = [&random](size_t size) {
+    return static_cast<int>(random() % size);
+  };
+  while (strip.count() < 40) {
+    strip.AppendWebContents(CreateWebContents(), false);
+  }
+  for (int i = 0; i < 8; ++i) {
+    strip.AddToNewGroup({random_index(strip.count())});
+  }
+  expect_ranges_match_tabs();
+
+  for (int step = 0; step < 500; ++step) {
+    SCOPED_TRACE(step);
+    const std::vector<tab_groups::TabGroupId> groups =
+        strip.group_model()->ListTabGroups();
+    const int index = random_index(strip.count());
+    switch (random_index(7)) {
+      case 0: {
+        // Join the group on either side of the new tab, or the group around
+        // it so that it is not split.
+        const int insert_index = random_index(strip.count() + 1);
+        const std::optional<tab_groups::TabGroupId> before =
+            insert_index > 0 ? strip.GetTabGroupForTab(insert_index - 1)
+                             : std::nullopt;
+        const std::optional<tab_groups::TabGroupId> after =
+            insert_index < strip.count() ? strip.GetTabGroupForTab(insert_index)
+                                         : std::nullopt;
+        const std::optional<tab_groups::TabGroupId> group =
+            before == after || random_index(2) ? before : after;
+        strip.InsertWebContentsAt(insert_index, CreateWebContents(),
+                                  AddTabTypes::ADD_NONE, group);
+        break;
+      }
+      case 1:
+        strip.MoveWebContentsAt(index, random_index(strip.count()), false);
+        break;
+      case 2:
+        if (!groups.empty()) {
+          strip.AddToExistingGroup({index},
+                                   groups[random_index(groups.size())]);
+        }
+        break;
+      case 3:
+        if (groups.size() < 16) {
+          strip.AddToNewGroup({index});
+        }
+        break;
+      case 4:
+        if (strip.GetTabGroupForTab(index)) {
+          strip.RemoveFromGroup({index});
+        }
+        break;
+      case 5:
+        if (strip.count() > 8) {
+          strip.CloseWebContentsAt(index, TabCloseTypes::CLOSE_NONE);
+        }
+        break;
+      case 6:
+        if (!groups.empty()) {
+          const tab_groups::TabGroupId group =
+              groups[random_index(groups.size())];
+          const int length = static_cast<int>(
+              strip.group_model()->GetTabGroup(group)->ListTabs().length());
+          strip.MoveGroupTo(group,
+                            random_index(2) ? 0 : strip.count() - length);
+        }
+        break;
+    }
+    expect_ranges_match_tabs();
+  }
+
+  strip.CloseAllTabs();
+}
+
 TEST_P(TabStripModelTest, AddToExistingGroupDeletesGroup) {
   TestTabStripModelDelegate delegate;
   TabStripModel strip(&delegate, profile());
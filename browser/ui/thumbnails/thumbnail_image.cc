@@ -9,14 +9,24 @@
 #include "base/memory/ptr_util.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/ranges/algorithm.h"
+#include "base/task/sequenced_task_runner.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool.h"
 #include "base/time/time.h"
 #include "base/trace_event/trace_event.h"
+#include "chrome/browser/ui/thumbnails/thumbnail_image_store.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/gfx/codec/jpeg_codec.h"
 #include "ui/gfx/geometry/skia_conversions.h"
 
+namespace {
+
+// The JPEG quality of thumbnails which were recompressed to fit in the memory
+// budget.
+constexpr int kReducedCompressionQuality = 50;
+
+}  // namespace
+
 ThumbnailImage::Subscription::Subscription(
     scoped_refptr<ThumbnailImage> thumbnail)
     : thumbnail_(std::move(thumbnail)) {}
@@ -41,12 +51,22 @@ ThumbnailImage::ThumbnailImage(Delegate* delegate, CompressedThumbnailData data)
   DCHECK(delegate_);
   DCHECK(!delegate_->thumbnail_);
   delegate_->thumbnail_ = this;
+  if (data_) {
+    thumbnail_id_ = base::Token::CreateRandom();
+    last_used_ = base::TimeTicks::Now();
+    ThumbnailImageStore::GetInstance()->UpdateDataSize(
+        this, 0, GetCompressedDataSizeInBytes());
+  }
 }
 
 ThumbnailImage::~ThumbnailImage() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   if (delegate_)
     delegate_->thumbnail_ = nullptr;
+  if (data_) {
+    ThumbnailImageStore::GetInstance()->RemoveThumbnail(
+        this, GetCompressedDataSizeInBytes());
+  }
 }
 
 ThumbnailImage::CaptureReadiness ThumbnailImage::GetCaptureReadiness() const {
@@ -93,8 +113,11 @@ void ThumbnailImage::ClearData() {
   // the observers still think the thumbnail is blank.
   const bool should_notify = !!data_;
 
+  ThumbnailImageStore::GetInstance()->UpdateDataSize(
+      this, GetCompressedDataSizeInBytes(), 0);
   data_.reset();
   thumbnail_id_ = base::Token();
+  is_reduced_quality_ = false;
 
   // Notify observers of the new, blank thumbnail.
   if (should_notify) {
@@ -105,6 +128,7 @@ void ThumbnailImage::ClearData() {
 
 void ThumbnailImage::RequestThumbnailImage() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  last_used_ = base::TimeTicks::Now();
   ConvertJPEGDataToImageSkiaAndNotifyObservers();
 }
 
@@ -131,8 +155,14 @@ void ThumbnailImage::AssignJPEGData(base::Token thumbnail_id,
     return;
   }
 
+  ThumbnailImageStore* const store = ThumbnailImageStore::GetInstance();
+  const size_t old_size = GetCompressedDataSizeInBytes();
   data_ = base::MakeRefCounted<base::RefCountedData<std::vector<uint8_t>>>(
       std::move(data));
+  is_reduced_quality_ = false;
+  last_used_ = base::TimeTicks::Now();
+  store->UpdateDataSize(this, old_size, GetCompressedDataSizeInBytes());
+  store->EnforceMemoryBudget();
 
   // We select a TRACE_EVENT_* macro based on |frame_id|'s presence.
   // Since these are scoped traces, the macro invocation must be in the
@@ -161,15 +191,35 @@ bool ThumbnailImage::ConvertJPEGDataToImageSkiaAndNotifyObservers() {
       async_operation_finished_callback_.Run();
     return false;
   }
+
+  // Recently used thumbnails don't need to be decoded again.
+  std::optional<gfx::ImageSkia> image =
+      ThumbnailImageStore::GetInstance()->GetDecodedImage(thumbnail_id_);
+  if (image) {
+    return base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+        FROM_HERE,
+        base::BindOnce(&ThumbnailImage::NotifyUncompressedDataObservers,
+                       weak_ptr_factory_.GetWeakPtr(), thumbnail_id_,
+                       std::move(*image)));
+  }
+
   return base::ThreadPool::PostTaskAndReplyWithResult(
       FROM_HERE,
       {base::TaskPriority::USER_VISIBLE,
        base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN},
       base::BindOnce(&ThumbnailImage::UncompressImage, data_),
-      base::BindOnce(&ThumbnailImage::NotifyUncompressedDataObservers,
+      base::BindOnce(&ThumbnailImage::OnImageDecoded,
                      weak_ptr_factory_.GetWeakPtr(), thumbnail_id_));
 }
 
+void ThumbnailImage::OnImageDecoded(base::Token thumbnail_id,
+                                    gfx::ImageSkia image) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!image.isNull())
+    ThumbnailImageStore::GetInstance()->AddDecodedImage(thumbnail_id, image);
+  NotifyUncompressedDataObservers(thumbnail_id, std::move(image));
+}
+
 void ThumbnailImage::NotifyUncompressedDataObservers(base::Token thumbnail_id,
                                                      gfx::ImageSkia image) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
@@ -243,6 +293,53 @@ gfx::ImageSkia ThumbnailImage::UncompressImage(
   return result;
 }
 
+void ThumbnailImage::ReduceQuality() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(data_);
+  DCHECK(!is_reduced_quality_);
+  is_reduced_quality_ = true;
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE,
+      {base::TaskPriority::BEST_EFFORT,
+       base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN},
+      base::BindOnce(&ThumbnailImage::ReduceImageQuality, data_),
+      base::BindOnce(&ThumbnailImage::AssignReducedQualityJPEGData,
+                     weak_ptr_factory_.GetWeakPtr(), thumbnail_id_));
+}
+
+void ThumbnailImage::AssignReducedQualityJPEGData(base::Token thumbnail_id,
+                                                  std::vector<uint8_t> data) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // Ignore the data if the thumbnail changed in the meantime, or if it would
+  // not save any memory.
+  const size_t old_size = GetCompressedDataSizeInBytes();
+  if (thumbnail_id != thumbnail_id_ || data.empty() ||
+      data.size() >= old_size) {
+    return;
+  }
+
+  // Observers already have the image, so they aren't notified of the new
+  // data.
+  data_ = base::MakeRefCounted<base::RefCountedData<std::vector<uint8_t>>>(
+      std::move(data));
+  ThumbnailImageStore::GetInstance()->UpdateDataSize(
+      this, old_size, GetCompressedDataSizeInBytes());
+}
+
+// static
+std::vector<uint8_t> ThumbnailImage::ReduceImageQuality(
+    CompressedThumbnailData compressed) {
+  TRACE_EVENT0("ui", "Tab.Preview.ReduceJPEGQuality");
+  std::unique_ptr<SkBitmap> bitmap(
+      gfx::JPEGCodec::Decode(compressed->data.data(), compressed->data.size()));
+  std::vector<uint8_t> data;
+  if (!bitmap ||
+      !gfx::JPEGCodec::Encode(*bitmap, kReducedCompressionQuality, &data)) {
+    return {};
+  }
+  return data;
+}
+
 // static
 gfx::ImageSkia ThumbnailImage::CropPreviewImage(
     const gfx::ImageSkia& source_image,
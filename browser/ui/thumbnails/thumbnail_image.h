@@ -17,16 +17,14 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
+#include "base/time/time.h"
 #include "base/token.h"
 #include "ui/gfx/geometry/size.h"
 #include "ui/gfx/image/image_skia.h"
 
-namespace base {
-class TimeTicks;
-}  // namespace base
-
 // Stores compressed thumbnail data for a tab and can vend that data as an
-// uncompressed image to observers.
+// uncompressed image to observers. The data of all thumbnails is kept within
+// a memory budget by ThumbnailImageStore.
 class ThumbnailImage : public base::RefCountedThreadSafe<ThumbnailImage> {
  public:
   // Describes the readiness of the source page for thumbnail capture.
@@ -173,6 +171,7 @@ class ThumbnailImage : public base::RefCountedThreadSafe<ThumbnailImage> {
 
  private:
   friend class Delegate;
+  friend class ThumbnailImageStore;
   friend class ThumbnailImageTest;
   friend class base::RefCountedThreadSafe<ThumbnailImage>;
 
@@ -183,6 +182,7 @@ class ThumbnailImage : public base::RefCountedThreadSafe<ThumbnailImage> {
                       std::optional<uint64_t> frame_id_for_trace,
                       std::vector<uint8_t> data);
   bool ConvertJPEGDataToImageSkiaAndNotifyObservers();
+  void OnImageDecoded(base::Token thumbnail_id, gfx::ImageSkia image);
   void NotifyUncompressedDataObservers(base::Token thumbnail_id,
                                        gfx::ImageSkia image);
   void NotifyCompressedDataObservers(CompressedThumbnailData data);
@@ -191,6 +191,14 @@ class ThumbnailImage : public base::RefCountedThreadSafe<ThumbnailImage> {
                                              std::optional<uint64_t> frame_id);
   static gfx::ImageSkia UncompressImage(CompressedThumbnailData compressed);
 
+  // Recompresses |data_| at a lower quality, to save memory. Called by
+  // ThumbnailImageStore.
+  void ReduceQuality();
+  void AssignReducedQualityJPEGData(base::Token thumbnail_id,
+                                    std::vector<uint8_t> data);
+  static std::vector<uint8_t> ReduceImageQuality(
+      CompressedThumbnailData compressed);
+
   // Crops and returns a preview from a thumbnail of an entire web page. Uses
   // logic appropriate for fixed-aspect previews (e.g. hover cards).
   static gfx::ImageSkia CropPreviewImage(const gfx::ImageSkia& source_image,
@@ -210,6 +218,12 @@ class ThumbnailImage : public base::RefCountedThreadSafe<ThumbnailImage> {
   // AssignSkBitmap().
   base::Token thumbnail_id_;
 
+  // When the thumbnail was last assigned or requested.
+  base::TimeTicks last_used_;
+
+  // Whether |data_| is, or is being, recompressed at a lower quality.
+  bool is_reduced_quality_ = false;
+
   // Subscriptions are inserted on |Subscribe()| calls and removed when
   // they are destroyed via callback. The order of subscriber
   // notification doesn't matter, so don't maintain any ordering. Since
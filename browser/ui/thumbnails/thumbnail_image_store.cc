@@ -0,0 +1,100 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/ui/thumbnails/thumbnail_image_store.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/check_is_test.h"
+#include "base/check_op.h"
+#include "base/ranges/algorithm.h"
+#include "chrome/browser/ui/thumbnails/thumbnail_image.h"
+
+// static
+ThumbnailImageStore* ThumbnailImageStore::GetInstance() {
+  static base::NoDestructor<ThumbnailImageStore> instance;
+  return instance.get();
+}
+
+ThumbnailImageStore::ThumbnailImageStore()
+    : decoded_images_(kMaxDecodedImages) {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+ThumbnailImageStore::~ThumbnailImageStore() = default;
+
+base::AutoReset<size_t> ThumbnailImageStore::SetMemoryBudgetForTesting(
+    size_t memory_budget_in_bytes) {
+  CHECK_IS_TEST();
+  return base::AutoReset<size_t>(&memory_budget_in_bytes_,
+                                 memory_budget_in_bytes);
+}
+
+void ThumbnailImageStore::ResetForTesting() {
+  CHECK_IS_TEST();
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+  thumbnails_.clear();
+  total_size_in_bytes_ = 0;
+  memory_budget_in_bytes_ = kDefaultMemoryBudgetInBytes;
+  decoded_images_.Clear();
+  num_decodes_ = 0;
+}
+
+void ThumbnailImageStore::UpdateDataSize(ThumbnailImage* thumbnail,
+                                         size_t old_size,
+                                         size_t new_size) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK_GE(total_size_in_bytes_, old_size);
+  total_size_in_bytes_ = total_size_in_bytes_ - old_size + new_size;
+  if (new_size)
+    thumbnails_.insert(thumbnail);
+  else
+    thumbnails_.erase(thumbnail);
+}
+
+void ThumbnailImageStore::RemoveThumbnail(ThumbnailImage* thumbnail,
+                                          size_t size) {
+  UpdateDataSize(thumbnail, size, 0);
+}
+
+void ThumbnailImageStore::EnforceMemoryBudget() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (total_size_in_bytes_ <= memory_budget_in_bytes_)
+    return;
+
+  // Thumbnails which are being shown keep their quality.
+  std::vector<ThumbnailImage*> candidates;
+  for (ThumbnailImage* thumbnail : thumbnails_) {
+    if (!thumbnail->is_reduced_quality_ && thumbnail->subscribers_.empty())
+      candidates.push_back(thumbnail);
+  }
+  base::ranges::sort(candidates, {}, &ThumbnailImage::last_used_);
+
+  // Recompression is asynchronous, so assume that it halves the size of each
+  // thumbnail, which is conservative for the quality it reduces to.
+  size_t expected_size_in_bytes = total_size_in_bytes_;
+  for (ThumbnailImage* thumbnail : candidates) {
+    if (expected_size_in_bytes <= memory_budget_in_bytes_)
+      break;
+    expected_size_in_bytes -= thumbnail->GetCompressedDataSizeInBytes() / 2;
+    thumbnail->ReduceQuality();
+  }
+}
+
+std::optional<gfx::ImageSkia> ThumbnailImageStore::GetDecodedImage(
+    base::Token thumbnail_id) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = decoded_images_.Get(thumbnail_id);
+  if (it == decoded_images_.end())
+    return std::nullopt;
+  return it->second;
+}
+
+void ThumbnailImageStore::AddDecodedImage(base::Token thumbnail_id,
+                                          gfx::ImageSkia image) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  ++num_decodes_;
+  decoded_images_.Put(thumbnail_id, std::move(image));
+}
@@ -0,0 +1,87 @@
+// Copyright 2024 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_UI_THUMBNAILS_THUMBNAIL_IMAGE_STORE_H_
+#define CHROME_BROWSER_UI_THUMBNAILS_THUMBNAIL_IMAGE_STORE_H_
+
+#include <stddef.h>
+
+#include <optional>
+#include <set>
+
+#include "base/auto_reset.h"
+#include "base/containers/lru_cache.h"
+#include "base/memory/raw_ptr.h"
+#include "base/no_destructor.h"
+#include "base/sequence_checker.h"
+#include "base/token.h"
+#include "ui/gfx/image/image_skia.h"
+
+class ThumbnailImage;
+
+// Keeps track of the compressed data of all thumbnails, and keeps their total
+// size within a memory budget. When the budget is exceeded, the thumbnails
+// which were least recently used are recompressed at a lower quality. Also
+// keeps the decoded images of the few most recently used thumbnails, so that
+// e.g. hovering the same tab again doesn't decode its thumbnail again.
+//
+// Must only be used on the UI thread.
+class ThumbnailImageStore {
+ public:
+  static constexpr size_t kDefaultMemoryBudgetInBytes = 32 * 1024 * 1024;
+  static constexpr size_t kMaxDecodedImages = 4;
+
+  static ThumbnailImageStore* GetInstance();
+
+  ThumbnailImageStore(const ThumbnailImageStore&) = delete;
+  ThumbnailImageStore& operator=(const ThumbnailImageStore&) = delete;
+
+  // Called when the compressed data of |thumbnail| changed size. Doesn't
+  // enforce the memory budget, see EnforceMemoryBudget().
+  void UpdateDataSize(ThumbnailImage* thumbnail,
+                      size_t old_size,
+                      size_t new_size);
+
+  // Called when |thumbnail| is destroyed.
+  void RemoveThumbnail(ThumbnailImage* thumbnail, size_t size);
+
+  // Recompresses the least recently used thumbnails at a lower quality until
+  // the total size is expected to fit in the memory budget.
+  void EnforceMemoryBudget();
+
+  // Returns the decoded image of the thumbnail assigned |thumbnail_id|, if it
+  // is one of the most recently decoded ones.
+  std::optional<gfx::ImageSkia> GetDecodedImage(base::Token thumbnail_id);
+  void AddDecodedImage(base::Token thumbnail_id, gfx::ImageSkia image);
+
+  size_t total_size_in_bytes() const { return total_size_in_bytes_; }
+  size_t num_decodes() const { return num_decodes_; }
+
+  // Sets the memory budget until the returned object is destroyed.
+  [[nodiscard]] base::AutoReset<size_t> SetMemoryBudgetForTesting(
+      size_t memory_budget_in_bytes);
+
+  // Forgets all thumbnails and decoded images, restores the default memory
+  // budget, and allows the store to be used on a new sequence. Must only be
+  // called while no ThumbnailImage has compressed data, e.g. between tests.
+  void ResetForTesting();
+
+ private:
+  friend class base::NoDestructor<ThumbnailImageStore>;
+
+  ThumbnailImageStore();
+  ~ThumbnailImageStore();
+
+  // The thumbnails with compressed data.
+  std::set<raw_ptr<ThumbnailImage, SetExperimental>> thumbnails_;
+  size_t total_size_in_bytes_ = 0;
+  size_t memory_budget_in_bytes_ = kDefaultMemoryBudgetInBytes;
+
+  base::LRUCache<base::Token, gfx::ImageSkia> decoded_images_;
+  size_t num_decodes_ = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+#endif  // CHROME_BROWSER_UI_THUMBNAILS_THUMBNAIL_IMAGE_STORE_H_
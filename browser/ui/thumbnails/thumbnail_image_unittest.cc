@@ -7,13 +7,17 @@
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
+#include "base/auto_reset.h"
 #include "base/functional/callback_helpers.h"
 #include "base/memory/weak_ptr.h"
 #include "base/run_loop.h"
 #include "base/test/task_environment.h"
+#include "chrome/browser/ui/thumbnails/thumbnail_image_store.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkColor.h"
 #include "ui/gfx/image/image_skia.h"
 #include "ui/gfx/image/image_unittest_util.h"
 
@@ -58,6 +62,23 @@ class CallbackWaiter {
   base::WeakPtrFactory<CallbackWaiter> weak_ptr_factory_{this};
 };
 
+// Returns a bitmap with detail in it, which compresses like a web page rather
+// than like a single color.
+SkBitmap CreateDetailedBitmap(int seed) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(kTestBitmapWidth, kTestBitmapHeight);
+  for (int y = 0; y < kTestBitmapHeight; ++y) {
+    for (int x = 0; x < kTestBitmapWidth; ++x) {
+      const uint32_t value =
+          static_cast<uint32_t>(x * 7919 + y * 104729 + seed * 1299709) *
+          2654435761u;
+      *bitmap.getAddr32(x, y) =
+          SkColorSetRGB(value >> 24, value >> 16, value >> 8);
+    }
+  }
+  return bitmap;
+}
+
 class StubDelegate : public ThumbnailImage::Delegate {
  public:
   StubDelegate() = default;
@@ -72,7 +93,11 @@ class StubDelegate : public ThumbnailImage::Delegate {
 class ThumbnailImageTest : public testing::Test,
                            public ThumbnailImage::Delegate {
  public:
-  ThumbnailImageTest() = default;
+  ThumbnailImageTest() {
+    // The store is shared by all tests, which each run on a sequence of their
+    // own.
+    ThumbnailImageStore::GetInstance()->ResetForTesting();
+  }
 
   ThumbnailImageTest(const ThumbnailImageTest&) = delete;
   ThumbnailImageTest& operator=(const ThumbnailImageTest&) = delete;
@@ -84,6 +109,12 @@ class ThumbnailImageTest : public testing::Test,
 
   bool is_being_observed() const { return is_being_observed_; }
 
+  bool is_reduced_quality(const ThumbnailImage& image) const {
+    return image.is_reduced_quality_;
+  }
+
+  base::test::TaskEnvironment& task_environment() { return task_environment_; }
+
  private:
   void ThumbnailImageBeingObservedChanged(bool is_being_observed) override {
     is_being_observed_ = is_being_observed;
@@ -396,3 +427,75 @@ TEST_F(ThumbnailImageTest, DoesNotCropBlankThumbnails) {
   uncompressed_image_waiter.Wait();
   EXPECT_TRUE(uncompressed_image_waiter.called());
 }
+
+TEST_F(ThumbnailImageTest, RequestThumbnailImageReusesDecodedImage) {
+  auto image = base::MakeRefCounted<ThumbnailImage>(this);
+  std::unique_ptr<Subscription> subscription = image->Subscribe();
+  CallbackWaiter waiter;
+  subscription->SetUncompressedImageCallback(
+      base::IgnoreArgs<gfx::ImageSkia>(waiter.callback()));
+
+  ThumbnailImageStore* const store = ThumbnailImageStore::GetInstance();
+  const size_t num_decodes = store->num_decodes();
+  image->AssignSkBitmap(CreateDetailedBitmap(0), std::nullopt);
+  waiter.Wait();
+  EXPECT_EQ(num_decodes + 1, store->num_decodes());
+
+  // Hovering the tab again doesn't decode its thumbnail again.
+  for (int i = 0; i < 3; ++i) {
+    waiter.Reset();
+    image->RequestThumbnailImage();
+    waiter.Wait();
+    EXPECT_TRUE(waiter.called());
+  }
+  EXPECT_EQ(num_decodes + 1, store->num_decodes());
+}
+
+// Fills the store with the thumbnails of a synthetic population of tabs, and
+// checks the memory used and the number of decodes when hovering them.
+TEST_F(ThumbnailImageTest, ThumbnailsOfManyTabsFitInMemoryBudget) {
+  constexpr size_t kNumTabs = 40;
+  ThumbnailImageStore* const store = ThumbnailImageStore::GetInstance();
+  const size_t initial_size = store->total_size_in_bytes();
+
+  std::vector<std::unique_ptr<StubDelegate>> delegates;
+  std::vector<scoped_refptr<ThumbnailImage>> images;
+  for (size_t i = 0; i < kNumTabs; ++i) {
+    delegates.push_back(std::make_unique<StubDelegate>());
+    images.push_back(
+        base::MakeRefCounted<ThumbnailImage>(delegates.back().get()));
+    images.back()->AssignSkBitmap(CreateDetailedBitmap(i), std::nullopt);
+    task_environment().RunUntilIdle();
+  }
+  const size_t full_quality_size = store->total_size_in_bytes() - initial_size;
+  const size_t thumbnail_size = images.front()->GetCompressedDataSizeInBytes();
+  for (const auto& image : images)
+    EXPECT_FALSE(is_reduced_quality(*image));
+
+  // Reassigning the most recent thumbnail over a smaller budget reduces the
+  // quality of the thumbnails used least recently.
+  base::AutoReset<size_t> memory_budget = store->SetMemoryBudgetForTesting(
+      initial_size + full_quality_size * 3 / 4);
+  images.back()->AssignSkBitmap(CreateDetailedBitmap(kNumTabs - 1),
+                                std::nullopt);
+  task_environment().RunUntilIdle();
+  EXPECT_TRUE(is_reduced_quality(*images.front()));
+  EXPECT_LT(images.front()->GetCompressedDataSizeInBytes(), thumbnail_size);
+  EXPECT_FALSE(is_reduced_quality(*images.back()));
+  EXPECT_LT(store->total_size_in_bytes() - initial_size, full_quality_size);
+
+  // Hovering the same few tabs over and over only decodes their thumbnails
+  // once.
+  const size_t num_decodes = store->num_decodes();
+  for (int round = 0; round < 5; ++round) {
+    for (size_t i = 0; i < ThumbnailImageStore::kMaxDecodedImages; ++i) {
+      images[i]->RequestThumbnailImage();
+      task_environment().RunUntilIdle();
+    }
+  }
+  EXPECT_EQ(num_decodes + ThumbnailImageStore::kMaxDecodedImages,
+            store->num_decodes());
+
+  images.clear();
+  EXPECT_EQ(initial_size, store->total_size_in_bytes());
+}
@@ -182,6 +182,10 @@ void BookmarkMenuController::WillShowMenu(MenuItemView* menu) {
   menu_delegate_->WillShowMenu(menu);
 }
 
+void BookmarkMenuController::SelectionChanged(MenuItemView* menu) {
+  menu_delegate_->SelectionChanged(menu);
+}
+
 void BookmarkMenuController::BookmarkModelChanged() {
   if (!menu_delegate_->is_mutating_model())
     menu()->Cancel();
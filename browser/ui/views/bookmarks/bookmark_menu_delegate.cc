@@ -4,10 +4,12 @@
 
 #include "chrome/browser/ui/views/bookmarks/bookmark_menu_delegate.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "base/feature_list.h"
 #include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
 #include "base/memory/raw_ptr.h"
 #include "base/metrics/user_metrics.h"
 #include "base/strings/utf_string_conversions.h"
@@ -187,7 +189,7 @@ void BookmarkMenuDelegate::Init(views::MenuDelegate* real_delegate,
 
     if (show_managed)
       BuildMenuForManagedNode(parent);
-    BuildMenu(node, start_child_index, parent);
+    BuildMenu(node, start_child_index, parent, /*incremental=*/false);
     if (show_options == SHOW_PERMANENT_FOLDERS)
       BuildMenusForPermanentNodes(parent);
   } else {
@@ -295,7 +297,9 @@ bool BookmarkMenuDelegate::AreDropTypesRequired(MenuItemView* menu) {
 
 bool BookmarkMenuDelegate::CanDrop(MenuItemView* menu,
                                    const ui::OSExchangeData& data) {
-  if (menu->GetCommand() == IDC_SHOW_BOOKMARK_SIDE_PANEL) {
+  // Nothing can be dropped on the "More bookmarks" titles.
+  if (menu->GetCommand() == IDC_SHOW_BOOKMARK_SIDE_PANEL ||
+      menu->GetType() == MenuItemView::Type::kTitle) {
     return false;
   }
 
@@ -343,7 +347,11 @@ ui::mojom::DragOperation BookmarkMenuDelegate::GetDropOperation(
     return ui::mojom::DragOperation::kNone;
   }
 
-  const BookmarkNode* node = menu_id_to_node_map_[item->GetCommand()];
+  auto iter = menu_id_to_node_map_.find(item->GetCommand());
+  if (iter == menu_id_to_node_map_.end()) {
+    return ui::mojom::DragOperation::kNone;
+  }
+  const BookmarkNode* node = iter->second;
   const BookmarkNode* drop_parent = node->parent();
   size_t index_to_drop_at = drop_parent->GetIndexOf(node).value();
   switch (*position) {
@@ -379,7 +387,11 @@ views::View::DropCallback BookmarkMenuDelegate::GetDropCallback(
     views::MenuItemView* menu,
     views::MenuDelegate::DropPosition position,
     const ui::DropTargetEvent& event) {
-  const BookmarkNode* drop_node = menu_id_to_node_map_[menu->GetCommand()];
+  auto iter = menu_id_to_node_map_.find(menu->GetCommand());
+  if (iter == menu_id_to_node_map_.end()) {
+    return base::DoNothing();
+  }
+  const BookmarkNode* drop_node = iter->second;
   DCHECK(drop_node);
   BookmarkModel* model = GetBookmarkModel();
   DCHECK(model);
@@ -446,7 +458,11 @@ bool BookmarkMenuDelegate::CanDrag(MenuItemView* menu) {
   if (menu->GetCommand() == IDC_SHOW_BOOKMARK_SIDE_PANEL) {
     return false;
   }
-  const BookmarkNode* node = menu_id_to_node_map_[menu->GetCommand()];
+  auto iter = menu_id_to_node_map_.find(menu->GetCommand());
+  // Ignore items without a node, e.g. the "More bookmarks" titles.
+  if (iter == menu_id_to_node_map_.end())
+    return false;
+  const BookmarkNode* node = iter->second;
   // Don't let users drag the other folder.
   return node->parent() != GetBookmarkModel()->root_node();
 }
@@ -475,7 +491,60 @@ void BookmarkMenuDelegate::WillShowMenu(MenuItemView* menu) {
   if ((iter != menu_id_to_node_map_.end()) &&
       !iter->second->children().empty() &&
       menu->GetSubmenu()->GetMenuItems().empty())
-    BuildMenu(iter->second, 0, menu);
+    BuildMenu(iter->second, 0, menu, /*incremental=*/true);
+}
+
+void BookmarkMenuDelegate::SelectionChanged(MenuItemView* menu) {
+  MenuItemView* parent_menu = menu->GetParentMenuItem();
+  auto partial_menu = partial_menus_.find(parent_menu);
+  if (partial_menu == partial_menus_.end())
+    return;
+  auto iter = menu_id_to_node_map_.find(menu->GetCommand());
+  if (iter == menu_id_to_node_map_.end())
+    return;
+
+  // Keep at least half a window of entries on either side of the selected one,
+  // so that the user doesn't run out of entries while moving through the menu,
+  // and drop the entries farthest from it once there are too many.
+  const BookmarkNode* parent = iter->second->parent();
+  const size_t child_index = parent->GetIndexOf(iter->second).value();
+  const PartialMenu window = partial_menu->second;
+  size_t start_child_index = window.start_child_index;
+  size_t end_child_index = window.end_child_index;
+  if (end_child_index < parent->children().size() &&
+      child_index + kMenuItemsPerWindow / 2 >= end_child_index) {
+    end_child_index = std::min(parent->children().size(),
+                               end_child_index + kMenuItemsPerWindow);
+    const BookmarkNode* last_built =
+        parent->children()[window.end_child_index - 1].get();
+    BuildMenuItems(parent, window.end_child_index, end_child_index, parent_menu,
+                   GetIndexOfMenuItem(parent_menu, last_built) + 1);
+    if (end_child_index - start_child_index > kMaxMenuItemsPerMenu) {
+      RemoveMenuItems(parent, start_child_index,
+                      end_child_index - kMaxMenuItemsPerMenu, parent_menu);
+      start_child_index = end_child_index - kMaxMenuItemsPerMenu;
+    }
+  } else if (start_child_index > window.min_child_index &&
+             child_index < start_child_index + kMenuItemsPerWindow / 2) {
+    start_child_index =
+        std::max(window.min_child_index,
+                 start_child_index - std::min(start_child_index,
+                                              kMenuItemsPerWindow));
+    const BookmarkNode* first_built =
+        parent->children()[window.start_child_index].get();
+    BuildMenuItems(parent, start_child_index, window.start_child_index,
+                   parent_menu, GetIndexOfMenuItem(parent_menu, first_built));
+    if (end_child_index - start_child_index > kMaxMenuItemsPerMenu) {
+      RemoveMenuItems(parent, start_child_index + kMaxMenuItemsPerMenu,
+                      end_child_index, parent_menu);
+      end_child_index = start_child_index + kMaxMenuItemsPerMenu;
+    }
+  } else {
+    return;
+  }
+  UpdatePartialMenu(parent, window.min_child_index, start_child_index,
+                    end_child_index, parent_menu);
+  parent_menu->ChildrenChanged();
 }
 
 void BookmarkMenuDelegate::BookmarkModelChanged() {}
@@ -500,6 +569,28 @@ void BookmarkMenuDelegate::WillRemoveBookmarks(
   // cancel the menu. The observer is added back in DidRemoveBookmarks().
   bookmark_model_observation_.Reset();
 
+  // The children after the removed ones move up, so shift the range of children
+  // with an entry in partially built menus. The indices of the removed children
+  // are those before any of them is removed.
+  const PartialMenuMap windows_before_removal = partial_menus_;
+  for (const BookmarkNode* bookmark : bookmarks) {
+    const BookmarkNode* parent_node = bookmark->parent();
+    auto parent_to_menu = node_to_menu_map_.find(parent_node);
+    if (!parent_node || parent_to_menu == node_to_menu_map_.end())
+      continue;
+    auto window = windows_before_removal.find(parent_to_menu->second);
+    if (window == windows_before_removal.end())
+      continue;
+    const size_t index = parent_node->GetIndexOf(bookmark).value();
+    PartialMenu& partial_menu = partial_menus_[parent_to_menu->second];
+    if (index < window->second.min_child_index)
+      --partial_menu.min_child_index;
+    if (index < window->second.start_child_index)
+      --partial_menu.start_child_index;
+    if (index < window->second.end_child_index)
+      --partial_menu.end_child_index;
+  }
+
   // Remove the menu items.
   std::set<MenuItemView*> changed_parent_menus;
   for (const BookmarkNode* bookmark : bookmarks) {
@@ -507,6 +598,7 @@ void BookmarkMenuDelegate::WillRemoveBookmarks(
     if (node_to_menu != node_to_menu_map_.end()) {
       MenuItemView* menu = node_to_menu->second;
       MenuItemView* parent = menu->GetParentMenuItem();
+      partial_menus_.erase(menu);
       // |parent| is NULL when removing a root. This happens when right clicking
       // to delete an empty folder.
       if (parent) {
@@ -534,6 +626,7 @@ void BookmarkMenuDelegate::WillRemoveBookmarks(
       }
     }
     if (ancestor_removed) {
+      partial_menus_.erase(i->second);
       menu_id_to_node_map_.erase(i->second->GetCommand());
       node_to_menu_map_.erase(i++);
     } else {
@@ -584,7 +677,9 @@ MenuItemView* BookmarkMenuDelegate::CreateMenu(const BookmarkNode* parent,
   bool show_permanent = show_options == SHOW_PERMANENT_FOLDERS;
   if (show_permanent && parent == GetBookmarkModel()->bookmark_bar_node())
     BuildMenuForManagedNode(menu);
-  BuildMenu(parent, start_child_index, menu);
+  // The permanent folders follow the children of |parent|, so all of them need
+  // to be built up front.
+  BuildMenu(parent, start_child_index, menu, /*incremental=*/!show_permanent);
   if (show_permanent)
     BuildMenusForPermanentNodes(menu);
   return menu;
@@ -636,7 +731,8 @@ void BookmarkMenuDelegate::BuildMenuForManagedNode(MenuItemView* menu) {
 
 void BookmarkMenuDelegate::BuildMenu(const BookmarkNode* parent,
                                      size_t start_child_index,
-                                     MenuItemView* menu) {
+                                     MenuItemView* menu,
+                                     bool incremental) {
   DCHECK_LE(start_child_index, parent->children().size());
   if (parent == GetBookmarkModel()->other_node()) {
     ui::ImageModel bookmarks_side_panel_icon = ui::ImageModel::FromVectorIcon(
@@ -650,30 +746,138 @@ void BookmarkMenuDelegate::BuildMenu(const BookmarkNode* parent,
       menu->AppendSeparator();
     }
   }
+  const size_t end_child_index =
+      incremental ? std::min(parent->children().size(),
+                             start_child_index + kMenuItemsPerWindow)
+                  : parent->children().size();
+  BuildMenuItems(parent, start_child_index, end_child_index, menu,
+                 menu->HasSubmenu() ? menu->GetSubmenu()->children().size() : 0);
+  UpdatePartialMenu(parent, start_child_index, start_child_index,
+                    end_child_index, menu);
+}
+
+void BookmarkMenuDelegate::BuildMenuItems(const BookmarkNode* parent,
+                                          size_t start_child_index,
+                                          size_t end_child_index,
+                                          MenuItemView* menu,
+                                          size_t index) {
+  DCHECK_LE(start_child_index, end_child_index);
+  DCHECK_LE(end_child_index, parent->children().size());
   const ui::ImageModel folder_icon = chrome::GetBookmarkFolderIcon(
       chrome::BookmarkFolderIconType::kNormal, ui::kColorMenuIcon);
+  // Favicons are only requested for the children that get an entry.
   for (auto i = parent->children().cbegin() + start_child_index;
-       i != parent->children().cend(); ++i) {
+       i != parent->children().cbegin() + end_child_index; ++i) {
     const BookmarkNode* node = i->get();
     const int id = GetAndIncrementNextMenuID();
     MenuItemView* child_menu_item;
     if (node->is_url()) {
-      child_menu_item =
-          menu->AppendMenuItem(id, MaybeEscapeLabel(node->GetTitle()),
-                               GetFaviconForNode(GetBookmarkModel(), node));
+      child_menu_item = menu->AddMenuItemAt(
+          index++, id, MaybeEscapeLabel(node->GetTitle()), std::u16string(),
+          std::u16string(), ui::ImageModel(),
+          GetFaviconForNode(GetBookmarkModel(), node),
+          MenuItemView::Type::kNormal, ui::NORMAL_SEPARATOR);
       child_menu_item->GetViewAccessibility().SetDescription(
           url_formatter::FormatUrl(
               node->url(), url_formatter::kFormatUrlOmitDefaults,
               base::UnescapeRule::SPACES, nullptr, nullptr, nullptr));
     } else {
       DCHECK(node->is_folder());
-      child_menu_item = menu->AppendSubMenu(
-          id, MaybeEscapeLabel(node->GetTitle()), folder_icon);
+      child_menu_item = menu->AddMenuItemAt(
+          index++, id, MaybeEscapeLabel(node->GetTitle()), std::u16string(),
+          std::u16string(), ui::ImageModel(), folder_icon,
+          MenuItemView::Type::kSubMenu, ui::NORMAL_SEPARATOR);
     }
     AddMenuToMaps(child_menu_item, node);
   }
 }
 
+void BookmarkMenuDelegate::RemoveMenuItems(const BookmarkNode* parent,
+                                           size_t start_child_index,
+                                           size_t end_child_index,
+                                           MenuItemView* menu) {
+  for (auto i = parent->children().cbegin() + start_child_index;
+       i != parent->children().cbegin() + end_child_index; ++i) {
+    const BookmarkNode* node = i->get();
+    auto node_to_menu = node_to_menu_map_.find(node);
+    DCHECK(node_to_menu != node_to_menu_map_.end());
+    MenuItemView* child_menu_item = node_to_menu->second;
+    // Forget the entries of the folder's descendants, if it has been shown.
+    if (child_menu_item->HasSubmenu() &&
+        !child_menu_item->GetSubmenu()->GetMenuItems().empty()) {
+      for (auto j = node_to_menu_map_.begin(); j != node_to_menu_map_.end();) {
+        if (j->first != node && j->first->HasAncestor(node)) {
+          partial_menus_.erase(j->second);
+          menu_id_to_node_map_.erase(j->second->GetCommand());
+          j = node_to_menu_map_.erase(j);
+        } else {
+          ++j;
+        }
+      }
+    }
+    partial_menus_.erase(child_menu_item);
+    menu_id_to_node_map_.erase(child_menu_item->GetCommand());
+    node_to_menu_map_.erase(node);
+    menu->RemoveMenuItem(child_menu_item);
+  }
+}
+
+void BookmarkMenuDelegate::UpdatePartialMenu(const BookmarkNode* parent,
+                                             size_t min_child_index,
+                                             size_t start_child_index,
+                                             size_t end_child_index,
+                                             MenuItemView* menu) {
+  PartialMenu previous;
+  auto partial_menu = partial_menus_.find(menu);
+  if (partial_menu != partial_menus_.end())
+    previous = partial_menu->second;
+
+  const bool has_more_above = start_child_index > min_child_index;
+  const bool has_more_below = end_child_index < parent->children().size();
+  if (!has_more_above && !has_more_below) {
+    partial_menus_.erase(menu);
+  } else {
+    partial_menus_[menu] = {.min_child_index = min_child_index,
+                            .start_child_index = start_child_index,
+                            .end_child_index = end_child_index,
+                            .has_more_above = has_more_above,
+                            .has_more_below = has_more_below};
+  }
+  if (start_child_index == end_child_index)
+    return;
+
+  // The "More bookmarks" titles are right before the first entry and right
+  // after the last one. They are disabled, as they have no node to open, drag
+  // or drop on.
+  const std::u16string more_label =
+      l10n_util::GetStringUTF16(IDS_BOOKMARK_MENU_MORE_BOOKMARKS);
+  const size_t first_index = GetIndexOfMenuItem(
+      menu, parent->children()[start_child_index].get());
+  if (has_more_above && !previous.has_more_above) {
+    menu->AddMenuItemAt(first_index, 0, more_label, std::u16string(),
+                        std::u16string(), ui::ImageModel(), ui::ImageModel(),
+                        MenuItemView::Type::kTitle, ui::NORMAL_SEPARATOR)
+        ->SetEnabled(false);
+  } else if (!has_more_above && previous.has_more_above) {
+    menu->RemoveMenuItem(menu->GetSubmenu()->children()[first_index - 1]);
+  }
+  const size_t last_index = GetIndexOfMenuItem(
+      menu, parent->children()[end_child_index - 1].get());
+  if (has_more_below && !previous.has_more_below) {
+    menu->AddMenuItemAt(last_index + 1, 0, more_label, std::u16string(),
+                        std::u16string(), ui::ImageModel(), ui::ImageModel(),
+                        MenuItemView::Type::kTitle, ui::NORMAL_SEPARATOR)
+        ->SetEnabled(false);
+  } else if (!has_more_below && previous.has_more_below) {
+    menu->RemoveMenuItem(menu->GetSubmenu()->children()[last_index + 1]);
+  }
+}
+
+size_t BookmarkMenuDelegate::GetIndexOfMenuItem(MenuItemView* menu,
+                                                const BookmarkNode* node) {
+  return menu->GetSubmenu()->GetIndexOf(node_to_menu_map_[node]).value();
+}
+
 void BookmarkMenuDelegate::AddMenuToMaps(MenuItemView* menu,
                                          const BookmarkNode* node) {
   menu_id_to_node_map_[menu->GetCommand()] = node;
@@ -55,6 +55,15 @@ class BookmarkMenuDelegate : public bookmarks::BaseBookmarkModelObserver,
     HIDE_PERMANENT_FOLDERS
   };
 
+  // The number of children of a folder for which menu items are created at a
+  // time. Large folders get the menu items for their first children when the
+  // menu is shown, and more as the selection approaches either end of them.
+  static constexpr size_t kMenuItemsPerWindow = 100;
+
+  // The most children of a folder that have a menu item at once. The items
+  // farthest from the selection are removed beyond that.
+  static constexpr size_t kMaxMenuItemsPerMenu = 3 * kMenuItemsPerWindow;
+
   BookmarkMenuDelegate(Browser* browser, views::Widget* parent);
 
   BookmarkMenuDelegate(const BookmarkMenuDelegate&) = delete;
@@ -127,6 +136,7 @@ class BookmarkMenuDelegate : public bookmarks::BaseBookmarkModelObserver,
   int GetDragOperations(views::MenuItemView* sender);
   int GetMaxWidthForMenu(views::MenuItemView* menu);
   void WillShowMenu(views::MenuItemView* menu);
+  void SelectionChanged(views::MenuItemView* menu);
 
   // BookmarkModelObserver methods.
   void BookmarkModelChanged() override;
@@ -146,6 +156,19 @@ class BookmarkMenuDelegate : public bookmarks::BaseBookmarkModelObserver,
   typedef std::map<const bookmarks::BookmarkNode*, views::MenuItemView*>
       NodeToMenuMap;
 
+  // The children of a node which have an entry in a partially built menu.
+  struct PartialMenu {
+    // The first child which may have an entry.
+    size_t min_child_index = 0;
+    // The children in [|start_child_index|, |end_child_index|) have an entry.
+    size_t start_child_index = 0;
+    size_t end_child_index = 0;
+    // Whether a "More bookmarks" title is shown before and after the entries.
+    bool has_more_above = false;
+    bool has_more_below = false;
+  };
+  typedef std::map<const views::MenuItemView*, PartialMenu> PartialMenuMap;
+
   // Returns whether the menu should close id 'delete' is selected.
   bool ShouldCloseOnRemove(const bookmarks::BookmarkNode* node) const;
 
@@ -170,10 +193,43 @@ class BookmarkMenuDelegate : public bookmarks::BaseBookmarkModelObserver,
   void BuildMenuForManagedNode(views::MenuItemView* menu);
 
   // Creates an entry in menu for each child node of |parent| starting at
-  // |start_child_index|.
+  // |start_child_index|. If |incremental| is true, only the entries for the
+  // first |kMenuItemsPerWindow| children are created, the rest are created by
+  // SelectionChanged().
   void BuildMenu(const bookmarks::BookmarkNode* parent,
                  size_t start_child_index,
-                 views::MenuItemView* menu);
+                 views::MenuItemView* menu,
+                 bool incremental);
+
+  // Creates an entry in |menu|, starting at |index| in its submenu, for each
+  // child node of |parent| in [|start_child_index|, |end_child_index|).
+  void BuildMenuItems(const bookmarks::BookmarkNode* parent,
+                      size_t start_child_index,
+                      size_t end_child_index,
+                      views::MenuItemView* menu,
+                      size_t index);
+
+  // Removes the entries in |menu| for the child nodes of |parent| in
+  // [|start_child_index|, |end_child_index|), along with those of their
+  // descendants.
+  void RemoveMenuItems(const bookmarks::BookmarkNode* parent,
+                       size_t start_child_index,
+                       size_t end_child_index,
+                       views::MenuItemView* menu);
+
+  // Records in |partial_menus_| that the child nodes of |parent| in
+  // [|start_child_index|, |end_child_index|) have an entry in |menu|, and
+  // shows a "More bookmarks" title in place of the children from
+  // |min_child_index| on which don't.
+  void UpdatePartialMenu(const bookmarks::BookmarkNode* parent,
+                         size_t min_child_index,
+                         size_t start_child_index,
+                         size_t end_child_index,
+                         views::MenuItemView* menu);
+
+  // Returns the index of the entry for |node| in the submenu of |menu|.
+  size_t GetIndexOfMenuItem(views::MenuItemView* menu,
+                            const bookmarks::BookmarkNode* node);
 
   // Registers the necessary mappings for |menu| and |node|.
   void AddMenuToMaps(views::MenuItemView* menu,
@@ -212,6 +268,10 @@ class BookmarkMenuDelegate : public bookmarks::BaseBookmarkModelObserver,
   // Maps from node to menu.
   NodeToMenuMap node_to_menu_map_;
 
+  // Maps from a menu which only has entries for some of the children of its
+  // node to the range of children which do.
+  PartialMenuMap partial_menus_;
+
   // ID of the next menu item.
   int next_menu_id_;
 
@@ -8,6 +8,7 @@
 
 #include "base/memory/ptr_util.h"
 #include "base/memory/raw_ptr.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "chrome/browser/bookmarks/bookmark_model_factory.h"
 #include "chrome/browser/bookmarks/managed_bookmark_service_factory.h"
@@ -101,6 +102,10 @@ class BookmarkMenuDelegateTest : public BrowserWithTestWindowTest {
 
   int next_menu_id() { return bookmark_menu_delegate_->next_menu_id_; }
 
+  size_t num_nodes_with_menu() {
+    return bookmark_menu_delegate_->node_to_menu_map_.size();
+  }
+
   // Forces all the menus to load by way of invoking WillShowMenu() on all menu
   // items of tyep SUBMENU.
   void LoadAllMenus() { LoadAllMenus(bookmark_menu_delegate_->menu()); }
@@ -317,3 +322,97 @@ TEST_F(BookmarkMenuDelegateTest, DropCallback_ModelChanged) {
   EXPECT_EQ(output_drag_op, ui::mojom::DragOperation::kNone);
   EXPECT_EQ(model()->bookmark_bar_node()->children()[1]->children().size(), 2u);
 }
+
+// Opens a folder with 10,000 children, of which only the first window of
+// entries is built up front. More are built as the selection moves down.
+TEST_F(BookmarkMenuDelegateTest, LargeFolderIsBuiltIncrementally) {
+  constexpr size_t kNumChildren = 10000;
+  constexpr size_t kWindow = BookmarkMenuDelegate::kMenuItemsPerWindow;
+  const BookmarkNode* folder =
+      model()->AddFolder(model()->bookmark_bar_node(), 3, u"Large");
+  for (size_t i = 0; i < kNumChildren; ++i) {
+    model()->AddURL(folder, i, base::NumberToString16(i),
+                    GURL(kBasePath + base::NumberToString(i)));
+  }
+
+  NewAndInitDelegateForPermanent();
+  views::MenuItemView* root_item = bookmark_menu_delegate_->menu();
+  views::MenuItemView* folder_item = root_item->GetSubmenu()->GetMenuItemAt(3);
+  ASSERT_EQ(folder, GetNodeForMenuItem(folder_item));
+  const size_t num_nodes_before_load = num_nodes_with_menu();
+  bookmark_menu_delegate_->WillShowMenu(folder_item);
+  views::SubmenuView* submenu = folder_item->GetSubmenu();
+  // The entries for the first children are followed by a "More bookmarks"
+  // title.
+  ASSERT_EQ(kWindow + 1, submenu->GetMenuItems().size());
+  views::MenuItemView* more_item = submenu->GetMenuItemAt(kWindow);
+  EXPECT_EQ(views::MenuItemView::Type::kTitle, more_item->GetType());
+  EXPECT_FALSE(more_item->GetEnabled());
+  // Nothing can be dropped on the title.
+  ui::OSExchangeData drop_data;
+  drop_data.SetURL(GURL("http://www.chromium.org/"), std::u16string(u"z"));
+  EXPECT_FALSE(bookmark_menu_delegate_->CanDrop(more_item, drop_data));
+  // Favicons are only requested for the nodes with a menu item.
+  EXPECT_EQ(num_nodes_before_load + kWindow, num_nodes_with_menu());
+
+  // Selecting an entry far from the last one builds nothing.
+  bookmark_menu_delegate_->SelectionChanged(submenu->GetMenuItemAt(0));
+  EXPECT_EQ(kWindow + 1, submenu->GetMenuItems().size());
+
+  // Selecting one of the last entries builds the next window.
+  bookmark_menu_delegate_->SelectionChanged(
+      submenu->GetMenuItemAt(kWindow - 1));
+  ASSERT_EQ(2 * kWindow + 1, submenu->GetMenuItems().size());
+
+  // Removing a built entry doesn't skip any of the children without one.
+  std::vector<raw_ptr<const BookmarkNode, VectorExperimental>> nodes_to_remove =
+      {folder->children()[0].get()};
+  bookmark_menu_delegate_->WillRemoveBookmarks(nodes_to_remove);
+  model()->Remove(folder->children()[0].get(),
+                  bookmarks::metrics::BookmarkEditSource::kOther, FROM_HERE);
+  bookmark_menu_delegate_->DidRemoveBookmarks();
+  bookmark_menu_delegate_->SelectionChanged(
+      submenu->GetMenuItemAt(2 * kWindow - 2));
+  ASSERT_EQ(3 * kWindow, submenu->GetMenuItems().size());
+  for (size_t i = 0; i + 1 < submenu->GetMenuItems().size(); ++i) {
+    EXPECT_EQ(folder->children()[i].get(),
+              GetNodeForMenuItem(submenu->GetMenuItemAt(i)));
+  }
+
+  // Moving down to the end of the menu builds the entries for the last
+  // children, and removes those far above the selection, so that the menu
+  // never has more than |kMaxMenuItemsPerMenu| entries and the two titles.
+  const size_t max_menu_items = BookmarkMenuDelegate::kMaxMenuItemsPerMenu + 2;
+  views::MenuItemView* last_item = submenu->GetMenuItemAt(3 * kWindow - 2);
+  while (GetNodeForMenuItem(last_item) != folder->children().back().get()) {
+    bookmark_menu_delegate_->SelectionChanged(last_item);
+    const size_t num_items = submenu->GetMenuItems().size();
+    ASSERT_LE(num_items, max_menu_items);
+    last_item = submenu->GetMenuItemAt(num_items - 1);
+    if (!GetNodeForMenuItem(last_item))
+      last_item = submenu->GetMenuItemAt(num_items - 2);
+  }
+  EXPECT_LE(num_nodes_with_menu(),
+            num_nodes_before_load + BookmarkMenuDelegate::kMaxMenuItemsPerMenu);
+  // There is nothing more below the last entry, only above the first one.
+  EXPECT_EQ(last_item, submenu->GetMenuItems().back());
+  EXPECT_EQ(views::MenuItemView::Type::kTitle,
+            submenu->GetMenuItemAt(0)->GetType());
+
+  // Moving back up rebuilds the entries for the first children.
+  views::MenuItemView* first_item = submenu->GetMenuItemAt(1);
+  while (GetNodeForMenuItem(first_item) != folder->children().front().get()) {
+    bookmark_menu_delegate_->SelectionChanged(first_item);
+    ASSERT_LE(submenu->GetMenuItems().size(), max_menu_items);
+    first_item = submenu->GetMenuItemAt(0);
+    if (!GetNodeForMenuItem(first_item))
+      first_item = submenu->GetMenuItemAt(1);
+  }
+  EXPECT_EQ(first_item, submenu->GetMenuItemAt(0));
+  EXPECT_EQ(views::MenuItemView::Type::kTitle,
+            submenu->GetMenuItems().back()->GetType());
+  for (size_t i = 0; i + 1 < submenu->GetMenuItems().size(); ++i) {
+    EXPECT_EQ(folder->children()[i].get(),
+              GetNodeForMenuItem(submenu->GetMenuItemAt(i)));
+  }
+}
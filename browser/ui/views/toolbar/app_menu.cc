@@ -1302,6 +1302,11 @@ void AppMenu::WillHideMenu(MenuItemView* menu) {
   }
 }
 
+void AppMenu::SelectionChanged(MenuItemView* menu) {
+  if (bookmark_menu_delegate_ && IsBookmarkCommand(menu->GetCommand()))
+    bookmark_menu_delegate_->SelectionChanged(menu);
+}
+
 bool AppMenu::ShouldCloseOnDragComplete() {
   return false;
 }
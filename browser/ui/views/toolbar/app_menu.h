@@ -95,6 +95,7 @@ class AppMenu final : public views::MenuDelegate,
                       ui::Accelerator* accelerator) const override;
   void WillShowMenu(views::MenuItemView* menu) override;
   void WillHideMenu(views::MenuItemView* menu) override;
+  void SelectionChanged(views::MenuItemView* menu) override;
   bool ShouldCloseOnDragComplete() override;
   void OnMenuClosed(views::MenuItemView* menu) override;
   bool ShouldExecuteCommandWithoutClosingMenu(int command_id,
@@ -120,6 +120,26 @@ base::Value::Dict BuildCupsPrintersList(const std::vector<Printer>& printers) {
   return response;
 }
 
+// Applies the changes reported by OnPrinterClassUpdated() to |printers|.
+void ApplyPrinterClassUpdate(
+    const std::vector<Printer>& added_or_updated,
+    const std::vector<std::string>& removed_printer_ids,
+    std::vector<Printer>& printers) {
+  const std::set<std::string> removed(removed_printer_ids.begin(),
+                                      removed_printer_ids.end());
+  std::erase_if(printers, [&removed](const Printer& printer) {
+    return removed.contains(printer.id());
+  });
+  for (const Printer& printer : added_or_updated) {
+    auto it = base::ranges::find(printers, printer.id(), &Printer::id);
+    if (it != printers.end()) {
+      *it = printer;
+    } else {
+      printers.push_back(printer);
+    }
+  }
+}
+
 // Generates a Printer from |printer_dict| where |printer_dict| is a
 // CupsPrinterInfo representation.  If any of the required fields are missing,
 // returns nullptr.
@@ -1223,6 +1243,32 @@ void CupsPrintersHandler::OnPrintersChanged(
   }
 }
 
+void CupsPrintersHandler::OnPrinterClassUpdated(
+    PrinterClass printer_class,
+    const std::vector<Printer>& added_or_updated,
+    const std::vector<std::string>& removed_printer_ids) {
+  switch (printer_class) {
+    case PrinterClass::kAutomatic:
+    case PrinterClass::kDiscovered:
+      // The nearby printer lists are rebuilt when discovery starts.
+      if (!discovery_active_) {
+        return;
+      }
+      ApplyPrinterClassUpdate(added_or_updated, removed_printer_ids,
+                              printer_class == PrinterClass::kAutomatic
+                                  ? automatic_printers_
+                                  : discovered_printers_);
+      SendNearbyPrintersUpdate(printer_class, added_or_updated,
+                               removed_printer_ids);
+      break;
+    case PrinterClass::kSaved:
+    case PrinterClass::kEnterprise:
+      OnPrintersChanged(printer_class,
+                        printers_manager_->GetPrinters(printer_class));
+      break;
+  }
+}
+
 void CupsPrintersHandler::OnLocalPrintersUpdated() {
   CHECK(base::FeatureList::IsEnabled(::features::kLocalPrinterObserving));
 
@@ -1259,6 +1305,29 @@ void CupsPrintersHandler::UpdateDiscoveredPrinters() {
                     discovered_printers_list);
 }
 
+void CupsPrintersHandler::SendNearbyPrintersUpdate(
+    PrinterClass printer_class,
+    const std::vector<Printer>& added_or_updated,
+    const std::vector<std::string>& removed_printer_ids) {
+  base::Value::List added_or_updated_list;
+  for (const Printer& printer : added_or_updated) {
+    added_or_updated_list.Append(GetCupsPrinterInfo(printer));
+  }
+
+  base::Value::List removed_list;
+  for (const std::string& printer_id : removed_printer_ids) {
+    removed_list.Append(printer_id);
+  }
+
+  const bool automatic = printer_class == PrinterClass::kAutomatic;
+  PRINTER_LOG(DEBUG) << (automatic ? "Automatic" : "Discovered")
+                     << " printers updating. Added or updated: "
+                     << added_or_updated_list.size()
+                     << " Removed: " << removed_list.size();
+  FireWebUIListener("on-nearby-printers-updated", base::Value(automatic),
+                    added_or_updated_list, removed_list);
+}
+
 void CupsPrintersHandler::HandleAddDiscoveredPrinter(
     const base::Value::List& args) {
   AllowJavascript();
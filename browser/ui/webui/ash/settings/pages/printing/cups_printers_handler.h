@@ -189,6 +189,13 @@ class CupsPrintersHandler : public ::settings::SettingsPageUIHandler,
   // Emits the updated discovered printer list after new printers are received.
   void UpdateDiscoveredPrinters();
 
+  // Emits the printers added to, updated in or removed from the nearby printer
+  // list of |printer_class|, without resending the lists in full.
+  void SendNearbyPrintersUpdate(
+      chromeos::PrinterClass printer_class,
+      const std::vector<chromeos::Printer>& added_or_updated,
+      const std::vector<std::string>& removed_printer_ids);
+
   // Attempt to add a discovered printer.
   void HandleAddDiscoveredPrinter(const base::Value::List& args);
 
@@ -217,6 +224,10 @@ class CupsPrintersHandler : public ::settings::SettingsPageUIHandler,
   void OnPrintersChanged(
       chromeos::PrinterClass printer_class,
       const std::vector<chromeos::Printer>& printers) override;
+  void OnPrinterClassUpdated(
+      chromeos::PrinterClass printer_class,
+      const std::vector<chromeos::Printer>& added_or_updated,
+      const std::vector<std::string>& removed_printer_ids) override;
 
   // CupsPrintersManager::LocalPrintersObserver:
   void OnLocalPrintersUpdated() override;
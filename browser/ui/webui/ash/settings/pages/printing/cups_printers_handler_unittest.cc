@@ -67,6 +67,7 @@ void AddPrinterToPrintScanManager(const std::string& printer_id,
 }  // namespace
 
 using ::chromeos::Printer;
+using ::chromeos::PrinterClass;
 
 class CupsPrintersHandlerTest;
 
@@ -567,4 +568,25 @@ TEST_F(CupsPrintersHandlerTest, LocalPrintersObserver) {
   EXPECT_EQ(2u, data.arg2()->GetList().size());
 }
 
+// Verify changes to the nearby printers are sent to the
+// "on-nearby-printers-updated" event as deltas, not as full lists.
+TEST_F(CupsPrintersHandlerTest, NearbyPrintersUpdatedWithDeltas) {
+  printers_manager_.AddPrinter(Printer("automatic"), PrinterClass::kAutomatic);
+  web_ui_.HandleReceivedMessage("startDiscoveringPrinters",
+                                base::Value::List());
+
+  CupsPrintersManager::Observer* observer = printers_handler_.get();
+  observer->OnPrinterClassUpdated(PrinterClass::kDiscovered,
+                                  {Printer("discovered")}, {"removed"});
+  const content::TestWebUI::CallData& data = *web_ui_.call_data().back();
+  ASSERT_EQ(4u, data.args().size());
+  EXPECT_EQ("on-nearby-printers-updated", data.args()[0].GetString());
+  EXPECT_FALSE(data.args()[1].GetBool());
+  const base::Value::List& added_or_updated = data.args()[2].GetList();
+  ASSERT_EQ(1u, added_or_updated.size());
+  EXPECT_EQ("discovered",
+            *added_or_updated[0].GetDict().FindString("printerId"));
+  EXPECT_EQ(base::Value::List().Append("removed"), data.args()[3].GetList());
+}
+
 }  // namespace ash::settings
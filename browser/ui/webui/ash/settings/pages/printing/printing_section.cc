@@ -384,6 +384,15 @@ void PrintingSection::OnPrintersChanged(
   UpdateSavedPrintersSearchTags();
 }
 
+void PrintingSection::OnPrinterClassUpdated(
+    chromeos::PrinterClass printer_class,
+    const std::vector<chromeos::Printer>& added_or_updated,
+    const std::vector<std::string>& removed_printer_ids) {
+  if (printer_class == chromeos::PrinterClass::kSaved) {
+    UpdateSavedPrintersSearchTags();
+  }
+}
+
 void PrintingSection::UpdateSavedPrintersSearchTags() {
   // Start with no saved printers search tags.
   SearchTagRegistry::ScopedTagUpdater updater = registry()->StartUpdate();
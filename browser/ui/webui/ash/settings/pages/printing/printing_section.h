@@ -5,6 +5,9 @@
 #ifndef CHROME_BROWSER_UI_WEBUI_ASH_SETTINGS_PAGES_PRINTING_PRINTING_SECTION_H_
 #define CHROME_BROWSER_UI_WEBUI_ASH_SETTINGS_PAGES_PRINTING_PRINTING_SECTION_H_
 
+#include <string>
+#include <vector>
+
 #include "base/memory/raw_ptr.h"
 #include "base/values.h"
 #include "chrome/browser/ash/printing/cups_printers_manager.h"
@@ -43,6 +46,10 @@ class PrintingSection : public OsSettingsSection,
   void OnPrintersChanged(
       chromeos::PrinterClass printer_class,
       const std::vector<chromeos::Printer>& printers) override;
+  void OnPrinterClassUpdated(
+      chromeos::PrinterClass printer_class,
+      const std::vector<chromeos::Printer>& added_or_updated,
+      const std::vector<std::string>& removed_printer_ids) override;
 
   void UpdateSavedPrintersSearchTags();
 
@@ -4,7 +4,6 @@
 
 #include "chrome/browser/ui/webui/downloads/downloads_list_tracker.h"
 
-#include <iterator>
 #include <optional>
 #include <string>
 #include <utility>
@@ -13,6 +12,7 @@
 #include "base/feature_list.h"
 #include "base/functional/bind.h"
 #include "base/functional/callback_helpers.h"
+#include "base/i18n/case_conversion.h"
 #include "base/i18n/rtl.h"
 #include "base/i18n/unicodestring.h"
 #include "base/metrics/histogram_functions.h"
@@ -183,6 +183,15 @@ void FillUrlFields(const GURL& url,
   display_url_out = GetFormattedDisplayUrl(url);
 }
 
+// Returns a copy of |data| without the fields which only change with the
+// progress of the download.
+downloads::mojom::DataPtr WithoutProgress(const downloads::mojom::Data& data) {
+  downloads::mojom::DataPtr result = data.Clone();
+  result->percent = 0;
+  result->progress_status_text.clear();
+  return result;
+}
+
 }  // namespace
 
 DownloadsListTracker::DownloadsListTracker(
@@ -201,6 +210,7 @@ void DownloadsListTracker::Reset() {
   if (sending_updates_)
     page_->ClearAll();
   sent_to_page_ = 0u;
+  ClearProgressUpdates();
 }
 
 bool DownloadsListTracker::SetSearchTerms(
@@ -214,8 +224,19 @@ bool DownloadsListTracker::SetSearchTerms(
   if (new_terms == search_terms_)
     return false;
 
+  const bool narrows_search = NarrowsSearch(new_terms);
   search_terms_.swap(new_terms);
-  RebuildSortedItems();
+  if (narrows_search) {
+    // Items which don't match the old terms don't match the new ones either,
+    // so only the items on the page need to be searched again.
+    base::EraseIf(sorted_items_, [this](download::DownloadItem* item) {
+      return !should_show_.Run(*item);
+    });
+    RebuildWarningItems();
+    ClearProgressUpdates();
+  } else {
+    RebuildSortedItems();
+  }
   return true;
 }
 
@@ -224,12 +245,12 @@ void DownloadsListTracker::StartAndSendChunk() {
 
   CHECK_LE(sent_to_page_, sorted_items_.size());
 
-  auto it = sorted_items_.begin();
-  std::advance(it, sent_to_page_);
+  auto it = sorted_items_.begin() + sent_to_page_;
 
   std::vector<downloads::mojom::DataPtr> list;
   while (it != sorted_items_.end() && list.size() < chunk_size_) {
     list.push_back(CreateDownloadData(*it));
+    RememberSentData(**it, *list.back());
     ++it;
   }
 
@@ -244,28 +265,27 @@ void DownloadsListTracker::Stop() {
 }
 
 int DownloadsListTracker::NumDangerousItemsSent() const {
-  auto sent_items_end_it = sorted_items_.begin();
-  std::advance(sent_items_end_it, sent_to_page_);
-
-  return base::ranges::count_if(
-      sorted_items_.begin(), sent_items_end_it,
-      [](download::DownloadItem* item) { return item->IsDangerous(); });
+  if (sent_to_page_ >= sorted_items_.size())
+    return static_cast<int>(dangerous_items_.size());
+
+  // The dangerous items which were sent are those which sort before the first
+  // item that wasn't.
+  auto sent_items_end_it =
+      dangerous_items_.lower_bound(sorted_items_.begin()[sent_to_page_]);
+  return static_cast<int>(sent_items_end_it - dangerous_items_.begin());
 }
 
 download::DownloadItem* DownloadsListTracker::GetFirstActiveWarningItem() {
-  auto sent_items_end_it = sorted_items_.begin();
-  std::advance(sent_items_end_it, sent_to_page_);
-
-  auto iter = base::ranges::find_if(
-      sorted_items_.begin(), sent_items_end_it,
-      [](download::DownloadItem* item) {
-        return item->GetState() != download::DownloadItem::CANCELLED &&
-               item->IsDangerous();
-      });
-  if (iter != sent_items_end_it) {
-    return *iter;
+  if (active_warning_items_.empty())
+    return nullptr;
+
+  DownloadItem* first_item = *active_warning_items_.begin();
+  if (sent_to_page_ < sorted_items_.size() &&
+      !sorted_items_.key_comp()(first_item,
+                                sorted_items_.begin()[sent_to_page_])) {
+    return nullptr;
   }
-  return nullptr;
+  return first_item;
 }
 
 DownloadManager* DownloadsListTracker::GetMainNotifierManager() const {
@@ -279,8 +299,10 @@ DownloadManager* DownloadsListTracker::GetOriginalNotifierManager() const {
 void DownloadsListTracker::OnDownloadCreated(DownloadManager* manager,
                                              DownloadItem* download_item) {
   DCHECK_EQ(0u, sorted_items_.count(download_item));
-  if (should_show_.Run(*download_item))
+  if (should_show_.Run(*download_item)) {
+    UpdateWarningItems(download_item);
     InsertItem(sorted_items_.insert(download_item).first);
+  }
 }
 
 void DownloadsListTracker::OnDownloadUpdated(DownloadManager* manager,
@@ -289,6 +311,9 @@ void DownloadsListTracker::OnDownloadUpdated(DownloadManager* manager,
   bool is_showing = current_position != sorted_items_.end();
   bool should_show = should_show_.Run(*download_item);
 
+  if (should_show)
+    UpdateWarningItems(download_item);
+
   if (!is_showing && should_show)
     InsertItem(sorted_items_.insert(download_item).first);
   else if (is_showing && !should_show)
@@ -518,9 +543,7 @@ const DownloadItem* DownloadsListTracker::GetItemForTesting(
   if (index >= sorted_items_.size())
     return nullptr;
 
-  auto it = sorted_items_.begin();
-  std::advance(it, index);
-  return *it;
+  return sorted_items_.begin()[index];
 }
 
 void DownloadsListTracker::SetChunkSizeForTesting(size_t chunk_size) {
@@ -541,6 +564,38 @@ bool DownloadsListTracker::ShouldShow(const DownloadItem& item) const {
          DownloadQuery::MatchesQuery(search_terms_, item);
 }
 
+bool DownloadsListTracker::NarrowsSearch(
+    const std::vector<std::u16string>& new_terms) const {
+  return base::ranges::all_of(
+      search_terms_, [&new_terms](const std::u16string& term) {
+        const std::u16string lower_term = base::i18n::ToLower(term);
+        return base::ranges::any_of(
+            new_terms, [&lower_term](const std::u16string& new_term) {
+              return base::i18n::ToLower(new_term).find(lower_term) !=
+                     std::u16string::npos;
+            });
+      });
+}
+
+void DownloadsListTracker::UpdateWarningItems(DownloadItem* item) {
+  if (item->IsDangerous())
+    dangerous_items_.insert(item);
+  else
+    dangerous_items_.erase(item);
+
+  if (item->IsDangerous() && item->GetState() != DownloadItem::CANCELLED)
+    active_warning_items_.insert(item);
+  else
+    active_warning_items_.erase(item);
+}
+
+void DownloadsListTracker::RebuildWarningItems() {
+  dangerous_items_.clear();
+  active_warning_items_.clear();
+  for (DownloadItem* item : sorted_items_)
+    UpdateWarningItems(item);
+}
+
 bool DownloadsListTracker::StartTimeComparator::operator()(
     const download::DownloadItem* a,
     const download::DownloadItem* b) const {
@@ -573,6 +628,8 @@ void DownloadsListTracker::RebuildSortedItems() {
 
   SortedSet sorted_items(visible_items.begin(), visible_items.end());
   sorted_items_.swap(sorted_items);
+  RebuildWarningItems();
+  ClearProgressUpdates();
 }
 
 void DownloadsListTracker::InsertItem(const SortedSet::iterator& insert) {
@@ -585,6 +642,7 @@ void DownloadsListTracker::InsertItem(const SortedSet::iterator& insert) {
 
   std::vector<downloads::mojom::DataPtr> list;
   list.push_back(CreateDownloadData(*insert));
+  RememberSentData(**insert, *list.back());
 
   page_->InsertItems(static_cast<int>(index), std::move(list));
 
@@ -595,13 +653,59 @@ void DownloadsListTracker::UpdateItem(const SortedSet::iterator& update) {
   if (!sending_updates_ || GetIndex(update) >= sent_to_page_)
     return;
 
-  page_->UpdateItem(static_cast<int>(GetIndex(update)),
-                    CreateDownloadData(*update));
+  DownloadItem* item = *update;
+  downloads::mojom::DataPtr data = CreateDownloadData(item);
+  auto sent_data = sent_data_without_progress_.find(item);
+  if (item->GetState() == DownloadItem::IN_PROGRESS &&
+      sent_data != sent_data_without_progress_.end() &&
+      WithoutProgress(*data)->Equals(*sent_data->second)) {
+    // Only the progress changed, which the page is told about periodically.
+    pending_progress_updates_.insert(item);
+    if (!progress_update_timer_.IsRunning()) {
+      progress_update_timer_.Start(FROM_HERE, kProgressUpdateInterval, this,
+                                   &DownloadsListTracker::SendProgressUpdates);
+    }
+    return;
+  }
+
+  pending_progress_updates_.erase(item);
+  RememberSentData(*item, *data);
+  page_->UpdateItem(static_cast<int>(GetIndex(update)), std::move(data));
+}
+
+void DownloadsListTracker::RememberSentData(
+    const DownloadItem& item,
+    const downloads::mojom::Data& data) {
+  if (item.GetState() == DownloadItem::IN_PROGRESS) {
+    sent_data_without_progress_[&item] = WithoutProgress(data);
+  } else {
+    sent_data_without_progress_.erase(&item);
+  }
+}
+
+void DownloadsListTracker::SendProgressUpdates() {
+  auto pending_progress_updates = std::move(pending_progress_updates_);
+  pending_progress_updates_.clear();
+  if (!sending_updates_)
+    return;
+
+  for (DownloadItem* item : pending_progress_updates) {
+    auto update = sorted_items_.find(item);
+    if (update == sorted_items_.end() || GetIndex(update) >= sent_to_page_)
+      continue;
+    page_->UpdateItem(static_cast<int>(GetIndex(update)),
+                      CreateDownloadData(item));
+  }
+}
+
+void DownloadsListTracker::ClearProgressUpdates() {
+  progress_update_timer_.Stop();
+  pending_progress_updates_.clear();
+  sent_data_without_progress_.clear();
 }
 
 size_t DownloadsListTracker::GetIndex(const SortedSet::iterator& item) const {
-  // TODO(dbeam): this could be log(N) if |item| was random access.
-  return std::distance(sorted_items_.begin(), item);
+  return item - sorted_items_.begin();
 }
 
 void DownloadsListTracker::RemoveItem(const SortedSet::iterator& remove) {
@@ -613,5 +717,9 @@ void DownloadsListTracker::RemoveItem(const SortedSet::iterator& remove) {
       sent_to_page_--;
     }
   }
+  pending_progress_updates_.erase(*remove);
+  sent_data_without_progress_.erase(*remove);
+  dangerous_items_.erase(*remove);
+  active_warning_items_.erase(*remove);
   sorted_items_.erase(remove);
 }
@@ -7,13 +7,17 @@
 
 #include <stddef.h>
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
 
+#include "base/containers/flat_set.h"
 #include "base/functional/callback_forward.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/raw_ptr.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "build/buildflag.h"
 #include "chrome/browser/ui/webui/downloads/downloads.mojom.h"
 #include "components/download/content/public/all_download_item_notifier.h"
@@ -31,6 +35,10 @@ class DownloadManager;
 class DownloadsListTracker
     : public download::AllDownloadItemNotifier::Observer {
  public:
+  // How often progress updates of in-progress downloads are sent to the page.
+  // Any other change to a download is sent right away.
+  static constexpr base::TimeDelta kProgressUpdateInterval = base::Seconds(1);
+
   DownloadsListTracker(content::DownloadManager* download_manager,
                        mojo::PendingRemote<downloads::mojom::Page> page);
 
@@ -118,6 +126,7 @@ class DownloadsListTracker
                            CreateDownloadData_ReferrerUrlFormatting_Long);
   FRIEND_TEST_ALL_PREFIXES(DownloadsListTrackerTest,
                            CreateDownloadData_ReferrerUrlFormatting_VeryLong);
+  FRIEND_TEST_ALL_PREFIXES(DownloadsListTrackerTest, NarrowsSearch);
 
 #if BUILDFLAG(FULL_SAFE_BROWSING)
   FRIEND_TEST_ALL_PREFIXES(DownloadsListTrackerTest,
@@ -128,8 +137,11 @@ class DownloadsListTracker
     bool operator()(const download::DownloadItem* a,
                     const download::DownloadItem* b) const;
   };
-  using SortedSet = std::set<raw_ptr<download::DownloadItem, SetExperimental>,
-                             StartTimeComparator>;
+  // Sorted by start time, so that the index of an item on the page is its
+  // offset in the set.
+  using SortedSet =
+      base::flat_set<raw_ptr<download::DownloadItem, VectorExperimental>,
+                     StartTimeComparator>;
 
   // Called by both constructors to initialize common state.
   void Init();
@@ -140,6 +152,26 @@ class DownloadsListTracker
   // Whether |item| should show on the current page.
   bool ShouldShow(const download::DownloadItem& item) const;
 
+  // Whether every item matching |new_terms| also matches |search_terms_|,
+  // i.e. each current term is part of one of |new_terms|.
+  bool NarrowsSearch(const std::vector<std::u16string>& new_terms) const;
+
+  // Adds |item| to, or removes it from, |dangerous_items_| and
+  // |active_warning_items_| as needed.
+  void UpdateWarningItems(download::DownloadItem* item);
+  void RebuildWarningItems();
+
+  // Remembers |data|, which was just sent to the page for |item|.
+  void RememberSentData(const download::DownloadItem& item,
+                        const downloads::mojom::Data& data);
+
+  // Sends the progress updates which were held back.
+  void SendProgressUpdates();
+
+  // Drops the progress updates which were held back, and forgets the data of
+  // all sent items.
+  void ClearProgressUpdates();
+
   // Returns the index of |item| in |sorted_items_|.
   size_t GetIndex(const SortedSet::iterator& item) const;
 
@@ -168,6 +200,23 @@ class DownloadsListTracker
 
   SortedSet sorted_items_;
 
+  // The items of |sorted_items_| which are dangerous, and those of them which
+  // are not cancelled, i.e. still show an active warning. Kept in the same
+  // order so that they can be compared against |sorted_items_| directly.
+  SortedSet dangerous_items_;
+  SortedSet active_warning_items_;
+
+  // The data last sent to the page for each in-progress item, without its
+  // progress. Updates that do not change it only change the item's progress,
+  // and are held back in |pending_progress_updates_| until
+  // |progress_update_timer_| fires.
+  std::map<raw_ptr<const download::DownloadItem, CtnExperimental>,
+           downloads::mojom::DataPtr>
+      sent_data_without_progress_;
+  std::set<raw_ptr<download::DownloadItem, SetExperimental>>
+      pending_progress_updates_;
+  base::OneShotTimer progress_update_timer_;
+
   // The number of items sent to the page so far.
   size_t sent_to_page_ = 0u;
 
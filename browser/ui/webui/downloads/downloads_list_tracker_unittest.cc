@@ -76,6 +76,17 @@ class TestDownloadsListTracker : public DownloadsListTracker {
       download::DownloadItem* download_item) const override {
     auto file_value = downloads::mojom::Data::New();
     file_value->id = base::NumberToString(download_item->GetId());
+    file_value->file_name =
+        download_item->GetFileNameToReportUser().AsUTF8Unsafe();
+    file_value->is_insecure = download_item->IsInsecure();
+    file_value->percent = download_item->PercentComplete();
+    if (download_item->GetState() == DownloadItem::COMPLETE) {
+      file_value->state = downloads::mojom::State::kComplete;
+    } else if (download_item->IsPaused()) {
+      file_value->state = downloads::mojom::State::kPaused;
+    } else {
+      file_value->state = downloads::mojom::State::kInProgress;
+    }
     return file_value;
   }
 };
@@ -107,6 +118,9 @@ class DownloadsListTrackerTest : public testing::Test {
     ON_CALL(*new_item, GetTargetFilePath())
         .WillByDefault(
             ReturnRefOfCopy(base::FilePath(FILE_PATH_LITERAL("foo.txt"))));
+    ON_CALL(*new_item, GetFileNameToReportUser())
+        .WillByDefault(
+            ReturnRefOfCopy(base::FilePath(FILE_PATH_LITERAL("foo.txt"))));
     ON_CALL(*new_item, GetURL())
         .WillByDefault(ReturnRefOfCopy(GURL("https://example.test")));
     ON_CALL(*new_item, GetReferrerUrl())
@@ -128,8 +142,11 @@ class DownloadsListTrackerTest : public testing::Test {
         manager(), page_.BindAndGetRemote());
   }
 
+  content::BrowserTaskEnvironment* task_environment() {
+    return &task_environment_;
+  }
   TestingProfile* profile() { return &profile_; }
-  content::DownloadManager* manager() { return &manager_; }
+  content::MockDownloadManager* manager() { return &manager_; }
   TestDownloadsListTracker* tracker() { return tracker_.get(); }
 
  protected:
@@ -142,7 +159,8 @@ class DownloadsListTrackerTest : public testing::Test {
   }
 
   // NOTE: The initialization order of these members matters.
-  content::BrowserTaskEnvironment task_environment_;
+  content::BrowserTaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
   TestingProfile profile_;
 
   testing::NiceMock<content::MockDownloadManager> manager_;
@@ -328,6 +346,122 @@ TEST_F(DownloadsListTrackerTest, IgnoreUnsentItemRemovals) {
   tracker()->OnDownloadUpdated(manager(), unsent_item);
 }
 
+TEST_F(DownloadsListTrackerTest, ThrottleProgressUpdates) {
+  MockDownloadItem* item = CreateNextItem();
+
+  CreateTracker();
+  EXPECT_CALL(page_, InsertItems(0, _));
+  tracker()->StartAndSendChunk();
+  task_environment()->RunUntilIdle();
+  testing::Mock::VerifyAndClearExpectations(&page_);
+
+  // Progress updates are held back, and sent together.
+  ON_CALL(*item, PercentComplete()).WillByDefault(Return(10));
+  tracker()->OnDownloadUpdated(manager(), item);
+  ON_CALL(*item, PercentComplete()).WillByDefault(Return(20));
+  tracker()->OnDownloadUpdated(manager(), item);
+  task_environment()->RunUntilIdle();
+  testing::Mock::VerifyAndClearExpectations(&page_);
+
+  EXPECT_CALL(page_, UpdateItem(0, _));
+  task_environment()->FastForwardBy(
+      DownloadsListTracker::kProgressUpdateInterval);
+  testing::Mock::VerifyAndClearExpectations(&page_);
+
+  // Other changes are sent right away.
+  ON_CALL(*item, IsPaused()).WillByDefault(Return(true));
+  EXPECT_CALL(page_, UpdateItem(0, _));
+  tracker()->OnDownloadUpdated(manager(), item);
+  task_environment()->RunUntilIdle();
+  testing::Mock::VerifyAndClearExpectations(&page_);
+
+  ON_CALL(*item, GetFileNameToReportUser())
+      .WillByDefault(
+          ReturnRefOfCopy(base::FilePath(FILE_PATH_LITERAL("bar.txt"))));
+  EXPECT_CALL(page_, UpdateItem(0, _));
+  tracker()->OnDownloadUpdated(manager(), item);
+  task_environment()->RunUntilIdle();
+  testing::Mock::VerifyAndClearExpectations(&page_);
+
+  ON_CALL(*item, IsInsecure()).WillByDefault(Return(true));
+  EXPECT_CALL(page_, UpdateItem(0, _));
+  tracker()->OnDownloadUpdated(manager(), item);
+  task_environment()->RunUntilIdle();
+  testing::Mock::VerifyAndClearExpectations(&page_);
+
+  tracker()->OnDownloadUpdated(manager(), item);
+  ON_CALL(*item, GetState())
+      .WillByDefault(Return(download::DownloadItem::COMPLETE));
+  EXPECT_CALL(page_, UpdateItem(0, _));
+  tracker()->OnDownloadUpdated(manager(), item);
+  task_environment()->FastForwardBy(
+      DownloadsListTracker::kProgressUpdateInterval);
+}
+
+TEST_F(DownloadsListTrackerTest, NarrowsSearch) {
+  CreateNextItem();
+  CreateNextItem();
+  CreateTracker();
+  EXPECT_TRUE(tracker()->SetSearchTerms({"foo"}));
+
+  // Narrowing the search only searches the items found so far again.
+  EXPECT_CALL(*manager(), GetAllDownloads(_)).Times(0);
+  EXPECT_TRUE(tracker()->NarrowsSearch({u"foo.txt"}));
+  EXPECT_TRUE(tracker()->SetSearchTerms({"foo.txt"}));
+  EXPECT_TRUE(tracker()->NarrowsSearch({u"bar", u"foo.txt"}));
+
+  // Changing the letter case doesn't change the items found.
+  EXPECT_TRUE(tracker()->NarrowsSearch({u"FOO.TXT"}));
+  EXPECT_TRUE(tracker()->SetSearchTerms({"FOO.TXT"}));
+  testing::Mock::VerifyAndClearExpectations(manager());
+  EXPECT_TRUE(tracker()->GetItemForTesting(0));
+  EXPECT_TRUE(tracker()->GetItemForTesting(1));
+
+  // Widening the search searches all the items again.
+  EXPECT_FALSE(tracker()->NarrowsSearch({u"foo"}));
+  EXPECT_FALSE(tracker()->NarrowsSearch({u"bar"}));
+  EXPECT_CALL(*manager(), GetAllDownloads(_));
+  EXPECT_TRUE(tracker()->SetSearchTerms({"foo"}));
+  testing::Mock::VerifyAndClearExpectations(manager());
+  EXPECT_TRUE(tracker()->GetItemForTesting(0));
+  EXPECT_TRUE(tracker()->GetItemForTesting(1));
+}
+
+// Indexes and warning counts stay right with a long download history.
+TEST_F(DownloadsListTrackerTest, ManyItems) {
+  constexpr size_t kNumItems = 20000;
+  std::vector<MockDownloadItem*> items;
+  for (size_t i = 0; i < kNumItems; ++i) {
+    items.push_back(CreateNextItem());
+    if (i % 100 == 0)
+      ON_CALL(*items.back(), IsDangerous()).WillByDefault(Return(true));
+  }
+
+  CreateTracker();
+  tracker()->SetChunkSizeForTesting(1000);
+  EXPECT_CALL(page_, InsertItems(_, _)).Times(2);
+  tracker()->StartAndSendChunk();
+  tracker()->StartAndSendChunk();
+
+  // Items 19999 to 18000 were sent, newest first.
+  EXPECT_EQ(items[kNumItems - 1234], tracker()->GetItemForTesting(1233));
+  EXPECT_EQ(20, tracker()->NumDangerousItemsSent());
+  EXPECT_EQ(items[19900], tracker()->GetFirstActiveWarningItem());
+
+  EXPECT_CALL(page_, RemoveItem(0));
+  tracker()->OnDownloadRemoved(manager(), items[kNumItems - 1]);
+  EXPECT_EQ(items[kNumItems - 2], tracker()->GetItemForTesting(0));
+  EXPECT_EQ(20, tracker()->NumDangerousItemsSent());
+
+  ON_CALL(*items[19900], GetState())
+      .WillByDefault(Return(download::DownloadItem::CANCELLED));
+  EXPECT_CALL(page_, UpdateItem(98, _));
+  tracker()->OnDownloadUpdated(manager(), items[19900]);
+  EXPECT_EQ(items[19800], tracker()->GetFirstActiveWarningItem());
+  EXPECT_EQ(20, tracker()->NumDangerousItemsSent());
+  task_environment()->RunUntilIdle();
+}
+
 TEST_F(DownloadsListTrackerTest, IgnoreTransientDownloads) {
   MockDownloadItem* transient_item = CreateNextItem();
   ON_CALL(*transient_item, IsTransient()).WillByDefault(Return(true));